@@ -4,6 +4,21 @@
 #include "flyuxc/frontend/ast.h"
 #include <stdio.h>
 
+/* 名字索引条目（见 codegen_symtab.c） */
+typedef struct NameIndexEntry {
+    const char *name;       /* 被索引条目的名字（不复制） */
+    unsigned long hash;
+    void *value;            /* 被索引的条目 */
+    struct NameIndexEntry *next;
+} NameIndexEntry;
+
+/* 名字索引：名字 → 最新插入的同名条目，供各链表表格 O(1) 查找 */
+typedef struct NameIndex {
+    NameIndexEntry **buckets;
+    size_t bucket_count;    /* 2 的幂，0 表示尚未分配 */
+    size_t count;
+} NameIndex;
+
 /* 数组元数据 */
 typedef struct ArrayMetadata {
     char *var_name;         /* 变量名 */
@@ -32,6 +47,7 @@ typedef struct SymbolEntry {
     int scope_level;        /* 作用域层级（0=全局/函数顶层，递增表示嵌套） */
     char *ir_name;          /* LLVM IR 中的变量名（用于遮蔽时生成唯一名称） */
     int is_const;           /* 是否为常量 */
+    int is_num;             /* 是否以 double 存储（类型推断证明只保存 num） */
     struct SymbolEntry *next;
 } SymbolEntry;
 
@@ -69,6 +85,7 @@ typedef struct TempValueStack {
 
 /* 前向声明 */
 typedef struct CapturedVars CapturedVars;
+typedef struct NumericVars NumericVars;
 
 /* 已分配 IR 名称集合（用于避免重复 alloca） */
 typedef struct AllocatedIRName {
@@ -86,10 +103,23 @@ typedef struct CodeGen {
     int temp_count;         /* 临时变量计数器 */
     int label_count;        /* 标签计数器 */
     int string_count;       /* 字符串常量计数器 */
+    int ic_count;           /* 字段访问内联缓存计数器 */
+    int literal_count;      /* 静态字面量 Value 计数器 */
+    char **key_symbols;     /* 字面量属性名（下标即 @.key.N 的 N） */
+    int key_symbol_count;   /* 字面量属性名数量 */
+    int key_symbol_capacity;/* key_symbols 容量 */
     ArrayMetadata *arrays;  /* 数组元数据链表 */
     ObjectMetadata *objects; /* 对象元数据链表 */
-    SymbolEntry *symbols;   /* 符号表 - 已定义的变量 */
+    SymbolEntry *symbols;   /* 符号表 - 已定义的变量（后进先出，同一作用域的条目相邻） */
     SymbolEntry *globals;   /* 全局变量表 - has_main时使用LLVM全局变量 */
+    NameIndex array_index;  /* 以下索引与同名链表一一对应，用于按名字查找 */
+    NameIndex object_index;
+    NameIndex symbol_index;
+    NameIndex global_index;
+    NameIndex function_index;
+    NameIndex closure_index;
+    NameIndex allocated_ir_index;
+    NameIndex refbox_index;
     int scope_level;        /* 当前作用域层级 */
     int shadow_count;       /* 遮蔽变量计数器（用于生成唯一IR名称） */
     const char *current_var_name;  /* 当前正在赋值的变量名（用于数组/对象跟踪） */
@@ -114,6 +144,9 @@ typedef struct CodeGen {
     struct ClosureMapping *closure_mappings;  /* 变量到闭包函数的映射 */
     AllocatedIRName *allocated_ir_names;  /* 当前函数中已分配的 IR 名称 */
     struct RefBoxVarEntry *refbox_vars;  /* 引用盒子变量集合 */
+    NumericVars *numeric_vars;  /* 当前函数中以 double 存储的局部变量 */
+    int text_entries;       /* 统一调用入口以文本 IR 输出（-IR 调试回退）；否则只声明，由后端用 IRBuilder 生成 */
+    int entry_count;        /* 交给后端生成的统一入口数量（!flyux.entries 的元素数） */
 } CodeGen;
 
 /* 引用盒子变量条目 - 标记哪些变量是引用盒子 */
@@ -127,6 +160,8 @@ typedef struct ClosureMapping {
     char *var_name;          /* 存储闭包的变量名（映射后） */
     char *func_name;         /* 实际的闭包函数名 */
     CapturedVars *captured;  /* 该闭包需要的捕获变量 */
+    size_t param_count;      /* 闭包函数的普通参数数量 */
+    int uses_self;           /* 闭包函数是否有隐式 self 参数 */
     struct ClosureMapping *next;
 } ClosureMapping;
 
@@ -139,6 +174,9 @@ void codegen_set_varmap(CodeGen *gen, void *entries, size_t count);
 /* 设置原始源代码（用于错误消息中显示源码行） */
 void codegen_set_original_source(CodeGen *gen, const char *source);
 
+/* 统一调用入口是否以文本 IR 输出（默认否：只输出声明，由后端通过 IRBuilder 构建） */
+void codegen_set_text_entries(CodeGen *gen, int enabled);
+
 /* 生成LLVM IR */
 void codegen_generate(CodeGen *gen, ASTNode *ast);
 
@@ -188,7 +226,8 @@ CapturedVars *analyze_captured_vars(CodeGen *gen, ASTNode *func_body,
 
 /* 注册闭包映射 - 记录变量存储了哪个闭包函数 */
 void register_closure_mapping(CodeGen *gen, const char *var_name, 
-                              const char *func_name, CapturedVars *captured);
+                              const char *func_name, CapturedVars *captured,
+                              size_t param_count, int uses_self);
 
 /* 查找闭包映射 - 检查变量是否存储了闭包 */
 ClosureMapping *find_closure_mapping(CodeGen *gen, const char *var_name);
@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include "lexer.h"
 #include "normalize.h"
+#include "flyuxc/utils/string_pool.h"
 
 /* ============================================================================
  * AST (Abstract Syntax Tree) 节点定义
@@ -301,11 +302,22 @@ typedef struct ASTTypeAnnotation {
  * AST辅助函数
  * ============================================================================ */
 
+/* 设置本次编译的分配区：之后的节点、数组和名字都从 arena 分配，名字经 strings 驻留。
+ * AST 不单独释放，整棵树随 arena_destroy 一起回收 */
+void ast_set_arena(Arena *arena, StringPool *strings);
+
+/* 从当前分配区分配 / 扩展（用于节点数据和参数、语句等数组） */
+void *ast_alloc(size_t size);
+void *ast_realloc(void *ptr, size_t old_size, size_t new_size);
+
+/* 驻留名字：相同内容返回同一指针，归分配区所有，不可修改或释放 */
+char *ast_strdup(const char *str);
+
 /* 创建AST节点 */
 ASTNode *ast_node_create(ASTNodeKind kind, SourceLocation loc);
 
-/* 释放AST节点（递归释放） */
-void ast_node_free(ASTNode *node);
+/* 进程内累计创建的AST节点数 */
+size_t ast_node_count(void);
 
 /* 打印AST（用于调试） */
 void ast_print(ASTNode *node, int indent);
@@ -315,6 +327,9 @@ const char *ast_kind_name(ASTNodeKind kind);
 
 /* ============================================================================
  * 特定节点创建函数
+ *
+ * 传入的名字、字符串和数组须已在分配区中（token 的 lexeme、ast_strdup /
+ * ast_alloc 的结果），节点直接引用，不再复制
  * ============================================================================ */
 
 /* 创建程序节点 */
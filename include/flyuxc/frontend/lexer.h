@@ -4,6 +4,8 @@
 #include <stddef.h>
 #include <stdio.h>
 #include "normalize.h"  /* 获取 SourceLocation 定义 */
+#include "varmap.h"
+#include "flyuxc/utils/string_pool.h"
 
 /* 词法 Token 类型 */
 typedef enum TokenKind {
@@ -102,7 +104,7 @@ typedef enum TokenKind {
 /* 单个 Token */
 typedef struct Token {
     TokenKind kind;
-    char* lexeme;
+    char* lexeme;          /* 驻留在字符串池中，相同内容指向同一地址 */
     int line;              /* 规范化代码中的行号 */
     int column;            /* 规范化代码中的列号 */
     int orig_line;         /* 原始源码行号（0表示合成token） */
@@ -124,12 +126,15 @@ typedef struct LexerResult {
 extern "C" {
 #endif
 
-/* 对映射后的源码做词法分析，带源码位置映射 */
+/* 对规范化代码做词法分析，带源码位置映射；
+ * varmap 非 NULL 时在扫描过程中完成变量名映射。
+ * lexeme 驻留在 strings 中，最终的 token 数组也放在 strings 的 Arena 里，随 Arena 释放 */
 LexerResult lexer_tokenize(const char* source,
-                          const SourceLocation* norm_source_map,
-                          size_t norm_source_map_size,
-                          const size_t* offset_map,
-                          size_t offset_map_size);/* 释放 LexerResult 里所有动态内存 */
+                          const SourceMap* source_map,
+                          VarMap* varmap,
+                          StringPool* strings);
+
+/* 释放 LexerResult 里的错误信息（token 归 Arena 所有） */
 void lexer_result_free(LexerResult* result);
 
 /* 调试输出 Token 列表 */
@@ -9,7 +9,7 @@
  */
 
 /**
- * 源码位置映射：记录规范化后每个字符对应的原始源码位置
+ * 源码位置：规范化代码中某个字符（或 AST 节点）对应的原始源码位置
  */
 typedef struct {
     int orig_line;       /* 原始行号（1-based），0表示合成字符 */
@@ -18,6 +18,39 @@ typedef struct {
     int is_synthetic;    /* 1=合成字符（如添加的分号），0=来自原始代码 */
 } SourceLocation;
 
+/**
+ * 源码位置映射片段
+ * 规范化代码中连续来自原始源码同一行的一段 ASCII 字符只记一个片段（起点的行列），
+ * 片段内列号 = 起点列号 + 字节偏移；多字节字符和合成字符（如添加的分号）各自单独成段。
+ */
+typedef struct {
+    size_t norm_start;   /* 片段在规范化代码中的起始偏移 */
+    int orig_line;       /* 片段首字符的原始行号，0表示合成片段 */
+    int orig_column;     /* 片段首字符的原始列号 */
+} SourceSegment;
+
+/**
+ * 紧凑源码位置映射：片段数与行数、被删除的空白/注释处数量成正比，
+ * 而不是每个字节一项；按需用 source_map_lookup 查询
+ */
+typedef struct {
+    SourceSegment* segments;   /* 按 norm_start 递增 */
+    size_t count;
+    size_t capacity;
+    const char* text;          /* 规范化代码（用于判断片段首字符的 UTF-8 长度） */
+    size_t text_len;
+} SourceMap;
+
+/**
+ * 查询规范化代码 offset 处字符的原始位置；越界时返回合成位置
+ */
+SourceLocation source_map_lookup(const SourceMap* map, size_t offset);
+
+/**
+ * 同 source_map_lookup，但 offset 落在合成字符上时向前取最近的非合成字符
+ */
+SourceLocation source_map_lookup_nearest(const SourceMap* map, size_t offset);
+
 /**
  * 语句类型
  */
@@ -47,8 +80,7 @@ typedef struct {
  */
 typedef struct {
     char* normalized;       // 规范化后的代码
-    SourceLocation* source_map;  // 源码位置映射数组
-    size_t source_map_size;      // 映射数组长度
+    SourceMap source_map;   // 源码位置映射（text 指向 normalized）
     char* error_msg;        // 错误信息（如有）
     int error_code;         // 错误代码
 } NormalizeResult;
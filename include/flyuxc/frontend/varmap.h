@@ -3,7 +3,7 @@
 
 #include <stddef.h>
 #include <stdio.h>
-#include "normalize.h"  // 引入 SourceLocation 定义
+#include "normalize.h"  // 引入 SourceMap 定义
 
 /**
  * 变量种类（目前主要用于扩展，暂时可全部 UNKNOWN）
@@ -21,43 +21,64 @@ typedef enum {
 typedef struct {
     char*   original;     // 原始名字，例如 "x"、"🚀"
     char*   mapped;       // 映射后的名字，例如 "_00001"
+    size_t  original_len; // original 的字节长度
+    size_t  mapped_len;   // mapped 的字节长度
+    unsigned int hash;    // original 的 FNV-1a 哈希（索引用）
     VarKind kind;         // 变量类别（暂未精细区分，默认 UNKNOWN）
     int     first_line;   // 首次出现的行号（目前填 0，占位）
     int     first_column; // 首次出现的列号（目前填 0，占位）
 } VarMapEntry;
 
 /**
- * 变量映射结果
+ * 变量映射表
+ *
+ * 不再生成改名后的源码副本：lexer 扫描规范化代码时，对每个标识符 token
+ * 调用 flyux_varmap_identifier，当场决定它的名字（映射名或原名）。
  */
 typedef struct {
-    char* mapped_source;         /* Variable-mapped source code */
+    const char* source;                 /* 规范化代码（与 lexer 扫描的是同一份） */
+    size_t source_len;
+    const SourceMap* source_map;        /* 规范化代码的源码位置映射（用于错误报告） */
+    const char* original_source;        /* 原始源代码（用于错误报告） */
+
     VarMapEntry* entries;       /* Mapping table entries */
     size_t entry_count;         /* Number of entries */
-    size_t* offset_map;         /* mapped_offset → normalized_offset 映射 */
-    size_t offset_map_size;     /* offset_map 数组大小 */
+    size_t entry_cap;
+    size_t* slots;              /* 按名字哈希的开放寻址索引：entries 下标 + 1，0 为空 */
+    size_t slot_cap;            /* 槽数（2 的幂），装载率不超过 1/2 */
+    size_t next_index;          /* 用于生成 _00001, _00002, ... */
+
     char* error_msg;            /* Error message (if any) */
     int error_code;             /* 0 = success, non-zero = error */
-} VarMapResult;
+} VarMap;
 
 /**
- * 对规范化后的 FLYUX 源码进行变量名映射。
- * 只映射"标识符 token"，并跳过关键字、类型名、布尔/特殊字面量等。
+ * 初始化变量映射表。
  *
+ * @param vm 映射表
  * @param normalized_source 来自 flyux_normalize(...) 的 normalized 字符串
  * @param source_map 来自 flyux_normalize(...) 的源码位置映射
- * @param source_map_size 源码位置映射数组长度
  * @param original_source 原始源代码（用于错误报告）
- * @return 映射结果，需要调用 varmap_result_free 释放
  */
-VarMapResult flyux_varmap_process(const char* normalized_source, 
-                                  const SourceLocation* source_map,
-                                  size_t source_map_size,
-                                  const char* original_source);
+void flyux_varmap_init(VarMap* vm,
+                       const char* normalized_source,
+                       const SourceMap* source_map,
+                       const char* original_source);
+
+/**
+ * 决定规范化代码中 [start, end) 处标识符的名字。
+ * 只映射"标识符 token"，并跳过关键字、类型名、布尔/特殊字面量、
+ * 属性名和对象 key 等，这些返回原名（指向 source 内部，不以 '\0' 结尾）。
+ *
+ * @param out_len 输出：返回名字的长度
+ * @return 名字；出错时返回 NULL，错误信息在 vm->error_msg
+ */
+const char* flyux_varmap_identifier(VarMap* vm, size_t start, size_t end, size_t* out_len);
 
 /**
- * 释放 VarMapResult 内部动态资源。
+ * 释放 VarMap 内部动态资源。
  */
-void varmap_result_free(VarMapResult* result);
+void varmap_free(VarMap* vm);
 
 /**
  * 调试辅助：将映射表打印到指定 FILE*。
@@ -65,6 +86,6 @@ void varmap_result_free(VarMapResult* result);
  *   [1] x -> _00001 (UNKNOWN)
  *   [2] 🚀 -> _00002 (UNKNOWN)
  */
-void varmap_print_table(const VarMapResult* result, FILE* out);
+void varmap_print_table(const VarMap* vm, FILE* out);
 
 #endif // FLYUXC_VARMAP_H
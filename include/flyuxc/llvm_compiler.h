@@ -1,17 +1,29 @@
 #ifndef FLYUXC_LLVM_COMPILER_H
 #define FLYUXC_LLVM_COMPILER_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * 优化级别（各接口的 opt_level 参数）
+ * 0-3 对应 -O0..-O3，FLYUXC_OPT_SIZE 对应 -Os；
+ * 可再或上 FLYUXC_OPT_LTO：整程序模式，运行时 bitcode 与用户代码合并，
+ * 除 main 外全部内部化后运行完整的 LTO 流水线（需要以 FLYUXC_RUNTIME_BITCODE 构建）
+ */
+#define FLYUXC_OPT_SIZE       4
+#define FLYUXC_OPT_LEVEL_MASK 0xff
+#define FLYUXC_OPT_LTO        0x100
+
 /**
  * 编译 LLVM IR 到可执行文件
  * 
  * @param ir_file       LLVM IR 文件路径 (.ll)
  * @param runtime_obj   运行时库对象文件路径 (.o)
  * @param output_file   输出可执行文件路径
- * @param opt_level     优化级别 (0-3)
+ * @param opt_level     优化级别（见 FLYUXC_OPT_*）
  * @return 0 表示成功，非 0 表示失败
  */
 int llvm_compile_to_executable(
@@ -23,11 +35,12 @@ int llvm_compile_to_executable(
 
 /**
  * 编译 LLVM IR 字符串到可执行文件
+ * 直接在内存中解析，不再写出临时 .ll 文件
  * 
- * @param ir_code       LLVM IR 代码字符串
+ * @param ir_code       LLVM IR 代码字符串（以 NUL 结尾）
  * @param runtime_obj   运行时库对象文件路径 (.o)
  * @param output_file   输出可执行文件路径
- * @param opt_level     优化级别 (0-3)
+ * @param opt_level     优化级别（见 FLYUXC_OPT_*）
  * @return 0 表示成功，非 0 表示失败
  */
 int llvm_compile_string_to_executable(
@@ -37,6 +50,102 @@ int llvm_compile_string_to_executable(
     int opt_level
 );
 
+/**
+ * 将 IR 字符串编译为优化后的主对象文件（不链接）
+ * 
+ * @param ir_code       LLVM IR 代码字符串（以 NUL 结尾）
+ * @param runtime_obj   运行时库对象文件路径，为 NULL 时使用嵌入的运行时
+ *                      （bitcode 构建下运行时会链接进对象文件）
+ * @param object_file   输出对象文件路径
+ * @param opt_level     优化级别（见 FLYUXC_OPT_*）
+ * @return 0 表示成功，非 0 表示失败
+ */
+int llvm_compile_string_to_object(
+    const char *ir_code,
+    const char *runtime_obj,
+    const char *object_file,
+    int opt_level
+);
+
+/**
+ * 将主对象文件与运行时链接为可执行文件
+ * 
+ * @param object_file   llvm_compile_string_to_object 生成的对象文件
+ * @param runtime_obj   运行时库对象文件路径，须与生成对象文件时一致
+ * @param output_file   输出可执行文件路径
+ * @param opt_level     优化级别，须与生成对象文件时一致（整程序模式下运行时已在对象文件中）
+ * @return 0 表示成功，非 0 表示失败
+ */
+int llvm_link_executable(
+    const char *object_file,
+    const char *runtime_obj,
+    const char *output_file,
+    int opt_level
+);
+
+/**
+ * 在进程内以 JIT 方式编译并运行 IR 中的 main（flyuxc run）
+ * 运行时函数直接使用链接进编译器本身的 value_runtime，不生成对象文件也不链接
+ * 
+ * @param ir_code       LLVM IR 代码字符串（以 NUL 结尾）
+ * @param opt_level     优化级别（见 FLYUXC_OPT_*）
+ * @param lazy          非 0 时惰性编译：每个函数在第一次被调用时才编译
+ *                      （运行时来自编译器进程，FLYUXC_OPT_LTO 在此被忽略）
+ * @param exit_code     输出：main 的返回值
+ * @return 0 表示成功运行，非 0 表示编译失败（此时 exit_code 未设置）
+ */
+int llvm_run_string_jit(
+    const char *ir_code,
+    int opt_level,
+    int lazy,
+    int *exit_code
+);
+
+/**
+ * 配置 PGO，对之后的编译生效（flyuxc run 的 JIT 不插桩，只使用 profile）
+ * 
+ * @param generate_file 非 NULL 时插桩，程序退出时把原始 profile 写到该路径
+ *                      （支持 LLVM 的 %p / %m 等占位符，%m 会在多次运行间合并计数）
+ * @param use_file      非 NULL 时用该 profile 指导优化；.profraw 或 .profdata 均可，
+ *                      在进程内合并为索引格式，不需要 llvm-profdata
+ * @return 0 表示成功，非 0 表示 profile 无法读取（错误信息见 llvm_get_last_error）
+ */
+int llvm_set_profile(const char *generate_file, const char *use_file);
+
+/**
+ * 设置代码生成的并行度（-j），对之后的编译生效
+ * 
+ * 大于 1 时优化后的模块按 SplitModule 分成最多 threads 个分区，
+ * 各分区在自己的线程中生成对象文件，再合并为一个主对象文件
+ * 
+ * @param threads       线程数；0 表示按 CPU 核数，1 表示不分区（默认）
+ */
+void llvm_set_codegen_threads(int threads);
+
+/**
+ * 合并多个 .profraw / .profdata 为一个 .profdata（等同于 llvm-profdata merge）
+ * 
+ * @param inputs        输入文件路径数组
+ * @param count         输入文件数
+ * @param output_file   输出 .profdata 路径
+ * @return 0 表示成功，非 0 表示失败
+ */
+int llvm_profile_merge(const char *const *inputs, int count, const char *output_file);
+
+/**
+ * 目标机器描述（三元组 / CPU），生成的对象文件只在相同描述下可复用
+ */
+const char* llvm_target_description(void);
+
+/**
+ * 嵌入的运行时数据（用于缓存键）
+ * 
+ * @param len           输出：数据长度
+ * @param in_object     输出：1 表示运行时以 bitcode 链接进主对象文件，0 表示链接时作为对象文件加入
+ * @return 运行时对象文件或 bitcode 的字节
+ */
+const unsigned char* llvm_embedded_runtime(size_t *len, int *in_object);
+
 /**
  * 获取最后的错误信息
  * 
@@ -49,6 +158,13 @@ const char* llvm_get_last_error(void);
  */
 void llvm_initialize(void);
 
+/**
+ * 预先创建之后的编译要用的状态：各优化级别的目标机器、默认优化流水线，
+ * 并把运行时对象文件物化到共享位置。批量编译和编译服务器在 fork 工作进程前调用，
+ * 工作进程直接继承这些状态
+ */
+void llvm_warm_up(void);
+
 #ifdef __cplusplus
 }
 #endif
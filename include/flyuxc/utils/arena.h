@@ -20,6 +20,7 @@ typedef struct Arena {
     ArenaBlock* current;       // 当前块
     size_t total_allocated;    // 总分配量
     size_t block_size;         // 块大小（初始64KB，后续倍增）
+    size_t alloc_count;        // 分配次数（统计用）
 } Arena;
 
 /* 创建 Arena，初始块大小为 64KB */
@@ -31,6 +32,9 @@ void* arena_alloc(Arena* arena, size_t size);
 /* 分配并清零 */
 void* arena_alloc_zero(Arena* arena, size_t size);
 
+/* 扩展一块分配：ptr 是最近一次分配时原地扩展，否则分配新块并拷贝（旧块不回收） */
+void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size);
+
 /* 分配数组 */
 #define arena_alloc_array(arena, type, count) \
     ((type*)arena_alloc((arena), sizeof(type) * (count)))
@@ -48,5 +52,6 @@ void arena_destroy(Arena* arena);
 /* 获取统计信息 */
 size_t arena_total_allocated(const Arena* arena);
 size_t arena_total_used(const Arena* arena);
+size_t arena_alloc_count(const Arena* arena);
 
 #endif /* FLYUXC_ARENA_H */
@@ -9,7 +9,25 @@ typedef struct {
     bool version;        // -v, --version
     bool emit_ir;        // -IR, emit LLVM IR file
     const char* output;  // -o, --output
-    const char* input;   // 输入文件
+    const char* input;   // 输入文件（第一个）
+    const char** inputs; // 全部输入文件（指向 argv）；多于一个时为批量编译
+    int input_count;
+    bool time_report;    // --time-report=json[:<file>]
+    const char* time_report_file;  // JSON 输出文件，NULL 表示 stderr
+    const char* cache_dir;         // --cache-dir=<dir>，NULL 时看 FLYUXC_CACHE_DIR
+    bool no_cache;                 // --no-cache
+    unsigned long long cache_size_mb;  // --cache-size=<MiB>，0 表示默认
+    bool run;                      // flyuxc run <file>：JIT 编译并直接运行，不生成可执行文件
+    bool lazy;                     // --lazy：run 模式下函数在第一次调用时才编译
+    int opt_level;                 // -O0..-O3 为 0-3，-Os 为 FLYUXC_OPT_SIZE，默认 1
+    bool lto;                      // --lto：与运行时合并后整程序优化
+    int jobs;                      // -j<N>：代码生成线程数（批量编译和 serve 时为工作进程数），
+                                   // -j / -j0 为 CPU 核数，默认 1
+    const char* profile_generate;  // --profile-generate[=<file>]：插桩，运行时写出原始 profile
+    const char* profile_use;       // --profile-use=<file>：用 profile 指导优化
+    bool profile_merge;            // flyuxc profile-merge -o <out> <file...>（输入见 inputs）
+    bool serve;                    // flyuxc serve <socket>：编译服务器（套接字路径见 input）
+    const char* server;            // --server=<socket>：交给编译服务器编译，NULL 时看 FLYUXC_SERVER
 } CliOptions;
 
 // CLI 函数声明
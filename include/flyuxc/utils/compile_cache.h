@@ -0,0 +1,69 @@
+#ifndef FLYUXC_COMPILE_CACHE_H
+#define FLYUXC_COMPILE_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * 按内容寻址的编译缓存
+ *
+ * 缓存目录下分两类条目，文件名都是键的十六进制 SHA-256：
+ *   exe/<key>     完整可执行文件，键覆盖源码、编译器版本、优化级别和运行时对象
+ *   obj/<key>.o   优化后的主对象文件，键覆盖 IR、优化级别和目标机器，
+ *                 运行时等链接输入变化时仍可复用，只需重新链接
+ * 命中时把条目硬链接（失败则复制）到输出位置，并刷新其修改时间；
+ * 写入新条目后按修改时间做 LRU 淘汰，使目录总大小不超过上限。
+ * 条目先写到同目录的临时文件再 rename，多个编译进程可以共享同一目录。
+ */
+
+#define COMPILE_CACHE_KEY_HEX_LEN 64
+#define COMPILE_CACHE_DEFAULT_MAX_MB 256
+
+typedef enum {
+    CACHE_ENTRY_EXECUTABLE,
+    CACHE_ENTRY_OBJECT
+} CacheEntryKind;
+
+typedef struct {
+    char dir[1024];
+    unsigned long long max_bytes;
+} CompileCache;
+
+// 增量计算缓存键（SHA-256）
+typedef struct {
+    uint32_t state[8];
+    uint64_t length;
+    unsigned char block[64];
+    size_t block_used;
+} CacheKeyBuilder;
+
+void cache_key_begin(CacheKeyBuilder *builder, const char *domain);
+void cache_key_add(CacheKeyBuilder *builder, const void *data, size_t len);
+// 以长度前缀加入字符串，避免相邻字段拼接产生歧义
+void cache_key_add_string(CacheKeyBuilder *builder, const char *str);
+void cache_key_add_int(CacheKeyBuilder *builder, long long value);
+// 加入文件内容；文件无法读取时返回 false
+bool cache_key_add_file(CacheKeyBuilder *builder, const char *path);
+void cache_key_finish(CacheKeyBuilder *builder, char out[COMPILE_CACHE_KEY_HEX_LEN + 1]);
+
+// 打开（必要时创建）缓存目录；失败返回 false，此时不应使用缓存
+bool compile_cache_open(CompileCache *cache, const char *dir, unsigned long long max_bytes);
+
+// 条目在缓存中的路径
+void compile_cache_entry_path(const CompileCache *cache, CacheEntryKind kind,
+                              const char *key, char *path, size_t path_size);
+
+// 查找条目：命中时刷新其 LRU 时间并把路径写入 path
+bool compile_cache_lookup(const CompileCache *cache, CacheEntryKind kind, const char *key,
+                          char *path, size_t path_size);
+
+// 取出条目到 dest（硬链接或复制），命中并成功取出时返回 true
+bool compile_cache_fetch(const CompileCache *cache, CacheEntryKind kind, const char *key,
+                         const char *dest);
+
+// 把 src 存为条目，随后做 LRU 淘汰；失败只影响缓存本身
+bool compile_cache_store(const CompileCache *cache, CacheEntryKind kind, const char *key,
+                         const char *src);
+
+#endif // FLYUXC_COMPILE_CACHE_H
@@ -0,0 +1,51 @@
+#ifndef FLYUXC_COMPILE_SERVER_H
+#define FLYUXC_COMPILE_SERVER_H
+
+#include <stdbool.h>
+
+/*
+ * 批量编译与编译服务器
+ *
+ * 两种模式都由父进程预先完成 LLVM 初始化等一次性工作（见 llvm_warm_up），
+ * 每个编译任务在 fork 出的工作进程中执行：工作进程直接继承已初始化的目标机器、
+ * 优化流水线和运行时对象文件，任务之间的全局状态互不影响，单个任务崩溃也不影响其他任务。
+ * 同时运行的工作进程不超过 workers 个。
+ *
+ * 服务器监听 Unix 套接字。客户端发送工作目录和命令行参数，
+ * 并通过 SCM_RIGHTS 传递自己的 stdin / stdout / stderr，编译输出直接写到客户端的终端；
+ * 工作进程结束后服务器回送退出码（崩溃时为 128 + 信号值）。服务器使用自己的环境变量。
+ */
+
+typedef struct {
+    const char *input;
+    int status;             // 任务退出码；被信号终止时为 128 + 信号值，无法启动时为 -1
+    double ms;
+    const char *log_path;   // 任务的 stdout / stderr 输出，回调返回后删除；无法启动时为 NULL
+} BatchResult;
+
+// 编译一个文件，返回退出码（在工作进程中调用）
+typedef int (*BatchJobFn)(const char *input, void *ctx);
+// 一个文件编译结束（在父进程中按完成顺序调用）
+typedef void (*BatchDoneFn)(const BatchResult *result, void *ctx);
+
+// 批量编译 count 个文件，返回失败的文件数
+int batch_run(const char *const *inputs, int count, int workers,
+              BatchJobFn job, BatchDoneFn done, void *ctx);
+
+// 执行一个服务器请求，返回退出码（在工作进程中调用，stdio 已换成客户端的）
+typedef int (*ServerJobFn)(int argc, char **argv, void *ctx);
+
+// 在 socket_path 上运行编译服务器，直到收到 SIGINT / SIGTERM；启动失败返回非 0
+int compile_server_run(const char *socket_path, int workers, ServerJobFn job, void *ctx);
+
+typedef enum {
+    SERVER_REQUEST_DONE,         // 已收到退出码
+    SERVER_REQUEST_UNAVAILABLE,  // 连接或发送请求头失败，请求没有执行，可以改为本地编译
+    SERVER_REQUEST_LOST          // 请求已送达但没有收到回复，可能已经部分执行，不应重新编译
+} ServerRequestStatus;
+
+// 把命令行发给 socket_path 上的服务器执行，收到回复时写入 exit_code
+ServerRequestStatus compile_server_request(const char *socket_path, int argc, char *const argv[],
+                                           int *exit_code);
+
+#endif // FLYUXC_COMPILE_SERVER_H
@@ -3,10 +3,26 @@
 
 #include <stddef.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 // 打印文件到 stdout，成功返回 0，失败返回非 0
 int print_file_to_stdout(const char *path);
 
 // 读取文件内容到字符串，返回字符串指针（需要 free），失败返回 NULL
 char* read_file_to_string(const char *path);
 
+// 当前用户私有的临时目录 $TMPDIR/flyuxc-<uid>（权限 0700），
+// 无法创建或不属于当前用户时返回 NULL
+const char* flyuxc_temp_dir(void);
+
+// 创建唯一的空临时文件 <dir>/<prefix>XXXXXX<suffix>，返回路径（需要 free），失败返回 NULL
+// 优先放在 flyuxc_temp_dir()，不可用时直接放在 $TMPDIR
+char* create_temp_file(const char *prefix, const char *suffix);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif // FLYUXC_IO_H
@@ -7,7 +7,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-/* 字符串池哈希表大小（必须是2的幂） */
+/* 字符串池哈希表初始大小（必须是2的幂），条目数超过表大小时翻倍 */
 #define STRING_POOL_HASH_SIZE 4096
 
 /* 字符串池条目 */
@@ -21,7 +21,8 @@ typedef struct StringPoolEntry {
 /* 字符串池 */
 typedef struct StringPool {
     Arena* arena;                              // Arena分配器
-    StringPoolEntry* table[STRING_POOL_HASH_SIZE];  // 哈希表
+    StringPoolEntry** table;                   // 哈希表（分配在Arena中）
+    size_t table_size;                         // 哈希表大小
     size_t count;                              // 字符串总数
     size_t total_length;                       // 总字符数
 } StringPool;
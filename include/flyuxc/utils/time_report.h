@@ -0,0 +1,44 @@
+#ifndef FLYUXC_TIME_REPORT_H
+#define FLYUXC_TIME_REPORT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 编译期性能报告（--time-report=json）
+ *
+ * 记录各编译阶段的耗时、阶段结束时的堆占用与峰值 RSS，
+ * 以及 token / AST / IR 等计数，最后以 JSON 输出，供构建机跟踪回归。
+ * 未启用时所有记录函数都是空操作。
+ */
+
+// 启用报告；path 为 NULL 时输出到 stderr
+void time_report_enable(const char *path);
+bool time_report_enabled(void);
+
+// 当前时间（毫秒，单调时钟）
+double time_report_now_ms(void);
+
+// 开始 / 结束一个阶段；begin 返回的句柄传给 end，嵌套阶段以 "/" 分隔名字
+int time_report_begin(const char *phase);
+void time_report_end(int handle);
+
+// 直接记录一段已测量的耗时（用于 LLVM pass 等外部计时）
+void time_report_add_pass(const char *pass, double ms);
+
+// 设置一个计数（同名覆盖）
+void time_report_count(const char *name, unsigned long long value);
+
+// 输出 JSON；status 为 0 表示编译成功
+void time_report_write(int status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FLYUXC_TIME_REPORT_H
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""
+批量编译与编译服务器的基准：生成大量小脚本，比较三种方式的总耗时
+  per-process  每个文件启动一次 flyuxc（按 -j 个并发执行）
+  batch        一次 flyuxc a.fx b.fx ... -j N
+  server       flyuxc serve -j N 预热后，每个文件由一个客户端进程提交（按 -j 个并发执行）
+编译缓存关闭，三种方式都完整编译每个文件
+
+用法: bench_batch.py [flyuxc 路径] [文件数，默认 200] [-j，默认 CPU 核数]
+"""
+import os
+import subprocess
+import sys
+import tempfile
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+compiler = os.path.abspath(sys.argv[1] if len(sys.argv) > 1 else "./build/flyuxc")
+count = int(sys.argv[2]) if len(sys.argv) > 2 else 200
+jobs = int(sys.argv[3]) if len(sys.argv) > 3 else (os.cpu_count() or 1)
+
+
+def generate(directory):
+    files = []
+    for i in range(count):
+        path = os.path.join(directory, f"script{i}.fx")
+        with open(path, "w") as f:
+            f.write(f"""square := (x) {{
+    R> x * x + {i}
+}}
+main := () {{
+    total := 0
+    L> (k := 0; k < {i % 50 + 10}; k++) {{
+        total = total + square(k)
+    }}
+    println(total)
+}}
+""")
+        files.append(path)
+    return files
+
+
+def run_parallel(commands, workdir, env=None):
+    # 返回失败的命令数
+    def run(cmd):
+        return subprocess.run(cmd, cwd=workdir, env=env, stdout=subprocess.DEVNULL,
+                              stderr=subprocess.DEVNULL).returncode != 0
+    with ThreadPoolExecutor(max_workers=jobs) as pool:
+        return sum(pool.map(run, commands))
+
+
+def timed(label, fn):
+    start = time.perf_counter()
+    failed = fn()
+    ms = (time.perf_counter() - start) * 1000
+    print(f"{label:<12} {ms:>10.0f} {ms / count:>10.2f} {failed:>7}")
+    return ms
+
+
+def main():
+    with tempfile.TemporaryDirectory() as tmp:
+        files = generate(tmp)
+        print(f"{count} files, -j{jobs}")
+        print(f"{'mode':<12} {'total(ms)':>10} {'ms/file':>10} {'failed':>7}")
+
+        base = timed("per-process", lambda: run_parallel(
+            [[compiler, f, "--no-cache"] for f in files], tmp))
+
+        batch = timed("batch", lambda: subprocess.run(
+            [compiler, *files, "--no-cache", f"-j{jobs}"], cwd=tmp,
+            stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL).returncode)
+
+        socket_path = os.path.join(tmp, "server.sock")
+        server = subprocess.Popen([compiler, "serve", f"-j{jobs}", socket_path],
+                                  stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        try:
+            deadline = time.time() + 30
+            while not os.path.exists(socket_path) and time.time() < deadline:
+                time.sleep(0.05)
+            env = dict(os.environ, FLYUXC_SERVER=socket_path)
+            served = timed("server", lambda: run_parallel(
+                [[compiler, f, "--no-cache"] for f in files], tmp, env))
+        finally:
+            server.terminate()
+            server.wait()
+
+        print(f"speedup vs per-process: batch {base / batch:.2f}x, server {base / served:.2f}x")
+
+
+if __name__ == "__main__":
+    main()
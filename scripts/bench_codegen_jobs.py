@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""
+并行代码生成的基准：生成含大量顶层函数的 .fx 文件，分别用 -j1 和更大的 -j 编译，
+用 --time-report=json 读取 emit_object 阶段（分区、各线程生成对象文件、合并）耗时，
+同时记录整次编译的墙钟时间，并检查各 -j 生成的程序输出一致
+
+用法: bench_codegen_jobs.py [flyuxc 路径] [-j 值，默认 1 2 4 8 16 32]
+"""
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+compiler = os.path.abspath(sys.argv[1] if len(sys.argv) > 1 else "./build/flyuxc")
+jobs_list = [int(n) for n in sys.argv[2:]] or [1, 2, 4, 8, 16, 32]
+
+FUNCTIONS = 800
+RUNS = 3
+
+
+def generate(path):
+    # 每个函数有循环、分支和数组操作，main 调用全部函数，避免被当作死代码删除
+    with open(path, "w") as f:
+        for i in range(FUNCTIONS):
+            f.write(f"""fn{i} := (n) {{
+    arr := []
+    sum := {i}
+    L> (k := 0; k < n; k++) {{
+        arr.>push(k * {i % 7 + 1})
+        if (k % 3 == 0) {{ sum = sum + arr[k] }} {{ sum = sum - 1 }}
+    }}
+    R> sum
+}}
+""")
+        f.write("main := () {\n    total := 0\n")
+        for i in range(FUNCTIONS):
+            f.write(f"    total = total + fn{i}({i % 10 + 1})\n")
+        f.write("    println(total)\n}\n")
+
+
+def compile_once(source, jobs, report):
+    # 返回 (墙钟毫秒, emit_object 毫秒)；编译失败时返回 (None, None)
+    workdir = os.path.dirname(source)
+    start = time.perf_counter()
+    result = subprocess.run([compiler, source, "--no-cache", f"-j{jobs}",
+                             "--time-report=json:" + report],
+                            cwd=workdir, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    wall = (time.perf_counter() - start) * 1000
+    if result.returncode != 0:
+        return None, None
+    with open(report) as f:
+        data = json.load(f)
+    emit = sum(p["ms"] for p in data["phases"] if p["name"] == "emit_object")
+    return wall, emit
+
+
+def main():
+    with tempfile.TemporaryDirectory() as tmp:
+        source = os.path.join(tmp, "bench.fx")
+        report = os.path.join(tmp, "report.json")
+        exe = os.path.join(tmp, "bench")
+        generate(source)
+        kb = os.path.getsize(source) / 1024
+        print(f"{FUNCTIONS} functions, {kb:.0f} KB source")
+        print(f"{'jobs':>5} {'wall(ms)':>10} {'emit(ms)':>10} {'speedup':>8} {'output':>7}")
+
+        base_emit, base_output = None, None
+        for jobs in jobs_list:
+            results = [compile_once(source, jobs, report) for _ in range(RUNS)]
+            if any(r[0] is None for r in results):
+                print(f"{jobs:>5} {'compile failed':>30}")
+                continue
+            wall = min(r[0] for r in results)
+            emit = min(r[1] for r in results)
+            output = subprocess.run([exe], cwd=tmp, stdin=subprocess.DEVNULL,
+                                    capture_output=True, timeout=60).stdout
+            if base_emit is None:
+                base_emit, base_output = emit, output
+            speedup = f"{base_emit / emit:.2f}x" if emit > 0 else "n/a"
+            same = "same" if output == base_output else "DIFF"
+            print(f"{jobs:>5} {wall:>10.1f} {emit:>10.1f} {speedup:>8} {same:>7}")
+
+
+if __name__ == "__main__":
+    main()
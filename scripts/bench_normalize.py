@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""
+规范化阶段的规模测试：生成不同大小的 .fx 文件，
+用 --time-report=json 读取 normalize 阶段耗时，检查是否随文件大小线性增长
+
+用法: bench_normalize.py [flyuxc 路径] [最大 KB，默认 512]
+"""
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+compiler = sys.argv[1] if len(sys.argv) > 1 else "./build/flyuxc"
+max_kb = int(sys.argv[2]) if len(sys.argv) > 2 else 512
+
+# 一个函数约 400 字节：字符串、注释、嵌套括号和对象字面量都覆盖到
+FUNC_TEMPLATE = """// helper {i}: line comment with "quotes" and (brackets)
+f{i} := (a, b) {{
+    /* block comment ; with {{ braces }} */
+    s := "str {i}; \\"escaped\\" (not a bracket)"
+    o := {{ name: "n{i}", list: [a, b, (a + b) * {i}] }}
+    if (a > b) {{
+        R> o.list[0] + len(s)
+    }}
+    R> o.list[2]
+}}
+"""
+
+
+def generate(path, target_bytes):
+    size = 0
+    i = 0
+    with open(path, "w") as f:
+        while size < target_bytes:
+            chunk = FUNC_TEMPLATE.format(i=i)
+            f.write(chunk)
+            size += len(chunk)
+            i += 1
+        f.write("main := () {\n    println(f0(1, 2))\n}\n")
+    return i
+
+
+def normalize_ms(source, report):
+    # 只需要前端阶段，产物写到临时目录，编译失败也不影响 normalize 计时
+    subprocess.run([compiler, source, "-IR", "--time-report=json:" + report],
+                   stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    with open(report) as f:
+        data = json.load(f)
+    for phase in data["phases"]:
+        if phase["name"] == "normalize":
+            return phase["ms"]
+    raise RuntimeError("no normalize phase in time report")
+
+
+def main():
+    sizes = []
+    kb = 16
+    while kb <= max_kb:
+        sizes.append(kb)
+        kb *= 2
+
+    with tempfile.TemporaryDirectory() as tmp:
+        source = os.path.join(tmp, "bench.fx")
+        report = os.path.join(tmp, "report.json")
+        print(f"{'size(KB)':>9} {'funcs':>7} {'normalize(ms)':>14} {'us/KB':>8}")
+        results = []
+        for kb in sizes:
+            funcs = generate(source, kb * 1024)
+            ms = min(normalize_ms(source, report) for _ in range(3))
+            results.append((kb, ms))
+            print(f"{kb:>9} {funcs:>7} {ms:>14.2f} {ms * 1000 / kb:>8.1f}")
+
+    # 线性增长时每 KB 耗时应大致不变；平方增长时每翻倍一次约 x2
+    (kb0, ms0), (kb1, ms1) = results[len(results) // 2], results[-1]
+    if ms0 > 0:
+        ratio = (ms1 / kb1) / (ms0 / kb0)
+        print(f"per-KB cost ratio {kb1}KB vs {kb0}KB: {ratio:.2f} (~1 means linear)")
+
+
+if __name__ == "__main__":
+    main()
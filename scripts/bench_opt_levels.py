@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+"""
+优化级别的运行时基准：用 -O0/-O1/-O2/-O3/-Os 和 --lto 分别编译 testfx 程序，
+测量生成的可执行文件的运行时间，输出每个程序的耗时和相对 -O0 的加速比
+
+用法: bench_opt_levels.py [flyuxc 路径] [.fx 文件或目录 ...]
+  默认测量 testfx/valid 下的全部程序，另附几个计算密集的小程序（KERNELS）；
+  -O0 运行时间低于 MIN_MS 的程序主要在测进程启动，不计入表格
+  --lto 需要以 FLYUXC_RUNTIME_BITCODE 构建的编译器，否则该列显示 n/a
+"""
+import math
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+compiler = os.path.abspath(sys.argv[1] if len(sys.argv) > 1 else "./build/flyuxc")
+inputs = sys.argv[2:] or [os.path.join(os.path.dirname(__file__), "..", "testfx", "valid")]
+
+LEVELS = [
+    ("O0", ["-O0"]),
+    ("O1", ["-O1"]),
+    ("O2", ["-O2"]),
+    ("O3", ["-O3"]),
+    ("Os", ["-Os"]),
+    ("O3+lto", ["-O3", "--lto"]),
+]
+RUNS = 5
+MIN_MS = 5.0
+
+# testfx 里的程序大多只运行几毫秒，另外生成几个以计算为主的程序
+KERNELS = {
+    "fib": """fib := (n) {
+    if (n < 2) { R> n }
+    R> fib(n - 1) + fib(n - 2)
+}
+main := () {
+    println(fib(30))
+}
+""",
+    "loop": """main := () {
+    sum := 0
+    L> (i := 0; i < 3000000; i++) {
+        sum = sum + i % 7 * 3
+    }
+    println(sum)
+}
+""",
+    "array": """main := () {
+    total := 0
+    L> (r := 0; r < 200; r++) {
+        arr := []
+        L> (i := 0; i < 2000; i++) {
+            arr.>push(i * 2)
+        }
+        L> (i := 0; i < 2000; i++) {
+            total = total + arr[i]
+        }
+    }
+    println(total)
+}
+""",
+}
+
+
+def collect(paths):
+    files = []
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, names in os.walk(path):
+                files += [os.path.join(root, n) for n in names if n.endswith(".fx")]
+        else:
+            files.append(path)
+    return sorted(os.path.abspath(f) for f in files)
+
+
+def compile_exe(source, flags, workdir, exe):
+    # 可执行文件名取自源文件名，生成在当前目录；在临时目录编译后改名，避免各级别互相覆盖
+    name = os.path.splitext(os.path.basename(source))[0]
+    built = os.path.join(workdir, name)
+    if os.path.exists(built):
+        os.unlink(built)
+    result = subprocess.run([compiler, source, "--no-cache"] + flags, cwd=workdir,
+                            stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    if result.returncode != 0 or not os.path.exists(built):
+        return False
+    shutil.move(built, exe)
+    return True
+
+
+def run_ms(exe, workdir):
+    # 取多次运行的最小值；返回 (毫秒, 输出)，超时或崩溃时返回 (None, None)
+    best, output = None, None
+    for _ in range(RUNS):
+        start = time.perf_counter()
+        try:
+            result = subprocess.run([exe], cwd=workdir, stdin=subprocess.DEVNULL,
+                                    capture_output=True, timeout=20)
+        except subprocess.TimeoutExpired:
+            return None, None
+        ms = (time.perf_counter() - start) * 1000
+        if result.returncode < 0:
+            return None, None
+        best = ms if best is None else min(best, ms)
+        output = result.stdout
+    return best, output
+
+
+def main():
+    files = collect(inputs)
+    rows, skipped = [], 0
+    with tempfile.TemporaryDirectory() as tmp:
+        kernel_dir = os.path.join(tmp, "kernels")
+        os.mkdir(kernel_dir)
+        for name, code in KERNELS.items():
+            path = os.path.join(kernel_dir, name + ".fx")
+            with open(path, "w") as f:
+                f.write(code)
+            files.append(path)
+
+        for source in files:
+            times, outputs = {}, {}
+            for label, flags in LEVELS:
+                exe = os.path.join(tmp, "bench_" + label)
+                if compile_exe(source, flags, tmp, exe):
+                    times[label], outputs[label] = run_ms(exe, tmp)
+                else:
+                    times[label] = None
+            base = times.get("O0")
+            if base is None or base < MIN_MS:
+                skipped += 1
+                continue
+            # 输出与 -O0 不同的级别标 *（时间戳、随机数等不确定输出也会被标出）
+            marks = {label: "*" if times[label] is not None and outputs[label] != outputs["O0"] else ""
+                     for label, _ in LEVELS}
+            if source.startswith(kernel_dir):
+                name = "kernel:" + os.path.splitext(os.path.basename(source))[0]
+            else:
+                name = os.path.relpath(source)
+            rows.append((name, times, marks))
+
+    labels = [label for label, _ in LEVELS]
+    width = max([len(r[0]) for r in rows] + [len("speedup vs O0 (geomean)")])
+    print(f"{'program':<{width}} " + " ".join(f"{l + '(ms)':>11}" for l in labels))
+    for name, times, marks in rows:
+        cells = []
+        for label in labels:
+            t = times[label]
+            cells.append(f"{'n/a':>11}" if t is None else f"{t:>10.2f}{marks[label] or ' '}")
+        print(f"{name:<{width}} " + " ".join(cells))
+
+    # 各级别相对 -O0 的几何平均加速比（只统计该级别可用的程序）
+    cells = []
+    for label in labels:
+        ratios = [times["O0"] / times[label] for _, times, _ in rows if times[label]]
+        if ratios:
+            cells.append(f"{math.exp(sum(map(math.log, ratios)) / len(ratios)):>10.2f}x")
+        else:
+            cells.append(f"{'n/a':>11}")
+    print(f"{'speedup vs O0 (geomean)':<{width}} " + " ".join(cells))
+    print(f"{len(rows)} programs measured, {skipped} skipped "
+          f"(compile failure or -O0 run under {MIN_MS:.0f}ms)")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""
+变量映射的规模测试：生成含大量不同标识符的 .fx 文件，
+用 --time-report=json 读取 lexer 阶段（变量映射在其中完成）耗时，
+检查是否随标识符数量线性增长
+
+用法: bench_varmap.py [flyuxc 路径] [标识符数量，默认 10000 100000]
+"""
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+compiler = sys.argv[1] if len(sys.argv) > 1 else "./build/flyuxc"
+counts = [int(n) for n in sys.argv[2:]] or [10000, 100000]
+
+# 每个函数 64 个互不相同的局部变量，每个变量定义后再引用一次
+VARS_PER_FUNC = 64
+
+
+def generate(path, ident_count):
+    funcs = (ident_count + VARS_PER_FUNC - 1) // VARS_PER_FUNC
+    with open(path, "w") as f:
+        n = 0
+        for i in range(funcs):
+            f.write(f"fn{i} := (a) {{\n")
+            first = n
+            for _ in range(VARS_PER_FUNC):
+                f.write(f"    v{n} := a + {n}\n")
+                n += 1
+            f.write(f"    R> v{first} + v{n - 1}\n}}\n")
+        f.write("main := () {\n    println(fn0(1))\n}\n")
+    return n + funcs
+
+
+def lexer_ms(source, report):
+    # 只需要前端阶段，编译失败也不影响 lexer 计时；在临时目录运行，产物不落到当前目录
+    subprocess.run([os.path.abspath(compiler), source, "-IR", "--time-report=json:" + report],
+                   cwd=os.path.dirname(source),
+                   stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    with open(report) as f:
+        data = json.load(f)
+    for phase in data["phases"]:
+        if phase["name"] == "lexer":
+            return phase["ms"]
+    raise RuntimeError("no lexer phase in time report")
+
+
+def main():
+    with tempfile.TemporaryDirectory() as tmp:
+        source = os.path.join(tmp, "bench.fx")
+        report = os.path.join(tmp, "report.json")
+        print(f"{'idents':>9} {'size(KB)':>9} {'lexer(ms)':>10} {'ns/ident':>9}")
+        results = []
+        for count in counts:
+            idents = generate(source, count)
+            kb = os.path.getsize(source) / 1024
+            ms = min(lexer_ms(source, report) for _ in range(3))
+            results.append((idents, ms))
+            print(f"{idents:>9} {kb:>9.0f} {ms:>10.2f} {ms * 1e6 / idents:>9.1f}")
+
+    # 线性增长时每个标识符的耗时应大致不变；平方增长时会随数量成比例上升
+    if len(results) >= 2:
+        (n0, ms0), (n1, ms1) = results[0], results[-1]
+        if ms0 > 0:
+            ratio = (ms1 / n1) / (ms0 / n0)
+            print(f"per-ident cost ratio {n1} vs {n0}: {ratio:.2f} (~1 means linear)")
+
+
+if __name__ == "__main__":
+    main()
@@ -27,6 +27,11 @@ CodeGen *codegen_create(FILE *output) {
     gen->temp_count = 0;
     gen->label_count = 0;
     gen->string_count = 0;
+    gen->ic_count = 0;
+    gen->literal_count = 0;
+    gen->key_symbols = NULL;  /* 初始无字面量属性名 */
+    gen->key_symbol_count = 0;
+    gen->key_symbol_capacity = 0;
     gen->arrays = NULL;
     gen->objects = NULL;
     gen->symbols = NULL;
@@ -53,10 +58,28 @@ CodeGen *codegen_create(FILE *output) {
     gen->current_captured = NULL;  /* 初始无闭包捕获变量 */
     gen->allocated_ir_names = NULL;  /* 初始无已分配 IR 名称 */
     gen->refbox_vars = NULL;  /* 初始无引用盒子变量 */
+    gen->numeric_vars = NULL;  /* 初始无 num 局部变量（函数内由类型推断设置） */
+    gen->text_entries = 0;  /* 统一入口默认交给后端的 IRBuilder 生成 */
+    gen->entry_count = 0;
+    name_index_init(&gen->array_index);
+    name_index_init(&gen->object_index);
+    name_index_init(&gen->symbol_index);
+    name_index_init(&gen->global_index);
+    name_index_init(&gen->function_index);
+    name_index_init(&gen->closure_index);
+    name_index_init(&gen->allocated_ir_index);
+    name_index_init(&gen->refbox_index);
     
     return gen;
 }
 
+/* 设置统一调用入口的输出方式 */
+void codegen_set_text_entries(CodeGen *gen, int enabled) {
+    if (gen) {
+        gen->text_entries = enabled;
+    }
+}
+
 /* 设置变量映射表 */
 void codegen_set_varmap(CodeGen *gen, void *entries, size_t count) {
     if (gen) {
@@ -139,6 +162,22 @@ void codegen_free(CodeGen *gen) {
             mapping = next_mapping;
         }
         
+        // 释放名字索引
+        name_index_free(&gen->array_index);
+        name_index_free(&gen->object_index);
+        name_index_free(&gen->symbol_index);
+        name_index_free(&gen->global_index);
+        name_index_free(&gen->function_index);
+        name_index_free(&gen->closure_index);
+        name_index_free(&gen->allocated_ir_index);
+        name_index_free(&gen->refbox_index);
+        
+        // 释放字面量属性名表
+        for (int i = 0; i < gen->key_symbol_count; i++) {
+            free(gen->key_symbols[i]);
+        }
+        free(gen->key_symbols);
+        
         // 释放中间值栈
         if (gen->temp_values) {
             temp_value_stack_free(gen->temp_values);
@@ -522,7 +561,13 @@ void codegen_generate(CodeGen *gen, ASTNode *ast) {
     fprintf(gen->output, ";; Mixed-type value system\n");
     fprintf(gen->output, "%%struct.Value = type { i32, [12 x i8] }\n");
     fprintf(gen->output, "%%struct.ObjectEntry = type { i8*, %%struct.Value* }\n");
-    fprintf(gen->output, "%%struct.ObjectPair = type { i8*, %%struct.Value* }\n\n");
+    fprintf(gen->output, "%%struct.ObjectPair = type { i8*, %%struct.Value* }\n");
+    fprintf(gen->output, "%%struct.FieldIC = type { i32, i32 }  ; (shape, slot)\n");
+    fprintf(gen->output, "%%struct.KeySymbol = type { i8*, i64, i8* }  ; (name, hash, symbol)\n");
+    // 静态字面量：与 runtime 的完整 Value 布局一致（40 字节），分别以 double / i8* 作为 data
+    fprintf(gen->output, "%%struct.StaticNumber = type { i32, i32, i32, i8, i8, i16, double, i64, i64 }\n");
+    fprintf(gen->output, "%%struct.StaticString = type { i32, i32, i32, i8, i8, i16, i8*, i64, i64 }\n");
+    fprintf(gen->output, "%%struct.FunctionObject = type { i8*, %%struct.Value**, i32, i32, %%struct.Value*, i32, i32, i8* }  ; (func_ptr, captured, captured_count, param_count, bound_self, needs_self, capture_by_ref, entry)\n\n");
     
     // 3. 运行时函数声明
     fprintf(gen->output, ";; Boxing functions\n");
@@ -536,8 +581,9 @@ void codegen_generate(CodeGen *gen, ASTNode *ast) {
     fprintf(gen->output, "declare %%struct.Value* @box_null_preserve_type(%%struct.Value*)\n");
     fprintf(gen->output, "declare %%struct.Value* @box_array(i8*, i64)\n");
     fprintf(gen->output, "declare %%struct.Value* @box_object(i8*, i64)\n");
-    fprintf(gen->output, "declare %%struct.Value* @box_function(i8*, %%struct.Value**, i32, i32, i32)\n");  // 添加 needs_self 参数
-    fprintf(gen->output, "declare %%struct.Value* @box_function_ex(i8*, %%struct.Value**, i32, i32, i32, i32)\n");  // 扩展版本：添加 capture_by_ref 参数
+    fprintf(gen->output, "declare %%struct.Value* @box_object_symbols(i8*, i64)\n");
+    fprintf(gen->output, "declare %%struct.Value* @box_function(i8*, i8*, %%struct.Value**, i32, i32, i32)\n");  // (本体, 统一入口, ...) 添加 needs_self 参数
+    fprintf(gen->output, "declare %%struct.Value* @box_function_ex(i8*, i8*, %%struct.Value**, i32, i32, i32, i32)\n");  // 扩展版本：添加 capture_by_ref 参数
     fprintf(gen->output, "declare void @update_closure_captured(%%struct.Value*, i32, %%struct.Value*)\n");
     
     fprintf(gen->output, ";; Reference box functions for closure capture\n");
@@ -548,6 +594,7 @@ void codegen_generate(CodeGen *gen, ASTNode *ast) {
     
     fprintf(gen->output, ";; Unboxing functions\n");
     fprintf(gen->output, "declare double @unbox_number(%%struct.Value*)\n");
+    fprintf(gen->output, "declare double @llvm.pow.f64(double, double)\n");
     fprintf(gen->output, "declare i8* @unbox_string(%%struct.Value*)\n");
     fprintf(gen->output, "declare i8* @unbox_function_ptr(%%struct.Value*)\n");
     fprintf(gen->output, "declare %%struct.Value** @get_function_captured(%%struct.Value*)\n");
@@ -577,6 +624,14 @@ void codegen_generate(CodeGen *gen, ASTNode *ast) {
     fprintf(gen->output, "declare i64 @value_array_length(%%struct.Value*)\n");
     fprintf(gen->output, "declare %%struct.Value* @value_array_get(%%struct.Value*, %%struct.Value*)\n\n");
     
+    fprintf(gen->output, ";; Compact (NaN-boxed) values: num 与任意值混合的 + / == / !=\n");
+    fprintf(gen->output, "declare i64 @box_number_fx(double)\n");
+    fprintf(gen->output, "declare i64 @box_value_fx(%%struct.Value*)\n");
+    fprintf(gen->output, "declare %%struct.Value* @unbox_value_fx(i64)\n");
+    fprintf(gen->output, "declare void @fx_release(i64)\n");
+    fprintf(gen->output, "declare i64 @fx_add(i64, i64)\n");
+    fprintf(gen->output, "declare i32 @fx_equals(i64, i64)\n\n");
+    
     fprintf(gen->output, ";; Memory management functions (Reference Counting)\n");
     fprintf(gen->output, "declare %%struct.Value* @value_retain(%%struct.Value*)\n");
     fprintf(gen->output, "declare void @value_release(%%struct.Value*)\n\n");
@@ -688,6 +743,9 @@ void codegen_generate(CodeGen *gen, ASTNode *ast) {
     fprintf(gen->output, "declare %%struct.Value* @value_get_method(%%struct.Value*, %%struct.Value*)\n");
     fprintf(gen->output, "declare %%struct.Value* @value_get_method_by_index(%%struct.Value*, %%struct.Value*)\n");
     fprintf(gen->output, "declare %%struct.Value* @value_set_field(%%struct.Value*, %%struct.Value*, %%struct.Value*)\n");
+    fprintf(gen->output, "declare void @value_intern_keys(%%struct.KeySymbol**, i64)\n");
+    fprintf(gen->output, "declare %%struct.Value* @value_get_field_ic(%%struct.Value*, i8*, %%struct.FieldIC*)\n");
+    fprintf(gen->output, "declare %%struct.Value* @value_set_field_ic(%%struct.Value*, i8*, %%struct.Value*, %%struct.FieldIC*)\n");
     fprintf(gen->output, "declare %%struct.Value* @value_delete_field(%%struct.Value*, %%struct.Value*)\n");
     fprintf(gen->output, "declare %%struct.Value* @value_has_field(%%struct.Value*, %%struct.Value*)\n");
     fprintf(gen->output, "declare %%struct.Value* @value_keys(%%struct.Value*)\n");
@@ -755,4 +813,28 @@ void codegen_generate(CodeGen *gen, ASTNode *ast) {
     while (fgets(buffer, sizeof(buffer), gen->code_buf)) {
         fputs(buffer, gen->output);
     }
+    
+    // 8. 字面量属性名：main 之前统一驻留
+    if (gen->key_symbol_count > 0) {
+        int n = gen->key_symbol_count;
+        fprintf(gen->output, "\n@.key_table = internal constant [%d x %%struct.KeySymbol*] [", n);
+        for (int i = 0; i < n; i++) {
+            fprintf(gen->output, "%s%%struct.KeySymbol* @.key.%d", i ? ", " : "", i);
+        }
+        fprintf(gen->output, "]\n\n");
+        fprintf(gen->output, "define internal void @.intern_keys() {\n");
+        fprintf(gen->output, "  call void @value_intern_keys(%%struct.KeySymbol** getelementptr ([%d x %%struct.KeySymbol*], [%d x %%struct.KeySymbol*]* @.key_table, i32 0, i32 0), i64 %d)\n",
+                n, n, n);
+        fprintf(gen->output, "  ret void\n}\n\n");
+        fprintf(gen->output, "@llvm.global_ctors = appending global [1 x { i32, void ()*, i8* }] [{ i32, void ()*, i8* } { i32 65535, void ()* @.intern_keys, i8* null }]\n");
+    }
+    
+    // 9. 交给后端构建的统一入口列表（各元素 !N 紧跟在对应的 declare 之后）
+    if (gen->entry_count > 0) {
+        fprintf(gen->output, "\n!%s = !{", CODEGEN_ENTRIES_METADATA);
+        for (int i = 0; i < gen->entry_count; i++) {
+            fprintf(gen->output, "%s!%d", i ? ", " : "", i);
+        }
+        fprintf(gen->output, "}\n");
+    }
 }
@@ -448,23 +448,115 @@ CapturedVars *captured_vars_copy(CapturedVars *cv) {
 
 /* 注册闭包映射 - 记录变量存储了哪个闭包函数 */
 void register_closure_mapping(CodeGen *gen, const char *var_name, 
-                              const char *func_name, CapturedVars *captured) {
+                              const char *func_name, CapturedVars *captured,
+                              size_t param_count, int uses_self) {
     ClosureMapping *mapping = (ClosureMapping *)malloc(sizeof(ClosureMapping));
     mapping->var_name = strdup(var_name);
     mapping->func_name = strdup(func_name);
     mapping->captured = captured_vars_copy(captured);
+    mapping->param_count = param_count;
+    mapping->uses_self = uses_self;
     mapping->next = gen->closure_mappings;
     gen->closure_mappings = mapping;
+    name_index_insert(&gen->closure_index, mapping->var_name, mapping);
 }
 
 /* 查找闭包映射 - 检查变量是否存储了闭包 */
 ClosureMapping *find_closure_mapping(CodeGen *gen, const char *var_name) {
-    ClosureMapping *m = gen->closure_mappings;
-    while (m) {
-        if (strcmp(m->var_name, var_name) == 0) {
-            return m;
-        }
-        m = m->next;
+    return (ClosureMapping *)name_index_find(&gen->closure_index, var_name);
+}
+
+/* ============================================================================
+ * 统一调用入口
+ *
+ * 函数本体的签名随函数而变：[self] + 普通参数 + 捕获变量。
+ * 间接调用（call_function_value）统一走 <函数名>.entry(func_val, args, argc)，
+ * 由入口按本体签名展开参数后直接调用本体：
+ *   - self 取 FunctionObject.bound_self，未绑定时为 undef
+ *   - 调用方给出的参数不足时补 undef，多余的忽略
+ *   - 捕获变量取 FunctionObject.captured
+ * ============================================================================ */
+
+void codegen_emit_function_type(FILE *out, size_t total_params) {
+    fprintf(out, "%%struct.Value* (");
+    for (size_t i = 0; i < total_params; i++) {
+        if (i > 0) fprintf(out, ", ");
+        fprintf(out, "%%struct.Value*");
+    }
+    fprintf(out, ")*");
+}
+
+void codegen_emit_function_entry(CodeGen *gen, FILE *out, const char *func_name, size_t param_count,
+                                 int uses_self, size_t captured_count) {
+    if (!gen->text_entries) {
+        // 只声明入口，函数体由后端按 !flyux.entries 中的描述直接构建
+        int id = gen->entry_count++;
+        fprintf(out, "\ndeclare %%struct.Value* @%s.entry(%%struct.Value*, %%struct.Value**, i64)\n", func_name);
+        fprintf(out, "!%d = !{" FUNCTION_ENTRY_TYPE " @%s.entry, i32 %zu, i32 %d, i32 %zu}\n",
+                id, func_name, param_count, uses_self ? 1 : 0, captured_count);
+        return;
+    }
+
+    fprintf(out, "\ndefine internal %%struct.Value* @%s.entry(%%struct.Value* %%fn, "
+            "%%struct.Value** %%args, i64 %%argc) {\n", func_name);
+
+    int needs_fn_obj = uses_self || captured_count > 0;
+    if (needs_fn_obj) {
+        fprintf(out, "  %%fn.raw = bitcast %%struct.Value* %%fn to i8*\n");
+        fprintf(out, "  %%fn.data = getelementptr inbounds i8, i8* %%fn.raw, i64 %d\n", VALUE_DATA_OFFSET);
+        fprintf(out, "  %%fn.objpp = bitcast i8* %%fn.data to %%struct.FunctionObject**\n");
+        fprintf(out, "  %%fn.obj = load %%struct.FunctionObject*, %%struct.FunctionObject** %%fn.objpp\n");
+    }
+    if (uses_self || param_count > 0) {
+        fprintf(out, "  %%undef = call %%struct.Value* @box_undef()\n");
+    }
+
+    if (uses_self) {
+        fprintf(out, "  %%self.p = getelementptr inbounds %%struct.FunctionObject, "
+                "%%struct.FunctionObject* %%fn.obj, i32 0, i32 %d\n", FUNCTION_OBJECT_BOUND_SELF);
+        fprintf(out, "  %%self.v = load %%struct.Value*, %%struct.Value** %%self.p\n");
+        fprintf(out, "  %%self.none = icmp eq %%struct.Value* %%self.v, null\n");
+        fprintf(out, "  %%self = select i1 %%self.none, %%struct.Value* %%undef, %%struct.Value* %%self.v\n");
+    }
+
+    // 参数：不足的位置读 undef 槽位，避免越界读取 args
+    if (param_count > 0) {
+        fprintf(out, "  %%undef.slot = alloca %%struct.Value*\n");
+        fprintf(out, "  store %%struct.Value* %%undef, %%struct.Value** %%undef.slot\n");
+    }
+    for (size_t i = 0; i < param_count; i++) {
+        fprintf(out, "  %%arg%zu.has = icmp sgt i64 %%argc, %zu\n", i, i);
+        fprintf(out, "  %%arg%zu.at = getelementptr %%struct.Value*, %%struct.Value** %%args, i64 %zu\n", i, i);
+        fprintf(out, "  %%arg%zu.p = select i1 %%arg%zu.has, %%struct.Value** %%arg%zu.at, "
+                "%%struct.Value** %%undef.slot\n", i, i, i);
+        fprintf(out, "  %%arg%zu = load %%struct.Value*, %%struct.Value** %%arg%zu.p\n", i, i);
+    }
+
+    if (captured_count > 0) {
+        fprintf(out, "  %%caps.p = getelementptr inbounds %%struct.FunctionObject, "
+                "%%struct.FunctionObject* %%fn.obj, i32 0, i32 %d\n", FUNCTION_OBJECT_CAPTURED);
+        fprintf(out, "  %%caps = load %%struct.Value**, %%struct.Value*** %%caps.p\n");
+    }
+    for (size_t i = 0; i < captured_count; i++) {
+        fprintf(out, "  %%cap%zu.p = getelementptr inbounds %%struct.Value*, %%struct.Value** %%caps, i64 %zu\n", i, i);
+        fprintf(out, "  %%cap%zu = load %%struct.Value*, %%struct.Value** %%cap%zu.p\n", i, i);
+    }
+
+    fprintf(out, "  %%result = call %%struct.Value* @%s(", func_name);
+    int need_comma = 0;
+    if (uses_self) {
+        fprintf(out, "%%struct.Value* %%self");
+        need_comma = 1;
+    }
+    for (size_t i = 0; i < param_count; i++) {
+        fprintf(out, "%s%%struct.Value* %%arg%zu", need_comma ? ", " : "", i);
+        need_comma = 1;
+    }
+    for (size_t i = 0; i < captured_count; i++) {
+        fprintf(out, "%s%%struct.Value* %%cap%zu", need_comma ? ", " : "", i);
+        need_comma = 1;
     }
-    return NULL;
+    fprintf(out, ")\n");
+    fprintf(out, "  ret %%struct.Value* %%result\n");
+    fprintf(out, "}\n");
 }
@@ -4,175 +4,258 @@
 #include <stdio.h>
 
 /* ============================================================================
- * 内联数字运算辅助函数
- * 生成直接的 LLVM 指令而不是调用运行时函数
+ * 数值快速路径
+ * 类型推断证明为 num 的表达式直接在 double 上计算，只在值逃逸时装箱一次
  * ============================================================================ */
 
-/* 生成内联的数字减法: unbox -> fsub -> box */
-static char* gen_inline_num_subtract(CodeGen *gen, const char *left, const char *right) {
-    char *left_num = new_temp(gen);
-    char *right_num = new_temp(gen);
-    char *sub_result = new_temp(gen);
-    char *result = new_temp(gen);
-    
-    // unbox 两个操作数
-    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", left_num, left);
-    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", right_num, right);
-    // 直接用 LLVM fsub 指令
-    fprintf(gen->code_buf, "  %s = fsub double %s, %s\n", sub_result, left_num, right_num);
-    // box 结果
-    fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_number(double %s)\n", result, sub_result);
+/* 格式化 double 常量（使用 %.17e 保持完整精度） */
+static char *format_num_const(double value) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.17e", value);
+    return strdup(buf);
+}
+
+/* num 变量 ++/--：直接更新 double 栈槽，前缀返回新值，后缀返回旧值 */
+static char *gen_num_var_increment(CodeGen *gen, ASTUnaryExpr *unary) {
+    ASTIdentifier *id = (ASTIdentifier *)unary->operand->data;
+    const char *ir_name = get_symbol_ir_name(gen, id->name);
+    char *old_val = new_temp(gen);
+    char *new_val = new_temp(gen);
     
-    free(left_num);
-    free(right_num);
-    free(sub_result);
+    fprintf(gen->code_buf, "  %s = load double, double* %%%s.num\n", old_val, ir_name);
+    fprintf(gen->code_buf, "  %s = %s double %s, 1.0\n", new_val,
+            unary->op == TK_PLUS_PLUS ? "fadd" : "fsub", old_val);
+    fprintf(gen->code_buf, "  store double %s, double* %%%s.num\n", new_val, ir_name);
     
-    return result;
+    if (unary->is_postfix) {
+        free(new_val);
+        return old_val;
+    }
+    free(old_val);
+    return new_val;
 }
 
-/* 生成内联的数字加法: unbox -> fadd -> box */
-static char* gen_inline_num_add(CodeGen *gen, const char *left, const char *right) {
-    char *left_num = new_temp(gen);
-    char *right_num = new_temp(gen);
-    char *add_result = new_temp(gen);
-    char *result = new_temp(gen);
+/* 生成表达式的 double 值（不装箱）
+ * 可证明为 num 的子表达式直接计算；其他子表达式先生成 Value* 再 unbox_number，
+ * 与运行时 value_subtract 等函数的强制转换语义一致 */
+char *codegen_num_expr(CodeGen *gen, ASTNode *node) {
+    if (!node) return format_num_const(0.0);
     
-    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", left_num, left);
-    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", right_num, right);
-    fprintf(gen->code_buf, "  %s = fadd double %s, %s\n", add_result, left_num, right_num);
-    fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_number(double %s)\n", result, add_result);
+    switch (node->kind) {
+        case AST_NUM_LITERAL: {
+            ASTNumLiteral *num = (ASTNumLiteral *)node->data;
+            return format_num_const(num->value);
+        }
+        
+        case AST_IDENTIFIER: {
+            ASTIdentifier *id = (ASTIdentifier *)node->data;
+            if (!is_symbol_numeric(gen, id->name)) break;
+            
+            char *result = new_temp(gen);
+            fprintf(gen->code_buf, "  %s = load double, double* %%%s.num\n",
+                    result, get_symbol_ir_name(gen, id->name));
+            return result;
+        }
+        
+        case AST_BINARY_EXPR: {
+            ASTBinaryExpr *expr = (ASTBinaryExpr *)node->data;
+            const char *instr = NULL;
+            
+            switch (expr->op) {
+                case TK_PLUS:
+                    // + 只有在两边都是 num 时才是数字加法（否则可能是字符串拼接）
+                    if (is_numeric_expr(gen, node)) instr = "fadd";
+                    break;
+                case TK_MINUS:   instr = "fsub"; break;
+                case TK_STAR:    instr = "fmul"; break;
+                case TK_SLASH:   instr = "fdiv"; break;
+                case TK_PERCENT: instr = "frem"; break;  // frem 与 fmod 语义相同，除数为 0 时得到 NaN
+                case TK_POWER:   instr = "pow";  break;
+                default: break;
+            }
+            if (!instr) break;
+            
+            char *left = codegen_num_expr(gen, expr->left);
+            char *right = codegen_num_expr(gen, expr->right);
+            char *result = new_temp(gen);
+            
+            if (expr->op == TK_POWER) {
+                fprintf(gen->code_buf, "  %s = call double @llvm.pow.f64(double %s, double %s)\n",
+                        result, left, right);
+            } else {
+                fprintf(gen->code_buf, "  %s = %s double %s, %s\n", result, instr, left, right);
+            }
+            
+            free(left);
+            free(right);
+            return result;
+        }
+        
+        case AST_UNARY_EXPR: {
+            ASTUnaryExpr *unary = (ASTUnaryExpr *)node->data;
+            
+            if (unary->op == TK_MINUS) {
+                // 与 value_multiply(x, -1) 保持一致
+                char *operand = codegen_num_expr(gen, unary->operand);
+                char *result = new_temp(gen);
+                fprintf(gen->code_buf, "  %s = fmul double %s, -1.0\n", result, operand);
+                free(operand);
+                return result;
+            }
+            if (unary->op == TK_PLUS && is_numeric_expr(gen, unary->operand)) {
+                return codegen_num_expr(gen, unary->operand);
+            }
+            if ((unary->op == TK_PLUS_PLUS || unary->op == TK_MINUS_MINUS) &&
+                unary->operand->kind == AST_IDENTIFIER &&
+                is_symbol_numeric(gen, ((ASTIdentifier *)unary->operand->data)->name)) {
+                return gen_num_var_increment(gen, unary);
+            }
+            break;
+        }
+        
+        default:
+            break;
+    }
     
-    free(left_num);
-    free(right_num);
-    free(add_result);
+    // 非 num 表达式：生成 Value* 后拆箱（Value* 已注册为中间值，随语句一起释放）
+    char *boxed = codegen_expr(gen, node);
+    if (!boxed) return format_num_const(0.0);
     
+    char *result = new_temp(gen);
+    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", result, boxed);
+    free(boxed);
     return result;
 }
 
-/* 生成内联的数字乘法: unbox -> fmul -> box */
-static char* gen_inline_num_multiply(CodeGen *gen, const char *left, const char *right) {
-    char *left_num = new_temp(gen);
-    char *right_num = new_temp(gen);
-    char *mul_result = new_temp(gen);
-    char *result = new_temp(gen);
-    
-    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", left_num, left);
-    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", right_num, right);
-    fprintf(gen->code_buf, "  %s = fmul double %s, %s\n", mul_result, left_num, right_num);
-    fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_number(double %s)\n", result, mul_result);
+/* 数值比较对应的 fcmp 谓词；不能按数值比较时返回 NULL
+ * <, >, <=, >= 在运行时总是按 unbox_number 比较；==, != 只有两边都是 num 时才是 */
+static const char *num_compare_predicate(CodeGen *gen, ASTBinaryExpr *expr) {
+    switch (expr->op) {
+        case TK_LT: return "olt";
+        case TK_GT: return "ogt";
+        case TK_LE: return "ole";
+        case TK_GE: return "oge";
+        case TK_EQ_EQ:
+        case TK_BANG_EQ:
+            if (is_numeric_expr(gen, expr->left) && is_numeric_expr(gen, expr->right)) {
+                return expr->op == TK_EQ_EQ ? "oeq" : "une";
+            }
+            return NULL;
+        default:
+            return NULL;
+    }
+}
+
+/* 生成数值比较，返回 i1 临时变量 */
+static char *gen_num_compare(CodeGen *gen, const char *pred, ASTBinaryExpr *expr) {
+    char *left = codegen_num_expr(gen, expr->left);
+    char *right = codegen_num_expr(gen, expr->right);
+    char *cmp = new_temp(gen);
     
-    free(left_num);
-    free(right_num);
-    free(mul_result);
+    fprintf(gen->code_buf, "  %s = fcmp %s double %s, %s\n", cmp, pred, left, right);
     
-    return result;
+    free(left);
+    free(right);
+    return cmp;
 }
 
-/* 生成内联的数字除法: unbox -> fdiv -> box */
-static char* gen_inline_num_divide(CodeGen *gen, const char *left, const char *right) {
-    char *left_num = new_temp(gen);
-    char *right_num = new_temp(gen);
-    char *div_result = new_temp(gen);
-    char *result = new_temp(gen);
-    
-    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", left_num, left);
-    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", right_num, right);
-    fprintf(gen->code_buf, "  %s = fdiv double %s, %s\n", div_result, left_num, right_num);
-    fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_number(double %s)\n", result, div_result);
+/* 一边是可证明的 num、另一边不是时的 + / == / != 走紧凑值（FxValue）路径：
+ * num 一侧直接编码为立即数，不必先 box_number 出一个 Value 再传给 value_add / value_equals；
+ * fx_add / fx_equals 对非数字操作数退回 Value 运算，语义与原路径一致。
+ * 字面量一侧已是静态 Value，不走这条路径 */
+static int use_fx_mixed_path(CodeGen *gen, ASTBinaryExpr *expr) {
+    if (expr->op != TK_PLUS && expr->op != TK_EQ_EQ && expr->op != TK_BANG_EQ) return 0;
     
-    free(left_num);
-    free(right_num);
-    free(div_result);
+    int left_num = is_numeric_expr(gen, expr->left);
+    int right_num = is_numeric_expr(gen, expr->right);
+    if (left_num == right_num) return 0;
     
-    return result;
+    ASTNode *num_side = left_num ? expr->left : expr->right;
+    return num_side->kind != AST_NUM_LITERAL;
 }
 
-/* 生成内联的数字比较 (小于): unbox -> fcmp olt -> box_bool */
-static char* gen_inline_num_less_than(CodeGen *gen, const char *left, const char *right) {
-    char *left_num = new_temp(gen);
-    char *right_num = new_temp(gen);
-    char *cmp_result = new_temp(gen);
-    char *cmp_i32 = new_temp(gen);
+/* 生成 FxValue 操作数（i64）；非 num 一侧持有引用，通过 *owned 返回，用完后 fx_release */
+static char *gen_fx_operand(CodeGen *gen, ASTNode *node, char **owned) {
     char *result = new_temp(gen);
     
-    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", left_num, left);
-    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", right_num, right);
-    fprintf(gen->code_buf, "  %s = fcmp olt double %s, %s\n", cmp_result, left_num, right_num);
-    fprintf(gen->code_buf, "  %s = zext i1 %s to i32\n", cmp_i32, cmp_result);
-    fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_bool(i32 %s)\n", result, cmp_i32);
-    
-    free(left_num);
-    free(right_num);
-    free(cmp_result);
-    free(cmp_i32);
-    
+    if (is_numeric_expr(gen, node)) {
+        char *num = codegen_num_expr(gen, node);
+        fprintf(gen->code_buf, "  %s = call i64 @box_number_fx(double %s)\n", result, num);
+        free(num);
+        *owned = NULL;
+    } else {
+        char *value = codegen_expr(gen, node);
+        fprintf(gen->code_buf, "  %s = call i64 @box_value_fx(%%struct.Value* %s)\n", result, value);
+        free(value);
+        *owned = result;
+    }
     return result;
 }
 
-/* 生成内联的数字比较 (大于): unbox -> fcmp ogt -> box_bool */
-static char* gen_inline_num_greater_than(CodeGen *gen, const char *left, const char *right) {
-    char *left_num = new_temp(gen);
-    char *right_num = new_temp(gen);
-    char *cmp_result = new_temp(gen);
-    char *cmp_i32 = new_temp(gen);
-    char *result = new_temp(gen);
-    
-    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", left_num, left);
-    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", right_num, right);
-    fprintf(gen->code_buf, "  %s = fcmp ogt double %s, %s\n", cmp_result, left_num, right_num);
-    fprintf(gen->code_buf, "  %s = zext i1 %s to i32\n", cmp_i32, cmp_result);
-    fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_bool(i32 %s)\n", result, cmp_i32);
+static void gen_fx_operands_release(CodeGen *gen, char *left, char *left_owned,
+                                    char *right, char *right_owned) {
+    if (left_owned) fprintf(gen->code_buf, "  call void @fx_release(i64 %s)\n", left_owned);
+    if (right_owned) fprintf(gen->code_buf, "  call void @fx_release(i64 %s)\n", right_owned);
+    free(left);
+    free(right);
+}
+
+/* num 与任意值的 ==、!=，返回 i1 临时变量 */
+static char *gen_fx_mixed_equals(CodeGen *gen, ASTBinaryExpr *expr) {
+    char *left_owned, *right_owned;
+    char *left = gen_fx_operand(gen, expr->left, &left_owned);
+    char *right = gen_fx_operand(gen, expr->right, &right_owned);
+    char *eq = new_temp(gen);
+    char *cmp = new_temp(gen);
     
-    free(left_num);
-    free(right_num);
-    free(cmp_result);
-    free(cmp_i32);
+    fprintf(gen->code_buf, "  %s = call i32 @fx_equals(i64 %s, i64 %s)\n", eq, left, right);
+    fprintf(gen->code_buf, "  %s = icmp %s i32 %s, 0\n", cmp, expr->op == TK_EQ_EQ ? "ne" : "eq", eq);
+    gen_fx_operands_release(gen, left, left_owned, right, right_owned);
     
-    return result;
+    free(eq);
+    return cmp;
 }
 
-/* 生成内联的数字比较 (小于等于): unbox -> fcmp ole -> box_bool */
-static char* gen_inline_num_less_equal(CodeGen *gen, const char *left, const char *right) {
-    char *left_num = new_temp(gen);
-    char *right_num = new_temp(gen);
-    char *cmp_result = new_temp(gen);
-    char *cmp_i32 = new_temp(gen);
+/* num 与任意值的 +，返回已注册的 Value* 中间值 */
+static char *gen_fx_mixed_add(CodeGen *gen, ASTBinaryExpr *expr) {
+    char *left_owned, *right_owned;
+    char *left = gen_fx_operand(gen, expr->left, &left_owned);
+    char *right = gen_fx_operand(gen, expr->right, &right_owned);
+    char *sum = new_temp(gen);
     char *result = new_temp(gen);
     
-    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", left_num, left);
-    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", right_num, right);
-    fprintf(gen->code_buf, "  %s = fcmp ole double %s, %s\n", cmp_result, left_num, right_num);
-    fprintf(gen->code_buf, "  %s = zext i1 %s to i32\n", cmp_i32, cmp_result);
-    fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_bool(i32 %s)\n", result, cmp_i32);
-    
-    free(left_num);
-    free(right_num);
-    free(cmp_result);
-    free(cmp_i32);
+    fprintf(gen->code_buf, "  %s = call i64 @fx_add(i64 %s, i64 %s)\n", sum, left, right);
+    fprintf(gen->code_buf, "  %s = call %%struct.Value* @unbox_value_fx(i64 %s)\n", result, sum);
+    fprintf(gen->code_buf, "  call void @fx_release(i64 %s)\n", sum);
+    gen_fx_operands_release(gen, left, left_owned, right, right_owned);
+    temp_value_register(gen, result);
     
+    free(sum);
     return result;
 }
 
-/* 生成内联的数字比较 (大于等于): unbox -> fcmp oge -> box_bool */
-static char* gen_inline_num_greater_equal(CodeGen *gen, const char *left, const char *right) {
-    char *left_num = new_temp(gen);
-    char *right_num = new_temp(gen);
-    char *cmp_result = new_temp(gen);
-    char *cmp_i32 = new_temp(gen);
-    char *result = new_temp(gen);
-    
-    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", left_num, left);
-    fprintf(gen->code_buf, "  %s = call double @unbox_number(%%struct.Value* %s)\n", right_num, right);
-    fprintf(gen->code_buf, "  %s = fcmp oge double %s, %s\n", cmp_result, left_num, right_num);
-    fprintf(gen->code_buf, "  %s = zext i1 %s to i32\n", cmp_i32, cmp_result);
-    fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_bool(i32 %s)\n", result, cmp_i32);
-    
-    free(left_num);
-    free(right_num);
-    free(cmp_result);
-    free(cmp_i32);
+/* 生成条件表达式，返回 i1 临时变量名
+ * 数值比较直接使用 fcmp 的结果，不经过 box_bool + value_is_truthy */
+char *codegen_cond_expr(CodeGen *gen, ASTNode *node) {
+    if (node && node->kind == AST_BINARY_EXPR) {
+        ASTBinaryExpr *expr = (ASTBinaryExpr *)node->data;
+        const char *pred = num_compare_predicate(gen, expr);
+        if (pred) {
+            return gen_num_compare(gen, pred, expr);
+        }
+        if (expr->op != TK_PLUS && use_fx_mixed_path(gen, expr)) {
+            return gen_fx_mixed_equals(gen, expr);
+        }
+    }
     
-    return result;
+    char *value = codegen_expr(gen, node);
+    char *truthy = new_temp(gen);
+    char *cond_bool = new_temp(gen);
+    fprintf(gen->code_buf, "  %s = call i32 @value_is_truthy(%%struct.Value* %s)\n", truthy, value);
+    fprintf(gen->code_buf, "  %s = icmp ne i32 %s, 0\n", cond_bool, truthy);
+    free(value);
+    free(truthy);
+    return cond_bool;
 }
 
 /* 生成带类型检查快速路径的加法
@@ -317,29 +400,8 @@ static char *codegen_optional_chain_call(CodeGen *gen, ASTMemberExpr *member, AS
     // 2. 检查属性是否存在
     fprintf(gen->code_buf, "%s:\n", check_exists_label);
     
-    // 生成属性名 - 使用内联字符串数组
-    size_t prop_len = strlen(member->property);
-    char *str_array = new_temp(gen);
-    fprintf(gen->code_buf, "  %s = alloca [%zu x i8]\n", str_array, prop_len + 1);
-    
-    // 逐字符存储
-    for (size_t i = 0; i < prop_len; i++) {
-        char *elem_ptr = new_temp(gen);
-        fprintf(gen->code_buf, "  %s = getelementptr inbounds [%zu x i8], [%zu x i8]* %s, i64 0, i64 %zu\n",
-                elem_ptr, prop_len + 1, prop_len + 1, str_array, i);
-        fprintf(gen->code_buf, "  store i8 %d, i8* %s\n", (int)member->property[i], elem_ptr);
-        free(elem_ptr);
-    }
-    // 添加 null 终止符
-    char *null_ptr = new_temp(gen);
-    fprintf(gen->code_buf, "  %s = getelementptr inbounds [%zu x i8], [%zu x i8]* %s, i64 0, i64 %zu\n",
-            null_ptr, prop_len + 1, prop_len + 1, str_array, prop_len);
-    fprintf(gen->code_buf, "  store i8 0, i8* %s\n", null_ptr);
-    free(null_ptr);
-    
-    char *key_ptr = new_temp(gen);
-    fprintf(gen->code_buf, "  %s = getelementptr inbounds [%zu x i8], [%zu x i8]* %s, i64 0, i64 0\n",
-            key_ptr, prop_len + 1, prop_len + 1, str_array);
+    // 属性名：驻留符号
+    char *key_ptr = codegen_key_symbol(gen, member->property);
     
     char *field_name = new_temp(gen);
     fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_string(i8* %s)\n",
@@ -437,7 +499,6 @@ static char *codegen_optional_chain_call(CodeGen *gen, ASTMemberExpr *member, AS
     free(is_null_bool);
     free(is_undef_bool);
     free(is_nullish);
-    free(str_array);
     free(key_ptr);
     free(field_name);
     free(prop_value);
@@ -470,15 +531,9 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
     switch (node->kind) {
         case AST_NUM_LITERAL: {
             ASTNumLiteral *num = (ASTNumLiteral *)node->data;
-            char *temp = new_temp(gen);
-            
-            // 使用 box_number 将数字装箱为 Value*
-            // 使用 %.17e 科学计数法保持完整精度（17位有效数字）
-            fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_number(double %.17e)\n", 
-                    temp, num->value);
-            temp_value_register(gen, temp);  // 注册为中间值
             
-            return temp;
+            // 静态常量 Value（永生，不需要注册为中间值）
+            return codegen_static_number(gen, num->value);
         }
         
         case AST_BOOL_LITERAL: {
@@ -497,8 +552,6 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
         case AST_STRING_LITERAL: {
             ASTStringLiteral *str = (ASTStringLiteral *)node->data;
             char *str_label = new_string_label(gen);
-            char *temp = new_temp(gen);
-            char *str_ptr = new_temp(gen);
             
             size_t len = str->length;  /* 使用AST中的实际长度，支持\0字符串 */
             size_t escaped_len = 0;
@@ -509,18 +562,11 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
             fprintf(gen->strings_buf, "%s = private unnamed_addr constant [%zu x i8] c\"%s\\00\"\n",
                     str_label, len + 1, escaped);
             
-            // 获取指针
-            fprintf(gen->code_buf, "  %s = getelementptr inbounds [%zu x i8], [%zu x i8]* %s, i32 0, i32 0\n",
-                    str_ptr, len + 1, len + 1, str_label);
-            
-            // 使用 box_string_with_length 装箱，传递显式长度支持\0字符串
-            fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_string_with_length(i8* %s, i64 %zu)\n",
-                    temp, str_ptr, len);
-            temp_value_register(gen, temp);  // 注册为中间值
+            // 静态常量 Value，显式长度支持\0字符串（永生，不需要注册为中间值）
+            char *temp = codegen_static_string(gen, str_label, len);
             
             free(escaped);
             free(str_label);
-            free(str_ptr);
             return temp;
         }
         
@@ -555,7 +601,10 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
                 // 获取函数参数数量以正确生成类型签名
                 // 简单处理：假设所有函数都返回 Value* 并接受 Value* 参数
                 // 这里我们需要知道函数的参数数量，但暂时用可变参数处理
-                fprintf(gen->code_buf, "...)* @%s to i8*), %%struct.Value** null, i32 0, i32 0, i32 0)\n", id->name);  // needs_self=0 for function refs
+                // 间接调用经由统一入口 @<函数名>.entry，不依赖这里的签名
+                const char *func_llvm_name = strcmp(id->name, "main") == 0 ? "_flyux_main" : id->name;
+                fprintf(gen->code_buf, "...)* @%s to i8*), i8* bitcast (" FUNCTION_ENTRY_TYPE " @%s.entry to i8*), "
+                        "%%struct.Value** null, i32 0, i32 0, i32 0)\n", id->name, func_llvm_name);  // needs_self=0 for function refs
                 // 注册为中间值
                 temp_value_register(gen, temp);
                 return temp;
@@ -583,6 +632,15 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
                 return temp;
             }
             
+            // num 变量以 double 存储：在作为 Value* 使用时装箱
+            if (is_symbol_numeric(gen, id->name)) {
+                char *num = codegen_num_expr(gen, node);
+                fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_number(double %s)\n", temp, num);
+                temp_value_register(gen, temp);
+                free(num);
+                return temp;
+            }
+            
             // 检查是否是全局变量
             int use_global = is_global_var(gen, id->name);
             
@@ -658,6 +716,59 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
         
         case AST_BINARY_EXPR: {
             ASTBinaryExpr *expr = (ASTBinaryExpr *)node->data;
+            
+            // 数值快速路径：整棵算术子树在 double 上计算，结果只装箱一次
+            if (expr->op != TK_PLUS || is_numeric_expr(gen, node)) {
+                switch (expr->op) {
+                    case TK_PLUS:
+                    case TK_MINUS:
+                    case TK_STAR:
+                    case TK_SLASH:
+                    case TK_PERCENT:
+                    case TK_POWER: {
+                        char *num = codegen_num_expr(gen, node);
+                        char *result = new_temp(gen);
+                        fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_number(double %s)\n",
+                                result, num);
+                        temp_value_register(gen, result);
+                        free(num);
+                        return result;
+                    }
+                    default:
+                        break;
+                }
+            }
+            
+            // 数值比较：fcmp 后装箱为 bool
+            const char *cmp_pred = num_compare_predicate(gen, expr);
+            if (cmp_pred) {
+                char *cmp = gen_num_compare(gen, cmp_pred, expr);
+                char *cmp_i32 = new_temp(gen);
+                char *result = new_temp(gen);
+                fprintf(gen->code_buf, "  %s = zext i1 %s to i32\n", cmp_i32, cmp);
+                fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_bool(i32 %s)\n", result, cmp_i32);
+                temp_value_register(gen, result);
+                free(cmp);
+                free(cmp_i32);
+                return result;
+            }
+            
+            // num 与任意值混合的 + / == / !=：紧凑值路径
+            if (use_fx_mixed_path(gen, expr)) {
+                if (expr->op == TK_PLUS) {
+                    return gen_fx_mixed_add(gen, expr);
+                }
+                char *cmp = gen_fx_mixed_equals(gen, expr);
+                char *cmp_i32 = new_temp(gen);
+                char *result = new_temp(gen);
+                fprintf(gen->code_buf, "  %s = zext i1 %s to i32\n", cmp_i32, cmp);
+                fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_bool(i32 %s)\n", result, cmp_i32);
+                temp_value_register(gen, result);
+                free(cmp);
+                free(cmp_i32);
+                return result;
+            }
+            
             char *left = codegen_expr(gen, expr->left);
             char *right = codegen_expr(gen, expr->right);
             char *result = NULL;
@@ -668,53 +779,6 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
                     result = gen_inline_add_with_type_check(gen, left, right);
                     temp_value_register(gen, result);  // 注册结果为中间值
                     break;
-                case TK_MINUS:
-                    // 内联数字减法
-                    result = gen_inline_num_subtract(gen, left, right);
-                    temp_value_register(gen, result);
-                    break;
-                case TK_STAR:
-                    // 内联数字乘法
-                    result = gen_inline_num_multiply(gen, left, right);
-                    temp_value_register(gen, result);
-                    break;
-                case TK_SLASH:
-                    // 内联数字除法
-                    result = gen_inline_num_divide(gen, left, right);
-                    temp_value_register(gen, result);
-                    break;
-                case TK_POWER:
-                    result = new_temp(gen);
-                    fprintf(gen->code_buf, "  %s = call %%struct.Value* @value_power(%%struct.Value* %s, %%struct.Value* %s)\n", 
-                            result, left, right);
-                    temp_value_register(gen, result);
-                    break;
-                case TK_PERCENT:
-                    result = new_temp(gen);
-                    fprintf(gen->code_buf, "  %s = call %%struct.Value* @value_modulo(%%struct.Value* %s, %%struct.Value* %s)\n", 
-                            result, left, right);
-                    temp_value_register(gen, result);
-                    break;
-                case TK_LT:
-                    // 内联小于比较
-                    result = gen_inline_num_less_than(gen, left, right);
-                    temp_value_register(gen, result);
-                    break;
-                case TK_GT:
-                    // 内联大于比较
-                    result = gen_inline_num_greater_than(gen, left, right);
-                    temp_value_register(gen, result);
-                    break;
-                case TK_LE:
-                    // 内联小于等于比较
-                    result = gen_inline_num_less_equal(gen, left, right);
-                    temp_value_register(gen, result);
-                    break;
-                case TK_GE:
-                    // 内联大于等于比较
-                    result = gen_inline_num_greater_equal(gen, left, right);
-                    temp_value_register(gen, result);
-                    break;
                 case TK_EQ_EQ:
                     result = new_temp(gen);
                     fprintf(gen->code_buf, "  %s = call %%struct.Value* @value_equals(%%struct.Value* %s, %%struct.Value* %s)\n", 
@@ -3901,6 +3965,83 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
                 // 函数调用分支
                 fprintf(gen->code_buf, "%s:\n", call_label);
                 
+                // 变量静态绑定到已知闭包且参数个数一致时，检查函数指针后直接调用本体，
+                // 捕获变量从函数值中读取；变量被重新赋值为其他函数时走统一入口
+                ClosureMapping *known = find_closure_mapping(gen, callee->name);
+                int direct_ok = known && !known->uses_self && known->param_count == call->arg_count;
+                char *direct_label = NULL;
+                char *direct_result = NULL;
+                char *indirect_label = call_label;
+                if (direct_ok) {
+                    size_t cap_count = known->captured ? known->captured->count : 0;
+                    direct_label = new_label(gen);
+                    indirect_label = new_label(gen);
+                    
+                    char *fn_raw = new_temp(gen);
+                    char *fn_data = new_temp(gen);
+                    char *fn_objpp = new_temp(gen);
+                    char *fn_obj = new_temp(gen);
+                    char *fn_ptr_p = new_temp(gen);
+                    char *fn_ptr = new_temp(gen);
+                    char *is_known = new_temp(gen);
+                    fprintf(gen->code_buf, "  %s = bitcast %%struct.Value* %s to i8*\n", fn_raw, func_val);
+                    fprintf(gen->code_buf, "  %s = getelementptr inbounds i8, i8* %s, i64 %d\n", fn_data, fn_raw, VALUE_DATA_OFFSET);
+                    fprintf(gen->code_buf, "  %s = bitcast i8* %s to %%struct.FunctionObject**\n", fn_objpp, fn_data);
+                    fprintf(gen->code_buf, "  %s = load %%struct.FunctionObject*, %%struct.FunctionObject** %s\n", fn_obj, fn_objpp);
+                    fprintf(gen->code_buf, "  %s = getelementptr inbounds %%struct.FunctionObject, %%struct.FunctionObject* %s, i32 0, i32 %d\n",
+                            fn_ptr_p, fn_obj, FUNCTION_OBJECT_FUNC_PTR);
+                    fprintf(gen->code_buf, "  %s = load i8*, i8** %s\n", fn_ptr, fn_ptr_p);
+                    fprintf(gen->code_buf, "  %s = icmp eq i8* %s, bitcast (", is_known, fn_ptr);
+                    codegen_emit_function_type(gen->code_buf, call->arg_count + cap_count);
+                    fprintf(gen->code_buf, " @%s to i8*)\n", known->func_name);
+                    fprintf(gen->code_buf, "  br i1 %s, label %%%s, label %%%s\n", is_known, direct_label, indirect_label);
+                    
+                    // 直接调用分支
+                    fprintf(gen->code_buf, "%s:\n", direct_label);
+                    char **cap_regs = NULL;
+                    if (cap_count > 0) {
+                        char *caps_p = new_temp(gen);
+                        char *caps = new_temp(gen);
+                        fprintf(gen->code_buf, "  %s = getelementptr inbounds %%struct.FunctionObject, %%struct.FunctionObject* %s, i32 0, i32 %d\n",
+                                caps_p, fn_obj, FUNCTION_OBJECT_CAPTURED);
+                        fprintf(gen->code_buf, "  %s = load %%struct.Value**, %%struct.Value*** %s\n", caps, caps_p);
+                        cap_regs = (char **)malloc(cap_count * sizeof(char *));
+                        for (size_t i = 0; i < cap_count; i++) {
+                            char *cap_p = new_temp(gen);
+                            cap_regs[i] = new_temp(gen);
+                            fprintf(gen->code_buf, "  %s = getelementptr inbounds %%struct.Value*, %%struct.Value** %s, i64 %zu\n", cap_p, caps, i);
+                            fprintf(gen->code_buf, "  %s = load %%struct.Value*, %%struct.Value** %s\n", cap_regs[i], cap_p);
+                            free(cap_p);
+                        }
+                        free(caps_p);
+                        free(caps);
+                    }
+                    direct_result = new_temp(gen);
+                    fprintf(gen->code_buf, "  %s = call %%struct.Value* @%s(", direct_result, known->func_name);
+                    for (size_t i = 0; i < call->arg_count; i++) {
+                        if (i > 0) fprintf(gen->code_buf, ", ");
+                        fprintf(gen->code_buf, "%%struct.Value* %s", arg_regs[i]);
+                    }
+                    for (size_t i = 0; i < cap_count; i++) {
+                        if (call->arg_count > 0 || i > 0) fprintf(gen->code_buf, ", ");
+                        fprintf(gen->code_buf, "%%struct.Value* %s", cap_regs[i]);
+                        free(cap_regs[i]);
+                    }
+                    fprintf(gen->code_buf, ")\n");
+                    fprintf(gen->code_buf, "  br label %%%s\n", merge_label);
+                    free(cap_regs);
+                    
+                    // 统一入口分支
+                    fprintf(gen->code_buf, "%s:\n", indirect_label);
+                    free(fn_raw);
+                    free(fn_data);
+                    free(fn_objpp);
+                    free(fn_obj);
+                    free(fn_ptr_p);
+                    free(fn_ptr);
+                    free(is_known);
+                }
+                
                 // 调用运行时辅助函数
                 char *call_result = new_temp(gen);
                 fprintf(gen->code_buf, "  %s = call %%struct.Value* @call_function_value(%%struct.Value* %s, %%struct.Value** %s, i32 %zu)\n",
@@ -3918,8 +4059,16 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
                 // 合并分支
                 fprintf(gen->code_buf, "%s:\n", merge_label);
                 char *result = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = phi %%struct.Value* [ %s, %%%s ], [ %s, %%%s ]\n",
-                        result, call_result, call_label, error_result, error_label);
+                if (direct_ok) {
+                    fprintf(gen->code_buf, "  %s = phi %%struct.Value* [ %s, %%%s ], [ %s, %%%s ], [ %s, %%%s ]\n",
+                            result, direct_result, direct_label, call_result, indirect_label, error_result, error_label);
+                    free(direct_label);
+                    free(direct_result);
+                    free(indirect_label);
+                } else {
+                    fprintf(gen->code_buf, "  %s = phi %%struct.Value* [ %s, %%%s ], [ %s, %%%s ]\n",
+                            result, call_result, call_label, error_result, error_label);
+                }
                 
                 // 清理
                 if (arg_regs) {
@@ -4090,14 +4239,7 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
                         free(spread_val);
                     } else {
                         // 普通属性：调用 set_field，原地修改并返回同一对象
-                        char *key_label = new_string_label(gen);
-                        size_t key_len = strlen(prop->key);
-                        fprintf(gen->strings_buf, "%s = private unnamed_addr constant [%zu x i8] c\"%s\\00\"\n",
-                                key_label, key_len + 1, prop->key);
-                        
-                        char *key_ptr = new_temp(gen);
-                        fprintf(gen->code_buf, "  %s = getelementptr [%zu x i8], [%zu x i8]* %s, i32 0, i32 0\n",
-                                key_ptr, key_len + 1, key_len + 1, key_label);
+                        char *key_ptr = codegen_key_symbol(gen, prop->key);
                         
                         char *key_val = new_temp(gen);
                         fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_string(i8* %s)\n", key_val, key_ptr);
@@ -4141,15 +4283,8 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
             for (size_t i = 0; i < prop_count; i++) {
                 ASTObjectProperty *prop = &obj_lit->properties[i];
                 
-                // 生成键字符串
-                char *key_label = new_string_label(gen);
-                size_t key_len = strlen(prop->key);
-                fprintf(gen->strings_buf, "%s = private unnamed_addr constant [%zu x i8] c\"%s\\00\"\n",
-                        key_label, key_len + 1, prop->key);
-                
-                char *key_ptr = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = getelementptr [%zu x i8], [%zu x i8]* %s, i32 0, i32 0\n",
-                        key_ptr, key_len + 1, key_len + 1, key_label);
+                // 键：驻留符号
+                char *key_ptr = codegen_key_symbol(gen, prop->key);
                 
                 // 计算属性值
                 char *value = codegen_expr(gen, prop->value);
@@ -4187,9 +4322,9 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
                 free(value);
             }
             
-            // 调用 box_object（直接使用 entries_alloc，它已经是 i8*）
+            // 调用 box_object_symbols（键已驻留；直接使用 entries_alloc，它已经是 i8*）
             char *result = new_temp(gen);
-            fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_object(i8* %s, i64 %zu)\n",
+            fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_object_symbols(i8* %s, i64 %zu)\n",
                     result, entries_alloc, prop_count);
             
             // 释放临时分配的内存（box_object 会复制数据）
@@ -4219,6 +4354,17 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
                 }
                 
                 ASTIdentifier *id = (ASTIdentifier *)unary->operand->data;
+                
+                // num 变量：在 double 栈槽上直接加减，结果装箱
+                if (is_symbol_numeric(gen, id->name)) {
+                    char *num = codegen_num_expr(gen, node);
+                    char *result = new_temp(gen);
+                    fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_number(double %s)\n", result, num);
+                    temp_value_register(gen, result);
+                    free(num);
+                    return result;
+                }
+                
                 const char *ir_name = get_symbol_ir_name(gen, id->name);
                 char *old_val = new_temp(gen);
                 char *one = new_temp(gen);
@@ -4292,20 +4438,21 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
                 }
             }
             
+            // -x 的结果总是 num：走数值快速路径
+            if (unary->op == TK_MINUS) {
+                char *num = codegen_num_expr(gen, node);
+                char *result = new_temp(gen);
+                fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_number(double %s)\n", result, num);
+                temp_value_register(gen, result);
+                free(num);
+                return result;
+            }
+            
             // 其他一元运算符
             char *operand = codegen_expr(gen, unary->operand);
             char *result = new_temp(gen);
             
             switch (unary->op) {
-                case TK_MINUS: {
-                    // -x: 使用 value_multiply(x, -1)
-                    char *neg_one = new_temp(gen);
-                    fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_number(double -1.0)\n", neg_one);
-                    fprintf(gen->code_buf, "  %s = call %%struct.Value* @value_multiply(%%struct.Value* %s, %%struct.Value* %s)\n", 
-                            result, operand, neg_one);
-                    free(neg_one);
-                    break;
-                }
                 case TK_PLUS:
                     // 一元+不改变值
                     free(result);
@@ -4362,19 +4509,16 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
                 }
             }
             
-            // 创建字段名字符串
-            char *key_label = new_string_label(gen);
-            size_t key_len = strlen(member->property);
-            fprintf(gen->strings_buf, "%s = private unnamed_addr constant [%zu x i8] c\"%s\\00\"\n",
-                    key_label, key_len + 1, member->property);
+            // 字段名：驻留符号（编译期算好哈希，启动时驻留）
+            char *key_ptr = codegen_key_symbol(gen, member->property);
             
-            char *key_ptr = new_temp(gen);
-            fprintf(gen->code_buf, "  %s = getelementptr [%zu x i8], [%zu x i8]* %s, i32 0, i32 0\n",
-                    key_ptr, key_len + 1, key_len + 1, key_label);
-            
-            char *field_name = new_temp(gen);
-            fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_string(i8* %s)\n",
-                    field_name, key_ptr);
+            // 可选链 / 未绑定访问使用字段名 Value；普通访问走内联缓存，直接传 key_ptr
+            char *field_name = NULL;
+            if (member->is_optional || member->is_unbound) {
+                field_name = new_temp(gen);
+                fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_string(i8* %s)\n",
+                        field_name, key_ptr);
+            }
             
             // 检查是否是未绑定方法访问 (.@)
             // 如果是未绑定访问，使用 value_get_field 不进行绑定
@@ -4416,7 +4560,6 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
                         final_result, is_nullish, undef_val, result);
                 
                 free(obj_value);
-                free(key_label);
                 free(key_ptr);
                 free(field_name);
                 free(is_null_val);
@@ -4467,8 +4610,71 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
                 free(is_error);
             } else {
                 // 普通方法访问: obj.method - 自动绑定 self
-                fprintf(gen->code_buf, "  %s = call %%struct.Value* @value_get_method(%%struct.Value* %s, %%struct.Value* %s)  ; .%s (bound)\n",
-                        result, obj_value, field_name, member->property);
+                // 内联缓存：对象形状与缓存第 0 路相同且字段不是函数时，直接按槽位读取；
+                // 否则调用 value_get_field_ic（多态查找 + 填充缓存，语义同 value_get_method）
+                char *ic = new_field_ic(gen);
+                char *ic_check = new_label(gen);
+                char *ic_hit = new_label(gen);
+                char *ic_miss = new_label(gen);
+                char *ic_miss_end = new_label(gen);
+                char *ic_done = new_label(gen);
+                
+                char *is_null_obj = new_temp(gen);
+                fprintf(gen->code_buf, "  %s = icmp eq %%struct.Value* %s, null\n", is_null_obj, obj_value);
+                fprintf(gen->code_buf, "  br i1 %s, label %%%s, label %%%s\n", is_null_obj, ic_miss, ic_check);
+                
+                fprintf(gen->code_buf, "%s:\n", ic_check);
+                char *obj_bytes = new_temp(gen);
+                char *shape_ptr = new_temp(gen);
+                char *shape_ptr16 = new_temp(gen);
+                char *shape16 = new_temp(gen);
+                char *shape = new_temp(gen);
+                char *cached_shape = new_temp(gen);
+                char *same_shape = new_temp(gen);
+                char *tracked = new_temp(gen);
+                char *ic_ok = new_temp(gen);
+                fprintf(gen->code_buf, "  %s = bitcast %%struct.Value* %s to i8*\n", obj_bytes, obj_value);
+                fprintf(gen->code_buf, "  %s = getelementptr i8, i8* %s, i64 %d\n", shape_ptr, obj_bytes, VALUE_SHAPE_OFFSET);
+                fprintf(gen->code_buf, "  %s = bitcast i8* %s to i16*\n", shape_ptr16, shape_ptr);
+                fprintf(gen->code_buf, "  %s = load i16, i16* %s\n", shape16, shape_ptr16);
+                fprintf(gen->code_buf, "  %s = zext i16 %s to i32\n", shape, shape16);
+                fprintf(gen->code_buf, "  %s = load i32, i32* getelementptr ([%d x %%struct.FieldIC], [%d x %%struct.FieldIC]* %s, i32 0, i32 0, i32 0)\n",
+                        cached_shape, FIELD_IC_WAYS, FIELD_IC_WAYS, ic);
+                fprintf(gen->code_buf, "  %s = icmp eq i32 %s, %s\n", same_shape, shape, cached_shape);
+                fprintf(gen->code_buf, "  %s = icmp ne i32 %s, 0\n", tracked, shape);
+                fprintf(gen->code_buf, "  %s = and i1 %s, %s\n", ic_ok, same_shape, tracked);
+                fprintf(gen->code_buf, "  br i1 %s, label %%%s, label %%%s\n", ic_ok, ic_hit, ic_miss);
+                
+                // 命中：entries[slot].value
+                fprintf(gen->code_buf, "%s:\n", ic_hit);
+                char *slot = new_temp(gen);
+                char *entries_ptr = new_temp(gen);
+                char *entries_pp = new_temp(gen);
+                char *entries = new_temp(gen);
+                char *value_ptr = new_temp(gen);
+                char *fast_value = new_temp(gen);
+                char *fast_type_ptr = new_temp(gen);
+                char *fast_type = new_temp(gen);
+                char *is_func = new_temp(gen);
+                fprintf(gen->code_buf, "  %s = load i32, i32* getelementptr ([%d x %%struct.FieldIC], [%d x %%struct.FieldIC]* %s, i32 0, i32 0, i32 1)\n",
+                        slot, FIELD_IC_WAYS, FIELD_IC_WAYS, ic);
+                fprintf(gen->code_buf, "  %s = getelementptr i8, i8* %s, i64 %d\n", entries_ptr, obj_bytes, VALUE_DATA_OFFSET);
+                fprintf(gen->code_buf, "  %s = bitcast i8* %s to %%struct.ObjectEntry**\n", entries_pp, entries_ptr);
+                fprintf(gen->code_buf, "  %s = load %%struct.ObjectEntry*, %%struct.ObjectEntry** %s\n", entries, entries_pp);
+                fprintf(gen->code_buf, "  %s = getelementptr %%struct.ObjectEntry, %%struct.ObjectEntry* %s, i32 %s, i32 1\n",
+                        value_ptr, entries, slot);
+                fprintf(gen->code_buf, "  %s = load %%struct.Value*, %%struct.Value** %s  ; .%s (ic hit)\n",
+                        fast_value, value_ptr, member->property);
+                fprintf(gen->code_buf, "  %s = getelementptr %%struct.Value, %%struct.Value* %s, i32 0, i32 0\n", fast_type_ptr, fast_value);
+                fprintf(gen->code_buf, "  %s = load i32, i32* %s\n", fast_type, fast_type_ptr);
+                fprintf(gen->code_buf, "  %s = icmp eq i32 %s, 7\n", is_func, fast_type);
+                fprintf(gen->code_buf, "  br i1 %s, label %%%s, label %%%s\n", is_func, ic_miss, ic_done);
+                
+                // 未命中 / 需要绑定 self：走 runtime
+                fprintf(gen->code_buf, "%s:\n", ic_miss);
+                char *slow_value = new_temp(gen);
+                fprintf(gen->code_buf, "  %s = call %%struct.Value* @value_get_field_ic(%%struct.Value* %s, i8* %s, %%struct.FieldIC* getelementptr ([%d x %%struct.FieldIC], [%d x %%struct.FieldIC]* %s, i32 0, i32 0))  ; .%s (bound)\n",
+                        slow_value, obj_value, key_ptr, FIELD_IC_WAYS, FIELD_IC_WAYS, ic, member->property);
                 
                 // 非可选链访问需要检查错误（等同于 getMethod()!）
                 char *is_ok = new_temp(gen);
@@ -4495,16 +4701,48 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
                     free(error_label);
                     free(continue_label);
                 }
+                fprintf(gen->code_buf, "  br label %%%s\n", ic_miss_end);
+                fprintf(gen->code_buf, "%s:\n", ic_miss_end);
+                fprintf(gen->code_buf, "  br label %%%s\n", ic_done);
+                
+                fprintf(gen->code_buf, "%s:\n", ic_done);
+                fprintf(gen->code_buf, "  %s = phi %%struct.Value* [ %s, %%%s ], [ %s, %%%s ]\n",
+                        result, fast_value, ic_hit, slow_value, ic_miss_end);
                 
                 free(is_ok);
                 free(ok_bool);
                 free(is_error);
+                free(ic);
+                free(ic_check);
+                free(ic_hit);
+                free(ic_miss);
+                free(ic_miss_end);
+                free(ic_done);
+                free(is_null_obj);
+                free(obj_bytes);
+                free(shape_ptr);
+                free(shape_ptr16);
+                free(shape16);
+                free(shape);
+                free(cached_shape);
+                free(same_shape);
+                free(tracked);
+                free(ic_ok);
+                free(slot);
+                free(entries_ptr);
+                free(entries_pp);
+                free(entries);
+                free(value_ptr);
+                free(fast_value);
+                free(fast_type_ptr);
+                free(fast_type);
+                free(is_func);
+                free(slow_value);
             }
             
             free(obj_value);
-            free(key_label);
             free(key_ptr);
-            free(field_name);
+            if (field_name) free(field_name);
             return result;
         }
         
@@ -4788,21 +5026,20 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
                 
                 // 获取函数指针
                 char *func_ptr = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = bitcast %%struct.Value* (", func_ptr);
-                // 函数签名：普通参数 + 捕获变量
-                for (int i = 0; i < total_params; i++) {
-                    if (i > 0) fprintf(gen->code_buf, ", ");
-                    fprintf(gen->code_buf, "%%struct.Value*");
-                }
-                fprintf(gen->code_buf, ")* @%s to i8*\n", func->name);
+                fprintf(gen->code_buf, "  %s = bitcast ", func_ptr);
+                // 函数签名：隐式 self（如果有）+ 普通参数 + 捕获变量
+                codegen_emit_function_type(gen->code_buf, (size_t)total_params);
+                fprintf(gen->code_buf, " @%s to i8*\n", func->name);
                 
                 // 计算用户可见的参数数量（不包括隐式 self，运行时会自动处理）
                 size_t user_param_count = func->param_count;
                 
-                // 调用 box_function_ex，传递 needs_self 和 capture_by_ref 标志
-                // capture_by_ref=0 表示按值捕获（让运行时retain），避免逃逸闭包的悬空指针问题
-                fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_function_ex(i8* %s, %%struct.Value** %s, i32 %zu, i32 %zu, i32 %d, i32 0)  ; closure '%s' (capture by value)\n",
-                        temp, func_ptr, captured_ptr, captured->count, user_param_count, func->uses_self ? 1 : 0, func->name);
+                // 调用 box_function_ex，传递统一入口、needs_self 和 capture_by_ref 标志
+                // 捕获数组里都是 box_ref 创建的引用盒子（Value**），必须 capture_by_ref=1，
+                // 否则运行时会把盒子当作 Value 去 retain/release。盒子分配在堆上，逃逸闭包不会悬空
+                fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_function_ex(i8* %s, i8* bitcast (" FUNCTION_ENTRY_TYPE " @%s.entry to i8*), "
+                        "%%struct.Value** %s, i32 %zu, i32 %zu, i32 %d, i32 1)  ; closure '%s' (capture by ref)\n",
+                        temp, func_ptr, func->name, captured_ptr, captured->count, user_param_count, func->uses_self ? 1 : 0, func->name);
                 
                 // 自引用闭包修复：对于按引用捕获，不需要更新！
                 // 因为已经捕获了变量的 alloca，闭包对象会存储到 alloca，
@@ -4821,27 +5058,31 @@ char *codegen_expr(CodeGen *gen, ASTNode *node) {
             } else {
                 // 无捕获变量：直接创建函数值
                 char *func_ptr = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = bitcast %%struct.Value* (", func_ptr);
+                fprintf(gen->code_buf, "  %s = bitcast ", func_ptr);
                 // 函数签名：隐式 self（如果有）+ 普通参数
-                for (int i = 0; i < total_params; i++) {
-                    if (i > 0) fprintf(gen->code_buf, ", ");
-                    fprintf(gen->code_buf, "%%struct.Value*");
-                }
-                fprintf(gen->code_buf, ")* @%s to i8*\n", func->name);
+                codegen_emit_function_type(gen->code_buf, (size_t)total_params);
+                fprintf(gen->code_buf, " @%s to i8*\n", func->name);
                 
                 // 计算用户可见的参数数量（不包括隐式 self，运行时会自动处理）
                 size_t user_param_count = func->param_count;
                 
-                // 调用 box_function（captured 为 null），传递 needs_self 标志
+                // 调用 box_function（captured 为 null），传递统一入口和 needs_self 标志
                 char *null_ptr = new_temp(gen);
                 fprintf(gen->code_buf, "  %s = inttoptr i64 0 to %%struct.Value**\n", null_ptr);
-                fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_function(i8* %s, %%struct.Value** %s, i32 0, i32 %zu, i32 %d)  ; function '%s'\n",
-                        temp, func_ptr, null_ptr, user_param_count, func->uses_self ? 1 : 0, func->name);
+                fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_function(i8* %s, i8* bitcast (" FUNCTION_ENTRY_TYPE " @%s.entry to i8*), "
+                        "%%struct.Value** %s, i32 0, i32 %zu, i32 %d)  ; function '%s'\n",
+                        temp, func_ptr, func->name, null_ptr, user_param_count, func->uses_self ? 1 : 0, func->name);
                 
                 free(func_ptr);
                 free(null_ptr);
             }
             
+            // 记录被初始化的变量对应的闭包函数，调用点可以直接调用本体
+            if (gen->current_var_name) {
+                register_closure_mapping(gen, gen->current_var_name, func->name, captured,
+                                         func->param_count, func->uses_self);
+            }
+            
             // 清理捕获变量结构
             if (captured) {
                 captured_vars_free(captured);
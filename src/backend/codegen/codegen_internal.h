@@ -17,6 +17,22 @@ void codegen_set_error_at(CodeGen *gen, int line, int column, int length,
 /* 从映射表中查找映射后名字对应的原始名字 */
 const char *codegen_lookup_original_name(CodeGen *gen, const char *mapped_name);
 
+/* ============================================================================
+ * 名字索引 - codegen_symtab.c
+ * ============================================================================ */
+
+void name_index_init(NameIndex *index);
+void name_index_free(NameIndex *index);
+
+/* 插入条目；同名时新条目遮蔽旧条目 */
+void name_index_insert(NameIndex *index, const char *name, void *value);
+
+/* 查找最新插入的同名条目，不存在返回 NULL */
+void *name_index_find(const NameIndex *index, const char *name);
+
+/* 移除 name 对应的指定条目 */
+void name_index_remove(NameIndex *index, const char *name, void *value);
+
 /* ============================================================================
  * 内部工具函数声明 - codegen_utils.c
  * ============================================================================ */
@@ -30,6 +46,19 @@ char *new_label(CodeGen *gen);
 /* 生成新的字符串标签 */
 char *new_string_label(CodeGen *gen);
 
+/* 生成新的字段访问内联缓存全局变量（返回 @.ic.N） */
+char *new_field_ic(CodeGen *gen);
+
+/* 属性名哈希（FNV-1a），须与 runtime 的 symbol_hash 一致 */
+unsigned long codegen_key_hash(const char *name);
+
+/* 加载字面量属性名的驻留符号（i8*），返回临时变量名 */
+char *codegen_key_symbol(CodeGen *gen, const char *name);
+
+/* 数字 / 字符串字面量的静态 Value（只读全局常量），返回 %struct.Value* 临时变量名 */
+char *codegen_static_number(CodeGen *gen, double value);
+char *codegen_static_string(CodeGen *gen, const char *str_label, size_t len);
+
 /* 转义字符串用于LLVM IR输出 - 支持包含\0的字符串 */
 char *escape_for_ir(const char *str, size_t in_len, size_t* out_len);
 
@@ -69,6 +98,12 @@ int is_symbol_const(CodeGen *gen, const char *var_name);
 /* 获取变量的IR名称（考虑遮蔽，返回最内层作用域的名称） */
 const char *get_symbol_ir_name(CodeGen *gen, const char *var_name);
 
+/* 将最内层同名变量标记为 double 存储 */
+void mark_symbol_numeric(CodeGen *gen, const char *var_name);
+
+/* 检查变量（最内层同名符号）是否以 double 存储 */
+int is_symbol_numeric(CodeGen *gen, const char *var_name);
+
 /* 检查变量是否是全局变量 */
 int is_global_var(CodeGen *gen, const char *var_name);
 
@@ -175,6 +210,12 @@ void temp_value_clear(CodeGen *gen);
 /* 生成表达式的LLVM IR代码，返回结果值的临时变量名 */
 char *codegen_expr(CodeGen *gen, ASTNode *node);
 
+/* 生成表达式的 double 值（不装箱），返回 double 临时变量名或常量 */
+char *codegen_num_expr(CodeGen *gen, ASTNode *node);
+
+/* 生成条件表达式，返回 i1 临时变量名（数值比较不经过 box_bool） */
+char *codegen_cond_expr(CodeGen *gen, ASTNode *node);
+
 /* ============================================================================
  * 语句代码生成声明 - codegen_stmt.c
  * ============================================================================ */
@@ -196,4 +237,65 @@ CapturedVars *analyze_captured_vars(CodeGen *gen, ASTNode *func_body,
 /* 检查最近分析的函数是否使用了 self 关键字 */
 bool closure_analysis_uses_self(void);
 
+/* 输出函数本体的 LLVM 函数类型：%struct.Value* (%struct.Value*, ...)* */
+void codegen_emit_function_type(FILE *out, size_t total_params);
+
+/* 为函数生成统一调用入口 @<func_name>.entry(函数值, 参数数组, 参数个数)
+ * text_entries 时输出完整的文本定义；否则只输出声明并登记到 !flyux.entries，
+ * 由后端解析模块后用 IRBuilder 生成函数体（见 codegen_irbuilder.cpp） */
+void codegen_emit_function_entry(CodeGen *gen, FILE *out, const char *func_name, size_t param_count,
+                                 int uses_self, size_t captured_count);
+
+/* ============================================================================
+ * 数值类型推断声明 - codegen_types.c
+ * ============================================================================ */
+
+/* 数值局部变量集合 */
+struct NumericVars {
+    char **names;           /* 变量名数组 */
+    size_t count;           /* 变量数量 */
+    size_t capacity;        /* 数组容量 */
+    NameIndex index;        /* 按名字查找 names 中的条目 */
+};
+
+/* 创建/添加/查询/释放数值局部变量集合 */
+NumericVars *numeric_vars_create(void);
+void numeric_vars_add(NumericVars *nv, const char *name);
+int numeric_vars_contains(NumericVars *nv, const char *name);
+void numeric_vars_free(NumericVars *nv);
+
+/* 分析函数体，返回可以用 double 存储的局部变量（调用者需释放） */
+NumericVars *analyze_numeric_locals(CodeGen *gen, ASTNode *func_body,
+                                    char **params, size_t param_count);
+
+/* 判断表达式的结果是否一定是 num（根据当前符号表） */
+int is_numeric_expr(CodeGen *gen, ASTNode *node);
+
+/* ============================================================================
+ * 字段访问内联缓存 - 布局须与 runtime 的 Value / FieldIC 保持一致
+ * ============================================================================ */
+
+#define FIELD_IC_WAYS       4   /* 每个访问点的缓存路数 */
+#define VALUE_SHAPE_OFFSET  14  /* Value.shape (u16) 的字节偏移 */
+#define VALUE_DATA_OFFSET   16  /* Value.data.pointer 的字节偏移 */
+
+/* 静态字面量 Value 的类型与标志 - 须与 runtime 的 VALUE_* / VALUE_FLAG_* 保持一致 */
+#define VALUE_TYPE_NUMBER     0
+#define VALUE_TYPE_STRING     1
+#define VALUE_FLAG_STATIC     0x01  /* data 不归 Value 所有，不释放 */
+#define VALUE_FLAG_IMMORTAL   0x04  /* retain/release 跳过，不会写入 Value 头 */
+
+/* %struct.FunctionObject 的字段下标 - 须与 runtime 的 FunctionObject 保持一致 */
+#define FUNCTION_OBJECT_FUNC_PTR    0
+#define FUNCTION_OBJECT_CAPTURED    1
+#define FUNCTION_OBJECT_BOUND_SELF  4
+
+/* 交给后端构建的统一入口列表（命名元数据）。每个元素为
+ * !{<入口函数>, i32 参数个数, i32 是否使用 self, i32 捕获变量个数}，本体为去掉 ".entry" 后缀的同名函数 */
+#define CODEGEN_ENTRIES_METADATA    "flyux.entries"
+#define CODEGEN_ENTRY_SUFFIX        ".entry"
+
+/* 统一调用入口的类型，用于 box_function 的 entry 参数（拼接进 fprintf 格式串） */
+#define FUNCTION_ENTRY_TYPE "%%struct.Value* (%%struct.Value*, %%struct.Value**, i64)*"
+
 #endif /* FLYUXC_CODEGEN_INTERNAL_H */
\ No newline at end of file
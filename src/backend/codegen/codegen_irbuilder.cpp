@@ -0,0 +1,170 @@
+/**
+ * 统一调用入口的 IRBuilder 实现
+ *
+ * 与 codegen_closure.c 中 codegen_emit_function_entry 的文本版本逐条对应：
+ *   - self 取 FunctionObject.bound_self，未绑定时为 undef
+ *   - 调用方给出的参数不足时补 undef，多余的忽略
+ *   - 捕获变量取 FunctionObject.captured
+ * 模块来自 LLVM 18 解析，指针均为不透明指针，所有 Value* / Value** 都是同一个 ptr 类型。
+ */
+
+#include "codegen_irbuilder.h"
+#include "codegen_internal.h"
+
+#include <llvm/ADT/StringRef.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Metadata.h>
+#include <llvm/IR/Module.h>
+
+#include <vector>
+
+namespace {
+
+// !flyux.entries 的一个元素
+struct EntrySpec {
+    llvm::Function* entry;      // 只有声明的 @<函数名>.entry
+    llvm::Function* body;       // 函数本体 @<函数名>
+    unsigned param_count;
+    bool uses_self;
+    unsigned captured_count;
+};
+
+bool read_count(const llvm::MDNode* node, unsigned index, unsigned& out) {
+    auto* value = llvm::mdconst::dyn_extract_or_null<llvm::ConstantInt>(node->getOperand(index));
+    if (!value) return false;
+    out = (unsigned)value->getZExtValue();
+    return true;
+}
+
+bool parse_entry_spec(llvm::Module& module, const llvm::MDNode* node,
+                      EntrySpec& spec, std::string& error) {
+    unsigned uses_self = 0;
+    if (node->getNumOperands() != 4 ||
+        !read_count(node, 1, spec.param_count) ||
+        !read_count(node, 2, uses_self) ||
+        !read_count(node, 3, spec.captured_count)) {
+        error = "malformed !" CODEGEN_ENTRIES_METADATA " entry";
+        return false;
+    }
+    spec.uses_self = uses_self != 0;
+
+    spec.entry = llvm::mdconst::dyn_extract_or_null<llvm::Function>(node->getOperand(0));
+    if (!spec.entry || !spec.entry->isDeclaration() || spec.entry->arg_size() != 3) {
+        error = "!" CODEGEN_ENTRIES_METADATA " must reference a declared (fn, args, argc) entry";
+        return false;
+    }
+
+    llvm::StringRef body_name = spec.entry->getName();
+    if (!body_name.consume_back(CODEGEN_ENTRY_SUFFIX) ||
+        !(spec.body = module.getFunction(body_name))) {
+        error = "no function body for entry @" + spec.entry->getName().str();
+        return false;
+    }
+
+    // 本体签名：[self] + 普通参数 + 捕获变量
+    size_t expected = (spec.uses_self ? 1 : 0) + spec.param_count + spec.captured_count;
+    if (spec.body->arg_size() != expected) {
+        error = "entry @" + spec.entry->getName().str() + " does not match the body signature";
+        return false;
+    }
+    return true;
+}
+
+void build_entry(const EntrySpec& spec, llvm::StructType* fn_object_type,
+                 llvm::FunctionCallee box_undef) {
+    llvm::Function* fn = spec.entry;
+    llvm::Argument* fn_value = fn->getArg(0);
+    llvm::Argument* args = fn->getArg(1);
+    llvm::Argument* argc = fn->getArg(2);
+    fn_value->setName("fn");
+    args->setName("args");
+    argc->setName("argc");
+    llvm::Type* ptr_type = fn_value->getType();
+
+    llvm::IRBuilder<> builder(llvm::BasicBlock::Create(fn->getContext(), "entry", fn));
+
+    llvm::Value* fn_obj = nullptr;
+    if (spec.uses_self || spec.captured_count > 0) {
+        llvm::Value* data = builder.CreateConstInBoundsGEP1_64(builder.getInt8Ty(), fn_value,
+                                                               VALUE_DATA_OFFSET, "fn.data");
+        fn_obj = builder.CreateLoad(ptr_type, data, "fn.obj");
+    }
+    llvm::Value* undef = nullptr;
+    if (spec.uses_self || spec.param_count > 0) {
+        undef = builder.CreateCall(box_undef, {}, "undef");
+    }
+
+    std::vector<llvm::Value*> call_args;
+    if (spec.uses_self) {
+        llvm::Value* self_p = builder.CreateStructGEP(fn_object_type, fn_obj,
+                                                      FUNCTION_OBJECT_BOUND_SELF, "self.p");
+        llvm::Value* self_v = builder.CreateLoad(ptr_type, self_p, "self.v");
+        llvm::Value* self_none = builder.CreateIsNull(self_v, "self.none");
+        call_args.push_back(builder.CreateSelect(self_none, undef, self_v, "self"));
+    }
+
+    // 参数：不足的位置读 undef 槽位，避免越界读取 args
+    llvm::Value* undef_slot = nullptr;
+    if (spec.param_count > 0) {
+        undef_slot = builder.CreateAlloca(ptr_type, nullptr, "undef.slot");
+        builder.CreateStore(undef, undef_slot);
+    }
+    for (unsigned i = 0; i < spec.param_count; i++) {
+        llvm::Value* has = builder.CreateICmpSGT(argc, builder.getInt64(i), "arg.has");
+        llvm::Value* at = builder.CreateConstGEP1_64(ptr_type, args, i, "arg.at");
+        llvm::Value* slot = builder.CreateSelect(has, at, undef_slot, "arg.p");
+        call_args.push_back(builder.CreateLoad(ptr_type, slot, "arg"));
+    }
+
+    if (spec.captured_count > 0) {
+        llvm::Value* caps_p = builder.CreateStructGEP(fn_object_type, fn_obj,
+                                                      FUNCTION_OBJECT_CAPTURED, "caps.p");
+        llvm::Value* caps = builder.CreateLoad(ptr_type, caps_p, "caps");
+        for (unsigned i = 0; i < spec.captured_count; i++) {
+            llvm::Value* cap_p = builder.CreateConstInBoundsGEP1_64(ptr_type, caps, i, "cap.p");
+            call_args.push_back(builder.CreateLoad(ptr_type, cap_p, "cap"));
+        }
+    }
+
+    llvm::Value* result = builder.CreateCall(spec.body->getFunctionType(), spec.body,
+                                             call_args, "result");
+    builder.CreateRet(result);
+    fn->setLinkage(llvm::GlobalValue::InternalLinkage);
+}
+
+} // namespace
+
+bool codegen_build_function_entries(llvm::Module& module, std::string& error) {
+    llvm::NamedMDNode* entries = module.getNamedMetadata(CODEGEN_ENTRIES_METADATA);
+    if (!entries) return true;
+
+    llvm::StructType* fn_object_type =
+        llvm::StructType::getTypeByName(module.getContext(), "struct.FunctionObject");
+    if (!fn_object_type) {
+        error = "%struct.FunctionObject is not defined in the module";
+        return false;
+    }
+
+    std::vector<EntrySpec> specs;
+    specs.reserve(entries->getNumOperands());
+    for (const llvm::MDNode* node : entries->operands()) {
+        EntrySpec spec;
+        if (!parse_entry_spec(module, node, spec, error)) return false;
+        specs.push_back(spec);
+    }
+
+    if (!specs.empty()) {
+        llvm::Type* ptr_type = specs.front().entry->getReturnType();
+        llvm::FunctionCallee box_undef =
+            module.getOrInsertFunction("box_undef", llvm::FunctionType::get(ptr_type, false));
+        for (const EntrySpec& spec : specs) {
+            build_entry(spec, fn_object_type, box_undef);
+        }
+    }
+
+    module.eraseNamedMetadata(entries);
+    return true;
+}
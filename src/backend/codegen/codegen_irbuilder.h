@@ -0,0 +1,22 @@
+/**
+ * 通过 IRBuilder 直接构建模块的一部分
+ *
+ * codegen 的大部分仍然输出文本 IR。统一调用入口 @<函数名>.entry 在文本中只有声明，
+ * 并登记在 !flyux.entries 中；后端解析出 llvm::Module 后由这里生成函数体。
+ * -IR 时 codegen 改为输出完整的文本定义（调试回退），模块中没有该元数据，这里什么也不做。
+ */
+
+#ifndef FLYUXC_CODEGEN_IRBUILDER_H
+#define FLYUXC_CODEGEN_IRBUILDER_H
+
+#include <string>
+
+namespace llvm {
+class Module;
+}
+
+// 为 !flyux.entries 中登记的每个入口生成函数体，完成后移除该元数据
+// 失败时返回 false，原因写入 error
+bool codegen_build_function_entries(llvm::Module& module, std::string& error);
+
+#endif /* FLYUXC_CODEGEN_IRBUILDER_H */
@@ -103,6 +103,26 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
             // 注册变量并获取IR名称（如果遮蔽则生成唯一名称）
             const char *ir_name = register_symbol_with_shadow(gen, decl->name, decl->is_const);
             
+            // 类型推断证明只保存 num 的局部变量：使用 double 栈槽，不需要引用计数清理
+            if (numeric_vars_contains(gen->numeric_vars, decl->name)) {
+                mark_symbol_numeric(gen, decl->name);
+                
+                char slot_name[256];
+                snprintf(slot_name, sizeof(slot_name), "%s.num", ir_name);
+                if (!is_ir_name_allocated(gen, slot_name)) {
+                    FILE *alloca_target = gen->entry_alloca_buf ? gen->entry_alloca_buf : gen->code_buf;
+                    fprintf(alloca_target, "  %%%s = alloca double\n", slot_name);
+                    fprintf(alloca_target, "  store double 0.0, double* %%%s\n", slot_name);
+                    mark_ir_name_allocated(gen, slot_name);
+                }
+                
+                char *init_num = codegen_num_expr(gen, decl->init_expr);
+                temp_value_release_except(gen, NULL);
+                fprintf(gen->code_buf, "  store double %s, double* %%%s\n", init_num, slot_name);
+                free(init_num);
+                break;
+            }
+            
             // P2: 将变量添加到作用域跟踪器（使用IR名称）
             if (gen->scope) {
                 scope_add_local(gen->scope, ir_name);
@@ -259,6 +279,16 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
                     return;
                 }
                 
+                // num 变量：计算 double 值后直接写入 double 栈槽
+                if (var_exists && is_symbol_numeric(gen, target->name)) {
+                    char *num = codegen_num_expr(gen, assign->value);
+                    temp_value_release_except(gen, NULL);
+                    fprintf(gen->code_buf, "  store double %s, double* %%%s.num\n",
+                            num, get_symbol_ir_name(gen, target->name));
+                    free(num);
+                    break;
+                }
+                
                 // 获取变量的 IR 名称（考虑遮蔽）
                 const char *ir_name;
                 
@@ -437,34 +467,22 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
                     break;
                 }
                 
-                // 创建字段名字符串
-                char *key_label = new_string_label(gen);
-                size_t key_len = strlen(member->property);
-                fprintf(gen->strings_buf, "%s = private unnamed_addr constant [%zu x i8] c\"%s\\00\"\n",
-                        key_label, key_len + 1, member->property);
-                
-                char *key_ptr = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = getelementptr [%zu x i8], [%zu x i8]* %s, i32 0, i32 0\n",
-                        key_ptr, key_len + 1, key_len + 1, key_label);
-                
-                char *key_value = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_string(i8* %s)\n",
-                        key_value, key_ptr);
-                temp_value_register(gen, key_value);  // 注册 key_value
+                // 字段名：驻留符号
+                char *key_ptr = codegen_key_symbol(gen, member->property);
                 
-                // 调用 value_set_field
+                // 调用 value_set_field_ic：已有字段按缓存的 (形状, 槽位) 直接替换
+                char *ic = new_field_ic(gen);
                 char *result = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = call %%struct.Value* @value_set_field(%%struct.Value* %s, %%struct.Value* %s, %%struct.Value* %s)\n",
-                        result, obj_var, key_value, value);
+                fprintf(gen->code_buf, "  %s = call %%struct.Value* @value_set_field_ic(%%struct.Value* %s, i8* %s, %%struct.Value* %s, %%struct.FieldIC* getelementptr ([%d x %%struct.FieldIC], [%d x %%struct.FieldIC]* %s, i32 0, i32 0))  ; .%s =\n",
+                        result, obj_var, key_ptr, value, FIELD_IC_WAYS, FIELD_IC_WAYS, ic, member->property);
                 temp_value_register(gen, result);  // 注册 result
                 
-                // 释放中间值（key_value 和 result 是临时创建的，需要释放）
+                // 释放中间值（result 是临时创建的，需要释放）
                 temp_value_release_except(gen, value);
                 
                 free(obj_var);
-                free(key_label);
                 free(key_ptr);
-                free(key_value);
+                free(ic);
                 free(result);
             }
             else {
@@ -778,13 +796,8 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
                 
                 // 处理每个条件（else-if 链）
                 for (size_t i = 0; i < ifstmt->cond_count; i++) {
-                    // 评估条件
-                    char *cond = codegen_expr(gen, ifstmt->conditions[i]);
-                    char *truthy = new_temp(gen);
-                    fprintf(gen->code_buf, "  %s = call i32 @value_is_truthy(%%struct.Value* %s)\n", 
-                            truthy, cond);
-                    char *cond_bool = new_temp(gen);
-                    fprintf(gen->code_buf, "  %s = icmp ne i32 %s, 0\n", cond_bool, truthy);
+                    // 评估条件（数值比较直接得到 i1）
+                    char *cond_bool = codegen_cond_expr(gen, ifstmt->conditions[i]);
                     
                     char *then_label = new_label(gen);
                     char *next_label = new_label(gen);
@@ -819,8 +832,6 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
                     // 下一个条件标签（else-if 或 else）
                     fprintf(gen->code_buf, "\n%s:\n", next_label);
                     
-                    free(cond);
-                    free(truthy);
                     free(cond_bool);
                     free(then_label);
                     free(next_label);
@@ -871,20 +882,19 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
             if (loop->loop_type == LOOP_REPEAT) {
                 // 重复循环: L> [n] { body }
                 // 转换为: i=0; while(i<n) { body; i++; }
+                // 计数器和上限都以 double 保存，循环控制不经过装箱
                 char *loop_counter = new_temp(gen);
-                char *loop_limit = codegen_expr(gen, loop->loop_data.repeat_count);
+                char *loop_limit = codegen_num_expr(gen, loop->loop_data.repeat_count);
                 
-                // 循环控制表达式不应该作为中间值释放，清空栈
-                temp_value_clear(gen);
+                // 上限已拆箱，释放循环控制表达式的中间值
+                temp_value_release_except(gen, NULL);
                 
                 // 分配计数器变量
-                fprintf(gen->code_buf, "  %s_var = alloca %%struct.Value*\n", loop_counter);
+                FILE *alloca_target = gen->entry_alloca_buf ? gen->entry_alloca_buf : gen->code_buf;
+                fprintf(alloca_target, "  %s_var = alloca double\n", loop_counter);
                 
                 // 初始化计数器为 0
-                char *zero = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_number(double 0.0)\n", zero);
-                fprintf(gen->code_buf, "  store %%struct.Value* %s, %%struct.Value** %s_var\n", zero, loop_counter);
-                free(zero);
+                fprintf(gen->code_buf, "  store double 0.0, double* %s_var\n", loop_counter);
                 
                 char *loop_header = new_label(gen);
                 char *loop_body = new_label(gen);
@@ -897,20 +907,12 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
                 
                 // 条件: i < n
                 char *counter_val = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = load %%struct.Value*, %%struct.Value** %s_var\n", counter_val, loop_counter);
-                char *cond_result = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = call %%struct.Value* @value_less_than(%%struct.Value* %s, %%struct.Value* %s)\n",
-                        cond_result, counter_val, loop_limit);
-                
-                char *truthy = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = call i32 @value_is_truthy(%%struct.Value* %s)\n", truthy, cond_result);
+                fprintf(gen->code_buf, "  %s = load double, double* %s_var\n", counter_val, loop_counter);
                 char *cond_bool = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = icmp ne i32 %s, 0\n", cond_bool, truthy);
+                fprintf(gen->code_buf, "  %s = fcmp olt double %s, %s\n", cond_bool, counter_val, loop_limit);
                 fprintf(gen->code_buf, "  br i1 %s, label %%%s, label %%%s\n", cond_bool, loop_body, loop_end);
                 
                 free(counter_val);
-                free(cond_result);
-                free(truthy);
                 free(cond_bool);
                 
                 // 循环体
@@ -941,17 +943,13 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
                 // 更新部分: i++
                 fprintf(gen->code_buf, "\n%s:\n", loop_update);
                 char *old_val = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = load %%struct.Value*, %%struct.Value** %s_var\n", old_val, loop_counter);
-                char *one = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = call %%struct.Value* @box_number(double 1.0)\n", one);
+                fprintf(gen->code_buf, "  %s = load double, double* %s_var\n", old_val, loop_counter);
                 char *new_val = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = call %%struct.Value* @value_add(%%struct.Value* %s, %%struct.Value* %s)\n",
-                        new_val, old_val, one);
-                fprintf(gen->code_buf, "  store %%struct.Value* %s, %%struct.Value** %s_var\n", new_val, loop_counter);
+                fprintf(gen->code_buf, "  %s = fadd double %s, 1.0\n", new_val, old_val);
+                fprintf(gen->code_buf, "  store double %s, double* %s_var\n", new_val, loop_counter);
                 fprintf(gen->code_buf, "  br label %%%s\n", loop_header);
                 
                 free(old_val);
-                free(one);
                 free(new_val);
                 
                 // 结束
@@ -1112,21 +1110,11 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
                 
                 // 条件判断
                 if (loop->loop_data.for_loop.condition) {
-                    char *cond = codegen_expr(gen, loop->loop_data.for_loop.condition);
-                    
-                    // 使用 value_is_truthy 将 Value* 转换为 i32
-                    char *truthy = new_temp(gen);
-                    fprintf(gen->code_buf, "  %s = call i32 @value_is_truthy(%%struct.Value* %s)\n", 
-                            truthy, cond);
-                    
-                    // 转换为 i1
-                    char *cond_bool = new_temp(gen);
-                    fprintf(gen->code_buf, "  %s = icmp ne i32 %s, 0\n", cond_bool, truthy);
+                    // 转换为 i1（数值比较直接使用 fcmp 结果）
+                    char *cond_bool = codegen_cond_expr(gen, loop->loop_data.for_loop.condition);
                     
                     fprintf(gen->code_buf, "  br i1 %s, label %%%s, label %%%s\n",
                             cond_bool, loop_body, loop_end);
-                    free(cond);
-                    free(truthy);
                     free(cond_bool);
                 } else {
                     // 无条件则一直循环
@@ -1166,6 +1154,10 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
                         loop->loop_data.for_loop.update->kind == AST_VAR_DECL ||
                         loop->loop_data.for_loop.update->kind == AST_ASSIGN_STMT) {
                         codegen_stmt(gen, loop->loop_data.for_loop.update);
+                    } else if (is_numeric_expr(gen, loop->loop_data.for_loop.update)) {
+                        // num 表达式（如 num 变量的 i++）：结果不需要装箱
+                        free(codegen_num_expr(gen, loop->loop_data.for_loop.update));
+                        temp_value_release_except(gen, NULL);
                     } else {
                         // 作为表达式处理（如 i++）
                         char *result = codegen_expr(gen, loop->loop_data.for_loop.update);
@@ -1191,6 +1183,14 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
         
         case AST_EXPR_STMT: {
             ASTExprStmt *stmt = (ASTExprStmt *)node->data;
+            
+            // num 表达式语句（如 i++）：结果直接丢弃，不需要装箱
+            if (is_numeric_expr(gen, stmt->expr)) {
+                free(codegen_num_expr(gen, stmt->expr));
+                temp_value_release_except(gen, NULL);
+                break;
+            }
+            
             char *result = codegen_expr(gen, stmt->expr);
             if (result) {
                 // 释放所有中间值（但保留最终结果）
@@ -1242,9 +1242,8 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
                         "%s_nested_%d", func->name, nested_anon_counter++);
                 func_llvm_name = unique_func_name;
                 
-                // 关键：将实际使用的 LLVM 函数名写回 AST，供后续引用
-                free(func->name);
-                func->name = strdup(func_llvm_name);
+                // 关键：将实际使用的 LLVM 函数名写回 AST，供后续引用（名字归 AST 分配区所有）
+                func->name = ast_strdup(func_llvm_name);
             }
             
             // 为了避免嵌套函数定义交错，始终使用临时缓冲区收集函数定义
@@ -1320,6 +1319,13 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
             TempValueStack *saved_temp_values = gen->temp_values;  // 保存临时值栈
             int saved_scope_level = gen->scope_level;  // 保存作用域层级
             RefBoxVarEntry *saved_refbox_vars = gen->refbox_vars;  // 保存 refbox 变量列表
+            NumericVars *saved_numeric_vars = gen->numeric_vars;  // 保存 num 变量集合
+            NameIndex saved_symbol_index = gen->symbol_index;  // 保存对应的名字索引
+            NameIndex saved_allocated_ir_index = gen->allocated_ir_index;
+            NameIndex saved_refbox_index = gen->refbox_index;
+            name_index_init(&gen->symbol_index);
+            name_index_init(&gen->allocated_ir_index);
+            name_index_init(&gen->refbox_index);
             gen->allocated_ir_names = NULL;  // 新函数开始，清空已分配名称
             gen->temp_values = NULL;  // 新函数使用新的临时值栈
             gen->scope_level = 0;  // 函数内部从 scope level 0 开始
@@ -1380,6 +1386,10 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
                 collect_catch_params(gen, func->body, func_entry_alloca_buf);
             }
             
+            // 类型推断：找出可以用 double 存储的局部变量
+            gen->numeric_vars = analyze_numeric_locals(gen, func->body,
+                                                       func->params, func->param_count);
+            
             // 生成函数体代码
             if (func->body) {
                 codegen_stmt(gen, func->body);
@@ -1399,6 +1409,11 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
             // P2: 生成默认返回前的清理代码
             fprintf(func_body_buf, "  ; P2: default return cleanup\n");
             for (LocalVarEntry *entry = func_scope->locals; entry != NULL; entry = entry->next) {
+                if (is_refbox_var(gen, entry->name)) {
+                    // 被闭包捕获的引用盒子随闭包存活，不释放
+                    fprintf(func_body_buf, "  ; skip release (captured refbox): %s\n", entry->name);
+                    continue;
+                }
                 char temp_name[64];
                 snprintf(temp_name, sizeof(temp_name), "%%cleanup_%s_%d", entry->name, gen->temp_count++);
                 fprintf(func_body_buf, "  %s = load %%struct.Value*, %%struct.Value** %%%s\n",
@@ -1418,10 +1433,15 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
             gen->temp_values = saved_temp_values;  // 恢复临时值栈
             gen->scope_level = saved_scope_level;  // 恢复作用域层级
             gen->refbox_vars = saved_refbox_vars;  // 恢复 refbox 列表
+            name_index_free(&gen->refbox_index);
+            gen->refbox_index = saved_refbox_index;
+            numeric_vars_free(gen->numeric_vars);
+            gen->numeric_vars = saved_numeric_vars;  // 恢复 num 变量集合
             
             // 清理并恢复已分配名称集合
             clear_allocated_ir_names(gen);
             gen->allocated_ir_names = saved_allocated_ir_names;
+            gen->allocated_ir_index = saved_allocated_ir_index;
             
             // 释放函数内新添加的符号（在 saved_symbols 之后添加的）
             // 注意：不释放 saved_symbols 及其之前的条目
@@ -1433,6 +1453,8 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
                 entry = next;
             }
             gen->symbols = saved_symbols;
+            name_index_free(&gen->symbol_index);
+            gen->symbol_index = saved_symbol_index;
             
             // 将 entry alloca 写入输出
             rewind(func_entry_alloca_buf);
@@ -1457,6 +1479,10 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
             free(default_ret_label);
             fprintf(output_target, "}\n");
             
+            // 统一调用入口，供 call_function_value 间接调用
+            codegen_emit_function_entry(gen, output_target, func_llvm_name, func->param_count,
+                                        func->uses_self, captured ? captured->count : 0);
+            
             // 将完整的函数定义从临时缓冲区写入最终目标
             rewind(func_output_buf);
             while (fgets(buffer, sizeof(buffer), func_output_buf)) {
@@ -1538,23 +1564,15 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
                     // 调用 box_function_ex 创建闭包值（按引用捕获）
                     int func_val_temp = gen->temp_count++;
                     fprintf(gen->code_buf, "  %%t%d = call %%struct.Value* @box_function_ex("
-                            "i8* bitcast (%%struct.Value* (", func_val_temp);
+                            "i8* bitcast (", func_val_temp);
                     
                     // 生成函数签名参数
-                    int need_comma = 0;
-                    for (size_t i = 0; i < func->param_count; i++) {
-                        if (need_comma) fprintf(gen->code_buf, ", ");
-                        fprintf(gen->code_buf, "%%struct.Value*");
-                        need_comma = 1;
-                    }
-                    for (size_t i = 0; i < captured->count; i++) {
-                        if (need_comma) fprintf(gen->code_buf, ", ");
-                        fprintf(gen->code_buf, "%%struct.Value*");
-                        need_comma = 1;
-                    }
+                    codegen_emit_function_type(gen->code_buf,
+                                               (func->uses_self ? 1 : 0) + func->param_count + captured->count);
                     
-                    fprintf(gen->code_buf, ")* @%s to i8*), %%struct.Value** %%t%d, i32 %zu, i32 %zu, i32 %d, i32 0)  ; capture by value\n",
-                            func_llvm_name, ptr_temp, captured->count, func->param_count, func->uses_self ? 1 : 0);
+                    fprintf(gen->code_buf, " @%s to i8*), i8* bitcast (" FUNCTION_ENTRY_TYPE " @%s.entry to i8*), "
+                            "%%struct.Value** %%t%d, i32 %zu, i32 %zu, i32 %d, i32 1)  ; capture by ref\n",
+                            func_llvm_name, func_llvm_name, ptr_temp, captured->count, func->param_count, func->uses_self ? 1 : 0);
                     
                     // 存储到局部变量
                     fprintf(gen->code_buf, "  call %%struct.Value* @value_retain(%%struct.Value* %%t%d)\n",
@@ -1580,16 +1598,14 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
                     // 无捕获变量 - 简单函数值
                     int func_val_temp = gen->temp_count++;
                     fprintf(gen->code_buf, "  %%t%d = call %%struct.Value* @box_function("
-                            "i8* bitcast (%%struct.Value* (", func_val_temp);
+                            "i8* bitcast (", func_val_temp);
                     
                     // 生成函数签名参数
-                    for (size_t i = 0; i < func->param_count; i++) {
-                        if (i > 0) fprintf(gen->code_buf, ", ");
-                        fprintf(gen->code_buf, "%%struct.Value*");
-                    }
+                    codegen_emit_function_type(gen->code_buf, (func->uses_self ? 1 : 0) + func->param_count);
                     
-                    fprintf(gen->code_buf, ")* @%s to i8*), %%struct.Value** null, i32 0, i32 %zu, i32 %d)\n",
-                            func_llvm_name, func->param_count, func->uses_self ? 1 : 0);
+                    fprintf(gen->code_buf, " @%s to i8*), i8* bitcast (" FUNCTION_ENTRY_TYPE " @%s.entry to i8*), "
+                            "%%struct.Value** null, i32 0, i32 %zu, i32 %d)\n",
+                            func_llvm_name, func_llvm_name, func->param_count, func->uses_self ? 1 : 0);
                     
                     // 存储到局部变量
                     fprintf(gen->code_buf, "  call %%struct.Value* @value_retain(%%struct.Value* %%t%d)\n",
@@ -1598,6 +1614,10 @@ void codegen_stmt(CodeGen *gen, ASTNode *node) {
                             func_val_temp, func->name);
                 }
                 
+                // 记录变量对应的闭包函数，调用点可以直接调用本体
+                register_closure_mapping(gen, func->name, func_llvm_name, captured,
+                                         func->param_count, func->uses_self);
+                
                 // 添加到作用域跟踪器用于清理
                 scope_add_local(gen->scope, func->name);
             }
@@ -0,0 +1,110 @@
+#include "codegen_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * 名字索引
+ *
+ * 符号表、函数表、闭包映射等仍按链表保存条目（注册顺序、作用域遍历和释放都靠它），
+ * 查找则走这里的哈希索引：同名时新插入的排在桶内前面，查到的就是最内层 / 最新的条目。
+ * 键是条目自己保存的名字（不另外复制），比较时先比指针，再比哈希和内容。
+ * ============================================================================ */
+
+#define NAME_INDEX_INITIAL_BUCKETS 64
+
+static int name_index_match(const NameIndexEntry *e, const char *name, unsigned long hash) {
+    return e->name == name || (e->hash == hash && strcmp(e->name, name) == 0);
+}
+
+static void name_index_grow(NameIndex *index) {
+    size_t new_count = index->bucket_count ? index->bucket_count * 2 : NAME_INDEX_INITIAL_BUCKETS;
+    NameIndexEntry **buckets = (NameIndexEntry **)calloc(new_count, sizeof(NameIndexEntry *));
+    if (!buckets) return;
+
+    // 逆序搬迁每个桶，保持同名条目的先后顺序
+    for (size_t i = 0; i < index->bucket_count; i++) {
+        NameIndexEntry *reversed = NULL;
+        for (NameIndexEntry *e = index->buckets[i]; e; ) {
+            NameIndexEntry *next = e->next;
+            e->next = reversed;
+            reversed = e;
+            e = next;
+        }
+        for (NameIndexEntry *e = reversed; e; ) {
+            NameIndexEntry *next = e->next;
+            size_t slot = e->hash & (new_count - 1);
+            e->next = buckets[slot];
+            buckets[slot] = e;
+            e = next;
+        }
+    }
+    free(index->buckets);
+    index->buckets = buckets;
+    index->bucket_count = new_count;
+}
+
+void name_index_init(NameIndex *index) {
+    index->buckets = NULL;
+    index->bucket_count = 0;
+    index->count = 0;
+}
+
+void name_index_free(NameIndex *index) {
+    for (size_t i = 0; i < index->bucket_count; i++) {
+        NameIndexEntry *e = index->buckets[i];
+        while (e) {
+            NameIndexEntry *next = e->next;
+            free(e);
+            e = next;
+        }
+    }
+    free(index->buckets);
+    name_index_init(index);
+}
+
+void name_index_insert(NameIndex *index, const char *name, void *value) {
+    if (index->count >= index->bucket_count) {
+        name_index_grow(index);
+        if (!index->buckets) return;
+    }
+
+    NameIndexEntry *e = (NameIndexEntry *)malloc(sizeof(NameIndexEntry));
+    if (!e) return;
+    e->name = name;
+    e->hash = codegen_key_hash(name);
+    e->value = value;
+
+    size_t slot = e->hash & (index->bucket_count - 1);
+    e->next = index->buckets[slot];
+    index->buckets[slot] = e;
+    index->count++;
+}
+
+void *name_index_find(const NameIndex *index, const char *name) {
+    if (!index->bucket_count) return NULL;
+
+    unsigned long hash = codegen_key_hash(name);
+    for (NameIndexEntry *e = index->buckets[hash & (index->bucket_count - 1)]; e; e = e->next) {
+        if (name_index_match(e, name, hash)) {
+            return e->value;
+        }
+    }
+    return NULL;
+}
+
+void name_index_remove(NameIndex *index, const char *name, void *value) {
+    if (!index->bucket_count) return;
+
+    unsigned long hash = codegen_key_hash(name);
+    NameIndexEntry **ptr = &index->buckets[hash & (index->bucket_count - 1)];
+    while (*ptr) {
+        NameIndexEntry *e = *ptr;
+        if (e->value == value) {
+            *ptr = e->next;
+            free(e);
+            index->count--;
+            return;
+        }
+        ptr = &e->next;
+    }
+}
@@ -0,0 +1,478 @@
+/* ============================================================================
+ * codegen_types.c - 数值类型推断
+ * ============================================================================
+ * 分析函数体，找出可以证明始终保存 num 的局部变量。
+ * 这些变量用 double 栈槽代替 Value* 栈槽，算术运算直接在 double SSA
+ * 寄存器上进行，只有在值逃逸（传参、放入数组/对象、返回等）时才装箱。
+ *
+ * 推断规则（保守）：
+ * - 数字字面量是 num
+ * - -, *, /, %, ** 的结果总是 num（运行时对操作数做 unbox_number 强制转换）
+ * - + 只有两边都是 num 时才是 num（否则可能是字符串拼接）
+ * - 一元 - 总是 num，一元 + 与操作数相同，++/-- 作用于 num 变量时是 num
+ * - 变量只有在函数内恰好声明一次、带初始值、所有赋值都是 num、
+ *   且没有被嵌套函数引用时才是 num
+ * ============================================================================ */
+
+#include "codegen_internal.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * NumericVars 结构管理
+ * ============================================================================ */
+
+NumericVars *numeric_vars_create(void) {
+    NumericVars *nv = (NumericVars *)malloc(sizeof(NumericVars));
+    nv->names = NULL;
+    nv->count = 0;
+    nv->capacity = 0;
+    name_index_init(&nv->index);
+    return nv;
+}
+
+void numeric_vars_add(NumericVars *nv, const char *name) {
+    if (numeric_vars_contains(nv, name)) {
+        return;
+    }
+
+    if (nv->count >= nv->capacity) {
+        size_t new_capacity = nv->capacity == 0 ? 8 : nv->capacity * 2;
+        nv->names = (char **)realloc(nv->names, new_capacity * sizeof(char *));
+        nv->capacity = new_capacity;
+    }
+
+    char *copy = strdup(name);
+    nv->names[nv->count++] = copy;
+    name_index_insert(&nv->index, copy, copy);
+}
+
+int numeric_vars_contains(NumericVars *nv, const char *name) {
+    if (!nv) return 0;
+    return name_index_find(&nv->index, name) != NULL;
+}
+
+void numeric_vars_free(NumericVars *nv) {
+    if (nv) {
+        for (size_t i = 0; i < nv->count; i++) {
+            free(nv->names[i]);
+        }
+        free(nv->names);
+        name_index_free(&nv->index);
+        free(nv);
+    }
+}
+
+/* ============================================================================
+ * 数值表达式判定（分析阶段与代码生成阶段共用）
+ * ============================================================================ */
+
+typedef int (*NumNamePredicate)(void *ctx, const char *name);
+
+static int expr_is_numeric(ASTNode *node, NumNamePredicate is_num_name, void *ctx) {
+    if (!node) return 0;
+
+    switch (node->kind) {
+        case AST_NUM_LITERAL:
+            return 1;
+
+        case AST_IDENTIFIER: {
+            ASTIdentifier *id = (ASTIdentifier *)node->data;
+            return is_num_name(ctx, id->name);
+        }
+
+        case AST_BINARY_EXPR: {
+            ASTBinaryExpr *expr = (ASTBinaryExpr *)node->data;
+            switch (expr->op) {
+                case TK_MINUS:
+                case TK_STAR:
+                case TK_SLASH:
+                case TK_PERCENT:
+                case TK_POWER:
+                    return 1;
+                case TK_PLUS:
+                    return expr_is_numeric(expr->left, is_num_name, ctx) &&
+                           expr_is_numeric(expr->right, is_num_name, ctx);
+                default:
+                    return 0;
+            }
+        }
+
+        case AST_UNARY_EXPR: {
+            ASTUnaryExpr *unary = (ASTUnaryExpr *)node->data;
+            switch (unary->op) {
+                case TK_MINUS:
+                    return 1;
+                case TK_PLUS:
+                case TK_PLUS_PLUS:
+                case TK_MINUS_MINUS:
+                    return expr_is_numeric(unary->operand, is_num_name, ctx);
+                default:
+                    return 0;
+            }
+        }
+
+        default:
+            return 0;
+    }
+}
+
+static int symbol_is_numeric_pred(void *ctx, const char *name) {
+    return is_symbol_numeric((CodeGen *)ctx, name);
+}
+
+/* 代码生成阶段：根据符号表判断表达式是否是 num */
+int is_numeric_expr(CodeGen *gen, ASTNode *node) {
+    return expr_is_numeric(node, symbol_is_numeric_pred, gen);
+}
+
+/* ============================================================================
+ * 函数体分析
+ * ============================================================================ */
+
+/* 候选变量信息 */
+typedef struct NumVarInfo {
+    char *name;
+    int decl_count;          /* 在函数内被声明的次数 */
+    int excluded;            /* 已被排除（不能用 double 存储） */
+    ASTNode **values;        /* 所有赋给该变量的表达式（初始值 + 赋值） */
+    size_t value_count;
+    size_t value_capacity;
+} NumVarInfo;
+
+typedef struct NumAnalysis {
+    NumVarInfo *vars;
+    size_t count;
+    size_t capacity;
+    NameIndex index;         /* 名字 -> vars 下标 + 1（vars 会 realloc，不能存指针） */
+} NumAnalysis;
+
+static NumVarInfo *analysis_get(NumAnalysis *na, const char *name) {
+    uintptr_t slot = (uintptr_t)name_index_find(&na->index, name);
+    if (slot) {
+        return &na->vars[slot - 1];
+    }
+
+    if (na->count >= na->capacity) {
+        size_t new_capacity = na->capacity == 0 ? 16 : na->capacity * 2;
+        na->vars = (NumVarInfo *)realloc(na->vars, new_capacity * sizeof(NumVarInfo));
+        na->capacity = new_capacity;
+    }
+
+    NumVarInfo *info = &na->vars[na->count++];
+    info->name = strdup(name);
+    info->decl_count = 0;
+    info->excluded = 0;
+    info->values = NULL;
+    info->value_count = 0;
+    info->value_capacity = 0;
+    name_index_insert(&na->index, info->name, (void *)(uintptr_t)na->count);
+    return info;
+}
+
+static void analysis_exclude(NumAnalysis *na, const char *name) {
+    analysis_get(na, name)->excluded = 1;
+}
+
+static void analysis_add_value(NumAnalysis *na, const char *name, ASTNode *value) {
+    NumVarInfo *info = analysis_get(na, name);
+    if (info->value_count >= info->value_capacity) {
+        size_t new_capacity = info->value_capacity == 0 ? 4 : info->value_capacity * 2;
+        info->values = (ASTNode **)realloc(info->values, new_capacity * sizeof(ASTNode *));
+        info->value_capacity = new_capacity;
+    }
+    info->values[info->value_count++] = value;
+}
+
+static void analysis_free(NumAnalysis *na) {
+    for (size_t i = 0; i < na->count; i++) {
+        free(na->vars[i].name);
+        free(na->vars[i].values);
+    }
+    free(na->vars);
+    name_index_free(&na->index);
+}
+
+/* 类型标注是否允许 num（无标注或 :[num]） */
+static int annotation_allows_num(ASTNode *type_ann) {
+    if (!type_ann) return 1;
+    if (type_ann->kind != AST_TYPE_ANNOTATION) return 0;
+    ASTTypeAnnotation *ann = (ASTTypeAnnotation *)type_ann->data;
+    return ann->type_token == TK_TYPE_NUM;
+}
+
+/* 递归收集变量声明、赋值和会阻止 double 存储的用法
+ * in_nested: 是否位于嵌套函数内部（嵌套函数引用的变量需要以 Value* 形式捕获） */
+static void collect_num_info(ASTNode *node, NumAnalysis *na, int in_nested) {
+    if (!node) return;
+
+    switch (node->kind) {
+        case AST_VAR_DECL: {
+            ASTVarDecl *decl = (ASTVarDecl *)node->data;
+            if (in_nested) {
+                analysis_exclude(na, decl->name);
+            } else {
+                NumVarInfo *info = analysis_get(na, decl->name);
+                info->decl_count++;
+                if (decl->is_const || !decl->init_expr ||
+                    !annotation_allows_num(decl->type_annotation)) {
+                    info->excluded = 1;
+                } else {
+                    analysis_add_value(na, decl->name, decl->init_expr);
+                }
+            }
+            collect_num_info(decl->init_expr, na, in_nested);
+            break;
+        }
+
+        case AST_CONST_DECL: {
+            ASTVarDecl *decl = (ASTVarDecl *)node->data;
+            analysis_exclude(na, decl->name);
+            collect_num_info(decl->init_expr, na, in_nested);
+            break;
+        }
+
+        case AST_FUNC_DECL: {
+            ASTFuncDecl *func = (ASTFuncDecl *)node->data;
+            analysis_exclude(na, func->name);
+            // 嵌套函数内引用的所有名字都不能用 double 存储
+            collect_num_info(func->body, na, 1);
+            break;
+        }
+
+        case AST_ASSIGN_STMT: {
+            ASTAssignStmt *assign = (ASTAssignStmt *)node->data;
+            if (assign->target->kind == AST_IDENTIFIER) {
+                ASTIdentifier *target = (ASTIdentifier *)assign->target->data;
+                if (in_nested) {
+                    analysis_exclude(na, target->name);
+                } else {
+                    analysis_add_value(na, target->name, assign->value);
+                }
+            } else {
+                collect_num_info(assign->target, na, in_nested);
+            }
+            collect_num_info(assign->value, na, in_nested);
+            break;
+        }
+
+        case AST_IDENTIFIER: {
+            if (in_nested) {
+                ASTIdentifier *id = (ASTIdentifier *)node->data;
+                analysis_exclude(na, id->name);
+            }
+            break;
+        }
+
+        case AST_EXPR_STMT: {
+            ASTExprStmt *stmt = (ASTExprStmt *)node->data;
+            collect_num_info(stmt->expr, na, in_nested);
+            break;
+        }
+
+        case AST_BLOCK: {
+            ASTBlock *block = (ASTBlock *)node->data;
+            for (size_t i = 0; i < block->stmt_count; i++) {
+                collect_num_info(block->statements[i], na, in_nested);
+            }
+            break;
+        }
+
+        case AST_IF_STMT: {
+            ASTIfStmt *ifstmt = (ASTIfStmt *)node->data;
+            for (size_t i = 0; i < ifstmt->cond_count; i++) {
+                collect_num_info(ifstmt->conditions[i], na, in_nested);
+                collect_num_info(ifstmt->then_blocks[i], na, in_nested);
+            }
+            collect_num_info(ifstmt->else_block, na, in_nested);
+            break;
+        }
+
+        case AST_LOOP_STMT: {
+            ASTLoopStmt *loop = (ASTLoopStmt *)node->data;
+            switch (loop->loop_type) {
+                case LOOP_REPEAT:
+                    collect_num_info(loop->loop_data.repeat_count, na, in_nested);
+                    break;
+                case LOOP_FOR:
+                    collect_num_info(loop->loop_data.for_loop.init, na, in_nested);
+                    collect_num_info(loop->loop_data.for_loop.condition, na, in_nested);
+                    collect_num_info(loop->loop_data.for_loop.update, na, in_nested);
+                    break;
+                case LOOP_FOREACH:
+                    // 循环变量由运行时数组元素赋值
+                    analysis_exclude(na, loop->loop_data.foreach_loop.item_var);
+                    collect_num_info(loop->loop_data.foreach_loop.iterable, na, in_nested);
+                    break;
+            }
+            collect_num_info(loop->body, na, in_nested);
+            break;
+        }
+
+        case AST_RETURN_STMT: {
+            ASTReturnStmt *ret = (ASTReturnStmt *)node->data;
+            collect_num_info(ret->value, na, in_nested);
+            break;
+        }
+
+        case AST_TRY_STMT: {
+            ASTTryStmt *try_stmt = (ASTTryStmt *)node->data;
+            if (try_stmt->catch_param) {
+                analysis_exclude(na, try_stmt->catch_param);
+            }
+            collect_num_info(try_stmt->try_block, na, in_nested);
+            collect_num_info(try_stmt->catch_block, na, in_nested);
+            collect_num_info(try_stmt->finally_block, na, in_nested);
+            break;
+        }
+
+        case AST_BINARY_EXPR: {
+            ASTBinaryExpr *expr = (ASTBinaryExpr *)node->data;
+            collect_num_info(expr->left, na, in_nested);
+            collect_num_info(expr->right, na, in_nested);
+            break;
+        }
+
+        case AST_UNARY_EXPR: {
+            ASTUnaryExpr *unary = (ASTUnaryExpr *)node->data;
+            collect_num_info(unary->operand, na, in_nested);
+            break;
+        }
+
+        case AST_TERNARY_EXPR: {
+            ASTTernaryExpr *ternary = (ASTTernaryExpr *)node->data;
+            collect_num_info(ternary->condition, na, in_nested);
+            collect_num_info(ternary->true_value, na, in_nested);
+            collect_num_info(ternary->false_value, na, in_nested);
+            break;
+        }
+
+        case AST_CALL_EXPR: {
+            ASTCallExpr *call = (ASTCallExpr *)node->data;
+            // 被调用的变量会按 Value* 直接从栈槽加载
+            if (call->callee && call->callee->kind == AST_IDENTIFIER) {
+                ASTIdentifier *id = (ASTIdentifier *)call->callee->data;
+                analysis_exclude(na, id->name);
+            }
+            collect_num_info(call->callee, na, in_nested);
+            for (size_t i = 0; i < call->arg_count; i++) {
+                collect_num_info(call->args[i], na, in_nested);
+            }
+            break;
+        }
+
+        case AST_MEMBER_EXPR: {
+            ASTMemberExpr *member = (ASTMemberExpr *)node->data;
+            // obj.prop 的对象变量会按 Value* 直接从栈槽加载
+            if (member->object && member->object->kind == AST_IDENTIFIER) {
+                ASTIdentifier *id = (ASTIdentifier *)member->object->data;
+                analysis_exclude(na, id->name);
+            }
+            collect_num_info(member->object, na, in_nested);
+            break;
+        }
+
+        case AST_INDEX_EXPR: {
+            ASTIndexExpr *index = (ASTIndexExpr *)node->data;
+            collect_num_info(index->object, na, in_nested);
+            collect_num_info(index->index, na, in_nested);
+            break;
+        }
+
+        case AST_CHAIN_EXPR: {
+            ASTChainExpr *chain = (ASTChainExpr *)node->data;
+            if (chain->object && chain->object->kind == AST_IDENTIFIER) {
+                ASTIdentifier *id = (ASTIdentifier *)chain->object->data;
+                analysis_exclude(na, id->name);
+            }
+            collect_num_info(chain->object, na, in_nested);
+            for (size_t i = 0; i < chain->chain_count; i++) {
+                for (size_t j = 0; j < chain->chain[i].arg_count; j++) {
+                    collect_num_info(chain->chain[i].args[j], na, in_nested);
+                }
+            }
+            break;
+        }
+
+        case AST_ARRAY_LITERAL: {
+            ASTArrayLiteral *arr = (ASTArrayLiteral *)node->data;
+            for (size_t i = 0; i < arr->elem_count; i++) {
+                collect_num_info(arr->elements[i], na, in_nested);
+            }
+            break;
+        }
+
+        case AST_OBJECT_LITERAL: {
+            ASTObjectLiteral *obj = (ASTObjectLiteral *)node->data;
+            for (size_t i = 0; i < obj->prop_count; i++) {
+                collect_num_info(obj->properties[i].value, na, in_nested);
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+static int analysis_is_num_pred(void *ctx, const char *name) {
+    NumAnalysis *na = (NumAnalysis *)ctx;
+    uintptr_t slot = (uintptr_t)name_index_find(&na->index, name);
+    return slot && !na->vars[slot - 1].excluded;
+}
+
+NumericVars *analyze_numeric_locals(CodeGen *gen, ASTNode *func_body,
+                                    char **params, size_t param_count) {
+    NumAnalysis na;
+    na.vars = NULL;
+    na.count = 0;
+    na.capacity = 0;
+    name_index_init(&na.index);
+
+    collect_num_info(func_body, &na, 0);
+
+    // 参数、全局变量、函数名以及未声明或重复声明的名字都保持 Value* 存储
+    for (size_t i = 0; i < param_count; i++) {
+        analysis_exclude(&na, params[i]);
+    }
+    analysis_exclude(&na, "self");
+    for (size_t i = 0; i < na.count; i++) {
+        NumVarInfo *info = &na.vars[i];
+        if (info->decl_count != 1 ||
+            is_global_var(gen, info->name) ||
+            is_function_name(gen, info->name)) {
+            info->excluded = 1;
+        }
+    }
+
+    // 乐观假设所有候选都是 num，反复剔除有非 num 赋值的变量直到不动点
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (size_t i = 0; i < na.count; i++) {
+            NumVarInfo *info = &na.vars[i];
+            if (info->excluded) continue;
+            for (size_t j = 0; j < info->value_count; j++) {
+                if (!expr_is_numeric(info->values[j], analysis_is_num_pred, &na)) {
+                    info->excluded = 1;
+                    changed = 1;
+                    break;
+                }
+            }
+        }
+    }
+
+    NumericVars *result = numeric_vars_create();
+    for (size_t i = 0; i < na.count; i++) {
+        if (!na.vars[i].excluded) {
+            numeric_vars_add(result, na.vars[i].name);
+            if (getenv("DEBUG_NUMERIC")) {
+                fprintf(stderr, "[DEBUG NUMERIC] %s stored as double\n", na.vars[i].name);
+            }
+        }
+    }
+
+    analysis_free(&na);
+    return result;
+}
@@ -25,6 +25,87 @@ char *new_string_label(CodeGen *gen) {
     return label;
 }
 
+/* 生成新的字段访问内联缓存（零初始化，运行时填充） */
+char *new_field_ic(CodeGen *gen) {
+    char *label = (char *)malloc(32);
+    snprintf(label, 32, "@.ic.%d", gen->ic_count++);
+    fprintf(gen->strings_buf, "%s = internal global [%d x %%struct.FieldIC] zeroinitializer\n",
+            label, FIELD_IC_WAYS);
+    return label;
+}
+
+/* 属性名哈希（FNV-1a），须与 runtime 的 symbol_hash 一致 */
+unsigned long codegen_key_hash(const char *name) {
+    unsigned long hash = 14695981039346656037UL;
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 1099511628211UL;
+    }
+    return hash;
+}
+
+/* 加载字面量属性名的驻留符号
+ * 每个不同的名字生成一个 @.key.N（名字 + 编译期哈希），程序启动时由
+ * value_intern_keys 填入符号指针；这里只生成一次 load */
+char *codegen_key_symbol(CodeGen *gen, const char *name) {
+    int index = -1;
+    for (int i = 0; i < gen->key_symbol_count; i++) {
+        if (strcmp(gen->key_symbols[i], name) == 0) {
+            index = i;
+            break;
+        }
+    }
+    
+    if (index < 0) {
+        if (gen->key_symbol_count >= gen->key_symbol_capacity) {
+            int new_capacity = gen->key_symbol_capacity ? gen->key_symbol_capacity * 2 : 16;
+            gen->key_symbols = (char **)realloc(gen->key_symbols, sizeof(char *) * new_capacity);
+            gen->key_symbol_capacity = new_capacity;
+        }
+        index = gen->key_symbol_count++;
+        gen->key_symbols[index] = strdup(name);
+        
+        size_t len = strlen(name);
+        fprintf(gen->strings_buf, "@.keyname.%d = private unnamed_addr constant [%zu x i8] c\"%s\\00\"\n",
+                index, len + 1, name);
+        fprintf(gen->strings_buf, "@.key.%d = internal global %%struct.KeySymbol { i8* getelementptr ([%zu x i8], [%zu x i8]* @.keyname.%d, i32 0, i32 0), i64 %lld, i8* null }\n",
+                index, len + 1, len + 1, index, (long long)codegen_key_hash(name));
+    }
+    
+    char *sym = new_temp(gen);
+    fprintf(gen->code_buf, "  %s = load i8*, i8** getelementptr (%%struct.KeySymbol, %%struct.KeySymbol* @.key.%d, i32 0, i32 2)\n",
+            sym, index);
+    return sym;
+}
+
+/* 数字字面量的静态 Value
+ * 带 VALUE_FLAG_IMMORTAL 的只读全局常量：retain/release 直接跳过，
+ * 求值时不分配也不调用 runtime */
+char *codegen_static_number(CodeGen *gen, double value) {
+    int index = gen->literal_count++;
+    fprintf(gen->strings_buf, "@.lit.%d = private unnamed_addr constant %%struct.StaticNumber "
+            "{ i32 %d, i32 %d, i32 1, i8 %d, i8 0, i16 0, double %.17e, i64 0, i64 0 }, align 8\n",
+            index, VALUE_TYPE_NUMBER, VALUE_TYPE_NUMBER, VALUE_FLAG_IMMORTAL, value);
+    
+    char *temp = new_temp(gen);
+    fprintf(gen->code_buf, "  %s = bitcast %%struct.StaticNumber* @.lit.%d to %%struct.Value*\n", temp, index);
+    return temp;
+}
+
+/* 字符串字面量的静态 Value，data 指向已生成的字符串常量 str_label */
+char *codegen_static_string(CodeGen *gen, const char *str_label, size_t len) {
+    int index = gen->literal_count++;
+    fprintf(gen->strings_buf, "@.lit.%d = private unnamed_addr constant %%struct.StaticString "
+            "{ i32 %d, i32 %d, i32 1, i8 %d, i8 0, i16 0, "
+            "i8* getelementptr inbounds ([%zu x i8], [%zu x i8]* %s, i32 0, i32 0), i64 0, i64 %zu }, align 8\n",
+            index, VALUE_TYPE_STRING, VALUE_TYPE_STRING, VALUE_FLAG_STATIC | VALUE_FLAG_IMMORTAL,
+            len + 1, len + 1, str_label, len);
+    
+    char *temp = new_temp(gen);
+    fprintf(gen->code_buf, "  %s = bitcast %%struct.StaticString* @.lit.%d to %%struct.Value*\n", temp, index);
+    return temp;
+}
+
 /* 转义字符串用于LLVM IR输出 - 支持包含\0的字符串 */
 char *escape_for_ir(const char *str, size_t in_len, size_t* out_len) {
     size_t len = in_len;
@@ -73,16 +154,12 @@ void register_array(CodeGen *gen, const char *var_name, const char *array_ptr, s
     meta->elem_count = elem_count;
     meta->next = gen->arrays;
     gen->arrays = meta;
+    name_index_insert(&gen->array_index, meta->var_name, meta);
 }
 
 /* 查找数组元数据 */
 ArrayMetadata *find_array(CodeGen *gen, const char *var_name) {
-    for (ArrayMetadata *meta = gen->arrays; meta != NULL; meta = meta->next) {
-        if (strcmp(meta->var_name, var_name) == 0) {
-            return meta;
-        }
-    }
-    return NULL;
+    return (ArrayMetadata *)name_index_find(&gen->array_index, var_name);
 }
 
 /* 注册对象元数据 */
@@ -92,16 +169,12 @@ void register_object(CodeGen *gen, const char *var_name, ObjectField *fields) {
     meta->fields = fields;
     meta->next = gen->objects;
     gen->objects = meta;
+    name_index_insert(&gen->object_index, meta->var_name, meta);
 }
 
 /* 查找对象元数据 */
 ObjectMetadata *find_object(CodeGen *gen, const char *var_name) {
-    for (ObjectMetadata *meta = gen->objects; meta != NULL; meta = meta->next) {
-        if (strcmp(meta->var_name, var_name) == 0) {
-            return meta;
-        }
-    }
-    return NULL;
+    return (ObjectMetadata *)name_index_find(&gen->object_index, var_name);
 }
 
 /* 在对象中查找字段 */
@@ -121,8 +194,19 @@ void register_symbol(CodeGen *gen, const char *var_name) {
     entry->scope_level = gen->scope_level;
     entry->ir_name = strdup(var_name);  // 默认IR名称与变量名相同
     entry->is_const = 0;  // 默认不是常量
+    entry->is_num = 0;
     entry->next = gen->symbols;
     gen->symbols = entry;
+    name_index_insert(&gen->symbol_index, entry->name, entry);
+}
+
+/* 最内层同名局部符号 / 全局符号 */
+static SymbolEntry *find_local_symbol(CodeGen *gen, const char *var_name) {
+    return (SymbolEntry *)name_index_find(&gen->symbol_index, var_name);
+}
+
+static SymbolEntry *find_global_symbol(CodeGen *gen, const char *var_name) {
+    return (SymbolEntry *)name_index_find(&gen->global_index, var_name);
 }
 
 /* 注册变量并返回IR名称（支持遮蔽时生成唯一名称） */
@@ -131,19 +215,17 @@ const char *register_symbol_with_shadow(CodeGen *gen, const char *var_name, int
     entry->name = strdup(var_name);
     entry->scope_level = gen->scope_level;
     entry->is_const = is_const;
-    entry->is_const = is_const;
+    entry->is_num = 0;
     
     // 检查是否已存在同名变量（任何层级）
     // 如果存在，必须生成唯一的 IR 名称避免 LLVM 重复定义错误
     int needs_shadow = 0;
-    for (SymbolEntry *e = gen->symbols; e != NULL; e = e->next) {
-        if (strcmp(e->name, var_name) == 0) {
-            needs_shadow = 1;
-            if (getenv("DEBUG_CODEGEN")) {
-                fprintf(stderr, "[DEBUG register_symbol_with_shadow] %s: found existing at scope %d, needs_shadow=1\n", 
-                        var_name, e->scope_level);
-            }
-            break;
+    SymbolEntry *existing = find_local_symbol(gen, var_name);
+    if (existing) {
+        needs_shadow = 1;
+        if (getenv("DEBUG_CODEGEN")) {
+            fprintf(stderr, "[DEBUG register_symbol_with_shadow] %s: found existing at scope %d, needs_shadow=1\n", 
+                    var_name, existing->scope_level);
         }
     }
     
@@ -164,6 +246,7 @@ const char *register_symbol_with_shadow(CodeGen *gen, const char *var_name, int
     
     entry->next = gen->symbols;
     gen->symbols = entry;
+    name_index_insert(&gen->symbol_index, entry->name, entry);
     
     return entry->ir_name;
 }
@@ -175,8 +258,10 @@ void register_global(CodeGen *gen, const char *var_name, int is_const) {
     entry->scope_level = 0;
     entry->ir_name = strdup(var_name);
     entry->is_const = is_const;  // 使用传入的 is_const
+    entry->is_num = 0;
     entry->next = gen->globals;
     gen->globals = entry;
+    name_index_insert(&gen->global_index, entry->name, entry);
 }
 
 /* 检查变量是否已定义（在任意层级） */
@@ -193,22 +278,18 @@ int is_symbol_defined(CodeGen *gen, const char *var_name) {
             fprintf(stderr, "  - %s (const=%d)\n", e->name, e->is_const);
         }
     }
-    for (SymbolEntry *entry = gen->symbols; entry != NULL; entry = entry->next) {
-        if (strcmp(entry->name, var_name) == 0) {
-            if (getenv("DEBUG_SYMBOL")) {
-                fprintf(stderr, "[DEBUG] Found %s in symbols list\n", var_name);
-            }
-            return 1;
+    if (find_local_symbol(gen, var_name)) {
+        if (getenv("DEBUG_SYMBOL")) {
+            fprintf(stderr, "[DEBUG] Found %s in symbols list\n", var_name);
         }
+        return 1;
     }
     // 也检查全局变量
-    for (SymbolEntry *entry = gen->globals; entry != NULL; entry = entry->next) {
-        if (strcmp(entry->name, var_name) == 0) {
-            if (getenv("DEBUG_SYMBOL")) {
-                fprintf(stderr, "[DEBUG] Found %s in globals list\n", var_name);
-            }
-            return 1;
+    if (find_global_symbol(gen, var_name)) {
+        if (getenv("DEBUG_SYMBOL")) {
+            fprintf(stderr, "[DEBUG] Found %s in globals list\n", var_name);
         }
+        return 1;
     }
     if (getenv("DEBUG_SYMBOL")) {
         fprintf(stderr, "[DEBUG] %s NOT FOUND\n", var_name);
@@ -218,56 +299,48 @@ int is_symbol_defined(CodeGen *gen, const char *var_name) {
 
 /* 检查变量是否在当前作用域层级已定义（用于检测重复声明） */
 int is_symbol_defined_in_current_scope(CodeGen *gen, const char *var_name) {
-    for (SymbolEntry *entry = gen->symbols; entry != NULL; entry = entry->next) {
-        if (strcmp(entry->name, var_name) == 0 && entry->scope_level == gen->scope_level) {
-            return 1;
-        }
-    }
-    return 0;
+    // 当前层级的同名符号一定是最内层的那个
+    SymbolEntry *entry = find_local_symbol(gen, var_name);
+    return entry && entry->scope_level == gen->scope_level;
 }
 
 /* 检查变量是否是常量 */
 int is_symbol_const(CodeGen *gen, const char *var_name) {
     // 检查局部符号表
-    for (SymbolEntry *entry = gen->symbols; entry != NULL; entry = entry->next) {
-        if (strcmp(entry->name, var_name) == 0) {
-            return entry->is_const;
-        }
-    }
+    SymbolEntry *entry = find_local_symbol(gen, var_name);
+    if (entry) return entry->is_const;
     // 检查全局符号表
-    for (SymbolEntry *entry = gen->globals; entry != NULL; entry = entry->next) {
-        if (strcmp(entry->name, var_name) == 0) {
-            return entry->is_const;
-        }
-    }
+    entry = find_global_symbol(gen, var_name);
+    if (entry) return entry->is_const;
     return 0;  // 未定义的变量默认不是常量
 }
 
 /* 获取变量的IR名称（考虑遮蔽，返回最内层作用域的名称） */
 const char *get_symbol_ir_name(CodeGen *gen, const char *var_name) {
-    // 符号表是后进先出，所以第一个匹配的就是最内层
-    for (SymbolEntry *entry = gen->symbols; entry != NULL; entry = entry->next) {
-        if (strcmp(entry->name, var_name) == 0) {
-            return entry->ir_name;
-        }
-    }
+    // 索引中同名的最新条目就是最内层
+    SymbolEntry *entry = find_local_symbol(gen, var_name);
+    if (entry) return entry->ir_name;
     // 检查全局变量
-    for (SymbolEntry *entry = gen->globals; entry != NULL; entry = entry->next) {
-        if (strcmp(entry->name, var_name) == 0) {
-            return entry->ir_name;
-        }
-    }
+    entry = find_global_symbol(gen, var_name);
+    if (entry) return entry->ir_name;
     return var_name;  // 回退到原始名称
 }
 
+/* 将最内层同名变量标记为 double 存储 */
+void mark_symbol_numeric(CodeGen *gen, const char *var_name) {
+    SymbolEntry *entry = find_local_symbol(gen, var_name);
+    if (entry) entry->is_num = 1;
+}
+
+/* 检查变量（最内层同名符号）是否以 double 存储 */
+int is_symbol_numeric(CodeGen *gen, const char *var_name) {
+    SymbolEntry *entry = find_local_symbol(gen, var_name);
+    return entry ? entry->is_num : 0;
+}
+
 /* 检查变量是否是全局变量 */
 int is_global_var(CodeGen *gen, const char *var_name) {
-    for (SymbolEntry *entry = gen->globals; entry != NULL; entry = entry->next) {
-        if (strcmp(entry->name, var_name) == 0) {
-            return 1;
-        }
-    }
-    return 0;
+    return find_global_symbol(gen, var_name) != NULL;
 }
 
 /* 进入新的作用域 */
@@ -285,21 +358,18 @@ void scope_exit(CodeGen *gen) {
     }
     
     // 从符号表中移除当前作用域层级的所有符号
-    SymbolEntry **ptr = &gen->symbols;
-    while (*ptr != NULL) {
-        SymbolEntry *entry = *ptr;
-        if (entry->scope_level == gen->scope_level) {
-            *ptr = entry->next;
-            if (getenv("DEBUG_CODEGEN")) {
-                fprintf(stderr, "[DEBUG scope_exit] Removing symbol: %s (ir=%s)\n", 
-                        entry->name, entry->ir_name);
-            }
-            free(entry->name);
-            free(entry->ir_name);
-            free(entry);
-        } else {
-            ptr = &entry->next;
+    // 作用域严格嵌套，当前层级的符号都在链表头部，逐个弹出即可
+    while (gen->symbols && gen->symbols->scope_level == gen->scope_level) {
+        SymbolEntry *entry = gen->symbols;
+        gen->symbols = entry->next;
+        if (getenv("DEBUG_CODEGEN")) {
+            fprintf(stderr, "[DEBUG scope_exit] Removing symbol: %s (ir=%s)\n", 
+                    entry->name, entry->ir_name);
         }
+        name_index_remove(&gen->symbol_index, entry->name, entry);
+        free(entry->name);
+        free(entry->ir_name);
+        free(entry);
     }
     
     gen->scope_level--;
@@ -309,7 +379,12 @@ void scope_exit(CodeGen *gen) {
 void scope_generate_exit_cleanup(CodeGen *gen) {
     // 释放当前作用域层级的所有变量
     for (SymbolEntry *entry = gen->symbols; entry != NULL; entry = entry->next) {
-        if (entry->scope_level == gen->scope_level) {
+        if (entry->scope_level == gen->scope_level && !entry->is_num) {
+            if (is_refbox_var(gen, entry->ir_name)) {
+                // 被闭包捕获的引用盒子随闭包存活，不释放
+                fprintf(gen->code_buf, "  ; skip release (captured refbox): %s\n", entry->ir_name);
+                continue;
+            }
             char *temp = new_temp(gen);
             fprintf(gen->code_buf, "  %s = load %%struct.Value*, %%struct.Value** %%%s\n",
                     temp, entry->ir_name);
@@ -323,12 +398,7 @@ void scope_generate_exit_cleanup(CodeGen *gen) {
 
 /* 检查 IR 名称是否已被分配（用于避免重复 alloca） */
 int is_ir_name_allocated(CodeGen *gen, const char *ir_name) {
-    for (AllocatedIRName *entry = gen->allocated_ir_names; entry != NULL; entry = entry->next) {
-        if (strcmp(entry->ir_name, ir_name) == 0) {
-            return 1;
-        }
-    }
-    return 0;
+    return name_index_find(&gen->allocated_ir_index, ir_name) != NULL;
 }
 
 /* 标记 IR 名称已被分配 */
@@ -337,6 +407,7 @@ void mark_ir_name_allocated(CodeGen *gen, const char *ir_name) {
     entry->ir_name = strdup(ir_name);
     entry->next = gen->allocated_ir_names;
     gen->allocated_ir_names = entry;
+    name_index_insert(&gen->allocated_ir_index, entry->ir_name, entry);
 }
 
 /* 清除已分配 IR 名称集合（在函数退出时调用） */
@@ -349,6 +420,7 @@ void clear_allocated_ir_names(CodeGen *gen) {
         entry = next;
     }
     gen->allocated_ir_names = NULL;
+    name_index_free(&gen->allocated_ir_index);
 }
 
 /* 注册函数名到函数表 */
@@ -357,16 +429,12 @@ void register_function(CodeGen *gen, const char *func_name) {
     entry->name = strdup(func_name);
     entry->next = gen->functions;
     gen->functions = entry;
+    name_index_insert(&gen->function_index, entry->name, entry);
 }
 
 /* 检查名字是否是函数 */
 int is_function_name(CodeGen *gen, const char *name) {
-    for (SymbolEntry *entry = gen->functions; entry != NULL; entry = entry->next) {
-        if (strcmp(entry->name, name) == 0) {
-            return 1;
-        }
-    }
-    return 0;
+    return name_index_find(&gen->function_index, name) != NULL;
 }
 
 /* ============================================================================
@@ -416,6 +484,20 @@ void scope_generate_cleanup(CodeGen *gen, ScopeTracker *scope) {
     scope_generate_cleanup_except(gen, scope, NULL);
 }
 
+/* 释放一个局部变量。被闭包捕获过的变量存的是引用盒子（Value**），
+ * 盒子要和闭包一起存活，不能当作 Value 释放 */
+static void emit_local_release(CodeGen *gen, const char *ir_name) {
+    if (is_refbox_var(gen, ir_name)) {
+        fprintf(gen->code_buf, "  ; skip release (captured refbox): %s\n", ir_name);
+        return;
+    }
+    char *val = new_temp(gen);
+    fprintf(gen->code_buf, "  %s = load %%struct.Value*, %%struct.Value** %%%s\n",
+            val, ir_name);
+    fprintf(gen->code_buf, "  call void @value_release(%%struct.Value* %s)\n", val);
+    free(val);
+}
+
 /* 检查 IR 名称是否仍在 symbols 列表中（用于避免双重释放） */
 static int is_ir_name_in_symbols(CodeGen *gen, const char *ir_name) {
     for (SymbolEntry *entry = gen->symbols; entry != NULL; entry = entry->next) {
@@ -447,11 +529,7 @@ void scope_generate_cleanup_except(CodeGen *gen, ScopeTracker *scope, const char
         }
         
         // 加载变量值并释放
-        char *val = new_temp(gen);
-        fprintf(gen->code_buf, "  %s = load %%struct.Value*, %%struct.Value** %%%s\n",
-                val, entry->name);
-        fprintf(gen->code_buf, "  call void @value_release(%%struct.Value* %s)\n", val);
-        free(val);
+        emit_local_release(gen, entry->name);
     }
     
     fprintf(gen->code_buf, "  ; === P2 Scope Cleanup End ===\n");
@@ -509,11 +587,7 @@ void loop_scope_generate_break_cleanup(CodeGen *gen) {
         fprintf(gen->code_buf, "  ; === Break Loop Cleanup Start ===\n");
         
         for (LocalVarEntry *entry = loop_scope->locals; entry != NULL; entry = entry->next) {
-            char *val = new_temp(gen);
-            fprintf(gen->code_buf, "  %s = load %%struct.Value*, %%struct.Value** %%%s\n",
-                    val, entry->name);
-            fprintf(gen->code_buf, "  call void @value_release(%%struct.Value* %s)\n", val);
-            free(val);
+            emit_local_release(gen, entry->name);
         }
         
         fprintf(gen->code_buf, "  ; === Break Loop Cleanup End ===\n");
@@ -531,11 +605,7 @@ void loop_scope_generate_next_cleanup(CodeGen *gen) {
         fprintf(gen->code_buf, "  ; === Next Loop Cleanup Start ===\n");
         
         for (LocalVarEntry *entry = loop_scope->locals; entry != NULL; entry = entry->next) {
-            char *val = new_temp(gen);
-            fprintf(gen->code_buf, "  %s = load %%struct.Value*, %%struct.Value** %%%s\n",
-                    val, entry->name);
-            fprintf(gen->code_buf, "  call void @value_release(%%struct.Value* %s)\n", val);
-            free(val);
+            emit_local_release(gen, entry->name);
         }
         
         fprintf(gen->code_buf, "  ; === Next Loop Cleanup End ===\n");
@@ -578,11 +648,7 @@ void loop_scope_generate_multilevel_break_cleanup(CodeGen *gen, const char *targ
         ScopeTracker *loop_scope = entry->loop_scope;
         if (loop_scope && loop_scope->locals) {
             for (LocalVarEntry *var = loop_scope->locals; var != NULL; var = var->next) {
-                char *val = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = load %%struct.Value*, %%struct.Value** %%%s\n",
-                        val, var->name);
-                fprintf(gen->code_buf, "  call void @value_release(%%struct.Value* %s)\n", val);
-                free(val);
+                emit_local_release(gen, var->name);
             }
         }
         
@@ -612,11 +678,7 @@ void loop_scope_generate_multilevel_next_cleanup(CodeGen *gen, const char *targe
         ScopeTracker *loop_scope = entry->loop_scope;
         if (loop_scope && loop_scope->locals) {
             for (LocalVarEntry *var = loop_scope->locals; var != NULL; var = var->next) {
-                char *val = new_temp(gen);
-                fprintf(gen->code_buf, "  %s = load %%struct.Value*, %%struct.Value** %%%s\n",
-                        val, var->name);
-                fprintf(gen->code_buf, "  call void @value_release(%%struct.Value* %s)\n", val);
-                free(val);
+                emit_local_release(gen, var->name);
             }
         }
     }
@@ -778,10 +840,8 @@ void temp_value_clear(CodeGen *gen) {
 /* 标记变量为引用盒子 */
 void mark_as_refbox_var(CodeGen *gen, const char *var_name) {
     // 检查是否已标记
-    for (RefBoxVarEntry *entry = gen->refbox_vars; entry != NULL; entry = entry->next) {
-        if (strcmp(entry->var_name, var_name) == 0) {
-            return;  // 已存在
-        }
+    if (is_refbox_var(gen, var_name)) {
+        return;  // 已存在
     }
     
     // 添加新条目
@@ -789,15 +849,11 @@ void mark_as_refbox_var(CodeGen *gen, const char *var_name) {
     entry->var_name = strdup(var_name);
     entry->next = gen->refbox_vars;
     gen->refbox_vars = entry;
+    name_index_insert(&gen->refbox_index, entry->var_name, entry);
 }
 
 /* 检查变量是否为引用盒子 */
 int is_refbox_var(CodeGen *gen, const char *var_name) {
-    for (RefBoxVarEntry *entry = gen->refbox_vars; entry != NULL; entry = entry->next) {
-        if (strcmp(entry->var_name, var_name) == 0) {
-            return 1;
-        }
-    }
-    return 0;
+    return name_index_find(&gen->refbox_index, var_name) != NULL;
 }
 
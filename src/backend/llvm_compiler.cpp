@@ -4,12 +4,17 @@
  */
 
 #include "flyuxc/llvm_compiler.h"
+#include "flyuxc/utils/time_report.h"
+#include "flyuxc/utils/io.h"
+#include "flyuxc/version.h"
+#include "codegen/codegen_irbuilder.h"
 
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/raw_ostream.h>
@@ -18,17 +23,44 @@
 #include <llvm/Target/TargetOptions.h>
 #include <llvm/MC/TargetRegistry.h>
 #include <llvm/Passes/PassBuilder.h>
+#include <llvm/IR/PassInstrumentation.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
 #include <llvm/Transforms/InstCombine/InstCombine.h>
 #include <llvm/Transforms/Scalar.h>
 #include <llvm/Transforms/Utils.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/CodeGen/ParallelCG.h>
+#include <llvm/Support/Threading.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/ProfileData/InstrProfReader.h>
+#include <llvm/ProfileData/InstrProfWriter.h>
+#include <llvm/Support/PGOOptions.h>
+#include <llvm/Support/VirtualFileSystem.h>
+#ifdef FLYUXC_RUNTIME_BITCODE
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Transforms/IPO/Internalize.h>
+#endif
+#ifdef FLYUXC_USE_LLD
+#include <lld/Common/Driver.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/VersionTuple.h>
+#include <llvm/TargetParser/Triple.h>
+#endif
 
 #include <string>
 #include <memory>
+#include <optional>
+#include <functional>
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <unistd.h>
+#include <sys/stat.h>
+#include <vector>
 #include <system_error>
 
 // 嵌入的运行时库源代码
@@ -37,6 +69,20 @@ extern "C" const char* get_embedded_runtime_source(void);
 // 嵌入的预编译运行时对象文件
 #include "runtime_object_embedded.h"
 
+#ifdef FLYUXC_RUNTIME_BITCODE
+// 嵌入的运行时 bitcode（FLYUXC_RUNTIME_BITCODE 构建选项）
+#include "runtime_bitcode_embedded.h"
+#endif
+
+#ifdef FLYUXC_USE_LLD
+// 进程内链接器：只注册宿主平台对应的 LLD 驱动
+#if defined(__APPLE__)
+LLD_HAS_DRIVER(macho)
+#else
+LLD_HAS_DRIVER(elf)
+#endif
+#endif
+
 static std::string g_last_error;
 
 // 设置错误信息
@@ -44,6 +90,36 @@ static void set_error(const std::string& error) {
     g_last_error = error;
 }
 
+// --time-report：记录模块规模（函数 / 基本块 / 指令数）
+static void report_module_counts(llvm::Module* module, const char* prefix) {
+    if (!time_report_enabled()) return;
+    
+    unsigned long long functions = 0, blocks = 0, instructions = 0;
+    for (llvm::Function& F : *module) {
+        if (F.isDeclaration()) continue;
+        functions++;
+        for (llvm::BasicBlock& BB : F) {
+            blocks++;
+            instructions += BB.size();
+        }
+    }
+    
+    std::string name(prefix);
+    time_report_count((name + "_functions").c_str(), functions);
+    time_report_count((name + "_basic_blocks").c_str(), blocks);
+    time_report_count((name + "_instructions").c_str(), instructions);
+}
+
+// --time-report：记录文件大小
+static void report_file_size(const char* path, const char* name) {
+    if (!time_report_enabled()) return;
+    
+    struct stat st;
+    if (stat(path, &st) == 0) {
+        time_report_count(name, (unsigned long long)st.st_size);
+    }
+}
+
 // 初始化 LLVM 目标 - 只初始化本地目标以加快启动速度
 static void initialize_llvm_targets() {
     static bool initialized = false;
@@ -61,25 +137,96 @@ extern "C" void llvm_initialize() {
     initialize_llvm_targets();
 }
 
-// 将嵌入的运行时对象文件写入临时文件
-static std::string write_embedded_runtime_object() {
-    const char* tmpdir = getenv("TMPDIR");
-    if (!tmpdir) tmpdir = "/tmp";
+// 嵌入运行时对象文件在磁盘上的位置
+struct RuntimeObjectFile {
+    std::string path;
+    bool temporary;     // true: 本次编译专用，链接后删除
+};
+
+// 把嵌入数据写入 path（先写同目录的唯一临时文件，再 rename，保证其他进程看不到写了一半的文件）
+static bool write_runtime_object_atomically(const std::string& path) {
+    std::string tmp = path + ".tmp.XXXXXX";
+    std::vector<char> tmp_path(tmp.begin(), tmp.end());
+    tmp_path.push_back('\0');
+    int fd = mkstemp(tmp_path.data());
+    if (fd < 0) return false;
+    
+    ssize_t written = write(fd, runtime_object_o, runtime_object_o_len);
+    bool ok = close(fd) == 0 && written == (ssize_t)runtime_object_o_len;
+    if (ok) ok = rename(tmp_path.data(), path.c_str()) == 0;
+    if (!ok) unlink(tmp_path.data());
+    return ok;
+}
+
+// 取得嵌入运行时对象文件的路径
+// 按版本和内容哈希命名，物化到用户私有临时目录后同一主机上的编译都复用这一份；
+// 私有目录不可用时退回为每次编译写一个唯一的临时文件
+static RuntimeObjectFile get_runtime_object_file() {
+    static std::string materialized;
+    struct stat st;
+    if (!materialized.empty() && stat(materialized.c_str(), &st) == 0) {
+        return {materialized, false};
+    }
     
-    char runtime_o_path[512];
-    snprintf(runtime_o_path, sizeof(runtime_o_path), "%s/flyuxc_runtime_%d.o", tmpdir, getpid());
+    if (const char* dir = flyuxc_temp_dir()) {
+        // FNV-1a 64
+        uint64_t hash = 14695981039346656037ULL;
+        for (unsigned int i = 0; i < runtime_object_o_len; i++) {
+            hash ^= runtime_object_o[i];
+            hash *= 1099511628211ULL;
+        }
+        char name[128];
+        snprintf(name, sizeof(name), "/runtime-%s-%016llx.o", FLYUXC_VERSION, (unsigned long long)hash);
+        std::string path = std::string(dir) + name;
+        
+        if ((stat(path.c_str(), &st) == 0 && st.st_size == (off_t)runtime_object_o_len) ||
+            write_runtime_object_atomically(path)) {
+            materialized = path;
+            return {materialized, false};
+        }
+    }
     
-    // 写入嵌入的对象文件
-    FILE* f = fopen(runtime_o_path, "wb");
-    if (!f) {
+    char* tmp_path = create_temp_file("flyuxc_runtime_", ".o");
+    if (!tmp_path) {
         set_error("Failed to create temporary runtime object file");
-        return "";
+        return {"", true};
     }
+    std::string path(tmp_path);
+    free(tmp_path);
     
-    fwrite(runtime_object_o, 1, runtime_object_o_len, f);
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f || fwrite(runtime_object_o, 1, runtime_object_o_len, f) != runtime_object_o_len) {
+        if (f) fclose(f);
+        unlink(path.c_str());
+        set_error("Failed to write temporary runtime object file");
+        return {"", true};
+    }
     fclose(f);
     
-    return std::string(runtime_o_path);
+    return {path, true};
+}
+
+// 从内存中的 IR 文本解析模块（不经过临时文件）
+// codegen 仍然输出文本 IR，这里只省掉写临时 .ll 再读回的那一步
+static std::unique_ptr<llvm::Module> parse_ir_buffer(
+    llvm::LLVMContext& context,
+    const char* ir_code,
+    const char* buffer_name
+) {
+    llvm::SMDiagnostic err;
+    // getMemBuffer 不复制数据；LLParser 依赖末尾的 '\0'，ir_code 必须以 NUL 结尾
+    auto buffer = llvm::MemoryBuffer::getMemBuffer(ir_code, buffer_name);
+    auto module = llvm::parseIR(buffer->getMemBufferRef(), err, context);
+    
+    if (!module) {
+        std::string error_msg = "IR compilation error: ";
+        error_msg += err.getMessage().str();
+        error_msg += "\n  Hint: Use '-IR' flag to view generated IR for debugging";
+        set_error(error_msg);
+        return nullptr;
+    }
+    
+    return module;
 }
 
 // 从 IR 文件加载模块
@@ -114,81 +261,371 @@ static bool verify_module(llvm::Module* module) {
     return true;
 }
 
-// 优化模块
-static void optimize_module(llvm::Module* module, int opt_level) {
-    if (opt_level == 0) return;
+// PGO 配置（llvm_set_profile），对之后的所有编译生效
+static struct {
+    std::string generate_file;      // 非空时插桩，程序退出时写出原始 profile
+    // 合并后的索引格式 profile，放在内存文件系统中供 PGOInstrumentationUse 读取
+    llvm::IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem> use_fs;
+} g_profile;
+
+static const char* const PROFILE_USE_PATH = "/flyuxc/merged.profdata";
+
+// 在进程内把若干 .profraw / .profdata 合并为索引格式（即 llvm-profdata merge），不依赖外部工具
+static std::unique_ptr<llvm::MemoryBuffer> merge_profiles(const std::vector<std::string>& inputs) {
+    llvm::InstrProfWriter writer;
+    auto fs = llvm::vfs::getRealFileSystem();
+    std::string warnings;
     
-    // 使用新的 Pass Manager
-    llvm::PassBuilder PB;
+    for (const std::string& input : inputs) {
+        auto reader_or_err = llvm::InstrProfReader::create(input, *fs);
+        if (!reader_or_err) {
+            set_error("Failed to read profile " + input + ": " +
+                      llvm::toString(reader_or_err.takeError()));
+            return nullptr;
+        }
+        std::unique_ptr<llvm::InstrProfReader> reader = std::move(*reader_or_err);
+        if (llvm::Error err = writer.mergeProfileKind(reader->getProfileKind())) {
+            set_error("Incompatible profile " + input + ": " + llvm::toString(std::move(err)));
+            return nullptr;
+        }
+        for (llvm::NamedInstrProfRecord& record : *reader) {
+            writer.addRecord(std::move(record), 1, [&warnings](llvm::Error err) {
+                warnings = llvm::toString(std::move(err));
+            });
+        }
+        if (reader->hasError()) {
+            set_error("Failed to read profile " + input + ": " +
+                      llvm::toString(reader->getError()));
+            return nullptr;
+        }
+    }
     
+    // 计数溢出等问题只影响个别函数，不中止合并
+    if (!warnings.empty()) {
+        fprintf(stderr, "warning: profile merge: %s\n", warnings.c_str());
+    }
+    return writer.writeBuffer();
+}
+
+// 当前编译的 PGO 选项；instrument 为 false 时（JIT）不插桩，进程内没有 profile 运行时
+static std::optional<llvm::PGOOptions> profile_options(bool instrument) {
+    if (instrument && !g_profile.generate_file.empty()) {
+        return llvm::PGOOptions(g_profile.generate_file, "", "", "",
+                                llvm::vfs::getRealFileSystem(),
+                                llvm::PGOOptions::IRInstr);
+    }
+    if (g_profile.use_fs) {
+        return llvm::PGOOptions(PROFILE_USE_PATH, "", "", "", g_profile.use_fs,
+                                llvm::PGOOptions::IRUse);
+    }
+    return std::nullopt;
+}
+
+// 后端代码生成的优化级别
+static llvm::CodeGenOptLevel codegen_opt_level(int opt_level) {
+    switch (opt_level & FLYUXC_OPT_LEVEL_MASK) {
+        case 0:  return llvm::CodeGenOptLevel::None;
+        case 3:  return llvm::CodeGenOptLevel::Aggressive;
+        default: return llvm::CodeGenOptLevel::Default;
+    }
+}
+
+// PassBuilder 及注册好的分析管理器
+struct PassPipeline {
+    llvm::PassBuilder PB;
     llvm::LoopAnalysisManager LAM;
     llvm::FunctionAnalysisManager FAM;
     llvm::CGSCCAnalysisManager CGAM;
     llvm::ModuleAnalysisManager MAM;
     
-    PB.registerModuleAnalyses(MAM);
-    PB.registerCGSCCAnalyses(CGAM);
-    PB.registerFunctionAnalyses(FAM);
-    PB.registerLoopAnalyses(LAM);
-    PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+    PassPipeline(std::optional<llvm::PGOOptions> pgo, llvm::PassInstrumentationCallbacks* PIC)
+        : PB(nullptr, llvm::PipelineTuningOptions(), pgo, PIC) {
+        PB.registerModuleAnalyses(MAM);
+        PB.registerCGSCCAnalyses(CGAM);
+        PB.registerFunctionAnalyses(FAM);
+        PB.registerLoopAnalyses(LAM);
+        PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+    }
     
-    llvm::ModulePassManager MPM;
+    // 分析结果引用刚优化完的模块，运行后清空，下一个模块重新计算
+    void clear() {
+        LAM.clear();
+        FAM.clear();
+        CGAM.clear();
+        MAM.clear();
+    }
+};
+
+// 不用 PGO、不计时的默认流水线只注册一次，之后的编译直接复用
+static PassPipeline& default_pass_pipeline() {
+    static PassPipeline pipeline(std::nullopt, nullptr);
+    return pipeline;
+}
+
+// 优化模块（instrument：是否允许 --profile-generate 插桩）
+static void optimize_module(llvm::Module* module, int opt_level, bool instrument) {
+    int level = opt_level & FLYUXC_OPT_LEVEL_MASK;
+    std::optional<llvm::PGOOptions> pgo = profile_options(instrument);
+    if (level == 0 && !pgo) return;
+    
+    // 使用新的 Pass Manager
+    // --time-report：按 pass 类名累计耗时。pass 管理器和适配器只是容器，
+    // 不单独计时，避免与其中的 pass 重复；CGSCC 等包含子 pass 的 pass 计的是含子 pass 的时间
+    llvm::PassInstrumentationCallbacks PIC;
+    std::vector<double> pass_starts;
+    if (time_report_enabled()) {
+        auto is_container = [](llvm::StringRef pass) {
+            return pass.contains("PassManager") || pass.contains("PassAdaptor");
+        };
+        PIC.registerBeforeNonSkippedPassCallback(
+            [&pass_starts, is_container](llvm::StringRef pass, llvm::Any) {
+                if (!is_container(pass)) pass_starts.push_back(time_report_now_ms());
+            });
+        auto after = [&pass_starts, is_container](llvm::StringRef pass) {
+            if (is_container(pass) || pass_starts.empty()) return;
+            double ms = time_report_now_ms() - pass_starts.back();
+            pass_starts.pop_back();
+            time_report_add_pass(pass.str().c_str(), ms);
+        };
+        PIC.registerAfterPassCallback(
+            [after](llvm::StringRef pass, llvm::Any, const llvm::PreservedAnalyses&) { after(pass); });
+        PIC.registerAfterPassInvalidatedCallback(
+            [after](llvm::StringRef pass, const llvm::PreservedAnalyses&) { after(pass); });
+    }
+    
+    // PGO 选项交给 PassBuilder：插桩 / 使用 profile 由各流水线在合适的位置加入
+    std::unique_ptr<PassPipeline> custom_pipeline;
+    if (pgo || time_report_enabled()) {
+        custom_pipeline = std::make_unique<PassPipeline>(pgo, time_report_enabled() ? &PIC : nullptr);
+    }
+    PassPipeline& pipeline = custom_pipeline ? *custom_pipeline : default_pass_pipeline();
+    llvm::PassBuilder& PB = pipeline.PB;
+    
+    llvm::OptimizationLevel pipeline_level = llvm::OptimizationLevel::O3;
+    if (level == 1) {
+        pipeline_level = llvm::OptimizationLevel::O1;
+    } else if (level == 2) {
+        pipeline_level = llvm::OptimizationLevel::O2;
+    } else if (level == FLYUXC_OPT_SIZE) {
+        pipeline_level = llvm::OptimizationLevel::Os;
+        // 与 clang -Os 一致：给函数加上 optsize，内联和代码生成也按体积取舍
+        for (llvm::Function& fn : *module) {
+            if (!fn.isDeclaration()) fn.addFnAttr(llvm::Attribute::OptimizeForSize);
+        }
+    }
     
-    if (opt_level == 1) {
-        MPM = PB.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O1);
-    } else if (opt_level == 2) {
-        MPM = PB.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O2);
+    llvm::ModulePassManager MPM;
+    if (level == 0) {
+        // -O0 只做 PGO 插桩 / 标注
+        MPM = PB.buildO0DefaultPipeline(llvm::OptimizationLevel::O0);
+    } else if (opt_level & FLYUXC_OPT_LTO) {
+        // 整程序模式：模块已包含运行时且除 main 外全部内部化。
+        // 与 clang -flto 相同，先跑 pre-link 流水线（PGO 插桩 / 标注在其中），再跑完整的 LTO 流水线
+        MPM = PB.buildLTOPreLinkDefaultPipeline(pipeline_level);
+        MPM.addPass(PB.buildLTODefaultPipeline(pipeline_level, nullptr));
     } else {
-        MPM = PB.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O3);
+        MPM = PB.buildPerModuleDefaultPipeline(pipeline_level);
     }
     
-    MPM.run(*module, MAM);
+    MPM.run(*module, pipeline.MAM);
+    pipeline.clear();
 }
 
-// 生成目标对象文件
-static bool generate_object_file(
-    llvm::Module* module,
-    const char* output_file,
+// 代码生成线程数（llvm_set_codegen_threads / -j）
+static unsigned g_codegen_threads = 1;
+
+// 创建目标机器；并行代码生成时每个分区线程各创建一个
+static std::unique_ptr<llvm::TargetMachine> create_target_machine(
+    const llvm::Target* target,
+    const std::string& target_triple,
     int opt_level
 ) {
-    initialize_llvm_targets();
+    // 每个函数 / 全局变量单独成段，链接时未引用的部分可以被 gc-sections 回收
+    llvm::TargetOptions opt;
+    opt.FunctionSections = true;
+    opt.DataSections = true;
+    std::optional<llvm::Reloc::Model> RM = std::nullopt;
     
-    // 获取目标三元组
-    std::string target_triple = llvm::sys::getDefaultTargetTriple();
-    module->setTargetTriple(target_triple);
+    return std::unique_ptr<llvm::TargetMachine>(
+        target->createTargetMachine(
+            target_triple,
+            llvm::sys::getHostCPUName(),
+            "",
+            opt,
+            RM,
+            std::nullopt,
+            codegen_opt_level(opt_level)
+        )
+    );
+}
+
+// 宿主目标机器，按代码生成优化级别各缓存一个，同一进程中的编译复用
+static llvm::TargetMachine* host_target_machine(int opt_level) {
+    static std::unique_ptr<llvm::TargetMachine> cache[4];
+    std::unique_ptr<llvm::TargetMachine>& cached = cache[static_cast<int>(codegen_opt_level(opt_level)) & 3];
+    if (cached) return cached.get();
+    
+    initialize_llvm_targets();
     
     // 查找目标
+    std::string target_triple = llvm::sys::getDefaultTargetTriple();
     std::string error;
     const llvm::Target* target = llvm::TargetRegistry::lookupTarget(target_triple, error);
     
     if (!target) {
         set_error("Failed to lookup target: " + error);
+        return nullptr;
+    }
+    
+    cached = create_target_machine(target, target_triple, opt_level);
+    if (!cached) {
+        set_error("Failed to create target machine");
+    }
+    return cached.get();
+}
+
+// 代码生成的分区数：不超过 -j，也不超过模块中定义的函数数
+static unsigned codegen_partition_count(llvm::Module* module) {
+#if defined(FLYUXC_USE_LLD) && defined(__APPLE__)
+    // ld64.lld 不支持 -r，分区无法合并为一个对象文件
+    (void)module;
+    return 1;
+#else
+    if (g_codegen_threads <= 1) return 1;
+    
+    unsigned defined_functions = 0;
+    for (const llvm::Function& function : *module) {
+        if (!function.isDeclaration()) defined_functions++;
+    }
+    return std::max(1u, std::min(g_codegen_threads, defined_functions));
+#endif
+}
+
+#if defined(FLYUXC_USE_LLD) && !defined(__APPLE__)
+// 把分区对象文件合并为一个可重定位对象文件（ld.lld -r），段名保持不变，gc-sections 仍然有效
+static bool merge_object_files(const std::vector<std::string>& inputs, const char* output_file) {
+    std::vector<const char*> argv = {"ld.lld", "-r", "-o", output_file};
+    for (const std::string& input : inputs) argv.push_back(input.c_str());
+    
+    std::string diagnostics;
+    llvm::raw_string_ostream diag_stream(diagnostics);
+    lld::Result result = lld::lldMain(argv, diag_stream, diag_stream, {{lld::Gnu, &lld::elf::link}});
+    diag_stream.flush();
+    
+    if (result.retCode != 0) {
+        set_error("Merging partitioned objects failed: " + diagnostics);
         return false;
     }
+    return true;
+}
+#elif !defined(FLYUXC_USE_LLD)
+// 把分区对象文件合并为一个可重定位对象文件（经由系统 clang 驱动 -r）
+static bool merge_object_files(const std::vector<std::string>& inputs, const char* output_file) {
+    std::string cmd = "clang -r -nostdlib -o \"";
+    cmd += output_file;
+    cmd += "\"";
+    for (const std::string& input : inputs) {
+        cmd += " \"";
+        cmd += input;
+        cmd += "\"";
+    }
+    cmd += " 2>&1";
     
-    // 创建目标机器
-    llvm::TargetOptions opt;
-    std::optional<llvm::Reloc::Model> RM = std::nullopt;
+    if (system(cmd.c_str()) != 0) {
+        set_error("Merging partitioned objects failed: " + cmd);
+        return false;
+    }
+    return true;
+}
+#else
+static bool merge_object_files(const std::vector<std::string>&, const char*) {
+    set_error("Merging partitioned objects is not supported by ld64.lld");
+    return false;
+}
+#endif
+
+// 并行代码生成：SplitModule 把模块分成 count 个分区，splitCodeGen 在各自的线程中
+// 用独立的 LLVMContext 和 TargetMachine 生成对象文件，最后合并为 output_file
+static bool emit_partitioned_object(
+    llvm::Module* module,
+    const char* output_file,
+    unsigned count,
+    const std::function<std::unique_ptr<llvm::TargetMachine>()>& make_target_machine
+) {
+    std::vector<std::string> part_files;
+    std::vector<std::unique_ptr<llvm::raw_fd_ostream>> streams;
+    std::vector<llvm::raw_pwrite_stream*> outputs;
+    bool ok = true;
     
-    std::unique_ptr<llvm::TargetMachine> target_machine(
-        target->createTargetMachine(
-            target_triple,
-            llvm::sys::getHostCPUName(),
-            "",
-            opt,
-            RM
-        )
-    );
+    for (unsigned i = 0; i < count; i++) {
+        char* path = create_temp_file("part_", ".o");
+        if (!path) {
+            set_error("Failed to create temporary object file");
+            ok = false;
+            break;
+        }
+        part_files.push_back(path);
+        free(path);
+        
+        std::error_code EC;
+        streams.push_back(std::make_unique<llvm::raw_fd_ostream>(part_files.back(), EC,
+                                                                 llvm::sys::fs::OF_None));
+        if (EC) {
+            set_error("Could not open file: " + EC.message());
+            ok = false;
+            break;
+        }
+        outputs.push_back(streams.back().get());
+    }
     
+    if (ok) {
+        llvm::splitCodeGen(*module, outputs, {}, make_target_machine,
+                           llvm::CodeGenFileType::ObjectFile);
+        streams.clear();  // 关闭分区文件后再合并
+        ok = merge_object_files(part_files, output_file);
+    }
+    
+    streams.clear();
+    for (const std::string& path : part_files) {
+        unlink(path.c_str());
+    }
+    return ok;
+}
+
+// 生成目标对象文件
+static bool generate_object_file(
+    llvm::Module* module,
+    const char* output_file,
+    int opt_level
+) {
+    // 目标机器（进程内缓存）
+    llvm::TargetMachine* target_machine = host_target_machine(opt_level);
     if (!target_machine) {
-        set_error("Failed to create target machine");
         return false;
     }
     
+    module->setTargetTriple(target_machine->getTargetTriple().str());
     module->setDataLayout(target_machine->createDataLayout());
     
     // 优化模块
-    optimize_module(module, opt_level);
+    int tr_optimize = time_report_begin("optimize");
+    optimize_module(module, opt_level, true);
+    time_report_end(tr_optimize);
+    report_module_counts(module, "ir_optimized");
+    
+    // -j：分区并行生成（分区数为 1 时走下面的单线程路径）
+    unsigned partitions = codegen_partition_count(module);
+    time_report_count("codegen_partitions", partitions);
+    if (partitions > 1) {
+        int tr_emit = time_report_begin("emit_object");
+        bool ok = emit_partitioned_object(module, output_file, partitions,
+            [target_machine, opt_level]() {
+                return create_target_machine(&target_machine->getTarget(),
+                                             target_machine->getTargetTriple().str(), opt_level);
+            });
+        if (ok) time_report_end(tr_emit);
+        return ok;
+    }
     
     // 输出对象文件
     std::error_code EC;
@@ -199,6 +636,7 @@ static bool generate_object_file(
         return false;
     }
     
+    int tr_emit = time_report_begin("emit_object");
     llvm::legacy::PassManager pass;
     if (target_machine->addPassesToEmitFile(pass, dest, nullptr, 
                                            llvm::CodeGenFileType::ObjectFile)) {
@@ -208,11 +646,276 @@ static bool generate_object_file(
     
     pass.run(*module);
     dest.flush();
+    time_report_end(tr_emit);
+    
+    return true;
+}
+
+#ifdef FLYUXC_RUNTIME_BITCODE
+// 将嵌入的运行时 bitcode 链接进用户模块（在优化之前）
+// 只拉入用户代码实际引用的运行时符号，并将其内部化，
+// 使 box/unbox/retain/release 等函数可以被内联，未使用的部分由 GlobalDCE 删除
+// whole_program 为 true 时（--lto）用户模块的符号也一并内部化，只保留 main
+static bool link_runtime_bitcode(llvm::Module* module, bool whole_program) {
+    llvm::StringRef data(reinterpret_cast<const char*>(runtime_bitcode_bc),
+                         runtime_bitcode_bc_len);
+    llvm::MemoryBufferRef buffer(data, "runtime.bc");
+
+    llvm::Expected<std::unique_ptr<llvm::Module>> runtime_or_err =
+        llvm::parseBitcodeFile(buffer, module->getContext());
+    if (!runtime_or_err) {
+        set_error("Failed to load runtime bitcode: " +
+                  llvm::toString(runtime_or_err.takeError()));
+        return false;
+    }
+
+    std::unique_ptr<llvm::Module> runtime = std::move(*runtime_or_err);
+    // 目标三元组和数据布局稍后统一设置，这里先对齐以避免链接器警告
+    runtime->setTargetTriple(module->getTargetTriple());
+    runtime->setDataLayout(module->getDataLayout());
+
+    bool failed = llvm::Linker::linkModules(
+        *module, std::move(runtime), llvm::Linker::Flags::LinkOnlyNeeded,
+        [whole_program](llvm::Module& merged, const llvm::StringSet<>& runtime_symbols) {
+            if (whole_program) {
+                llvm::internalizeModule(merged, [](const llvm::GlobalValue& gv) {
+                    return gv.getName() == "main";
+                });
+                return;
+            }
+            // 保留用户模块自身的符号（包括 main），内部化所有来自运行时的符号
+            llvm::internalizeModule(merged, [&runtime_symbols](const llvm::GlobalValue& gv) {
+                return !gv.hasName() || runtime_symbols.count(gv.getName()) == 0;
+            });
+        });
+
+    if (failed) {
+        set_error("Failed to link runtime bitcode into module");
+        return false;
+    }
+
+    return true;
+}
+#endif
+
+#ifdef FLYUXC_USE_LLD
+// 在候选目录中查找文件，返回第一个存在的完整路径
+static std::string find_in_dirs(const std::vector<std::string>& dirs, const std::string& name) {
+    for (const std::string& dir : dirs) {
+        std::string path = dir + "/" + name;
+        if (llvm::sys::fs::exists(path)) return path;
+    }
+    return "";
+}
+
+// --profile-generate：插桩代码依赖 compiler-rt 的 profile 运行时（负责在退出时写出 .profraw）
+static std::string find_profile_runtime(const llvm::Triple& triple) {
+#ifdef FLYUXC_CLANG_RESOURCE_DIR
+    std::string lib = std::string(FLYUXC_CLANG_RESOURCE_DIR) + "/lib";
+#if defined(__APPLE__)
+    (void)triple;
+    return find_in_dirs({lib + "/darwin"}, "libclang_rt.profile_osx.a");
+#else
+    // 新布局按目标三元组分目录，旧布局文件名带架构后缀
+    std::string path = find_in_dirs({lib + "/" + triple.str()}, "libclang_rt.profile.a");
+    if (path.empty()) {
+        path = find_in_dirs({lib + "/linux"}, "libclang_rt.profile-" + triple.getArchName().str() + ".a");
+    }
+    return path;
+#endif
+#else
+    (void)triple;
+    return "";
+#endif
+}
+
+// 插桩构建需要的链接输入；找不到 profile 运行时时报错
+static bool add_profile_runtime(std::vector<std::string>& args, const llvm::Triple& triple) {
+    if (g_profile.generate_file.empty()) return true;
     
+    std::string runtime = find_profile_runtime(triple);
+    if (runtime.empty()) {
+        set_error("Linking failed: compiler-rt profile runtime (libclang_rt.profile) not found, "
+                  "required by --profile-generate");
+        return false;
+    }
+#if !defined(__APPLE__)
+    // ELF 上插桩 pass 不生成对运行时的引用，由链接器 -u 拉入（与 clang 驱动一致）
+    args.push_back("-u__llvm_profile_runtime");
+#endif
+    args.push_back(runtime);
+    return true;
+}
+
+#if defined(__APPLE__)
+// Mach-O：-dead_strip 回收未引用的函数和数据，系统库来自 SDK
+static bool build_link_args(
+    std::vector<std::string>& args,
+    const char* main_obj,
+    const char* runtime_obj,
+    const char* output_file
+) {
+    llvm::Triple triple(llvm::sys::getProcessTriple());
+    llvm::VersionTuple os_version;
+    triple.getMacOSXVersion(os_version);
+
+    // 优先使用 SDKROOT，其次是 Command Line Tools / Xcode 的默认 SDK
+    std::string sdk;
+    const char* sdkroot = getenv("SDKROOT");
+    if (sdkroot && *sdkroot) {
+        sdk = sdkroot;
+    } else {
+        const char* candidates[] = {
+            "/Library/Developer/CommandLineTools/SDKs/MacOSX.sdk",
+            "/Applications/Xcode.app/Contents/Developer/Platforms/MacOSX.platform/Developer/SDKs/MacOSX.sdk",
+        };
+        for (const char* candidate : candidates) {
+            if (llvm::sys::fs::exists(candidate)) {
+                sdk = candidate;
+                break;
+            }
+        }
+    }
+    if (sdk.empty()) {
+        set_error("Linking failed: macOS SDK not found (set SDKROOT)");
+        return false;
+    }
+
+    std::string version = os_version.getAsString();
+    args = {
+        "ld64.lld",
+        "-arch", triple.getArchName().str() == "aarch64" ? "arm64" : triple.getArchName().str(),
+        "-platform_version", "macos", version, version,
+        "-syslibroot", sdk,
+        "-dead_strip",
+        "-o", output_file,
+        main_obj,
+    };
+    if (runtime_obj) args.push_back(runtime_obj);
+    if (!add_profile_runtime(args, triple)) return false;
+    args.push_back("-lSystem");
+    return true;
+}
+#else
+// 查找 GCC 运行时目录（crtbegin.o / libgcc），取版本号最高的一个
+static std::string find_gcc_lib_dir(const std::string& multiarch) {
+    std::string best;
+    llvm::VersionTuple best_version;
+    const std::string roots[] = {
+        "/usr/lib/gcc/" + multiarch,
+        "/usr/lib64/gcc/" + multiarch,
+        "/usr/lib/gcc/" + multiarch.substr(0, multiarch.find('-')) + "-redhat-linux",
+    };
+    for (const std::string& root : roots) {
+        std::error_code ec;
+        for (llvm::sys::fs::directory_iterator it(root, ec), end; it != end && !ec; it.increment(ec)) {
+            llvm::VersionTuple version;
+            std::string name = llvm::sys::path::filename(it->path()).str();
+            if (version.tryParse(name)) continue;
+            if (!llvm::sys::fs::exists(it->path() + "/crtbegin.o")) continue;
+            if (best.empty() || version > best_version) {
+                best = it->path();
+                best_version = version;
+            }
+        }
+    }
+    return best;
+}
+
+// ELF（glibc）：自行拼出 clang 驱动原本会给的启动文件、系统库和动态链接器，
+// --gc-sections 配合 -ffunction-sections / -fdata-sections 回收未引用的段
+static bool build_link_args(
+    std::vector<std::string>& args,
+    const char* main_obj,
+    const char* runtime_obj,
+    const char* output_file
+) {
+    llvm::Triple triple(llvm::sys::getProcessTriple());
+    std::string arch = triple.getArchName().str();
+    std::string multiarch = arch + "-linux-gnu";
+
+    const char* dynamic_linker = nullptr;
+    switch (triple.getArch()) {
+        case llvm::Triple::x86_64:  dynamic_linker = "/lib64/ld-linux-x86-64.so.2"; break;
+        case llvm::Triple::aarch64: dynamic_linker = "/lib/ld-linux-aarch64.so.1"; break;
+        default:
+            set_error("Linking failed: unsupported host architecture " + arch);
+            return false;
+    }
+
+    std::vector<std::string> lib_dirs = {
+        "/usr/lib/" + multiarch, "/lib/" + multiarch, "/usr/lib64", "/lib64", "/usr/lib", "/lib",
+    };
+    std::string crt1 = find_in_dirs(lib_dirs, "crt1.o");
+    std::string crti = find_in_dirs(lib_dirs, "crti.o");
+    std::string crtn = find_in_dirs(lib_dirs, "crtn.o");
+    if (crt1.empty() || crti.empty() || crtn.empty()) {
+        set_error("Linking failed: C runtime startup files (crt1.o/crti.o/crtn.o) not found");
+        return false;
+    }
+    std::string gcc_dir = find_gcc_lib_dir(multiarch);
+
+    args = {
+        "ld.lld",
+        "--gc-sections",
+        "--eh-frame-hdr",
+        "-dynamic-linker", dynamic_linker,
+        "-o", output_file,
+        crt1, crti,
+    };
+    if (!gcc_dir.empty()) args.push_back(gcc_dir + "/crtbegin.o");
+    args.push_back(main_obj);
+    if (runtime_obj) args.push_back(runtime_obj);
+    if (!add_profile_runtime(args, triple)) return false;
+    if (!gcc_dir.empty()) args.push_back("-L" + gcc_dir);
+    for (const std::string& dir : lib_dirs) {
+        if (llvm::sys::fs::is_directory(dir)) args.push_back("-L" + dir);
+    }
+    args.insert(args.end(), {"-lm", "-lc"});
+    if (!gcc_dir.empty()) {
+        args.insert(args.end(), {"-lgcc", "--as-needed", "-lgcc_s", "--no-as-needed"});
+        args.push_back(gcc_dir + "/crtend.o");
+    }
+    args.push_back(crtn);
     return true;
 }
+#endif
+
+// 链接对象文件生成可执行文件（进程内调用 LLD，不依赖外部 clang）
+// runtime_obj 为 NULL 时表示运行时已经以 bitcode 形式链接进主对象文件
+static bool link_object_files(
+    const char* main_obj,
+    const char* runtime_obj,
+    const char* output_file
+) {
+    std::vector<std::string> args;
+    if (!build_link_args(args, main_obj, runtime_obj, output_file)) {
+        return false;
+    }
+
+    std::vector<const char*> argv;
+    argv.reserve(args.size());
+    for (const std::string& arg : args) argv.push_back(arg.c_str());
+
+    std::string diagnostics;
+    llvm::raw_string_ostream diag_stream(diagnostics);
+#if defined(__APPLE__)
+    lld::Result result = lld::lldMain(argv, diag_stream, diag_stream, {{lld::Darwin, &lld::macho::link}});
+#else
+    lld::Result result = lld::lldMain(argv, diag_stream, diag_stream, {{lld::Gnu, &lld::elf::link}});
+#endif
+    diag_stream.flush();
+
+    if (result.retCode != 0) {
+        set_error("Linking failed: " + diagnostics);
+        return false;
+    }
 
-// 链接对象文件生成可执行文件
+    return true;
+}
+#else
+// 链接对象文件生成可执行文件（未启用 FLYUXC_LLD 时经由系统 clang 驱动）
+// runtime_obj 为 NULL 时表示运行时已经以 bitcode 形式链接进主对象文件
 static bool link_object_files(
     const char* main_obj,
     const char* runtime_obj,
@@ -223,11 +926,22 @@ static bool link_object_files(
     cmd += output_file;
     cmd += "\" \"";
     cmd += main_obj;
-    cmd += "\" \"";
-    cmd += runtime_obj;
+    if (runtime_obj) {
+        cmd += "\" \"";
+        cmd += runtime_obj;
+    }
+    cmd += "\"";
+    // 插桩构建：由 clang 驱动加入 profile 运行时
+    if (!g_profile.generate_file.empty()) {
+        cmd += " -fprofile-generate";
+    }
+#if defined(__APPLE__)
     // macOS: -Wl,-dead_strip 移除未使用的函数和数据
+    cmd += " -Wl,-dead_strip 2>&1";
+#else
     // Linux: -Wl,--gc-sections 配合 -ffunction-sections 使用
-    cmd += "\" -Wl,-dead_strip 2>&1";
+    cmd += " -Wl,--gc-sections 2>&1";
+#endif
     
     int result = system(cmd.c_str());
     
@@ -238,6 +952,230 @@ static bool link_object_files(
     
     return true;
 }
+#endif
+
+// 运行时是否以 bitcode 形式链接进主对象文件（未显式指定运行时对象文件，或整程序模式）
+static bool runtime_in_object(const char* runtime_obj, int opt_level) {
+#ifdef FLYUXC_RUNTIME_BITCODE
+    return (opt_level & FLYUXC_OPT_LTO) || !runtime_obj || strlen(runtime_obj) == 0;
+#else
+    (void)runtime_obj;
+    (void)opt_level;
+    return false;
+#endif
+}
+
+// 验证、优化并生成主对象文件（文件输入与内存输入共用）
+static int compile_module_to_object(
+    llvm::Module* module,
+    const char* runtime_obj,
+    const char* object_file,
+    int opt_level
+) {
+    // 验证模块
+    int tr_verify = time_report_begin("verify");
+    if (!verify_module(module)) {
+        return 2;
+    }
+    time_report_end(tr_verify);
+    report_module_counts(module, "ir");
+    
+#ifdef FLYUXC_RUNTIME_BITCODE
+    // 未显式指定运行时对象文件时，将运行时 bitcode 链接进模块后再优化
+    if (runtime_in_object(runtime_obj, opt_level)) {
+        int tr_link_bc = time_report_begin("link_runtime_bitcode");
+        if (!link_runtime_bitcode(module, (opt_level & FLYUXC_OPT_LTO) != 0)) {
+            return 4;
+        }
+        time_report_end(tr_link_bc);
+    }
+#else
+    if (opt_level & FLYUXC_OPT_LTO) {
+        set_error("Whole-program mode (--lto) needs the runtime bitcode; "
+                  "rebuild flyuxc with -DFLYUXC_RUNTIME_BITCODE=ON");
+        return 4;
+    }
+#endif
+    
+    // 生成主程序的对象文件
+    if (!generate_object_file(module, object_file, opt_level)) {
+        return 3;
+    }
+    report_file_size(object_file, "object_bytes");
+    
+    return 0;
+}
+
+// 将主对象文件与运行时链接为可执行文件
+static int link_executable(
+    const char* object_file,
+    const char* runtime_obj,
+    const char* output_file,
+    int opt_level
+) {
+    // 使用嵌入的运行时对象文件
+    RuntimeObjectFile embedded_runtime_obj = {"", false};
+    bool in_object = runtime_in_object(runtime_obj, opt_level);
+    const char* actual_runtime_obj = in_object ? nullptr : runtime_obj;
+    
+    if (!in_object && (!runtime_obj || strlen(runtime_obj) == 0)) {
+        embedded_runtime_obj = get_runtime_object_file();
+        if (embedded_runtime_obj.path.empty()) {
+            return 4;
+        }
+        actual_runtime_obj = embedded_runtime_obj.path.c_str();
+    }
+    
+    // 链接生成可执行文件
+    int tr_link = time_report_begin("link");
+    bool linked = link_object_files(object_file, actual_runtime_obj, output_file);
+    
+    // 清理临时文件（共享的运行时对象文件保留给后续编译）
+    if (embedded_runtime_obj.temporary && !embedded_runtime_obj.path.empty()) {
+        unlink(embedded_runtime_obj.path.c_str());
+    }
+    if (!linked) {
+        return 5;
+    }
+    time_report_end(tr_link);
+    report_file_size(output_file, "executable_bytes");
+    
+    return 0;
+}
+
+// 验证、优化并生成可执行文件（文件输入与内存输入共用）
+static int compile_module_to_executable(
+    llvm::Module* module,
+    const char* runtime_obj,
+    const char* output_file,
+    int opt_level
+) {
+    // 主对象文件使用唯一的临时路径，同一目录下的并行编译互不干扰
+    char* temp_main_obj = create_temp_file("main_", ".o");
+    if (!temp_main_obj) {
+        set_error("Failed to create temporary object file");
+        return 3;
+    }
+    
+    int result = compile_module_to_object(module, runtime_obj, temp_main_obj, opt_level);
+    if (result == 0) {
+        result = link_executable(temp_main_obj, runtime_obj, output_file, opt_level);
+    }
+    
+    unlink(temp_main_obj);
+    free(temp_main_obj);
+    return result;
+}
+
+// 在进程内 JIT 执行模块的 main（flyuxc run），不生成对象文件也不链接
+// 运行时符号直接从编译器进程解析：value_runtime.c 已链接进 flyuxc，可执行文件导出了这些符号
+static int run_module_jit(
+    std::unique_ptr<llvm::LLVMContext> context,
+    std::unique_ptr<llvm::Module> module,
+    int opt_level,
+    bool lazy,
+    int* exit_code
+) {
+    // 运行时来自编译器进程本身，没有可合并的 bitcode，整程序模式退化为普通优化
+    opt_level &= FLYUXC_OPT_LEVEL_MASK;
+    
+    int tr_verify = time_report_begin("verify");
+    if (!verify_module(module.get())) {
+        return 2;
+    }
+    time_report_end(tr_verify);
+    report_module_counts(module.get(), "ir");
+    
+    initialize_llvm_targets();
+    
+    int tr_setup = time_report_begin("jit_setup");
+    auto jtmb = llvm::orc::JITTargetMachineBuilder::detectHost();
+    if (!jtmb) {
+        set_error("Failed to detect host target: " + llvm::toString(jtmb.takeError()));
+        return 3;
+    }
+    // JIT 内存可能远离进程映像，按 PIC 生成代码，避免常量地址被编码成 32 位绝对地址
+    jtmb->setRelocationModel(llvm::Reloc::PIC_);
+    jtmb->setCodeGenOptLevel(codegen_opt_level(opt_level));
+    
+    // 惰性模式下每个函数在第一次被调用时才编译（LLLazyJIT 默认按被请求的函数划分模块）
+    std::unique_ptr<llvm::orc::LLJIT> jit;
+    llvm::orc::LLLazyJIT* lazy_jit = nullptr;
+    if (lazy) {
+        auto built = llvm::orc::LLLazyJITBuilder()
+                         .setJITTargetMachineBuilder(std::move(*jtmb))
+                         .create();
+        if (!built) {
+            set_error("Failed to create JIT: " + llvm::toString(built.takeError()));
+            return 3;
+        }
+        lazy_jit = built->get();
+        jit = std::move(*built);
+    } else {
+        auto built = llvm::orc::LLJITBuilder()
+                         .setJITTargetMachineBuilder(std::move(*jtmb))
+                         .create();
+        if (!built) {
+            set_error("Failed to create JIT: " + llvm::toString(built.takeError()));
+            return 3;
+        }
+        jit = std::move(*built);
+    }
+    
+    llvm::orc::JITDylib& dylib = jit->getMainJITDylib();
+    auto process_symbols = llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+        jit->getDataLayout().getGlobalPrefix());
+    if (!process_symbols) {
+        set_error("Failed to expose runtime symbols to JIT: " +
+                  llvm::toString(process_symbols.takeError()));
+        return 4;
+    }
+    dylib.addGenerator(std::move(*process_symbols));
+    
+    // 优化在模块（惰性模式下是每个函数划分出的子模块）真正编译前进行
+    jit->getIRTransformLayer().setTransform(
+        [opt_level](llvm::orc::ThreadSafeModule tsm, const llvm::orc::MaterializationResponsibility&)
+            -> llvm::Expected<llvm::orc::ThreadSafeModule> {
+            tsm.withModuleDo([opt_level](llvm::Module& m) { optimize_module(&m, opt_level, false); });
+            return std::move(tsm);
+        });
+    
+    module->setTargetTriple(jit->getTargetTriple().str());
+    module->setDataLayout(jit->getDataLayout());
+    llvm::orc::ThreadSafeModule tsm(std::move(module), std::move(context));
+    llvm::Error added = lazy_jit ? lazy_jit->addLazyIRModule(std::move(tsm))
+                                 : jit->addIRModule(std::move(tsm));
+    if (added) {
+        set_error("Failed to add module to JIT: " + llvm::toString(std::move(added)));
+        return 3;
+    }
+    time_report_end(tr_setup);
+    
+    // 执行 llvm.global_ctors（如 .intern_keys），再查找 main；非惰性模式下这一步编译整个模块
+    int tr_compile = time_report_begin("jit_compile");
+    if (llvm::Error err = jit->initialize(dylib)) {
+        set_error("Failed to run static constructors: " + llvm::toString(std::move(err)));
+        return 3;
+    }
+    auto main_addr = jit->lookup("main");
+    if (!main_addr) {
+        set_error("Failed to find main: " + llvm::toString(main_addr.takeError()));
+        return 3;
+    }
+    time_report_end(tr_compile);
+    
+    int tr_execute = time_report_begin("execute");
+    auto* main_fn = main_addr->toPtr<int (*)()>();
+    *exit_code = main_fn();
+    fflush(stdout);
+    time_report_end(tr_execute);
+    
+    if (llvm::Error err = jit->deinitialize(dylib)) {
+        llvm::consumeError(std::move(err));
+    }
+    
+    return 0;
+}
 
 extern "C" {
 
@@ -258,80 +1196,223 @@ int llvm_compile_to_executable(
         llvm::LLVMContext context;
         
         // 加载 IR 模块
+        int tr_parse = time_report_begin("parse_ir");
         auto module = load_ir_module(context, ir_file);
+        time_report_end(tr_parse);
         if (!module) {
             return 1;
         }
         
-        // 验证模块
-        if (!verify_module(module.get())) {
-            return 2;
+        return compile_module_to_executable(module.get(), runtime_obj, output_file, opt_level);
+        
+    } catch (const std::exception& e) {
+        set_error(std::string("Exception: ") + e.what());
+        return 6;
+    }
+}
+
+// 解析 codegen 输出的 IR 文本，计入 time report 的 parse_ir 阶段
+static std::unique_ptr<llvm::Module> parse_codegen_ir(
+    llvm::LLVMContext& context,
+    const char* ir_code
+) {
+    if (!ir_code) {
+        set_error("No IR code provided");
+        return nullptr;
+    }
+    
+    int tr_parse = time_report_begin("parse_ir");
+    auto module = parse_ir_buffer(context, ir_code, "flyux_module");
+    time_report_end(tr_parse);
+    if (!module) return nullptr;
+    
+    // 文本中只声明的统一调用入口，在这里用 IRBuilder 补上函数体
+    int tr_build = time_report_begin("irbuilder");
+    std::string build_error;
+    bool built = codegen_build_function_entries(*module, build_error);
+    time_report_end(tr_build);
+    if (!built) {
+        set_error("Failed to build function entries: " + build_error);
+        return nullptr;
+    }
+    return module;
+}
+
+int llvm_compile_string_to_executable(
+    const char* ir_code,
+    const char* runtime_obj,
+    const char* output_file,
+    int opt_level
+) {
+    try {
+        g_last_error.clear();
+        
+        llvm::LLVMContext context;
+        auto module = parse_codegen_ir(context, ir_code);
+        if (!module) {
+            return 1;
         }
         
-        // 生成主程序的对象文件
-        std::string temp_main_obj = std::string(output_file) + ".main.o";
+        return compile_module_to_executable(module.get(), runtime_obj, output_file, opt_level);
         
-        if (!generate_object_file(module.get(), temp_main_obj.c_str(), opt_level)) {
-            return 3;
+    } catch (const std::exception& e) {
+        set_error(std::string("Exception: ") + e.what());
+        return 6;
+    }
+}
+
+int llvm_compile_string_to_object(
+    const char* ir_code,
+    const char* runtime_obj,
+    const char* object_file,
+    int opt_level
+) {
+    try {
+        g_last_error.clear();
+        
+        llvm::LLVMContext context;
+        auto module = parse_codegen_ir(context, ir_code);
+        if (!module) {
+            return 1;
         }
         
-        // 使用嵌入的运行时对象文件
-        std::string embedded_runtime_obj;
-        const char* actual_runtime_obj = runtime_obj;
+        // 对象文件可能是缓存条目的硬链接，先删除再写，避免原地改写缓存
+        unlink(object_file);
+        return compile_module_to_object(module.get(), runtime_obj, object_file, opt_level);
+        
+    } catch (const std::exception& e) {
+        set_error(std::string("Exception: ") + e.what());
+        return 6;
+    }
+}
+
+int llvm_link_executable(
+    const char* object_file,
+    const char* runtime_obj,
+    const char* output_file,
+    int opt_level
+) {
+    try {
+        g_last_error.clear();
+        return link_executable(object_file, runtime_obj, output_file, opt_level);
+    } catch (const std::exception& e) {
+        set_error(std::string("Exception: ") + e.what());
+        return 6;
+    }
+}
+
+void llvm_warm_up(void) {
+    initialize_llvm_targets();
+    
+    // 各代码生成优化级别的目标机器（-O0 / 默认 / -O3）
+    host_target_machine(0);
+    host_target_machine(1);
+    host_target_machine(3);
+    default_pass_pipeline();
+    
+    // 运行时对象文件物化到共享位置；只能写临时文件时不预先写出
+    RuntimeObjectFile runtime_obj = get_runtime_object_file();
+    if (runtime_obj.temporary && !runtime_obj.path.empty()) {
+        unlink(runtime_obj.path.c_str());
+    }
+}
+
+void llvm_set_codegen_threads(int threads) {
+    g_codegen_threads = threads > 0
+        ? (unsigned)threads
+        : llvm::heavyweight_hardware_concurrency().compute_thread_count();
+}
+
+int llvm_set_profile(const char* generate_file, const char* use_file) {
+    try {
+        g_last_error.clear();
+        g_profile.generate_file = generate_file ? generate_file : "";
+        g_profile.use_fs = nullptr;
         
-        if (!runtime_obj || strlen(runtime_obj) == 0) {
-            embedded_runtime_obj = write_embedded_runtime_object();
-            if (embedded_runtime_obj.empty()) {
-                unlink(temp_main_obj.c_str());
-                return 4;
+        if (use_file) {
+            std::unique_ptr<llvm::MemoryBuffer> merged = merge_profiles({use_file});
+            if (!merged) {
+                return 1;
             }
-            actual_runtime_obj = embedded_runtime_obj.c_str();
+            auto fs = llvm::makeIntrusiveRefCnt<llvm::vfs::InMemoryFileSystem>();
+            fs->addFile(PROFILE_USE_PATH, 0, std::move(merged));
+            g_profile.use_fs = fs;
         }
         
-        // 链接生成可执行文件
-        if (!link_object_files(temp_main_obj.c_str(), actual_runtime_obj, output_file)) {
-            unlink(temp_main_obj.c_str());
-            if (!embedded_runtime_obj.empty()) {
-                unlink(embedded_runtime_obj.c_str());
-            }
-            return 5;
+        return 0;
+    } catch (const std::exception& e) {
+        set_error(std::string("Exception: ") + e.what());
+        return 6;
+    }
+}
+
+int llvm_profile_merge(const char* const* inputs, int count, const char* output_file) {
+    try {
+        g_last_error.clear();
+        
+        std::unique_ptr<llvm::MemoryBuffer> merged =
+            merge_profiles(std::vector<std::string>(inputs, inputs + count));
+        if (!merged) {
+            return 1;
         }
         
-        // 清理临时文件
-        unlink(temp_main_obj.c_str());
-        if (!embedded_runtime_obj.empty()) {
-            unlink(embedded_runtime_obj.c_str());
+        std::error_code EC;
+        llvm::raw_fd_ostream out(output_file, EC, llvm::sys::fs::OF_None);
+        if (EC) {
+            set_error("Could not open file: " + EC.message());
+            return 1;
         }
+        out << merged->getBuffer();
         
         return 0;
-        
     } catch (const std::exception& e) {
         set_error(std::string("Exception: ") + e.what());
         return 6;
     }
 }
 
-int llvm_compile_string_to_executable(
+const char* llvm_target_description(void) {
+    static std::string description;
+    if (description.empty()) {
+        description = llvm::sys::getDefaultTargetTriple() + "/" + llvm::sys::getHostCPUName().str();
+    }
+    return description.c_str();
+}
+
+int llvm_run_string_jit(
     const char* ir_code,
-    const char* runtime_obj,
-    const char* output_file,
-    int opt_level
+    int opt_level,
+    int lazy,
+    int* exit_code
 ) {
-    const char* temp_file = "/tmp/flyuxc_temp.ll";
-    FILE* f = fopen(temp_file, "w");
-    if (!f) {
-        set_error("Failed to create temporary file");
-        return 1;
+    try {
+        g_last_error.clear();
+        
+        // ThreadSafeModule 需要接管上下文的所有权，上下文放在堆上
+        auto context = std::make_unique<llvm::LLVMContext>();
+        auto module = parse_codegen_ir(*context, ir_code);
+        if (!module) {
+            return 1;
+        }
+        
+        return run_module_jit(std::move(context), std::move(module), opt_level, lazy != 0, exit_code);
+        
+    } catch (const std::exception& e) {
+        set_error(std::string("Exception: ") + e.what());
+        return 6;
     }
-    
-    fprintf(f, "%s", ir_code);
-    fclose(f);
-    
-    int result = llvm_compile_to_executable(temp_file, runtime_obj, output_file, opt_level);
-    
-    unlink(temp_file);
-    
-    return result;
+}
+
+const unsigned char* llvm_embedded_runtime(size_t* len, int* in_object) {
+#ifdef FLYUXC_RUNTIME_BITCODE
+    *len = runtime_bitcode_bc_len;
+    *in_object = 1;
+    return runtime_bitcode_bc;
+#else
+    *len = runtime_object_o_len;
+    *in_object = 0;
+    return runtime_object_o;
+#endif
 }
 
 } // extern "C"
@@ -7,6 +7,7 @@
 /* Runtime support functions for FLYUX mixed-type system */
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <math.h>
 #include <unistd.h>
@@ -71,6 +72,9 @@ static int should_use_colors() {
 
 #include "value_runtime_state.c"
 #include "value_runtime_value.c"
+#include "value_runtime_alloc.c"
+#include "value_runtime_symbol.c"
+#include "value_runtime_shape.c"
 #include "value_runtime_ext.c"
 #include "value_runtime_io.c"
 #include "value_runtime_state_check.c"
@@ -80,4 +84,5 @@ static int should_use_colors() {
 #include "value_runtime_file.c"
 #include "value_runtime_json.c"
 #include "value_runtime_math.c"
+#include "value_runtime_compact.c"
 
@@ -0,0 +1,246 @@
+/*
+ * Module: value_runtime_alloc.c
+ * Value 头与元素数组的分配器
+ */
+
+/* ============================================================================
+ * 分配器
+ *
+ * FLYUX_POOL_ALLOC=1（默认）：
+ *   - Value 头：线程本地空闲链表，按 slab 批量向 malloc 申请
+ *   - 数组元素 / ObjectEntry 表：按大小分级的线程本地池，
+ *     超过最大级别的缓冲区直接走 malloc
+ * FLYUX_POOL_ALLOC=0：全部直接使用 malloc/realloc/free，用于基准对比
+ *
+ * 两种模式都统计分配次数；设置环境变量 FLYUX_ALLOC_STATS 后，
+ * 程序退出时把统计打印到 stderr。
+ *
+ * 约定：arr/obj 的 data.pointer 必须来自 pool_alloc_buf 系列函数，
+ * Value 本身必须来自 pool_alloc_value（返回时 shape 已清零）。
+ * ============================================================================ */
+
+#ifndef FLYUX_POOL_ALLOC
+#define FLYUX_POOL_ALLOC 1
+#endif
+
+typedef struct {
+    unsigned long value_allocs;
+    unsigned long value_frees;
+    unsigned long value_slabs;
+    unsigned long buf_allocs;
+    unsigned long buf_frees;
+    unsigned long buf_reallocs;
+    unsigned long buf_large;    /* 超出最大级别，直接 malloc */
+    unsigned long buf_slabs;
+} AllocStats;
+
+static AllocStats alloc_stats;
+static int alloc_stats_checked = 0;
+
+static void alloc_stats_report(void) {
+    fprintf(stderr,
+            "[FLYUX alloc] mode=%s\n"
+            "  values : alloc=%lu free=%lu slabs=%lu\n"
+            "  buffers: alloc=%lu free=%lu realloc=%lu large=%lu slabs=%lu\n",
+            FLYUX_POOL_ALLOC ? "pool" : "malloc",
+            alloc_stats.value_allocs, alloc_stats.value_frees, alloc_stats.value_slabs,
+            alloc_stats.buf_allocs, alloc_stats.buf_frees, alloc_stats.buf_reallocs,
+            alloc_stats.buf_large, alloc_stats.buf_slabs);
+}
+
+/* 首次分配时检查 FLYUX_ALLOC_STATS，决定是否在退出时打印统计 */
+static void alloc_stats_check(void) {
+    if (alloc_stats_checked) return;
+    alloc_stats_checked = 1;
+    if (getenv("FLYUX_ALLOC_STATS")) {
+        atexit(alloc_stats_report);
+    }
+}
+
+#if FLYUX_POOL_ALLOC
+
+/* 空闲块链表节点（复用块本身的内存） */
+typedef struct PoolNode {
+    struct PoolNode *next;
+} PoolNode;
+
+/* ---------------------------------------------------------------------------
+ * Value 头
+ * --------------------------------------------------------------------------- */
+
+#define VALUE_SLAB_COUNT 256
+
+static __thread PoolNode *value_free_list = NULL;
+
+static int value_pool_refill(void) {
+    alloc_stats_check();
+    Value *slab = (Value*)malloc(sizeof(Value) * VALUE_SLAB_COUNT);
+    if (!slab) return 0;
+    alloc_stats.value_slabs++;
+    for (int i = VALUE_SLAB_COUNT - 1; i >= 0; i--) {
+        PoolNode *node = (PoolNode*)&slab[i];
+        node->next = value_free_list;
+        value_free_list = node;
+    }
+    return 1;
+}
+
+Value* pool_alloc_value(void) {
+    alloc_stats.value_allocs++;
+    if (!value_free_list && !value_pool_refill()) return NULL;
+    PoolNode *node = value_free_list;
+    value_free_list = node->next;
+    Value *v = (Value*)node;
+    v->shape = 0;  /* 调用方只初始化自己关心的字段，形状默认为未跟踪 */
+    return v;
+}
+
+void pool_free_value(Value *v) {
+    if (!v) return;
+    alloc_stats.value_frees++;
+    PoolNode *node = (PoolNode*)v;
+    node->next = value_free_list;
+    value_free_list = node;
+}
+
+/* ---------------------------------------------------------------------------
+ * 分级缓冲区：块前有 16 字节头，记录级别和可用容量
+ * --------------------------------------------------------------------------- */
+
+#define BUF_CLASS_COUNT 8
+#define BUF_CLASS_LARGE ((size_t)-1)
+#define BUF_SLAB_BYTES  16384
+
+static const size_t buf_class_size[BUF_CLASS_COUNT] = {
+    16, 32, 64, 128, 256, 512, 1024, 2048
+};
+
+typedef struct {
+    size_t size_class;  /* 级别下标，或 BUF_CLASS_LARGE */
+    size_t capacity;    /* 可用字节数 */
+} BufHeader;
+
+static __thread PoolNode *buf_free_lists[BUF_CLASS_COUNT];
+
+static int buf_class_for(size_t size) {
+    for (int i = 0; i < BUF_CLASS_COUNT; i++) {
+        if (size <= buf_class_size[i]) return i;
+    }
+    return -1;
+}
+
+static int buf_pool_refill(int cls) {
+    alloc_stats_check();
+    size_t block = sizeof(BufHeader) + buf_class_size[cls];
+    size_t count = BUF_SLAB_BYTES / block;
+    if (count < 4) count = 4;
+
+    char *slab = (char*)malloc(block * count);
+    if (!slab) return 0;
+    alloc_stats.buf_slabs++;
+    for (size_t i = count; i > 0; i--) {
+        PoolNode *node = (PoolNode*)(slab + (i - 1) * block);
+        node->next = buf_free_lists[cls];
+        buf_free_lists[cls] = node;
+    }
+    return 1;
+}
+
+void* pool_alloc_buf(size_t size) {
+    alloc_stats.buf_allocs++;
+    BufHeader *h;
+    int cls = buf_class_for(size);
+    if (cls < 0) {
+        alloc_stats_check();
+        alloc_stats.buf_large++;
+        h = (BufHeader*)malloc(sizeof(BufHeader) + size);
+        if (!h) return NULL;
+        h->size_class = BUF_CLASS_LARGE;
+        h->capacity = size;
+    } else {
+        if (!buf_free_lists[cls] && !buf_pool_refill(cls)) return NULL;
+        PoolNode *node = buf_free_lists[cls];
+        buf_free_lists[cls] = node->next;
+        h = (BufHeader*)node;
+        h->size_class = (size_t)cls;
+        h->capacity = buf_class_size[cls];
+    }
+    return h + 1;
+}
+
+void pool_free_buf(void *ptr) {
+    if (!ptr) return;
+    alloc_stats.buf_frees++;
+    BufHeader *h = (BufHeader*)ptr - 1;
+    if (h->size_class == BUF_CLASS_LARGE) {
+        free(h);
+        return;
+    }
+    size_t cls = h->size_class;  /* 节点的 next 与头部重叠，先取出级别 */
+    PoolNode *node = (PoolNode*)h;
+    node->next = buf_free_lists[cls];
+    buf_free_lists[cls] = node;
+}
+
+/* 缩小或仍在当前级别容量内时原地返回 */
+void* pool_realloc_buf(void *ptr, size_t size) {
+    if (!ptr) return pool_alloc_buf(size);
+    alloc_stats.buf_reallocs++;
+    BufHeader *h = (BufHeader*)ptr - 1;
+    if (size <= h->capacity) return ptr;
+
+    if (h->size_class == BUF_CLASS_LARGE) {
+        BufHeader *nh = (BufHeader*)realloc(h, sizeof(BufHeader) + size);
+        if (!nh) return NULL;
+        nh->capacity = size;
+        return nh + 1;
+    }
+
+    void *np = pool_alloc_buf(size);
+    if (!np) return NULL;
+    memcpy(np, ptr, h->capacity);
+    pool_free_buf(ptr);
+    return np;
+}
+
+#else /* !FLYUX_POOL_ALLOC */
+
+Value* pool_alloc_value(void) {
+    alloc_stats_check();
+    alloc_stats.value_allocs++;
+    Value *v = (Value*)malloc(sizeof(Value));
+    if (v) v->shape = 0;
+    return v;
+}
+
+void pool_free_value(Value *v) {
+    if (!v) return;
+    alloc_stats.value_frees++;
+    free(v);
+}
+
+void* pool_alloc_buf(size_t size) {
+    alloc_stats_check();
+    alloc_stats.buf_allocs++;
+    return malloc(size);
+}
+
+void pool_free_buf(void *ptr) {
+    if (!ptr) return;
+    alloc_stats.buf_frees++;
+    free(ptr);
+}
+
+void* pool_realloc_buf(void *ptr, size_t size) {
+    if (!ptr) return pool_alloc_buf(size);
+    alloc_stats.buf_reallocs++;
+    return realloc(ptr, size);
+}
+
+#endif /* FLYUX_POOL_ALLOC */
+
+void* pool_calloc_buf(size_t count, size_t size) {
+    void *ptr = pool_alloc_buf(count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
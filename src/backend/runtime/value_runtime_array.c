@@ -12,6 +12,7 @@
  * push(array, value) - 在数组末尾添加元素（原地修改）
  * 直接修改原数组，返回数组新长度
  * 语义与 JavaScript Array.push() 一致
+ * 容量按倍数增长，均摊 O(1)
  */
 Value* value_push(Value *arr, Value *val) {
     set_runtime_status(FLYUX_OK, NULL);
@@ -22,28 +23,21 @@ Value* value_push(Value *arr, Value *val) {
     }
     
     size_t old_size = arr->array_size;
-    size_t new_size = old_size + 1;
-    Value **old_elements = (Value**)arr->data.pointer;
-    
-    // 使用 realloc 扩展数组
-    Value **new_elements = (Value**)realloc(old_elements, new_size * sizeof(Value*));
-    if (!new_elements) {
+    if (!array_reserve(arr, 1)) {
         set_runtime_status(FLYUX_ERROR, "(push) memory allocation failed");
         return box_number(old_size);
     }
     
     // 添加新元素（需要 retain）
-    new_elements[old_size] = val;
+    Value **elements = (Value**)arr->data.pointer;
+    elements[old_size] = val;
     if (val) {
         value_retain(val);
     }
-    
-    // 更新数组
-    arr->data.pointer = new_elements;
-    arr->array_size = new_size;
+    arr->array_size = old_size + 1;
     
     // 返回新长度
-    return box_number((double)new_size);
+    return box_number((double)arr->array_size);
 }
 
 /*
@@ -69,21 +63,11 @@ Value* value_pop(Value *arr) {
     
     // 获取最后一个元素（不 retain，因为我们要从数组中移除它）
     Value *removed = elements[new_size];
-    
-    // 缩小数组（realloc 可以缩小）
-    if (new_size > 0) {
-        Value **new_elements = (Value**)realloc(elements, new_size * sizeof(Value*));
-        if (new_elements) {
-            arr->data.pointer = new_elements;
-        }
-        // 如果 realloc 失败，保持原指针，只更新 size
-    } else {
-        // 数组变空了
-        free(elements);
-        arr->data.pointer = NULL;
-    }
     arr->array_size = new_size;
     
+    // 容量远大于元素数时才缩小
+    array_maybe_shrink(arr);
+    
     // 返回被移除的元素（它已经从数组中移除，调用者现在拥有它）
     return removed ? removed : box_null();
 }
@@ -92,6 +76,7 @@ Value* value_pop(Value *arr) {
  * shift(array) - 移除并返回数组第一个元素（原地修改）
  * 直接修改原数组，返回被移除的元素
  * 语义与 JavaScript Array.shift() 一致
+ * 只移动数组头部，不搬移元素；头部空闲过多时再整理
  */
 Value* value_shift(Value *arr) {
     set_runtime_status(FLYUX_OK, NULL);
@@ -106,27 +91,27 @@ Value* value_shift(Value *arr) {
         return box_null();
     }
     
+    Value **base = array_storage_base(arr);
     Value **elements = (Value**)arr->data.pointer;
+    size_t capacity = array_capacity(arr);
     size_t new_size = arr->array_size - 1;
     
     // 获取第一个元素（不 retain，因为我们要从数组中移除它）
     Value *removed = elements[0];
     
-    // 将后面的元素向前移动
-    if (new_size > 0) {
-        memmove(elements, elements + 1, new_size * sizeof(Value*));
-        // 缩小数组
-        Value **new_elements = (Value**)realloc(elements, new_size * sizeof(Value*));
-        if (new_elements) {
-            arr->data.pointer = new_elements;
-        }
-        // 如果 realloc 失败，保持原指针，只更新 size
-    } else {
-        // 数组变空了
-        free(elements);
-        arr->data.pointer = NULL;
-    }
+    // 头部后移一个槽
     arr->array_size = new_size;
+    arr->string_length = capacity - 1;
+    array_set_head(arr, base, elements + 1);
+    
+    // 头部空闲槽超过剩余元素数时整理到缓冲区起点（均摊 O(1)）
+    size_t head = array_head_slack(arr);
+    if (new_size == 0 || (head > ARRAY_MIN_CAPACITY && head > new_size)) {
+        memmove(base, arr->data.pointer, new_size * sizeof(Value*));
+        arr->string_length = head + arr->string_length;
+        array_set_head(arr, base, base);
+    }
+    array_maybe_shrink(arr);
     
     // 返回被移除的元素（它已经从数组中移除，调用者现在拥有它）
     return removed ? removed : box_null();
@@ -136,6 +121,7 @@ Value* value_shift(Value *arr) {
  * unshift(array, value) - 在数组开头添加元素（原地修改）
  * 直接修改原数组，返回数组新长度
  * 语义与 JavaScript Array.unshift() 一致
+ * 优先使用头部空闲槽；没有时重新分配并在头部预留空间
  */
 Value* value_unshift(Value *arr, Value *val) {
     set_runtime_status(FLYUX_OK, NULL);
@@ -146,31 +132,32 @@ Value* value_unshift(Value *arr, Value *val) {
     }
     
     size_t old_size = arr->array_size;
-    size_t new_size = old_size + 1;
-    Value **old_elements = (Value**)arr->data.pointer;
     
-    // 使用 realloc 扩展数组
-    Value **new_elements = (Value**)realloc(old_elements, new_size * sizeof(Value*));
-    if (!new_elements) {
-        set_runtime_status(FLYUX_ERROR, "(unshift) memory allocation failed");
-        return box_number(old_size);
+    if (!arr->data.pointer || array_head_slack(arr) == 0) {
+        size_t capacity = array_capacity(arr) * 2;
+        if (capacity < old_size + 1) capacity = old_size + 1;
+        if (capacity < ARRAY_MIN_CAPACITY) capacity = ARRAY_MIN_CAPACITY;
+        // 新增空间一半留在头部，一半留在尾部
+        size_t front = (capacity - old_size + 1) / 2;
+        if (!array_relocate(arr, capacity, front)) {
+            set_runtime_status(FLYUX_ERROR, "(unshift) memory allocation failed");
+            return box_number(old_size);
+        }
     }
     
-    // 将所有元素向后移动一位
-    memmove(new_elements + 1, new_elements, old_size * sizeof(Value*));
-    
-    // 在开头插入新元素
-    new_elements[0] = val;
+    // 头部前移一个槽并放入新元素
+    Value **base = array_storage_base(arr);
+    Value **elements = (Value**)arr->data.pointer - 1;
+    arr->string_length = array_capacity(arr) + 1;
+    array_set_head(arr, base, elements);
+    elements[0] = val;
     if (val) {
         value_retain(val);
     }
-    
-    // 更新数组
-    arr->data.pointer = new_elements;
-    arr->array_size = new_size;
+    arr->array_size = old_size + 1;
     
     // 返回新长度
-    return box_number((double)new_size);
+    return box_number((double)arr->array_size);
 }
 
 /*
@@ -190,7 +177,7 @@ Value* value_slice(Value *arr, Value *start, Value *end) {
     if (start_idx < 0) start_idx = 0;
     if (end_idx > (int)arr->array_size) end_idx = arr->array_size;
     if (start_idx >= end_idx) {
-        Value *empty = (Value*)malloc(sizeof(Value));
+        Value *empty = pool_alloc_value();
         empty->type = VALUE_ARRAY;
         empty->declared_type = VALUE_ARRAY;
         empty->refcount = 1;
@@ -198,11 +185,12 @@ Value* value_slice(Value *arr, Value *start, Value *end) {
         empty->ext_type = EXT_TYPE_NONE;
         empty->data.pointer = NULL;
         empty->array_size = 0;
+        empty->string_length = 0;
         return empty;
     }
     
     size_t new_size = end_idx - start_idx;
-    Value **new_elements = (Value**)malloc(new_size * sizeof(Value*));
+    Value **new_elements = (Value**)pool_alloc_buf(new_size * sizeof(Value*));
     Value **old_elements = (Value**)arr->data.pointer;
     
     for (size_t i = 0; i < new_size; i++) {
@@ -212,7 +200,7 @@ Value* value_slice(Value *arr, Value *start, Value *end) {
         }
     }
     
-    Value *result = (Value*)malloc(sizeof(Value));
+    Value *result = pool_alloc_value();
     result->type = VALUE_ARRAY;
     result->declared_type = VALUE_ARRAY;
     result->refcount = 1;
@@ -220,6 +208,7 @@ Value* value_slice(Value *arr, Value *start, Value *end) {
     result->ext_type = EXT_TYPE_NONE;
     result->data.pointer = new_elements;
     result->array_size = new_size;
+    result->string_length = 0;
     
     return result;
 }
@@ -236,7 +225,7 @@ Value* value_concat(Value *arr1, Value *arr2) {
     }
     
     size_t new_size = arr1->array_size + arr2->array_size;
-    Value **new_elements = (Value**)malloc(new_size * sizeof(Value*));
+    Value **new_elements = (Value**)pool_alloc_buf(new_size * sizeof(Value*));
     
     Value **elem1 = (Value**)arr1->data.pointer;
     Value **elem2 = (Value**)arr2->data.pointer;
@@ -254,7 +243,7 @@ Value* value_concat(Value *arr1, Value *arr2) {
         }
     }
     
-    Value *result = (Value*)malloc(sizeof(Value));
+    Value *result = pool_alloc_value();
     result->type = VALUE_ARRAY;
     result->declared_type = VALUE_ARRAY;
     result->refcount = 1;
@@ -262,6 +251,7 @@ Value* value_concat(Value *arr1, Value *arr2) {
     result->ext_type = EXT_TYPE_NONE;
     result->data.pointer = new_elements;
     result->array_size = new_size;
+    result->string_length = 0;
     
     return result;
 }
@@ -386,13 +376,13 @@ Value* value_create_array(int64_t size) {
     
     Value **elements = NULL;
     if (size > 0) {
-        elements = (Value**)malloc((size_t)size * sizeof(Value*));
+        elements = (Value**)pool_alloc_buf((size_t)size * sizeof(Value*));
         for (int64_t i = 0; i < size; i++) {
             elements[i] = box_null();
         }
     }
     
-    Value *result = (Value*)malloc(sizeof(Value));
+    Value *result = pool_alloc_value();
     result->type = VALUE_ARRAY;
     result->declared_type = VALUE_ARRAY;
     result->refcount = 1;
@@ -400,6 +390,7 @@ Value* value_create_array(int64_t size) {
     result->ext_type = EXT_TYPE_NONE;
     result->data.pointer = elements;
     result->array_size = (size_t)size;
+    result->string_length = 0;
     
     return result;
 }
@@ -13,18 +13,10 @@ void value_fatal_error(void);    // 致命错误处理（终止程序）
  * ============================================================================
  */
 
-/* FNV-1a 哈希函数 - 简单高效 */
-static inline unsigned long hash_string(const char *str) {
-    unsigned long hash = 14695981039346656037UL;  // FNV offset basis
-    while (*str) {
-        hash ^= (unsigned char)*str++;
-        hash *= 1099511628211UL;  // FNV prime
-    }
-    return hash;
-}
-
 /* 
  * 对象哈希表结构：
+ * - 键是驻留后的符号（见 value_runtime_symbol.c），比较指针即可，
+ *   哈希取自符号头部，不再逐次计算
  * - data.pointer 指向 ObjectEntry 数组
  * - array_size 存储实际字段数量
  * - string_length 存储哈希表容量（如果为0表示线性模式）
@@ -42,7 +34,7 @@ static inline int object_is_hash_mode(Value *obj) {
     return obj->string_length > 0;
 }
 
-/* 在哈希表中查找键，返回槽索引（找到或空槽），-1表示表满 */
+/* 在哈希表中查找符号 key，返回槽索引（找到或空槽），-1表示表满 */
 static inline long object_hash_find_slot(ObjectEntry *entries, size_t capacity, const char *key, unsigned long hash) {
     size_t idx = hash % capacity;
     size_t start = idx;
@@ -56,7 +48,7 @@ static inline long object_hash_find_slot(ObjectEntry *entries, size_t capacity,
         if (entries[idx].key == OBJECT_TOMBSTONE) {
             // 记录第一个墓碑位置
             if (first_tombstone < 0) first_tombstone = (long)idx;
-        } else if (strcmp(entries[idx].key, key) == 0) {
+        } else if (entries[idx].key == key) {
             // 找到匹配的键
             return (long)idx;
         }
@@ -79,13 +71,13 @@ static void object_convert_to_hash(Value *obj) {
     }
     
     // 分配新的哈希表
-    ObjectEntry *new_entries = (ObjectEntry*)calloc(new_capacity, sizeof(ObjectEntry));
+    ObjectEntry *new_entries = (ObjectEntry*)pool_calloc_buf(new_capacity, sizeof(ObjectEntry));
     if (!new_entries) return;  // 内存分配失败，保持线性模式
     
     // 重新插入所有条目
     for (size_t i = 0; i < old_count; i++) {
         if (old_entries[i].key && old_entries[i].key != OBJECT_TOMBSTONE) {
-            unsigned long hash = hash_string(old_entries[i].key);
+            unsigned long hash = symbol_key_hash(old_entries[i].key);
             long slot = object_hash_find_slot(new_entries, new_capacity, old_entries[i].key, hash);
             if (slot >= 0) {
                 new_entries[slot].key = old_entries[i].key;
@@ -95,11 +87,12 @@ static void object_convert_to_hash(Value *obj) {
     }
     
     // 释放旧数组
-    if (old_entries) free(old_entries);
+    if (old_entries) pool_free_buf(old_entries);
     
     // 更新对象
     obj->data.pointer = new_entries;
     obj->string_length = new_capacity;  // 标记为哈希模式并存储容量
+    obj->shape = SHAPE_NONE;            // 哈希模式不跟踪形状
 }
 
 /* 哈希表扩容 */
@@ -108,13 +101,13 @@ static void object_hash_resize(Value *obj, size_t new_capacity) {
     size_t old_capacity = obj->string_length;
     
     // 分配新的哈希表
-    ObjectEntry *new_entries = (ObjectEntry*)calloc(new_capacity, sizeof(ObjectEntry));
+    ObjectEntry *new_entries = (ObjectEntry*)pool_calloc_buf(new_capacity, sizeof(ObjectEntry));
     if (!new_entries) return;  // 内存分配失败
     
     // 重新插入所有条目
     for (size_t i = 0; i < old_capacity; i++) {
         if (old_entries[i].key && old_entries[i].key != OBJECT_TOMBSTONE) {
-            unsigned long hash = hash_string(old_entries[i].key);
+            unsigned long hash = symbol_key_hash(old_entries[i].key);
             long slot = object_hash_find_slot(new_entries, new_capacity, old_entries[i].key, hash);
             if (slot >= 0) {
                 new_entries[slot].key = old_entries[i].key;
@@ -124,13 +117,36 @@ static void object_hash_resize(Value *obj, size_t new_capacity) {
     }
     
     // 释放旧数组
-    free(old_entries);
+    pool_free_buf(old_entries);
     
     // 更新对象
     obj->data.pointer = new_entries;
     obj->string_length = new_capacity;
 }
 
+/* 在普通对象表中查找符号 sym，返回条目；不存在返回 NULL */
+static ObjectEntry* object_find_entry(Value *obj, const char *sym) {
+    ObjectEntry *entries = (ObjectEntry*)obj->data.pointer;
+    if (!sym || !entries) return NULL;
+    
+    if (object_is_hash_mode(obj)) {
+        size_t capacity = obj->string_length;
+        size_t idx = symbol_key_hash(sym) % capacity;
+        size_t start = idx;
+        do {
+            if (entries[idx].key == NULL) return NULL;  // 空槽，键不存在
+            if (entries[idx].key == sym) return &entries[idx];
+            idx = (idx + 1) % capacity;
+        } while (idx != start);
+        return NULL;
+    }
+    
+    for (size_t i = 0; i < (size_t)obj->array_size; i++) {
+        if (entries[i].key == sym) return &entries[i];
+    }
+    return NULL;
+}
+
 /* ============================================================================
  * 类型转换函数
  * ============================================================================
@@ -322,26 +338,28 @@ Value* value_to_bl(Value *v) {
  */
 Value* create_error_object(Value *message, Value *code, Value *type) {
     // 创建3个键值对
-    ObjectEntry *entries = (ObjectEntry*)malloc(3 * sizeof(ObjectEntry));
+    ObjectEntry *entries = (ObjectEntry*)pool_alloc_buf(3 * sizeof(ObjectEntry));
     
     // message字段
-    entries[0].key = strdup("message");
+    entries[0].key = (char*)symbol_intern("message");
     entries[0].value = message;
     
     // code字段
-    entries[1].key = strdup("code");
+    entries[1].key = (char*)symbol_intern("code");
     entries[1].value = code;
     
     // type字段
-    entries[2].key = strdup("type");
+    entries[2].key = (char*)symbol_intern("type");
     entries[2].value = type;
     
     // 创建对象Value
-    Value *obj = (Value*)malloc(sizeof(Value));
+    Value *obj = pool_alloc_value();
     obj->type = VALUE_OBJECT;
     obj->declared_type = VALUE_OBJECT;
     obj->data.pointer = entries;
     obj->array_size = 3;  // 3个键值对
+    obj->string_length = 0;
+    obj->shape = shape_for_entries(entries, 3);
     
     return obj;
 }
@@ -434,34 +452,11 @@ Value* value_get_field(Value *obj, Value *field_name) {
         }
     }
     
-    // 遍历对象的所有字段（普通对象或扩展类型未匹配虚拟属性）
-    ObjectEntry *entries = (ObjectEntry*)obj->data.pointer;
-    
-    // 检查是否是哈希模式
-    if (object_is_hash_mode(obj)) {
-        // 哈希模式：使用哈希查找
-        unsigned long hash = hash_string(key);
-        size_t capacity = obj->string_length;
-        size_t idx = hash % capacity;
-        size_t start = idx;
-        
-        do {
-            if (entries[idx].key == NULL) {
-                // 空槽，键不存在
-                break;
-            }
-            if (entries[idx].key != OBJECT_TOMBSTONE && strcmp(entries[idx].key, key) == 0) {
-                return entries[idx].value;
-            }
-            idx = (idx + 1) % capacity;
-        } while (idx != start);
-    } else {
-        // 线性模式：遍历所有字段
-        for (size_t i = 0; i < obj->array_size; i++) {
-            if (strcmp(entries[i].key, key) == 0) {
-                return entries[i].value;
-            }
-        }
+    // 查找对象的字段（普通对象或扩展类型未匹配虚拟属性）
+    // 未驻留的名字一定不是任何对象的键
+    ObjectEntry *entry = object_find_entry(obj, symbol_find(key));
+    if (entry) {
+        return entry->value;
     }
     
     // 字段不存在 - 只设置错误状态，由调用方决定是否终止
@@ -560,34 +555,10 @@ Value* value_get_field_safe(Value *obj, Value *field_name) {
         }
     }
     
-    // 遍历对象的所有字段
-    ObjectEntry *entries = (ObjectEntry*)obj->data.pointer;
-    
-    // 检查是否是哈希模式
-    if (object_is_hash_mode(obj)) {
-        // 哈希模式：使用哈希查找
-        unsigned long hash = hash_string(key);
-        size_t capacity = obj->string_length;
-        size_t idx = hash % capacity;
-        size_t start = idx;
-        
-        do {
-            if (entries[idx].key == NULL) {
-                // 空槽，键不存在
-                break;
-            }
-            if (entries[idx].key != OBJECT_TOMBSTONE && strcmp(entries[idx].key, key) == 0) {
-                return entries[idx].value;
-            }
-            idx = (idx + 1) % capacity;
-        } while (idx != start);
-    } else {
-        // 线性模式：遍历所有字段
-        for (size_t i = 0; i < obj->array_size; i++) {
-            if (strcmp(entries[i].key, key) == 0) {
-                return entries[i].value;
-            }
-        }
+    // 查找对象的字段
+    ObjectEntry *entry = object_find_entry(obj, symbol_find(key));
+    if (entry) {
+        return entry->value;
     }
     
     // 字段不存在，返回undef（不设置错误状态）
@@ -635,7 +606,11 @@ Value* value_set_field(Value *obj, Value *field_name, Value *value) {
         return box_undef();
     }
     
-    const char *key = (const char*)field_name->data.pointer;
+    // 写入时驻留键（动态键第一次出现时进入符号表）
+    const char *key = symbol_intern((const char*)field_name->data.pointer);
+    if (!key) {
+        return value_retain(value);
+    }
     ObjectEntry *entries = (ObjectEntry*)obj->data.pointer;
     size_t count = obj->array_size;
     
@@ -643,7 +618,7 @@ Value* value_set_field(Value *obj, Value *field_name, Value *value) {
     if (object_is_hash_mode(obj)) {
         // === 哈希模式 ===
         size_t capacity = obj->string_length;
-        unsigned long hash = hash_string(key);
+        unsigned long hash = symbol_key_hash(key);
         
         // 查找槽位
         long slot = object_hash_find_slot(entries, capacity, key, hash);
@@ -672,7 +647,7 @@ Value* value_set_field(Value *obj, Value *field_name, Value *value) {
         }
         
         // 插入新键值对
-        entries[slot].key = strdup(key);
+        entries[slot].key = (char*)key;
         entries[slot].value = value;
         if (value) value_retain(value);
         obj->array_size = count + 1;
@@ -684,7 +659,7 @@ Value* value_set_field(Value *obj, Value *field_name, Value *value) {
     
     // 查找是否已存在该字段
     for (size_t i = 0; i < count; i++) {
-        if (strcmp(entries[i].key, key) == 0) {
+        if (entries[i].key == key) {
             // 字段已存在，更新值
             if (entries[i].value) value_release(entries[i].value);
             entries[i].value = value;
@@ -703,7 +678,7 @@ Value* value_set_field(Value *obj, Value *field_name, Value *value) {
     }
     
     // 仍然使用线性模式，分配新数组
-    ObjectEntry *new_entries = (ObjectEntry*)malloc(sizeof(ObjectEntry) * (count + 1));
+    ObjectEntry *new_entries = (ObjectEntry*)pool_alloc_buf(sizeof(ObjectEntry) * (count + 1));
     if (!new_entries) {
         return value ? value_retain(value) : box_undef();
     }
@@ -715,18 +690,19 @@ Value* value_set_field(Value *obj, Value *field_name, Value *value) {
     }
     
     // 添加新字段
-    new_entries[count].key = strdup(key);
+    new_entries[count].key = (char*)key;
     new_entries[count].value = value;
     if (value) value_retain(value);
     
     // 释放旧entries数组
     if (entries) {
-        free(entries);
+        pool_free_buf(entries);
     }
     
     // 更新对象指针和大小
     obj->data.pointer = new_entries;
     obj->array_size = count + 1;
+    obj->shape = shape_transition(obj->shape, key);
     
     return value_retain(value);
 }
@@ -759,7 +735,11 @@ Value* value_delete_field(Value *obj, Value *field_name) {
         return box_bool(0);
     }
     
-    const char *key = (const char*)field_name->data.pointer;
+    // 未驻留的名字一定不是任何对象的键
+    const char *key = symbol_find((const char*)field_name->data.pointer);
+    if (!key) {
+        return box_bool(0);
+    }
     ObjectEntry *entries = (ObjectEntry*)obj->data.pointer;
     size_t count = obj->array_size;
     
@@ -767,7 +747,7 @@ Value* value_delete_field(Value *obj, Value *field_name) {
     if (object_is_hash_mode(obj)) {
         // === 哈希模式：使用墓碑标记删除 ===
         size_t capacity = obj->string_length;
-        unsigned long hash = hash_string(key);
+        unsigned long hash = symbol_key_hash(key);
         size_t idx = hash % capacity;
         size_t start = idx;
         
@@ -776,9 +756,8 @@ Value* value_delete_field(Value *obj, Value *field_name) {
                 // 空槽，键不存在
                 return box_bool(0);
             }
-            if (entries[idx].key != OBJECT_TOMBSTONE && strcmp(entries[idx].key, key) == 0) {
-                // 找到键，删除
-                free(entries[idx].key);
+            if (entries[idx].key == key) {
+                // 找到键，删除（符号永不释放）
                 if (entries[idx].value) value_release(entries[idx].value);
                 entries[idx].key = OBJECT_TOMBSTONE;
                 entries[idx].value = NULL;
@@ -796,7 +775,7 @@ Value* value_delete_field(Value *obj, Value *field_name) {
     // 查找要删除的字段
     int found_index = -1;
     for (size_t i = 0; i < count; i++) {
-        if (strcmp(entries[i].key, key) == 0) {
+        if (entries[i].key == key) {
             found_index = (int)i;
             break;
         }
@@ -809,17 +788,17 @@ Value* value_delete_field(Value *obj, Value *field_name) {
     
     // 如果删除后为空对象
     if (count == 1) {
-        // 释放旧数组和被删除字段的key
-        if (entries[0].key) free(entries[0].key);
+        // 释放旧数组和被删除字段的值（key 是符号，不释放）
         if (entries[0].value) value_release(entries[0].value);
-        free(entries);
+        pool_free_buf(entries);
         obj->data.pointer = NULL;
         obj->array_size = 0;
+        if (obj->shape != SHAPE_NONE) obj->shape = SHAPE_ROOT;
         return box_bool(1);
     }
     
     // 分配新数组
-    ObjectEntry *new_entries = (ObjectEntry*)malloc(sizeof(ObjectEntry) * (count - 1));
+    ObjectEntry *new_entries = (ObjectEntry*)pool_alloc_buf(sizeof(ObjectEntry) * (count - 1));
     if (!new_entries) {
         return box_bool(0);
     }
@@ -834,16 +813,16 @@ Value* value_delete_field(Value *obj, Value *field_name) {
         }
     }
     
-    // 释放被删除字段的key和value
-    if (entries[found_index].key) free(entries[found_index].key);
+    // 释放被删除字段的value（key 是符号，不释放）
     if (entries[found_index].value) value_release(entries[found_index].value);
     
     // 释放旧数组
-    free(entries);
+    pool_free_buf(entries);
     
     // 更新对象
     obj->data.pointer = new_entries;
     obj->array_size = count - 1;
+    if (obj->shape != SHAPE_NONE) obj->shape = shape_for_entries(new_entries, count - 1);
     
     return box_bool(1);
 }
@@ -867,37 +846,8 @@ Value* value_has_field(Value *obj, Value *field_name) {
         return box_bool(0);
     }
     
-    const char *key = (const char*)field_name->data.pointer;
-    ObjectEntry *entries = (ObjectEntry*)obj->data.pointer;
-    
-    // 检查是否是哈希模式
-    if (object_is_hash_mode(obj)) {
-        size_t capacity = obj->string_length;
-        unsigned long hash = hash_string(key);
-        size_t idx = hash % capacity;
-        size_t start = idx;
-        
-        do {
-            if (entries[idx].key == NULL) {
-                return box_bool(0);
-            }
-            if (entries[idx].key != OBJECT_TOMBSTONE && strcmp(entries[idx].key, key) == 0) {
-                return box_bool(1);
-            }
-            idx = (idx + 1) % capacity;
-        } while (idx != start);
-        
-        return box_bool(0);
-    }
-    
-    // 线性模式
-    for (size_t i = 0; i < obj->array_size; i++) {
-        if (strcmp(entries[i].key, key) == 0) {
-            return box_bool(1);
-        }
-    }
-    
-    return box_bool(0);
+    const char *key = symbol_find((const char*)field_name->data.pointer);
+    return box_bool(object_find_entry(obj, key) != NULL);
 }
 
 /*
@@ -1064,28 +1014,17 @@ Value* value_set_index(Value *obj, Value *index, Value *value) {
         // 如果索引超出当前数组大小，需要扩展数组
         if (idx >= count) {
             size_t new_size = idx + 1;
-            Value **new_elements = (Value**)malloc(sizeof(Value*) * new_size);
-            if (!new_elements) {
+            if (!array_reserve(obj, new_size - count)) {
                 return value ? value_retain(value) : box_undef();  // 内存分配失败
             }
-            
-            // 复制旧元素
-            if (elements) {
-                for (size_t i = 0; i < count; i++) {
-                    new_elements[i] = elements[i];
-                }
-                free(elements);
-            }
+            elements = (Value**)obj->data.pointer;
             
             // 新位置填充 undef
             for (size_t i = count; i < new_size; i++) {
-                new_elements[i] = box_undef();
+                elements[i] = box_undef();
             }
             
-            // 更新数组
-            obj->data.pointer = new_elements;
             obj->array_size = new_size;
-            elements = new_elements;
             count = new_size;
         }
         
@@ -1177,6 +1116,61 @@ Value* value_get_method(Value *obj, Value *field_name) {
     return field_value;
 }
 
+/*
+ * value_get_field_ic - 带内联缓存的 obj.field 读取（codegen 的慢速路径）
+ * 
+ * 语义与 value_get_method 相同（函数字段自动绑定 self）。
+ * 对带形状的对象先查缓存 ic，未命中时按键查找并填入缓存；
+ * 其他对象退回 value_get_method。
+ * 
+ * 参数：
+ *   obj: 对象Value
+ *   key: 字段名的驻留符号（codegen 的 @.key.N，见 value_runtime_symbol.c）
+ *   ic:  该访问点的 FieldIC 数组
+ */
+Value* value_get_field_ic(Value *obj, const char *key, FieldIC *ic) {
+    ObjectEntry *entry = NULL;
+    long slot = field_ic_lookup(obj, key, ic);
+    if (slot >= 0) {
+        entry = &((ObjectEntry*)obj->data.pointer)[slot];
+    } else if (obj && obj->type == VALUE_OBJECT && obj->ext_type == EXT_TYPE_NONE) {
+        // 未跟踪形状（如哈希模式）：key 已是符号，直接按指针查找
+        entry = object_find_entry(obj, key);
+    }
+    
+    if (entry && entry->value) {
+        if (entry->value->type == VALUE_FUNCTION) {
+            return bind_method(entry->value, obj);
+        }
+        return entry->value;
+    }
+    
+    Value name = field_ic_key_value(key);
+    return value_get_method(obj, &name);
+}
+
+/*
+ * value_set_field_ic - 带内联缓存的 obj.field = value
+ * 
+ * 语义与 value_set_field 相同；已有字段命中缓存时直接按槽位替换。
+ * 新增字段或赋值 undef（删除）走 value_set_field。
+ */
+Value* value_set_field_ic(Value *obj, const char *key, Value *value, FieldIC *ic) {
+    if (value && value->type != VALUE_UNDEF) {
+        long slot = field_ic_lookup(obj, key, ic);
+        if (slot >= 0) {
+            ObjectEntry *entry = &((ObjectEntry*)obj->data.pointer)[slot];
+            Value *old = entry->value;
+            entry->value = value_retain(value);
+            if (old) value_release(old);
+            return value_retain(value);
+        }
+    }
+    
+    Value name = field_ic_key_value(key);
+    return value_set_field(obj, &name, value);
+}
+
 /*
  * value_get_method_by_index - 通过索引获取方法（自动绑定 self）
  * 
@@ -0,0 +1,209 @@
+/*
+ * Module: value_runtime_compact.c
+ * 紧凑值表示 (NaN-boxing)
+ */
+
+/* ============================================================================
+ * FxValue - 64 位 NaN-boxed 值
+ *
+ * 普通 double 原样保存；其余类型编码在 quiet NaN 空间中：
+ *
+ *   数字      任意非 NaN double，NaN 规范化为 FX_CANONICAL_NAN（保留符号位）
+ *   null      FX_QNAN | FX_TAG_NULL
+ *   false     FX_QNAN | FX_TAG_FALSE
+ *   true      FX_QNAN | FX_TAG_TRUE
+ *   undef     FX_QNAN | FX_TAG_UNDEF
+ *   堆对象    FX_SIGN_BIT | FX_QNAN | (Value* 低 48 位)
+ *
+ * 数字/布尔/null/undef 是立即数，不分配内存也不需要引用计数；
+ * 字符串、数组、对象、函数仍是带 Value 头（refcount/flags）的堆对象。
+ *
+ * 这一层通过 box_*_fx / unbox_*_fx 暴露，并提供与 Value* 的双向转换
+ * (box_value_fx / unbox_value_fx)，codegen 逐个调用点迁移
+ * （目前是 num 与任意值混合的 + / == / !=，见 codegen_expr.c），未迁移的代码继续使用 Value* API。
+ * ============================================================================ */
+
+typedef uint64_t FxValue;
+
+#define FX_SIGN_BIT       0x8000000000000000ULL
+#define FX_QNAN           0x7FFC000000000000ULL
+#define FX_CANONICAL_NAN  0x7FF8000000000000ULL
+#define FX_PAYLOAD_MASK   0x0000FFFFFFFFFFFFULL
+
+#define FX_TAG_NULL   1
+#define FX_TAG_FALSE  2
+#define FX_TAG_TRUE   3
+#define FX_TAG_UNDEF  4
+
+#define FX_NULL   ((FxValue)(FX_QNAN | FX_TAG_NULL))
+#define FX_FALSE  ((FxValue)(FX_QNAN | FX_TAG_FALSE))
+#define FX_TRUE   ((FxValue)(FX_QNAN | FX_TAG_TRUE))
+#define FX_UNDEF  ((FxValue)(FX_QNAN | FX_TAG_UNDEF))
+
+static inline int fx_is_number(FxValue v) {
+    return (v & FX_QNAN) != FX_QNAN;
+}
+
+static inline int fx_is_heap(FxValue v) {
+    return (v & (FX_SIGN_BIT | FX_QNAN)) == (FX_SIGN_BIT | FX_QNAN);
+}
+
+static inline Value* fx_heap_ptr(FxValue v) {
+    return (Value*)(uintptr_t)(v & FX_PAYLOAD_MASK);
+}
+
+/* ============================================================================
+ * Box / Unbox
+ * ============================================================================ */
+
+FxValue box_number_fx(double num) {
+    FxValue bits;
+    memcpy(&bits, &num, sizeof(bits));
+    /* 规范化 NaN 的载荷，避免与标签冲突；保留符号位，转成字符串时 "-nan" 与 Value 路径一致 */
+    if (num != num) return (bits & FX_SIGN_BIT) | FX_CANONICAL_NAN;
+    return bits;
+}
+
+FxValue box_bool_fx(int b) {
+    return b ? FX_TRUE : FX_FALSE;
+}
+
+FxValue box_null_fx(void) {
+    return FX_NULL;
+}
+
+FxValue box_undef_fx(void) {
+    return FX_UNDEF;
+}
+
+/* 与 unbox_number 一致：布尔视为 0/1，null/undef 为 0，其余委托给 Value 版本 */
+double unbox_number_fx(FxValue v) {
+    if (fx_is_number(v)) {
+        double num;
+        memcpy(&num, &v, sizeof(num));
+        return num;
+    }
+    if (fx_is_heap(v)) return unbox_number(fx_heap_ptr(v));
+    return v == FX_TRUE ? 1.0 : 0.0;
+}
+
+/* 返回值的 VALUE_* 类型标签 */
+int fx_type(FxValue v) {
+    if (fx_is_number(v)) return VALUE_NUMBER;
+    if (fx_is_heap(v)) {
+        Value *p = fx_heap_ptr(v);
+        return p ? p->type : VALUE_NULL;
+    }
+    switch (v) {
+        case FX_TRUE:
+        case FX_FALSE:
+            return VALUE_BOOL;
+        case FX_UNDEF:
+            return VALUE_UNDEF;
+        default:
+            return VALUE_NULL;
+    }
+}
+
+int fx_is_truthy(FxValue v) {
+    if (fx_is_number(v)) {
+        double num;
+        memcpy(&num, &v, sizeof(num));
+        return num != 0.0 && num == num;
+    }
+    if (fx_is_heap(v)) return value_is_truthy(fx_heap_ptr(v));
+    return v == FX_TRUE;
+}
+
+/* ============================================================================
+ * 引用计数：立即数无操作，堆对象转发到 Value 头
+ * ============================================================================ */
+
+FxValue fx_retain(FxValue v) {
+    if (fx_is_heap(v)) value_retain(fx_heap_ptr(v));
+    return v;
+}
+
+void fx_release(FxValue v) {
+    if (fx_is_heap(v)) value_release(fx_heap_ptr(v));
+}
+
+/* ============================================================================
+ * 与 Value* 之间的转换
+ * ============================================================================ */
+
+/*
+ * box_value_fx - Value* -> FxValue
+ * 标量变为立即数（不持有 v）；堆对象持有一个新引用
+ */
+FxValue box_value_fx(Value *v) {
+    if (!v) return FX_NULL;
+    switch (v->type) {
+        case VALUE_NUMBER:
+            return box_number_fx(v->data.number);
+        case VALUE_BOOL:
+            return box_bool_fx(v->data.number != 0.0);
+        case VALUE_NULL:
+            /* 带声明类型的 null 需要保留 Value 头 */
+            if (v->declared_type != VALUE_NULL) break;
+            return FX_NULL;
+        case VALUE_UNDEF:
+            return FX_UNDEF;
+        default:
+            break;
+    }
+    value_retain(v);
+    return FX_SIGN_BIT | FX_QNAN | ((FxValue)(uintptr_t)v & FX_PAYLOAD_MASK);
+}
+
+/*
+ * unbox_value_fx - FxValue -> Value*
+ * 返回的 Value* 归调用者所有（与 box_* 一致，refcount = 1 或缓存单例）
+ */
+Value* unbox_value_fx(FxValue v) {
+    if (fx_is_number(v)) return box_number(unbox_number_fx(v));
+    if (fx_is_heap(v)) return value_retain(fx_heap_ptr(v));
+    switch (v) {
+        case FX_TRUE:  return box_bool(1);
+        case FX_FALSE: return box_bool(0);
+        case FX_UNDEF: return box_undef();
+        default:       return box_null();
+    }
+}
+
+/* ============================================================================
+ * 快速路径：两个数字立即数直接运算，否则退回 Value 运算
+ * ============================================================================ */
+
+FxValue fx_add(FxValue a, FxValue b) {
+    if (fx_is_number(a) && fx_is_number(b)) {
+        return box_number_fx(unbox_number_fx(a) + unbox_number_fx(b));
+    }
+    Value *va = unbox_value_fx(a);
+    Value *vb = unbox_value_fx(b);
+    Value *r = value_add(va, vb);
+    FxValue out = box_value_fx(r);
+    value_release(r);
+    value_release(va);
+    value_release(vb);
+    return out;
+}
+
+int fx_equals(FxValue a, FxValue b) {
+    if (fx_is_number(a) && fx_is_number(b)) {
+        return unbox_number_fx(a) == unbox_number_fx(b);
+    }
+    if (!fx_is_heap(a) && !fx_is_heap(b)) {
+        /* 与 value_equals 一致：null 只等于 null，其余立即数按数值比较（true == 1, undef == 0） */
+        if (a == FX_NULL || b == FX_NULL) return a == b;
+        return unbox_number_fx(a) == unbox_number_fx(b);
+    }
+    Value *va = unbox_value_fx(a);
+    Value *vb = unbox_value_fx(b);
+    Value *r = value_equals(va, vb);
+    int eq = value_is_truthy(r);
+    value_release(r);
+    value_release(va);
+    value_release(vb);
+    return eq;
+}
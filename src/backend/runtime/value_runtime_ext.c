@@ -46,7 +46,7 @@ static int small_int_cache_initialized = 0;
 static void init_small_int_cache(void) {
     if (small_int_cache_initialized) return;
     for (int i = 0; i < SMALL_INT_CACHE_SIZE; i++) {
-        Value *v = (Value*)malloc(sizeof(Value));
+        Value *v = pool_alloc_value();
         v->type = VALUE_NUMBER;
         v->declared_type = VALUE_NUMBER;
         v->refcount = 1;
@@ -74,7 +74,7 @@ Value* box_number(double num) {
     }
     
     // 非小整数，分配新的 Value
-    Value *v = (Value*)malloc(sizeof(Value));
+    Value *v = pool_alloc_value();
     v->type = VALUE_NUMBER;
     v->declared_type = VALUE_NUMBER;
     v->refcount = 1;
@@ -88,7 +88,7 @@ Value* box_number(double num) {
 
 /* Box a string into a Value (静态字符串，不会被释放) */
 Value* box_string(char *str) {
-    Value *v = (Value*)malloc(sizeof(Value));
+    Value *v = pool_alloc_value();
     v->type = VALUE_STRING;
     v->declared_type = VALUE_STRING;
     v->refcount = 1;
@@ -102,7 +102,7 @@ Value* box_string(char *str) {
 
 /* Box a dynamically allocated string (会在释放时 free) */
 Value* box_string_owned(char *str) {
-    Value *v = (Value*)malloc(sizeof(Value));
+    Value *v = pool_alloc_value();
     v->type = VALUE_STRING;
     v->declared_type = VALUE_STRING;
     v->refcount = 1;
@@ -116,7 +116,7 @@ Value* box_string_owned(char *str) {
 
 /* Box a string with explicit length (supports \0 in string) */
 Value* box_string_with_length(char *str, size_t len) {
-    Value *v = (Value*)malloc(sizeof(Value));
+    Value *v = pool_alloc_value();
     v->type = VALUE_STRING;
     v->declared_type = VALUE_STRING;
     v->refcount = 1;
@@ -136,7 +136,7 @@ static Value *cached_false = NULL;
 Value* box_bool(int b) {
     if (b) {
         if (!cached_true) {
-            Value *v = (Value*)malloc(sizeof(Value));
+            Value *v = pool_alloc_value();
             v->type = VALUE_BOOL;
             v->declared_type = VALUE_BOOL;
             v->refcount = 1;
@@ -150,7 +150,7 @@ Value* box_bool(int b) {
         return cached_true;
     } else {
         if (!cached_false) {
-            Value *v = (Value*)malloc(sizeof(Value));
+            Value *v = pool_alloc_value();
             v->type = VALUE_BOOL;
             v->declared_type = VALUE_BOOL;
             v->refcount = 1;
@@ -171,7 +171,7 @@ static Value *cached_null = NULL;
 /* Box null - 使用缓存 */
 Value* box_null() {
     if (!cached_null) {
-        Value *v = (Value*)malloc(sizeof(Value));
+        Value *v = pool_alloc_value();
         v->type = VALUE_NULL;
         v->declared_type = VALUE_NULL;
         v->refcount = 1;
@@ -191,7 +191,7 @@ static Value *cached_undef = NULL;
 /* Box undef - for undefined variables - 使用缓存 */
 Value* box_undef() {
     if (!cached_undef) {
-        Value *v = (Value*)malloc(sizeof(Value));
+        Value *v = pool_alloc_value();
         v->type = VALUE_UNDEF;
         v->declared_type = VALUE_UNDEF;
         v->refcount = 1;
@@ -215,15 +215,17 @@ Value* box_undef() {
 
 /* Box function - 创建一个函数值
  * @param func_ptr: 函数指针
+ * @param entry: 统一调用入口（codegen 生成的 <函数名>.entry）
  * @param captured: 捕获的变量数组（可为 NULL）
  * @param captured_count: 捕获变量数量
  * @param param_count: 函数参数数量
  * @param needs_self: 是否需要 self 参数
  * @param capture_by_ref: 是否按引用捕获（1 = captured 是 Value**, 0 = Value*）
  */
-Value* box_function_ex(void *func_ptr, Value **captured, int captured_count, int param_count, int needs_self, int capture_by_ref) {
+Value* box_function_ex(void *func_ptr, void *entry, Value **captured, int captured_count, int param_count, int needs_self, int capture_by_ref) {
     FunctionObject *fn = (FunctionObject*)malloc(sizeof(FunctionObject));
     fn->func_ptr = func_ptr;
+    fn->entry = (FunctionEntry)entry;
     fn->param_count = param_count;
     fn->captured_count = captured_count;
     fn->bound_self = NULL;  /* 初始没有绑定的 self */
@@ -245,7 +247,7 @@ Value* box_function_ex(void *func_ptr, Value **captured, int captured_count, int
         fn->captured = NULL;
     }
     
-    Value *v = (Value*)malloc(sizeof(Value));
+    Value *v = pool_alloc_value();
     v->type = VALUE_FUNCTION;
     v->declared_type = VALUE_FUNCTION;
     v->refcount = 1;
@@ -258,8 +260,8 @@ Value* box_function_ex(void *func_ptr, Value **captured, int captured_count, int
 }
 
 /* 兼容旧版本：默认按值捕获 */
-Value* box_function(void *func_ptr, Value **captured, int captured_count, int param_count, int needs_self) {
-    return box_function_ex(func_ptr, captured, captured_count, param_count, needs_self, 0);
+Value* box_function(void *func_ptr, void *entry, Value **captured, int captured_count, int param_count, int needs_self) {
+    return box_function_ex(func_ptr, entry, captured, captured_count, param_count, needs_self, 0);
 }
 
 /* 获取函数指针 */
@@ -358,6 +360,7 @@ Value* bind_method(Value *func_val, Value *self_obj) {
     /* 创建新的 FunctionObject，复制原有属性 */
     FunctionObject *new_fn = (FunctionObject*)malloc(sizeof(FunctionObject));
     new_fn->func_ptr = orig_fn->func_ptr;
+    new_fn->entry = orig_fn->entry;
     new_fn->param_count = orig_fn->param_count;
     new_fn->captured_count = orig_fn->captured_count;
     new_fn->needs_self = orig_fn->needs_self;  /* 复制 needs_self 标志 */
@@ -382,7 +385,7 @@ Value* bind_method(Value *func_val, Value *self_obj) {
     value_retain(self_obj);
     
     /* 创建新的 Value */
-    Value *v = (Value*)malloc(sizeof(Value));
+    Value *v = pool_alloc_value();
     v->type = VALUE_FUNCTION;
     v->declared_type = VALUE_FUNCTION;
     v->refcount = 1;
@@ -400,137 +403,21 @@ Value* bind_method(Value *func_val, Value *self_obj) {
  * @param arg_count: 参数数量
  * @return: 函数返回值
  *
- * 实现说明：
- * 由于C语言无法直接进行可变参数的间接函数调用，
- * 我们使用函数指针类型转换来实现。
- * 支持0-10个参数的函数调用。
- * 
- * 如果函数有 bound_self，它会作为第一个参数传入。
+ * 调用约定：
+ * 每个函数都有 codegen 生成的统一入口 <函数名>.entry(func_val, args, argc)，
+ * 入口负责按函数自己的签名展开参数：bound_self（需要时）、普通参数
+ * （不足的补 undef，多余的忽略）、最后是捕获变量，然后直接调用函数本体。
+ * 因此这里不再按参数个数转换函数指针，也没有参数个数上限。
+ *
+ * 静态已知的被调函数由 codegen 直接调用，不经过这里。
  */
 Value* call_function_value(Value *func_val, Value **args, int arg_count) {
     FunctionObject *fn = (FunctionObject*)func_val->data.pointer;
-    
-    // 快速路径：无 bound_self 或不需要 self 的常见情况
-    if (!fn->bound_self || !fn->needs_self) {
-        int total = arg_count + fn->captured_count;
-        
-        // 快速路径：1 参数 + 2 捕获 = 3 参数（fib 常见情况）
-        if (total == 3 && arg_count == 1 && fn->captured_count == 2) {
-            typedef Value* (*Func3)(Value*, Value*, Value*);
-            return ((Func3)fn->func_ptr)(args[0], fn->captured[0], fn->captured[1]);
-        }
-        
-        // 快速路径：1 参数 + 1 捕获 = 2 参数
-        if (total == 2 && arg_count == 1 && fn->captured_count == 1) {
-            typedef Value* (*Func2)(Value*, Value*);
-            return ((Func2)fn->func_ptr)(args[0], fn->captured[0]);
-        }
-        
-        // 快速路径：1 参数 + 0 捕获 = 1 参数
-        if (total == 1 && arg_count == 1 && fn->captured_count == 0) {
-            typedef Value* (*Func1)(Value*);
-            return ((Func1)fn->func_ptr)(args[0]);
-        }
-        
-        // 快速路径：0 参数 + 0 捕获 = 0 参数
-        if (total == 0) {
-            typedef Value* (*Func0)(void);
-            return ((Func0)fn->func_ptr)();
-        }
-        
-        // 快速路径：0 参数 + 1 捕获 = 1 参数（闭包常见情况）
-        if (total == 1 && arg_count == 0 && fn->captured_count == 1) {
-            typedef Value* (*Func1)(Value*);
-            return ((Func1)fn->func_ptr)(fn->captured[0]);
-        }
-    }
-    
-    // 慢速路径：通用情况
-    // 只有当函数需要 self 且有 bound_self 时才传入 self
-    int has_bound_self = (fn->bound_self != NULL && fn->needs_self) ? 1 : 0;
-    int total_args = has_bound_self + arg_count + fn->captured_count;
-    
-    // 使用栈上数组避免 malloc（最多支持 16 个参数）
-    Value *full_args[16];
-    if (total_args > 16) {
-        fprintf(stderr, "Error: call_function_value does not support more than 16 arguments\n");
+    if (!fn || !fn->entry) {
+        fprintf(stderr, "Error: call_function_value: function value has no entry point\n");
         return box_undef();
     }
-    
-    int idx = 0;
-    
-    // 首先添加 bound_self（如果有且需要）
-    if (has_bound_self) {
-        full_args[idx++] = fn->bound_self;
-    }
-    
-    // 再复制传入参数
-    for (int i = 0; i < arg_count; i++) {
-        full_args[idx++] = args ? args[i] : NULL;
-    }
-    
-    // 最后复制捕获变量
-    for (int i = 0; i < fn->captured_count; i++) {
-        full_args[idx++] = fn->captured ? fn->captured[i] : NULL;
-    }
-    
-    // 根据参数数量调用函数
-    Value* result = NULL;
-    
-    typedef Value* (*Func0)(void);
-    typedef Value* (*Func1)(Value*);
-    typedef Value* (*Func2)(Value*, Value*);
-    typedef Value* (*Func3)(Value*, Value*, Value*);
-    typedef Value* (*Func4)(Value*, Value*, Value*, Value*);
-    typedef Value* (*Func5)(Value*, Value*, Value*, Value*, Value*);
-    typedef Value* (*Func6)(Value*, Value*, Value*, Value*, Value*, Value*);
-    typedef Value* (*Func7)(Value*, Value*, Value*, Value*, Value*, Value*, Value*);
-    typedef Value* (*Func8)(Value*, Value*, Value*, Value*, Value*, Value*, Value*, Value*);
-    typedef Value* (*Func9)(Value*, Value*, Value*, Value*, Value*, Value*, Value*, Value*, Value*);
-    typedef Value* (*Func10)(Value*, Value*, Value*, Value*, Value*, Value*, Value*, Value*, Value*, Value*);
-    
-    switch (total_args) {
-        case 0:
-            result = ((Func0)fn->func_ptr)();
-            break;
-        case 1:
-            result = ((Func1)fn->func_ptr)(full_args[0]);
-            break;
-        case 2:
-            result = ((Func2)fn->func_ptr)(full_args[0], full_args[1]);
-            break;
-        case 3:
-            result = ((Func3)fn->func_ptr)(full_args[0], full_args[1], full_args[2]);
-            break;
-        case 4:
-            result = ((Func4)fn->func_ptr)(full_args[0], full_args[1], full_args[2], full_args[3]);
-            break;
-        case 5:
-            result = ((Func5)fn->func_ptr)(full_args[0], full_args[1], full_args[2], full_args[3], full_args[4]);
-            break;
-        case 6:
-            result = ((Func6)fn->func_ptr)(full_args[0], full_args[1], full_args[2], full_args[3], full_args[4], full_args[5]);
-            break;
-        case 7:
-            result = ((Func7)fn->func_ptr)(full_args[0], full_args[1], full_args[2], full_args[3], full_args[4], full_args[5], full_args[6]);
-            break;
-        case 8:
-            result = ((Func8)fn->func_ptr)(full_args[0], full_args[1], full_args[2], full_args[3], full_args[4], full_args[5], full_args[6], full_args[7]);
-            break;
-        case 9:
-            result = ((Func9)fn->func_ptr)(full_args[0], full_args[1], full_args[2], full_args[3], full_args[4], full_args[5], full_args[6], full_args[7], full_args[8]);
-            break;
-        case 10:
-            result = ((Func10)fn->func_ptr)(full_args[0], full_args[1], full_args[2], full_args[3], full_args[4], full_args[5], full_args[6], full_args[7], full_args[8], full_args[9]);
-            break;
-        default:
-            fprintf(stderr, "Error: call_function_value does not support %d arguments (max 10)\n", total_args);
-            result = box_undef();
-            break;
-    }
-    
-    // 栈上数组不需要 free
-    
+    Value *result = fn->entry(func_val, args, (long)arg_count);
     return result ? result : box_undef();
 }
 
@@ -546,7 +433,7 @@ Value* value_call_function(Value *func_val, Value **args, long arg_count) {
 
 /* Box null with declared type - for typed variables */
 Value* box_null_typed(int decl_type) {
-    Value *v = (Value*)malloc(sizeof(Value));
+    Value *v = pool_alloc_value();
     v->type = VALUE_NULL;
     v->declared_type = decl_type;
     v->refcount = 1;
@@ -566,7 +453,7 @@ Value* box_null_preserve_type(Value *old_val) {
 
 /* Box an array (从栈上拷贝到堆上并获得所有权) */
 Value* box_array(void *array_ptr, long size) {
-    Value *v = (Value*)malloc(sizeof(Value));
+    Value *v = pool_alloc_value();
     v->type = VALUE_ARRAY;
     v->declared_type = VALUE_ARRAY;
     v->refcount = 1;
@@ -576,7 +463,7 @@ Value* box_array(void *array_ptr, long size) {
     /* 重要：复制数组元素到堆上，因为传入的可能是栈上的临时数组 */
     if (size > 0 && array_ptr) {
         Value **src = (Value**)array_ptr;
-        Value **dst = (Value**)malloc(sizeof(Value*) * size);
+        Value **dst = (Value**)pool_alloc_buf(sizeof(Value*) * size);
         for (long i = 0; i < size; i++) {
             dst[i] = src[i];
             /* P2 修复：对每个元素进行 retain，因为数组持有元素的引用 */
@@ -597,12 +484,13 @@ Value* box_array(void *array_ptr, long size) {
 /* ObjectEntry 结构在 value_runtime_value.c 中定义，这里用前向声明 */
 struct ObjectEntry;  /* forward declaration */
 
-/* Box an object - takes array of ObjectEntry (从栈上拷贝到堆上) */
-Value* box_object(void *entries_ptr, long count) {
+/* Box an object - takes array of ObjectEntry (从栈上拷贝到堆上)
+ * keys_interned 为真时 key 已是驻留符号（codegen 生成的字面量），直接使用 */
+static Value* box_object_entries(void *entries_ptr, long count, int keys_interned) {
     /* 内部定义与外部相同的结构，用于访问字段 */
     typedef struct { char *key; Value *value; } ObjEntry;
     
-    Value *v = (Value*)malloc(sizeof(Value));
+    Value *v = pool_alloc_value();
     v->type = VALUE_OBJECT;
     v->declared_type = VALUE_OBJECT;
     v->refcount = 1;
@@ -612,10 +500,10 @@ Value* box_object(void *entries_ptr, long count) {
     /* 重要：复制 entries 到堆上，因为传入的可能是栈上的临时数组 */
     if (count > 0 && entries_ptr) {
         ObjEntry *src = (ObjEntry*)entries_ptr;
-        ObjEntry *dst = (ObjEntry*)malloc(sizeof(ObjEntry) * count);
+        ObjEntry *dst = (ObjEntry*)pool_alloc_buf(sizeof(ObjEntry) * count);
         for (long i = 0; i < count; i++) {
-            /* 复制 key（需要 strdup 因为原 key 可能在栈上）*/
-            dst[i].key = src[i].key ? strdup(src[i].key) : NULL;
+            /* 驻留 key（原 key 可能在栈上）*/
+            dst[i].key = keys_interned ? src[i].key : (char*)symbol_intern(src[i].key);
             dst[i].value = src[i].value;
             /* P2 修复：对每个 value 进行 retain，因为对象持有 value 的引用 */
             if (dst[i].value) {
@@ -629,9 +517,19 @@ Value* box_object(void *entries_ptr, long count) {
     
     v->array_size = count;
     v->string_length = 0;
+    v->shape = shape_for_entries((ObjectEntry*)v->data.pointer, count > 0 ? (size_t)count : 0);
     return v;
 }
 
+Value* box_object(void *entries_ptr, long count) {
+    return box_object_entries(entries_ptr, count, 0);
+}
+
+/* 键已驻留的对象字面量（见 value_intern_keys） */
+Value* box_object_symbols(void *entries_ptr, long count) {
+    return box_object_entries(entries_ptr, count, 1);
+}
+
 /* ============================================================================
  * Unbox 函数 - 从 Value 提取原始值
  * ============================================================================ */
@@ -766,7 +664,7 @@ Value* value_range(Value *start_val, Value *end_val, Value *step_val) {
     // 创建数组
     Value **elements = NULL;
     if (count > 0) {
-        elements = (Value**)malloc((size_t)count * sizeof(Value*));
+        elements = (Value**)pool_alloc_buf((size_t)count * sizeof(Value*));
         double val = start;
         for (int64_t i = 0; i < count; i++) {
             elements[i] = box_number(val);
@@ -774,7 +672,7 @@ Value* value_range(Value *start_val, Value *end_val, Value *step_val) {
         }
     }
     
-    Value *result = (Value*)malloc(sizeof(Value));
+    Value *result = pool_alloc_value();
     result->type = VALUE_ARRAY;
     result->declared_type = VALUE_ARRAY;
     result->refcount = 1;
@@ -782,6 +680,7 @@ Value* value_range(Value *start_val, Value *end_val, Value *step_val) {
     result->ext_type = EXT_TYPE_NONE;
     result->data.pointer = elements;
     result->array_size = (size_t)count;
+    result->string_length = 0;
     
     return result;
 }
@@ -1768,21 +1667,18 @@ Value* value_index(Value *obj, Value *index) {
     
     // For objects with string index (inline implementation to avoid forward declaration)
     if (obj->type == VALUE_OBJECT && index && index->type == VALUE_STRING) {
-        const char *key = (const char*)index->data.pointer;
+        // 对象键是驻留符号：未驻留的名字一定不存在，找到后按指针比较
+        const char *key = symbol_find((const char*)index->data.pointer);
         ObjectEntry *entries = (ObjectEntry*)obj->data.pointer;
         
-        // 检查是否是哈希模式（string_length > 0 表示哈希容量）
-        if (obj->string_length > 0) {
-            // 哈希模式：使用哈希查找
+        if (!key) {
+            // 键不存在
+            set_runtime_status(FLYUX_TYPE_ERROR, "Object key not found");
+            return box_null();
+        } else if (obj->string_length > 0) {
+            // 哈希模式（string_length > 0 表示哈希容量）：哈希取自符号头部
             size_t capacity = obj->string_length;
-            unsigned long hash = 14695981039346656037UL;  // FNV offset basis
-            const char *s = key;
-            while (*s) {
-                hash ^= (unsigned char)*s++;
-                hash *= 1099511628211UL;  // FNV prime
-            }
-            
-            size_t idx = hash % capacity;
+            size_t idx = symbol_key_hash(key) % capacity;
             size_t start = idx;
             
             do {
@@ -1790,7 +1686,7 @@ Value* value_index(Value *obj, Value *index) {
                     // 空槽，键不存在
                     break;
                 }
-                if (entries[idx].key != (char*)(intptr_t)-1 && strcmp(entries[idx].key, key) == 0) {
+                if (entries[idx].key == key) {
                     return value_retain(entries[idx].value);
                 }
                 idx = (idx + 1) % capacity;
@@ -1803,7 +1699,7 @@ Value* value_index(Value *obj, Value *index) {
             // 线性模式
             size_t count = obj->array_size;
             for (size_t i = 0; i < count; i++) {
-                if (strcmp(entries[i].key, key) == 0) {
+                if (entries[i].key == key) {
                     return value_retain(entries[i].value);
                 }
             }
@@ -1853,21 +1749,16 @@ Value* value_index_safe(Value *obj, Value *index) {
     
     // For objects with string index
     if (obj->type == VALUE_OBJECT && index->type == VALUE_STRING) {
-        const char *key = (const char*)index->data.pointer;
+        // 对象键是驻留符号：未驻留的名字一定不存在，找到后按指针比较
+        const char *key = symbol_find((const char*)index->data.pointer);
         ObjectEntry *entries = (ObjectEntry*)obj->data.pointer;
         
-        // 检查是否是哈希模式（string_length > 0 表示哈希容量）
-        if (obj->string_length > 0) {
-            // 哈希模式：使用哈希查找
+        if (!key) {
+            // 键不存在，返回 undef
+        } else if (obj->string_length > 0) {
+            // 哈希模式（string_length > 0 表示哈希容量）：哈希取自符号头部
             size_t capacity = obj->string_length;
-            unsigned long hash = 14695981039346656037UL;  // FNV offset basis
-            const char *s = key;
-            while (*s) {
-                hash ^= (unsigned char)*s++;
-                hash *= 1099511628211UL;  // FNV prime
-            }
-            
-            size_t idx = hash % capacity;
+            size_t idx = symbol_key_hash(key) % capacity;
             size_t start = idx;
             
             do {
@@ -1875,7 +1766,7 @@ Value* value_index_safe(Value *obj, Value *index) {
                     // 空槽，键不存在
                     break;
                 }
-                if (entries[idx].key != (char*)(intptr_t)-1 && strcmp(entries[idx].key, key) == 0) {
+                if (entries[idx].key == key) {
                     return value_retain(entries[idx].value);
                 }
                 idx = (idx + 1) % capacity;
@@ -1884,7 +1775,7 @@ Value* value_index_safe(Value *obj, Value *index) {
             // 线性模式
             size_t count = obj->array_size;
             for (size_t i = 0; i < count; i++) {
-                if (strcmp(entries[i].key, key) == 0) {
+                if (entries[i].key == key) {
                     return value_retain(entries[i].value);
                 }
             }
@@ -1899,7 +1790,7 @@ Value* value_index_safe(Value *obj, Value *index) {
 void value_free(Value *v) {
     if (v) {
         // Note: we don't free strings as they might be global constants
-        free(v);
+        pool_free_value(v);
     }
 }
 
@@ -2230,7 +2121,7 @@ Value* value_shallow_clone(Value *v) {
             
             Value **new_elements = NULL;
             if (size > 0 && old_elements) {
-                new_elements = (Value**)malloc(sizeof(Value*) * size);
+                new_elements = (Value**)pool_alloc_buf(sizeof(Value*) * size);
                 for (long i = 0; i < size; i++) {
                     new_elements[i] = old_elements[i];
                     /* 增加引用计数，因为新数组也持有引用 */
@@ -2240,7 +2131,7 @@ Value* value_shallow_clone(Value *v) {
                 }
             }
             
-            Value *result = (Value*)malloc(sizeof(Value));
+            Value *result = pool_alloc_value();
             result->type = VALUE_ARRAY;
             result->declared_type = VALUE_ARRAY;
             result->refcount = 1;
@@ -2260,10 +2151,10 @@ Value* value_shallow_clone(Value *v) {
             
             ObjEntry *new_entries = NULL;
             if (count > 0 && old_entries) {
-                new_entries = (ObjEntry*)malloc(sizeof(ObjEntry) * count);
+                new_entries = (ObjEntry*)pool_alloc_buf(sizeof(ObjEntry) * count);
                 for (long i = 0; i < count; i++) {
-                    /* 复制 key */
-                    new_entries[i].key = old_entries[i].key ? strdup(old_entries[i].key) : NULL;
+                    /* key 是符号，直接共享 */
+                    new_entries[i].key = old_entries[i].key;
                     /* value 仍是引用，增加引用计数 */
                     new_entries[i].value = old_entries[i].value;
                     if (new_entries[i].value) {
@@ -2272,7 +2163,7 @@ Value* value_shallow_clone(Value *v) {
                 }
             }
             
-            Value *result = (Value*)malloc(sizeof(Value));
+            Value *result = pool_alloc_value();
             result->type = VALUE_OBJECT;
             result->declared_type = VALUE_OBJECT;
             result->refcount = 1;
@@ -2281,6 +2172,7 @@ Value* value_shallow_clone(Value *v) {
             result->data.pointer = new_entries;
             result->array_size = count;
             result->string_length = 0;
+            result->shape = v->string_length == 0 ? v->shape : SHAPE_NONE;  /* 线性对象键顺序不变 */
             return result;
         }
             
@@ -2328,14 +2220,14 @@ Value* value_deep_clone(Value *v) {
             
             Value **new_elements = NULL;
             if (size > 0 && old_elements) {
-                new_elements = (Value**)malloc(sizeof(Value*) * size);
+                new_elements = (Value**)pool_alloc_buf(sizeof(Value*) * size);
                 for (long i = 0; i < size; i++) {
                     /* 递归深拷贝每个元素 */
                     new_elements[i] = value_deep_clone(old_elements[i]);
                 }
             }
             
-            Value *result = (Value*)malloc(sizeof(Value));
+            Value *result = pool_alloc_value();
             result->type = VALUE_ARRAY;
             result->declared_type = VALUE_ARRAY;
             result->refcount = 1;
@@ -2355,16 +2247,16 @@ Value* value_deep_clone(Value *v) {
             
             ObjEntry *new_entries = NULL;
             if (count > 0 && old_entries) {
-                new_entries = (ObjEntry*)malloc(sizeof(ObjEntry) * count);
+                new_entries = (ObjEntry*)pool_alloc_buf(sizeof(ObjEntry) * count);
                 for (long i = 0; i < count; i++) {
-                    /* 复制 key */
-                    new_entries[i].key = old_entries[i].key ? strdup(old_entries[i].key) : NULL;
+                    /* key 是符号，直接共享 */
+                    new_entries[i].key = old_entries[i].key;
                     /* 递归深拷贝 value */
                     new_entries[i].value = value_deep_clone(old_entries[i].value);
                 }
             }
             
-            Value *result = (Value*)malloc(sizeof(Value));
+            Value *result = pool_alloc_value();
             result->type = VALUE_OBJECT;
             result->declared_type = VALUE_OBJECT;
             result->refcount = 1;
@@ -2373,6 +2265,7 @@ Value* value_deep_clone(Value *v) {
             result->data.pointer = new_entries;
             result->array_size = count;
             result->string_length = 0;
+            result->shape = v->string_length == 0 ? v->shape : SHAPE_NONE;  /* 线性对象键顺序不变 */
             return result;
         }
             
@@ -2410,12 +2303,12 @@ Value* value_spread_into_object(Value *target, Value *source) {
     
     // 分配足够大的数组（最坏情况：所有属性都不重复）
     long max_count = target_count + source_count;
-    ObjEntry *new_entries = (ObjEntry*)malloc(sizeof(ObjEntry) * max_count);
+    ObjEntry *new_entries = (ObjEntry*)pool_alloc_buf(sizeof(ObjEntry) * max_count);
     long new_count = 0;
     
     // 先复制目标对象的所有属性
     for (long i = 0; i < target_count; i++) {
-        new_entries[new_count].key = target_entries[i].key ? strdup(target_entries[i].key) : NULL;
+        new_entries[new_count].key = target_entries[i].key;  /* 符号，直接共享 */
         new_entries[new_count].value = target_entries[i].value;
         if (new_entries[new_count].value) value_retain(new_entries[new_count].value);
         new_count++;
@@ -2429,7 +2322,7 @@ Value* value_spread_into_object(Value *target, Value *source) {
         // 查找是否已存在
         int found = 0;
         for (long j = 0; j < new_count; j++) {
-            if (new_entries[j].key && key && strcmp(new_entries[j].key, key) == 0) {
+            if (new_entries[j].key && new_entries[j].key == key) {
                 // 覆盖现有值
                 if (new_entries[j].value) value_release(new_entries[j].value);
                 new_entries[j].value = val;
@@ -2440,7 +2333,7 @@ Value* value_spread_into_object(Value *target, Value *source) {
         }
         
         if (!found) {
-            new_entries[new_count].key = key ? strdup(key) : NULL;
+            new_entries[new_count].key = key;
             new_entries[new_count].value = val;
             if (val) value_retain(val);
             new_count++;
@@ -2449,10 +2342,10 @@ Value* value_spread_into_object(Value *target, Value *source) {
     
     // 缩小数组到实际大小
     if (new_count < max_count) {
-        new_entries = (ObjEntry*)realloc(new_entries, sizeof(ObjEntry) * new_count);
+        new_entries = (ObjEntry*)pool_realloc_buf(new_entries, sizeof(ObjEntry) * new_count);
     }
     
-    Value *result = (Value*)malloc(sizeof(Value));
+    Value *result = pool_alloc_value();
     result->type = VALUE_OBJECT;
     result->declared_type = VALUE_OBJECT;
     result->refcount = 1;
@@ -2461,6 +2354,7 @@ Value* value_spread_into_object(Value *target, Value *source) {
     result->data.pointer = new_entries;
     result->array_size = new_count;
     result->string_length = 0;
+    result->shape = shape_for_entries((ObjectEntry*)new_entries, (size_t)new_count);
     return result;
 }
 
@@ -2484,7 +2378,7 @@ Value* value_spread_into_array(Value *target, Value *source) {
     
     Value **new_elems = NULL;
     if (new_count > 0) {
-        new_elems = (Value**)malloc(sizeof(Value*) * new_count);
+        new_elems = (Value**)pool_alloc_buf(sizeof(Value*) * new_count);
         
         // 复制目标数组元素
         for (long i = 0; i < target_count; i++) {
@@ -2499,7 +2393,7 @@ Value* value_spread_into_array(Value *target, Value *source) {
         }
     }
     
-    Value *result = (Value*)malloc(sizeof(Value));
+    Value *result = pool_alloc_value();
     result->type = VALUE_ARRAY;
     result->declared_type = VALUE_ARRAY;
     result->refcount = 1;
@@ -177,7 +177,7 @@ Value* value_read_bytes(Value *path) {
     fclose(fp);
     
     // 创建Value
-    Value *v = (Value*)malloc(sizeof(Value));
+    Value *v = pool_alloc_value();
     v->type = VALUE_OBJECT;
     v->declared_type = VALUE_OBJECT;
     v->ext_type = EXT_TYPE_BUFFER;
@@ -271,7 +271,7 @@ Value* value_read_lines(Value *path) {
             if (!new_lines) {
                 // 清理已分配的内存
                 for (size_t i = 0; i < count; i++) {
-                    free(lines[i]);
+                    value_release(lines[i]);
                 }
                 free(lines);
                 free(line);
@@ -469,7 +469,7 @@ Value* value_list_dir(Value *path) {
             Value **new_entries = (Value **)realloc(entries, capacity * sizeof(Value *));
             if (!new_entries) {
                 for (size_t i = 0; i < count; i++) {
-                    free(entries[i]);
+                    value_release(entries[i]);
                 }
                 free(entries);
                 closedir(dir);
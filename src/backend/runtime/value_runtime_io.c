@@ -73,7 +73,7 @@ Value* value_input(Value *prompt) {
     
     memcpy(result_str, buffer, len + 1);
     
-    Value *result = (Value*)malloc(sizeof(Value));
+    Value *result = pool_alloc_value();
     result->type = VALUE_STRING;
     result->declared_type = VALUE_STRING;
     result->data.string = result_str;
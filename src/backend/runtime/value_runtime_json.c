@@ -134,12 +134,12 @@ static Value* parse_json_object(const char** ptr) {
             Value* key_val = parse_json_string(&p);
             if (!key_val) break;
             
-            char* key = strdup((const char*)key_val->data.pointer);
-            free(key_val);
+            char* key = (char*)symbol_intern((const char*)key_val->data.pointer);
+            value_release(key_val);
+            if (!key) break;
             
             p = skip_whitespace(p);
             if (*p != ':') {
-                free(key);
                 break;
             }
             p++; // 跳过 :
@@ -147,10 +147,9 @@ static Value* parse_json_object(const char** ptr) {
             p = skip_whitespace(p);
             Value* value = parse_json_value(&p);
             if (!value) {
-                // 解析值失败，清理并返回 NULL
-                free(key);
+                // 解析值失败，清理并返回 NULL（key 是符号，不释放）
                 for (size_t i = 0; i < count; i++) {
-                    free(entries[i].key);
+                    value_release(entries[i].value);
                 }
                 free(entries);
                 return NULL;
@@ -160,7 +159,6 @@ static Value* parse_json_object(const char** ptr) {
                 capacity *= 2;
                 ObjectEntry* new_entries = (ObjectEntry*)realloc(entries, capacity * sizeof(ObjectEntry));
                 if (!new_entries) {
-                    free(key);
                     free(entries);
                     return box_object(NULL, 0);
                 }
@@ -184,7 +182,13 @@ static Value* parse_json_object(const char** ptr) {
     if (*p == '}') p++; // 跳过 }
     *ptr = p;
     
-    return box_object((char*)entries, count);
+    // box_object 会复制表并 retain 每个 value，这里交还解析时持有的引用
+    Value *obj = box_object_symbols((char*)entries, count);
+    for (size_t i = 0; i < count; i++) {
+        value_release(entries[i].value);
+    }
+    free(entries);
+    return obj;
 }
 
 /* 解析 JSON 值 */
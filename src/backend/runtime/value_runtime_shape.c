@@ -0,0 +1,164 @@
+/*
+ * Module: value_runtime_shape.c
+ * 对象形状 (hidden class) 与字段访问内联缓存
+ */
+
+/* ============================================================================
+ * 对象形状
+ *
+ * 线性模式的普通对象记录一个形状 id (Value.shape)：
+ *   - 形状 1 为空对象，每追加一个键沿转换树走到子形状
+ *   - 形状相同的对象，键的顺序完全相同，因此同一个键总在同一个槽位
+ *   - 形状 0 表示“未跟踪”：哈希模式对象、扩展类型对象、
+ *     未通过 box_object/value_set_field 构建的对象，以及形状表已满时
+ *
+ * 删除字段后按剩余键重新计算形状；转换为哈希模式后形状清零。
+ * 其他直接改写 ObjectEntry 表的代码必须同步维护 shape，或将其清零。
+ * ============================================================================ */
+
+#define SHAPE_NONE  0
+#define SHAPE_ROOT  1
+#define SHAPE_MAX   0xFFFF   /* Value.shape 为 16 位 */
+
+/* 转换表项：(parent, key) -> child，key 为驻留符号 */
+typedef struct {
+    const char *key;         /* NULL 表示空槽 */
+    unsigned long hash;
+    unsigned short parent;
+    unsigned short child;
+} ShapeTransition;
+
+static ShapeTransition *shape_transitions = NULL;
+static size_t shape_transition_capacity = 0;
+static size_t shape_transition_count = 0;
+static unsigned int shape_next_id = SHAPE_ROOT + 1;
+
+static inline unsigned long shape_key_hash(unsigned short parent, const char *key) {
+    return symbol_key_hash(key) ^ ((unsigned long)parent * 0x9E3779B97F4A7C15UL);
+}
+
+static int shape_table_grow(void) {
+    size_t new_capacity = shape_transition_capacity ? shape_transition_capacity * 2 : 256;
+    ShapeTransition *table = (ShapeTransition*)calloc(new_capacity, sizeof(ShapeTransition));
+    if (!table) return 0;
+
+    for (size_t i = 0; i < shape_transition_capacity; i++) {
+        ShapeTransition *t = &shape_transitions[i];
+        if (!t->key) continue;
+        size_t idx = t->hash & (new_capacity - 1);
+        while (table[idx].key) idx = (idx + 1) & (new_capacity - 1);
+        table[idx] = *t;
+    }
+
+    free(shape_transitions);
+    shape_transitions = table;
+    shape_transition_capacity = new_capacity;
+    return 1;
+}
+
+/* 形状 parent 追加符号 key 之后的形状；无法跟踪时返回 SHAPE_NONE */
+static unsigned short shape_transition(unsigned short parent, const char *key) {
+    if (parent == SHAPE_NONE || !key) return SHAPE_NONE;
+
+    if ((shape_transition_count + 1) * 2 > shape_transition_capacity) {
+        if (!shape_table_grow()) return SHAPE_NONE;
+    }
+
+    unsigned long hash = shape_key_hash(parent, key);
+    size_t mask = shape_transition_capacity - 1;
+    size_t idx = hash & mask;
+    while (shape_transitions[idx].key) {
+        ShapeTransition *t = &shape_transitions[idx];
+        if (t->key == key && t->parent == parent) {
+            return t->child;
+        }
+        idx = (idx + 1) & mask;
+    }
+
+    if (shape_next_id > SHAPE_MAX) return SHAPE_NONE;  /* 形状表已满，不再跟踪 */
+
+    shape_transitions[idx].key = key;
+    shape_transitions[idx].hash = hash;
+    shape_transitions[idx].parent = parent;
+    shape_transitions[idx].child = (unsigned short)shape_next_id++;
+    shape_transition_count++;
+    return shape_transitions[idx].child;
+}
+
+/* 按线性模式 entries 的键顺序计算形状 */
+static unsigned short shape_for_entries(ObjectEntry *entries, size_t count) {
+    unsigned short shape = SHAPE_ROOT;
+    for (size_t i = 0; i < count && shape != SHAPE_NONE; i++) {
+        shape = shape_transition(shape, entries[i].key);
+    }
+    return shape;
+}
+
+/* ============================================================================
+ * 字段访问内联缓存
+ *
+ * codegen 为每个 obj.field 读/写点生成一个 FieldIC 数组（FIELD_IC_WAYS 路）。
+ * 生成代码内联检查第 0 路（单态）：形状相同则直接按槽位读取 entries；
+ * 否则调用 value_get_field_ic / value_set_field_ic，在全部路中查找
+ * （多态），未命中时按键查找并把 (形状, 槽位) 填入缓存。
+ *
+ * 布局与 codegen 中的 [FIELD_IC_WAYS x { i32, i32 }] 一致。
+ * ============================================================================ */
+
+#define FIELD_IC_WAYS 4
+
+typedef struct {
+    unsigned int shape;   /* 0 表示空 */
+    unsigned int slot;
+} FieldIC;
+
+/* 查缓存：命中返回槽位，否则返回 -1 */
+static inline long field_ic_probe(FieldIC *ic, unsigned short shape) {
+    for (int i = 0; i < FIELD_IC_WAYS; i++) {
+        if (ic[i].shape == shape) return (long)ic[i].slot;
+        if (ic[i].shape == SHAPE_NONE) break;
+    }
+    return -1;
+}
+
+/* 填缓存：先占空路，满了则替换最后一路（保留第 0 路的单态快速路径） */
+static inline void field_ic_update(FieldIC *ic, unsigned short shape, size_t slot) {
+    int way = FIELD_IC_WAYS - 1;
+    for (int i = 0; i < FIELD_IC_WAYS; i++) {
+        if (ic[i].shape == SHAPE_NONE) {
+            way = i;
+            break;
+        }
+    }
+    ic[way].shape = shape;
+    ic[way].slot = (unsigned int)slot;
+}
+
+/* 带形状的线性对象中查找符号 key 的槽位，并更新缓存；找不到返回 -1 */
+static long field_ic_lookup(Value *obj, const char *key, FieldIC *ic) {
+    if (!obj || obj->type != VALUE_OBJECT || obj->shape == SHAPE_NONE || !ic) return -1;
+
+    long slot = field_ic_probe(ic, obj->shape);
+    if (slot >= 0) return slot;
+
+    ObjectEntry *entries = (ObjectEntry*)obj->data.pointer;
+    for (size_t i = 0; i < (size_t)obj->array_size; i++) {
+        if (entries[i].key == key) {
+            if (entries[i].value) field_ic_update(ic, obj->shape, i);
+            return (long)i;
+        }
+    }
+    return -1;
+}
+
+/* 以栈上的临时字符串 Value 包装 key，供慢速路径复用现有 API */
+static inline Value field_ic_key_value(const char *key) {
+    Value name;
+    memset(&name, 0, sizeof(name));
+    name.type = VALUE_STRING;
+    name.declared_type = VALUE_STRING;
+    name.flags = VALUE_FLAG_STATIC;
+    name.data.string = (char*)key;
+    name.string_length = strlen(key);
+    return name;
+}
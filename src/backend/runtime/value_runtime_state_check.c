@@ -23,7 +23,7 @@ Value* value_last_error() {
     char *msg = (char*)malloc(len + 1);
     strcpy(msg, g_runtime_state.error_msg);
     
-    Value *result = (Value*)malloc(sizeof(Value));
+    Value *result = pool_alloc_value();
     result->type = VALUE_STRING;
     result->declared_type = VALUE_STRING;
     result->data.string = msg;
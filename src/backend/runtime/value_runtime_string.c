@@ -412,7 +412,7 @@ Value* value_split(Value *str, Value *delimiter) {
     }
     
     // 创建数组
-    Value **elements = (Value**)malloc(count * sizeof(Value*));
+    Value **elements = (Value**)pool_alloc_buf(count * sizeof(Value*));
     size_t idx = 0;
     
     if (delim_len == 0) {
@@ -436,7 +436,7 @@ Value* value_split(Value *str, Value *delimiter) {
         elements[idx++] = box_string_owned(strdup(p));
     }
     
-    Value *result = (Value*)malloc(sizeof(Value));
+    Value *result = pool_alloc_value();
     result->type = VALUE_ARRAY;
     result->declared_type = VALUE_ARRAY;
     result->refcount = 1;
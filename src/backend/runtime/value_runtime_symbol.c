@@ -0,0 +1,128 @@
+/*
+ * Module: value_runtime_symbol.c
+ * 属性名符号表（字符串驻留）
+ */
+
+/* ============================================================================
+ * 符号表
+ *
+ * 对象表 (ObjectEntry.key) 中保存的键一律是驻留后的符号：
+ *   - 同一个名字只有一份，键比较直接比较指针
+ *   - 符号前有 SymbolHeader，保存 FNV-1a 哈希，哈希模式查找不再重复计算
+ *   - 符号永不释放，对象释放/删除字段时不 free 键
+ *
+ * 字面量属性名由 codegen 在编译期算好哈希，程序启动时经
+ * value_intern_keys 一次性驻留；运行时拼出的动态键在第一次写入对象时驻留，
+ * 只读查找用 symbol_find，不存在的名字不会进入符号表。
+ * ============================================================================ */
+
+typedef struct {
+    unsigned long hash;
+    size_t length;
+} SymbolHeader;
+
+static char **symbol_table = NULL;       /* 开放寻址，元素为符号指针 */
+static size_t symbol_capacity = 0;
+static size_t symbol_count = 0;
+
+/* FNV-1a，与 codegen 中 codegen_key_hash 保持一致 */
+static inline unsigned long symbol_hash(const char *str) {
+    unsigned long hash = 14695981039346656037UL;
+    while (*str) {
+        hash ^= (unsigned char)*str++;
+        hash *= 1099511628211UL;
+    }
+    return hash;
+}
+
+static inline unsigned long symbol_key_hash(const char *sym) {
+    return ((const SymbolHeader*)sym - 1)->hash;
+}
+
+static int symbol_table_grow(void) {
+    size_t new_capacity = symbol_capacity ? symbol_capacity * 2 : 256;
+    char **table = (char**)calloc(new_capacity, sizeof(char*));
+    if (!table) return 0;
+
+    for (size_t i = 0; i < symbol_capacity; i++) {
+        char *sym = symbol_table[i];
+        if (!sym) continue;
+        size_t idx = symbol_key_hash(sym) & (new_capacity - 1);
+        while (table[idx]) idx = (idx + 1) & (new_capacity - 1);
+        table[idx] = sym;
+    }
+
+    free(symbol_table);
+    symbol_table = table;
+    symbol_capacity = new_capacity;
+    return 1;
+}
+
+/* 查找已驻留的符号，不存在返回 NULL */
+static const char* symbol_find_hashed(const char *key, unsigned long hash) {
+    if (!symbol_capacity) return NULL;
+    size_t mask = symbol_capacity - 1;
+    size_t idx = hash & mask;
+    while (symbol_table[idx]) {
+        char *sym = symbol_table[idx];
+        if (symbol_key_hash(sym) == hash && strcmp(sym, key) == 0) return sym;
+        idx = (idx + 1) & mask;
+    }
+    return NULL;
+}
+
+static inline const char* symbol_find(const char *key) {
+    return key ? symbol_find_hashed(key, symbol_hash(key)) : NULL;
+}
+
+/* 驻留 key（hash 必须是 symbol_hash(key)），返回符号 */
+static const char* symbol_intern_hashed(const char *key, unsigned long hash) {
+    const char *found = symbol_find_hashed(key, hash);
+    if (found) return found;
+
+    if ((symbol_count + 1) * 2 > symbol_capacity && !symbol_table_grow()) return NULL;
+
+    size_t len = strlen(key);
+    SymbolHeader *h = (SymbolHeader*)malloc(sizeof(SymbolHeader) + len + 1);
+    if (!h) return NULL;
+    h->hash = hash;
+    h->length = len;
+    char *sym = (char*)(h + 1);
+    memcpy(sym, key, len + 1);
+
+    size_t mask = symbol_capacity - 1;
+    size_t idx = hash & mask;
+    while (symbol_table[idx]) idx = (idx + 1) & mask;
+    symbol_table[idx] = sym;
+    symbol_count++;
+    return sym;
+}
+
+static inline const char* symbol_intern(const char *key) {
+    return key ? symbol_intern_hashed(key, symbol_hash(key)) : NULL;
+}
+
+/* ============================================================================
+ * 字面量属性名
+ *
+ * codegen 为每个不同的字面量属性名生成一个 KeySymbol（名字 + 编译期哈希），
+ * 并通过 llvm.global_ctors 在 main 之前调用 value_intern_keys，
+ * 之后生成代码直接读取 KeySymbol.symbol 作为键。
+ * ============================================================================ */
+
+typedef struct {
+    const char *name;
+    unsigned long hash;
+    const char *symbol;   /* 启动时填入 */
+} KeySymbol;
+
+void value_intern_keys(KeySymbol **keys, long count) {
+    for (long i = 0; i < count; i++) {
+        KeySymbol *k = keys[i];
+        k->symbol = symbol_intern_hashed(k->name, k->hash);
+        if (!k->symbol) {
+            fprintf(stderr, "[FLYUX] out of memory while interning property names\n");
+            exit(1);
+        }
+    }
+}
@@ -13,6 +13,7 @@
 #define VALUE_FLAG_STATIC     0x01  /* 静态分配，不需释放 (如字符串常量) */
 #define VALUE_FLAG_BORROWED   0x02  /* 借用引用，不拥有所有权 */
 #define VALUE_FLAG_IMMORTAL   0x04  /* 永生对象，永不释放 (如全局单例) */
+#define VALUE_FLAG_ARRAY_HEAD 0x08  /* 数组头部有空闲槽（shift 之后），见 array_storage_base */
 
 /* Value structure with reference counting */
 typedef struct Value {
@@ -24,7 +25,7 @@ typedef struct Value {
     int refcount;       /* 引用计数 (0 = 未跟踪, >0 = 活跃引用数) */
     unsigned char flags;/* 内存标志位 */
     unsigned char ext_type;  /* 扩展对象类型标识 */
-    unsigned short _pad;/* 对齐填充 */
+    unsigned short shape;/* 对象形状 id（0 = 未跟踪），见 value_runtime_shape.c */
     
     /* === 数据 (16 bytes) === */
     union {
@@ -35,18 +36,23 @@ typedef struct Value {
     
     /* === 元数据 (16 bytes) === */
     long array_size;       /* 数组大小（仅当type==VALUE_ARRAY时有效）*/
-    size_t string_length;  /* 字符串长度（支持包含\0的字符串）*/
+    size_t string_length;  /* 字符串长度（支持包含\0的字符串）；
+                              数组：从 data.pointer 起的容量（0 表示等于 array_size）；
+                              对象：哈希模式的表容量 */
 } Value;
 
 /* Object key-value pair (after Value definition) */
 typedef struct ObjectEntry {
-    char *key;
+    char *key;          /* 驻留符号，见 value_runtime_symbol.c */
     Value *value;
 } ObjectEntry;
 
 /* VALUE_FUNCTION type constant */
 #define VALUE_FUNCTION 7
 
+/* 统一入口：(函数值, 参数数组, 参数个数)，由 codegen 为每个函数生成 */
+typedef struct Value* (*FunctionEntry)(struct Value *func_val, struct Value **args, long arg_count);
+
 /* Function object structure for closures */
 typedef struct FunctionObject {
     void *func_ptr;           /* 函数指针 */
@@ -56,6 +62,7 @@ typedef struct FunctionObject {
     struct Value *bound_self; /* 绑定的 self 对象（用于方法调用）*/
     int needs_self;           /* 函数是否需要 self 作为第一个参数 */
     int capture_by_ref;       /* 捕获的变量是否是引用（Value**）而不是值（Value*）*/
+    FunctionEntry entry;      /* 统一调用入口（<函数名>.entry） */
 } FunctionObject;
 
 /* ============================================================================
@@ -81,6 +88,104 @@ static void debug_rc(const char *op, Value *v, const char *context) {
 /* 前向声明 */
 static void value_free_internal(Value *v);
 
+/* 分配器（实现见 value_runtime_alloc.c） */
+Value* pool_alloc_value(void);
+void pool_free_value(Value *v);
+void* pool_alloc_buf(size_t size);
+void* pool_calloc_buf(size_t count, size_t size);
+void* pool_realloc_buf(void *ptr, size_t size);
+void pool_free_buf(void *ptr);
+
+/* ============================================================================
+ * 数组存储
+ *
+ * data.pointer 指向第一个元素，string_length 记录从 data.pointer 起可用的槽数。
+ * shift 只向后移动 data.pointer，不搬移元素；此时设置 VALUE_FLAG_ARRAY_HEAD，
+ * 并在第一个元素之前的空闲槽 (data.pointer[-1]) 中保存缓冲区起点。
+ * ============================================================================ */
+
+#define ARRAY_MIN_CAPACITY 4
+
+static inline size_t array_capacity(Value *arr) {
+    return arr->string_length > (size_t)arr->array_size ? arr->string_length : (size_t)arr->array_size;
+}
+
+/* 缓冲区起点（用于释放） */
+static inline Value** array_storage_base(Value *arr) {
+    Value **elements = (Value**)arr->data.pointer;
+    if (elements && (arr->flags & VALUE_FLAG_ARRAY_HEAD)) {
+        return (Value**)elements[-1];
+    }
+    return elements;
+}
+
+/* 头部空闲槽数 */
+static inline size_t array_head_slack(Value *arr) {
+    return (size_t)((Value**)arr->data.pointer - array_storage_base(arr));
+}
+
+/* 设置第一个元素位置，维护 VALUE_FLAG_ARRAY_HEAD 和起点记录 */
+static inline void array_set_head(Value *arr, Value **base, Value **first) {
+    arr->data.pointer = first;
+    if (first > base) {
+        first[-1] = (Value*)base;
+        arr->flags |= VALUE_FLAG_ARRAY_HEAD;
+    } else {
+        arr->flags &= (unsigned char)~VALUE_FLAG_ARRAY_HEAD;
+    }
+}
+
+/*
+ * 重新分配数组存储：新缓冲区容量为 new_capacity，元素放在 front 个空闲槽之后。
+ * 失败时保持原数组不变并返回 0。
+ */
+static int array_relocate(Value *arr, size_t new_capacity, size_t front) {
+    size_t size = (size_t)arr->array_size;
+    Value **old_base = array_storage_base(arr);
+    Value **old_elements = (Value**)arr->data.pointer;
+    Value **new_base = (Value**)pool_alloc_buf(new_capacity * sizeof(Value*));
+    if (!new_base) return 0;
+
+    if (size > 0) {
+        memcpy(new_base + front, old_elements, size * sizeof(Value*));
+    }
+    pool_free_buf(old_base);
+
+    array_set_head(arr, new_base, new_base + front);
+    arr->string_length = new_capacity - front;
+    return 1;
+}
+
+/* 确保尾部至少还能放下 extra 个元素（几何增长） */
+static int array_reserve(Value *arr, size_t extra) {
+    size_t size = (size_t)arr->array_size;
+    size_t needed = size + extra;
+    if (needed <= array_capacity(arr)) return 1;
+
+    /* 头部空闲槽足够多时先整理到缓冲区起点，避免无谓增长 */
+    size_t head = arr->data.pointer ? array_head_slack(arr) : 0;
+    if (head >= size && head + array_capacity(arr) >= needed) {
+        Value **base = array_storage_base(arr);
+        memmove(base, arr->data.pointer, size * sizeof(Value*));
+        arr->string_length = head + array_capacity(arr);
+        array_set_head(arr, base, base);
+        return 1;
+    }
+
+    size_t new_capacity = array_capacity(arr) * 2;
+    if (new_capacity < needed) new_capacity = needed;
+    if (new_capacity < ARRAY_MIN_CAPACITY) new_capacity = ARRAY_MIN_CAPACITY;
+    return array_relocate(arr, new_capacity, 0);
+}
+
+/* 元素数量降到容量的 1/4 以下时缩小一半（滞后收缩，避免 push/pop 抖动） */
+static void array_maybe_shrink(Value *arr) {
+    size_t size = (size_t)arr->array_size;
+    size_t capacity = array_capacity(arr) + array_head_slack(arr);
+    if (capacity <= ARRAY_MIN_CAPACITY * 4 || size * 4 >= capacity) return;
+    array_relocate(arr, capacity / 2, 0);
+}
+
 /*
  * value_retain - 增加引用计数
  * 返回传入的指针，方便链式调用: x = value_retain(y)
@@ -141,7 +246,7 @@ static void value_free_internal(Value *v) {
                 for (long i = 0; i < v->array_size; i++) {
                     value_release(elements[i]);
                 }
-                free(elements);
+                pool_free_buf(array_storage_base(v));
             }
             break;
         }
@@ -149,25 +254,27 @@ static void value_free_internal(Value *v) {
         case VALUE_OBJECT: {
             /* 递归释放对象属性 */
             ObjectEntry *entries = (ObjectEntry*)v->data.pointer;
-            if (entries) {
+            if (entries && v->ext_type != EXT_TYPE_NONE) {
+                /* 扩展对象（如 Buffer）的 data.pointer 不是 ObjectEntry 表 */
+                free(entries);
+            } else if (entries) {
+                /* key 是驻留符号（永不释放），只释放 value */
                 /* 检查是否是哈希模式（string_length > 0 表示哈希容量）*/
                 if (v->string_length > 0) {
                     /* 哈希模式：遍历整个表，跳过空槽和墓碑 */
                     size_t capacity = v->string_length;
                     for (size_t i = 0; i < capacity; i++) {
                         if (entries[i].key && entries[i].key != (char*)(intptr_t)-1) {
-                            free(entries[i].key);
                             value_release(entries[i].value);
                         }
                     }
                 } else {
                     /* 线性模式 */
                     for (long i = 0; i < v->array_size; i++) {
-                        if (entries[i].key) free(entries[i].key);
                         value_release(entries[i].value);
                     }
                 }
-                free(entries);
+                pool_free_buf(entries);
             }
             break;
         }
@@ -206,7 +313,7 @@ static void value_free_internal(Value *v) {
     }
     
     /* 释放 Value 本身 */
-    free(v);
+    pool_free_value(v);
 }
 
 /*
@@ -132,7 +132,10 @@ static char* unescape_string(const char* str, size_t len, size_t* out_len) {
     return result;
 }
 
-/* 动态数组扩容 */
+/* 本次 lexer_tokenize 的字符串池：lexeme 驻留其中 */
+static StringPool* lexer_strings = NULL;
+
+/* 动态数组扩容（扫描期间用 malloc 增长，结束时按实际大小拷进 Arena） */
 static int ensure_token_capacity(Token** arr, size_t* cap, size_t needed) {
     if (*cap >= needed) return 1;
     size_t new_cap = (*cap == 0) ? 32 : (*cap * 2);
@@ -446,11 +449,8 @@ static const char* token_kind_name(TokenKind kind) {
 }
 
 /* 获取原始源码位置（从映射表查询） */
-static void get_original_position(size_t mapped_offset,
-                                  const SourceLocation* norm_source_map,
-                                  size_t norm_source_map_size,
-                                  const size_t* offset_map,
-                                  size_t offset_map_size,
+static void get_original_position(size_t norm_offset,
+                                  const SourceMap* source_map,
                                   int fallback_line, int fallback_col,
                                   int* out_line, int* out_col) {
     // 默认使用回退值
@@ -458,15 +458,11 @@ static void get_original_position(size_t mapped_offset,
     *out_col = fallback_col;
     
     // 如果有映射表，尝试查询原始位置
-    if (offset_map && offset_map_size > 0 && mapped_offset < offset_map_size &&
-        norm_source_map && norm_source_map_size > 0) {
-        size_t norm_offset = offset_map[mapped_offset];
-        if (norm_offset < norm_source_map_size) {
-            const SourceLocation* loc = &norm_source_map[norm_offset];
-            if (!loc->is_synthetic && loc->orig_line > 0) {
-                *out_line = loc->orig_line;
-                *out_col = loc->orig_column;
-            }
+    if (source_map && norm_offset < source_map->text_len) {
+        SourceLocation loc = source_map_lookup(source_map, norm_offset);
+        if (!loc.is_synthetic && loc.orig_line > 0) {
+            *out_line = loc.orig_line;
+            *out_col = loc.orig_column;
         }
     }
 }
@@ -478,166 +474,136 @@ static char* make_unexpected_char_msg(char ch, int line, int col) {
     return str_dup_n(buf, strlen(buf));
 }
 
-/* 添加一个 token */
-static int emit_token(Token** tokens,
-                      size_t* count,
-                      size_t* cap,
-                      TokenKind kind,
-                      const char* lexeme_start,
-                      size_t lexeme_len,
-                      int line,
-                      int column,
-                      const SourceLocation* norm_source_map,
-                      size_t norm_source_map_size,
-                      const size_t* offset_map,
-                      size_t offset_map_size,
-                      size_t mapped_offset) {
+/* 添加一个 token
+ * lexeme 为 token 文本；source_len 为它在规范化代码中占的长度
+ * （映射后的标识符两者不同，其余 token 相同） */
+static int emit_token_ex(Token** tokens,
+                         size_t* count,
+                         size_t* cap,
+                         TokenKind kind,
+                         const char* lexeme_start,
+                         size_t lexeme_len,
+                         size_t source_len,
+                         int line,
+                         int column,
+                         const SourceMap* source_map,
+                         size_t norm_offset) {
     if (!ensure_token_capacity(tokens, cap, *count + 1)) {
         return 0;
     }
     Token* t = &(*tokens)[*count];
     t->kind = kind;
-    t->lexeme = str_dup_n(lexeme_start, lexeme_len);
+    t->lexeme = (char*)string_pool_insert(lexer_strings, lexeme_start, lexeme_len);
     if (!t->lexeme) return 0;
+    t->lexeme_length = lexeme_len;
     t->line = line;
     t->column = column;
     
-    // 查询原始源码位置（两级映射）
-    if (offset_map && offset_map_size > 0 && mapped_offset < offset_map_size &&
-        norm_source_map && norm_source_map_size > 0) {
-        // 第1级：mapped_offset → normalized_offset
-        size_t norm_offset = offset_map[mapped_offset];
-        
-        // 第2级：normalized_offset → original position
-        if (norm_offset < norm_source_map_size) {
-            const SourceLocation* loc = &norm_source_map[norm_offset];
-            
-            // 如果映射到合成字符，向前搜索最近的非合成字符
-            if (loc->is_synthetic && norm_offset > 0) {
-                for (size_t i = norm_offset; i > 0; i--) {
-                    if (!norm_source_map[i - 1].is_synthetic) {
-                        loc = &norm_source_map[i - 1];
-                        break;
-                    }
-                }
-            }
+    // 查询原始源码位置：normalized_offset → original position
+    if (source_map && source_map->text_len > 0) {
+        if (norm_offset < source_map->text_len) {
+            // 如果映射到合成字符，取前面最近的非合成字符
+            SourceLocation first_loc = source_map_lookup_nearest(source_map, norm_offset);
             
-            if (loc->is_synthetic) {
+            if (first_loc.is_synthetic) {
                 // 合成字符，标记为0
                 t->orig_line = 0;
                 t->orig_column = 0;
                 t->orig_length = 0;
             } else {
-                t->orig_line = loc->orig_line;
-                t->orig_column = loc->orig_column;
+                t->orig_line = first_loc.orig_line;
+                t->orig_column = first_loc.orig_column;
                 
-                // 计算整个token的原始长度
-                // 策略1：检查是否所有字符映射到同一位置（varmap替换的标识符）
-                // 策略2：计算从第一个到最后一个非synthetic字符的跨度
+                // 计算整个token的原始长度：从第一个到最后一个非synthetic字符的跨度
                 int total_orig_len = 0;
-                int all_same_pos = 1;
-                size_t first_norm_off = norm_offset;
-                const SourceLocation* first_loc = loc;
-                const SourceLocation* last_loc = NULL;
-                int found_valid = 0;
+                SourceLocation last_loc = first_loc;
+                size_t last_offset = norm_offset;
                 
-                // 遍历所有字符，找到最后一个有效字符
-                for (size_t k = 0; k < lexeme_len; k++) {
-                    size_t map_off = mapped_offset + k;
-                    if (map_off < offset_map_size) {
-                        size_t norm_off = offset_map[map_off];
-                        if (norm_off < norm_source_map_size) {
-                            const SourceLocation* cur_loc = &norm_source_map[norm_off];
-                            if (!cur_loc->is_synthetic && cur_loc->orig_line > 0) {
-                                last_loc = cur_loc;
-                                found_valid = 1;
-                                if (norm_off != first_norm_off) {
-                                    all_same_pos = 0;
-                                }
-                            }
-                        }
+                // 从后向前找到最后一个有效字符
+                for (size_t k = source_len; k > 1; k--) {
+                    size_t off = norm_offset + k - 1;
+                    if (off >= source_map->text_len) continue;
+                    SourceLocation cur_loc = source_map_lookup(source_map, off);
+                    if (!cur_loc.is_synthetic && cur_loc.orig_line > 0) {
+                        last_loc = cur_loc;
+                        last_offset = off;
+                        break;
                     }
                 }
                 
-                // 如果没找到有效字符，使用第一个字符
-                if (!found_valid || !last_loc) {
-                    last_loc = first_loc;
-                }
-                
                 // 计算长度
-                if (all_same_pos || first_loc == last_loc) {
-                    // 所有字符映射到同一位置，或只有一个字符
-                    // 对于varmap替换的标识符，使用orig_length
-                    // 对于普通标识符（orig_length=1），使用lexeme_len
-                    total_orig_len = first_loc->orig_length;
-                    if (total_orig_len == 1 && lexeme_len > 1) {
-                        // 普通多字符标识符，orig_length只记录了单个字符
-                        // 使用实际的token长度
-                        total_orig_len = (int)lexeme_len;
-                    }
-                } else if (first_loc->orig_line == last_loc->orig_line) {
+                if (last_offset == norm_offset) {
+                    // 只有一个字符（多字节字符的 orig_length 为其字节数）
+                    total_orig_len = first_loc.orig_length;
+                } else if (first_loc.orig_line == last_loc.orig_line) {
                     // 同一行：用跨度计算
-                    total_orig_len = (last_loc->orig_column - first_loc->orig_column) + last_loc->orig_length;
+                    total_orig_len = (last_loc.orig_column - first_loc.orig_column) + last_loc.orig_length;
                 } else {
                     // 跨行或其他情况：累加所有字符长度
                     total_orig_len = 0;
-                    for (size_t k = 0; k < lexeme_len; k++) {
-                        size_t map_off = mapped_offset + k;
-                        if (map_off < offset_map_size) {
-                            size_t norm_off = offset_map[map_off];
-                            if (norm_off < norm_source_map_size) {
-                                const SourceLocation* cur_loc = &norm_source_map[norm_off];
-                                if (!cur_loc->is_synthetic && cur_loc->orig_line > 0) {
-                                    total_orig_len += cur_loc->orig_length;
-                                }
-                            }
+                    for (size_t k = 0; k < source_len && norm_offset + k < source_map->text_len; k++) {
+                        SourceLocation cur_loc = source_map_lookup(source_map, norm_offset + k);
+                        if (!cur_loc.is_synthetic && cur_loc.orig_line > 0) {
+                            total_orig_len += cur_loc.orig_length;
                         }
                     }
                     // 如果累加结果为0，至少用第一个字符的长度
                     if (total_orig_len == 0) {
-                        total_orig_len = first_loc->orig_length;
+                        total_orig_len = first_loc.orig_length;
                     }
                 }
                 
-                // 如果所有字符映射到同一位置（变量被替换），只用第一个字符的长度
-                // 否则使用累加的总长度
-                t->orig_length = total_orig_len > 0 ? total_orig_len : (int)lexeme_len;
+                t->orig_length = total_orig_len > 0 ? total_orig_len : (int)source_len;
             }
         } else {
             // 越界，使用规范化位置
             t->orig_line = line;
             t->orig_column = column;
-            t->orig_length = (int)lexeme_len;
+            t->orig_length = (int)source_len;
         }
     } else {
         // 无映射，使用规范化位置
         t->orig_line = line;
         t->orig_column = column;
-        t->orig_length = (int)lexeme_len;
+        t->orig_length = (int)source_len;
     }
     
     (*count)++;
     return 1;
 }
 
+static int emit_token(Token** tokens,
+                      size_t* count,
+                      size_t* cap,
+                      TokenKind kind,
+                      const char* lexeme_start,
+                      size_t lexeme_len,
+                      int line,
+                      int column,
+                      const SourceMap* source_map,
+                      size_t norm_offset) {
+    return emit_token_ex(tokens, count, cap, kind, lexeme_start, lexeme_len, lexeme_len,
+                         line, column, source_map, norm_offset);
+}
+
 /* ========== 主词法分析 ========== */
 
 LexerResult lexer_tokenize(const char* source,
-                          const SourceLocation* norm_source_map,
-                          size_t norm_source_map_size,
-                          const size_t* offset_map,
-                          size_t offset_map_size) {
+                          const SourceMap* source_map,
+                          VarMap* varmap,
+                          StringPool* strings) {
     LexerResult result;
     result.tokens = NULL;
     result.count = 0;
     result.error_msg = NULL;
     result.error_code = 0;
 
-    if (!source) {
+    if (!source || !strings) {
         result.error_code = -1;
         result.error_msg = str_dup_n("source is NULL", strlen("source is NULL"));
         return result;
     }
+    lexer_strings = strings;
 
     size_t len = strlen(source);
     size_t cap = 0;
@@ -670,7 +636,7 @@ LexerResult lexer_tokenize(const char* source,
         if (c == 'L' && i + 1 < len && source[i + 1] == '>') {
             if (!emit_token(&tokens, &result.count, &cap,
                             TK_KW_LOOP, source + i, 2, start_line, start_col,
-                            norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                            source_map, start_offset)) {
                 result.error_code = -1;
                 result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                 goto fail;
@@ -683,7 +649,7 @@ LexerResult lexer_tokenize(const char* source,
         if (c == 'R' && i + 1 < len && source[i + 1] == '>') {
             if (!emit_token(&tokens, &result.count, &cap,
                             TK_KW_RETURN, source + i, 2, start_line, start_col,
-                            norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                            source_map, start_offset)) {
                 result.error_code = -1;
                 result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                 goto fail;
@@ -696,7 +662,7 @@ LexerResult lexer_tokenize(const char* source,
         if (c == 'T' && i + 1 < len && source[i + 1] == '>') {
             if (!emit_token(&tokens, &result.count, &cap,
                             TK_KW_TRY, source + i, 2, start_line, start_col,
-                            norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                            source_map, start_offset)) {
                 result.error_code = -1;
                 result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                 goto fail;
@@ -710,7 +676,7 @@ LexerResult lexer_tokenize(const char* source,
         if (c == 'B' && i + 1 < len && source[i + 1] == '>') {
             if (!emit_token(&tokens, &result.count, &cap,
                             TK_KW_BREAK, source + i, 2, start_line, start_col,
-                            norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                            source_map, start_offset)) {
                 result.error_code = -1;
                 result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                 goto fail;
@@ -724,7 +690,7 @@ LexerResult lexer_tokenize(const char* source,
         if (c == 'N' && i + 1 < len && source[i + 1] == '>') {
             if (!emit_token(&tokens, &result.count, &cap,
                             TK_KW_NEXT, source + i, 2, start_line, start_col,
-                            norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                            source_map, start_offset)) {
                 result.error_code = -1;
                 result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                 goto fail;
@@ -745,6 +711,19 @@ LexerResult lexer_tokenize(const char* source,
             }
             size_t ident_len = i - start;
             
+            /* 变量名映射：当场决定 token 名字（映射名或原名），不生成改名后的源码
+             * （映射表同时检查 X> 与非 FLYUX 关键字，带源码行的错误信息优先） */
+            const char* name = source + start;
+            size_t name_len = ident_len;
+            if (varmap) {
+                name = flyux_varmap_identifier(varmap, start, i, &name_len);
+                if (!name) {
+                    result.error_code = varmap->error_code;
+                    result.error_msg = str_dup_n(varmap->error_msg, strlen(varmap->error_msg));
+                    goto fail;
+                }
+            }
+
             /* Check for invalid X> format (single uppercase letter followed by >, not valid L>/R>/T>/B>/N>) */
             if (ident_len == 1 && isupper((unsigned char)source[start]) 
                 && i < len && source[i] == '>'
@@ -752,8 +731,7 @@ LexerResult lexer_tokenize(const char* source,
                 && source[start] != 'B' && source[start] != 'N') {
                 /* Get original position for error reporting */
                 int orig_line, orig_col;
-                get_original_position(start_offset, norm_source_map, norm_source_map_size,
-                                      offset_map, offset_map_size,
+                get_original_position(start_offset, source_map,
                                       start_line, start_col,
                                       &orig_line, &orig_col);
                 
@@ -773,29 +751,22 @@ LexerResult lexer_tokenize(const char* source,
                 goto fail;
             }
             
-            char* lexeme = str_dup_n(source + start, ident_len);
-            if (!lexeme) {
-                result.error_code = -1;
-                result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
-                goto fail;
-            }
-
             /* 
              * 注意：无效关键词检测已移除
              * 原因：lexer 无法区分上下文，例如 { fn: xxx } 中的 fn 作为对象属性名是合法的
              * 关键词检测现在由 parser 在正确的上下文中进行
              */
 
-            TokenKind kind = classify_identifier(lexeme);
-
-            /* emit_token will copy lexeme again, free this temporary one first */
-            free(lexeme);
-            if (!emit_token(&tokens, &result.count, &cap,
-                            kind, source + start, ident_len, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+            /* 先驻留名字，再用驻留后的（以 \0 结尾的）lexeme 判定种类 */
+            if (!emit_token_ex(&tokens, &result.count, &cap,
+                               TK_IDENT, name, name_len, ident_len, start_line, start_col,
+                               source_map, start_offset)) {
                 result.error_code = -1;
                 result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                 goto fail;
             }
+            Token* ident = &tokens[result.count - 1];
+            ident->kind = classify_identifier(ident->lexeme);
             continue;
         }
 
@@ -835,8 +806,7 @@ LexerResult lexer_tokenize(const char* source,
                 } else {
                     /* 无效的科学计数法格式 - 使用原始源码位置 */
                     int orig_line, orig_col;
-                    get_original_position(start_offset, norm_source_map, norm_source_map_size,
-                                          offset_map, offset_map_size,
+                    get_original_position(start_offset, source_map,
                                           start_line, start_col,
                                           &orig_line, &orig_col);
                     result.error_code = 1;
@@ -851,7 +821,7 @@ LexerResult lexer_tokenize(const char* source,
             
             size_t num_len = i - start;
             if (!emit_token(&tokens, &result.count, &cap,
-                            TK_NUM, source + start, num_len, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                            TK_NUM, source + start, num_len, start_line, start_col, source_map, start_offset)) {
                 result.error_code = -1;
                 result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                 goto fail;
@@ -887,8 +857,7 @@ LexerResult lexer_tokenize(const char* source,
             } else {
                 /* 未闭合的字符串 - 使用原始源码位置 */
                 int orig_line, orig_col;
-                get_original_position(start, norm_source_map, norm_source_map_size,
-                                      offset_map, offset_map_size,
+                get_original_position(start, source_map,
                                       start_line_str, start_col_str,
                                       &orig_line, &orig_col);
                 result.error_code = 1;
@@ -926,32 +895,28 @@ LexerResult lexer_tokenize(const char* source,
             
             Token* t = &tokens[result.count];
             t->kind = TK_STRING;
-            t->lexeme = unescaped;  /* 使用转义后的字符串 */
+            t->lexeme = (char*)string_pool_insert(lexer_strings, unescaped, unescaped_len);  /* 使用转义后的字符串 */
             t->lexeme_length = unescaped_len;  /* 保存实际长度，支持\0字符串 */
+            free(unescaped);
+            if (!t->lexeme) {
+                result.error_code = -1;
+                result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
+                goto fail;
+            }
             t->line = start_line_str;
             t->column = start_col_str;
             
             /* 设置原始源位置映射 */
-            if (offset_map && offset_map_size > 0 && start < offset_map_size &&
-                norm_source_map && norm_source_map_size > 0) {
-                size_t norm_offset = offset_map[start];
-                if (norm_offset < norm_source_map_size) {
-                    const SourceLocation* loc = &norm_source_map[norm_offset];
-                    if (loc->is_synthetic && norm_offset > 0) {
-                        for (size_t j = norm_offset; j > 0; j--) {
-                            if (!norm_source_map[j - 1].is_synthetic) {
-                                loc = &norm_source_map[j - 1];
-                                break;
-                            }
-                        }
-                    }
-                    if (loc->is_synthetic) {
+            if (source_map && source_map->text_len > 0) {
+                if (start < source_map->text_len) {
+                    SourceLocation loc = source_map_lookup_nearest(source_map, start);
+                    if (loc.is_synthetic) {
                         t->orig_line = 0;
                         t->orig_column = 0;
                         t->orig_length = 0;
                     } else {
-                        t->orig_line = loc->orig_line;
-                        t->orig_column = loc->orig_column;
+                        t->orig_line = loc.orig_line;
+                        t->orig_column = loc.orig_column;
                         t->orig_length = (int)(i - start);
                     }
                 } else {
@@ -976,7 +941,7 @@ LexerResult lexer_tokenize(const char* source,
             if (i + 2 < len && source[i + 1] == '.' && source[i + 2] == '.') {
                 /* ... 展开运算符 */
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_SPREAD, source + i, 3, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_SPREAD, source + i, 3, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -986,7 +951,7 @@ LexerResult lexer_tokenize(const char* source,
             } else if (i + 1 < len && source[i + 1] == '@') {
                 /* .@ 未绑定方法访问 */
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_DOT_AT, source + i, 2, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_DOT_AT, source + i, 2, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -995,7 +960,7 @@ LexerResult lexer_tokenize(const char* source,
                 col += 2;
             } else if (i + 1 < len && source[i + 1] == '>') {
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_DOT_CHAIN, source + i, 2, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_DOT_CHAIN, source + i, 2, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1004,7 +969,7 @@ LexerResult lexer_tokenize(const char* source,
                 col += 2;
             } else {
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_DOT, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_DOT, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1019,7 +984,7 @@ LexerResult lexer_tokenize(const char* source,
         if (c == ':') {
             if (i + 1 < len && source[i + 1] == '=') {
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_DEFINE, source + i, 2, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_DEFINE, source + i, 2, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1028,7 +993,7 @@ LexerResult lexer_tokenize(const char* source,
                 col += 2;
             } else if (i + 1 < len && source[i + 1] == '<') {
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_FUNC_TYPE_START, source + i, 2, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_FUNC_TYPE_START, source + i, 2, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1037,7 +1002,7 @@ LexerResult lexer_tokenize(const char* source,
                 col += 2;
             } else {
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_COLON, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_COLON, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1052,7 +1017,7 @@ LexerResult lexer_tokenize(const char* source,
         if (c == '&') {
             if (i + 1 < len && source[i + 1] == '&') {
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_AND_AND, source + i, 2, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_AND_AND, source + i, 2, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1062,7 +1027,7 @@ LexerResult lexer_tokenize(const char* source,
             } else {
                 /* 单独的 & ：位与 */
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_BIT_AND, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_BIT_AND, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1077,7 +1042,7 @@ LexerResult lexer_tokenize(const char* source,
         if (c == '|') {
             if (i + 1 < len && source[i + 1] == '|') {
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_OR_OR, source + i, 2, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_OR_OR, source + i, 2, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1087,7 +1052,7 @@ LexerResult lexer_tokenize(const char* source,
             } else {
                 /* 单独的 | ：位或 */
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_BIT_OR, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_BIT_OR, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1101,7 +1066,7 @@ LexerResult lexer_tokenize(const char* source,
         /* @ 解绑运算符 */
         if (c == '@') {
             if (!emit_token(&tokens, &result.count, &cap,
-                            TK_AT, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                            TK_AT, source + i, 1, start_line, start_col, source_map, start_offset)) {
                 result.error_code = -1;
                 result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                 goto fail;
@@ -1115,7 +1080,7 @@ LexerResult lexer_tokenize(const char* source,
         if (c == '!') {
             if (i + 1 < len && source[i + 1] == '=') {
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_BANG_EQ, source + i, 2, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_BANG_EQ, source + i, 2, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1124,7 +1089,7 @@ LexerResult lexer_tokenize(const char* source,
                 col += 2;
             } else {
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_BANG, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_BANG, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1139,7 +1104,7 @@ LexerResult lexer_tokenize(const char* source,
         if (c == '=') {
             if (i + 1 < len && source[i + 1] == '=') {
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_EQ_EQ, source + i, 2, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_EQ_EQ, source + i, 2, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1148,7 +1113,7 @@ LexerResult lexer_tokenize(const char* source,
                 col += 2;
             } else {
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_ASSIGN, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_ASSIGN, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1163,7 +1128,7 @@ LexerResult lexer_tokenize(const char* source,
         if (c == '<') {
             if (i + 1 < len && source[i + 1] == '=') {
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_LE, source + i, 2, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_LE, source + i, 2, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1172,7 +1137,7 @@ LexerResult lexer_tokenize(const char* source,
                 col += 2;
             } else {
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_LT, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_LT, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1188,7 +1153,7 @@ LexerResult lexer_tokenize(const char* source,
             if (i + 1 < len && source[i + 1] == '=') {
                 // >= 统一识别为 TK_GE，在parser中根据上下文判断是比较运算符还是函数类型结尾
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_GE, source + i, 2, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_GE, source + i, 2, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1197,7 +1162,7 @@ LexerResult lexer_tokenize(const char* source,
                 col += 2;
             } else {
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_GT, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_GT, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1213,7 +1178,7 @@ LexerResult lexer_tokenize(const char* source,
             if (i + 1 < len && source[i + 1] == '+') {
                 if (!emit_token(&tokens, &result.count, &cap,
                                 TK_PLUS_PLUS, source + i, 2, start_line, start_col,
-                                norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1223,7 +1188,7 @@ LexerResult lexer_tokenize(const char* source,
             } else {
                 if (!emit_token(&tokens, &result.count, &cap,
                                 TK_PLUS, source + i, 1, start_line, start_col,
-                                norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1239,7 +1204,7 @@ LexerResult lexer_tokenize(const char* source,
             if (i + 1 < len && source[i + 1] == '-') {
                 if (!emit_token(&tokens, &result.count, &cap,
                                 TK_MINUS_MINUS, source + i, 2, start_line, start_col,
-                                norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1249,7 +1214,7 @@ LexerResult lexer_tokenize(const char* source,
             } else {
                 if (!emit_token(&tokens, &result.count, &cap,
                                 TK_MINUS, source + i, 1, start_line, start_col,
-                                norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1266,7 +1231,7 @@ LexerResult lexer_tokenize(const char* source,
                 /* * / ** */
                 if (i + 1 < len && source[i + 1] == '*') {
                     if (!emit_token(&tokens, &result.count, &cap,
-                                    TK_POWER, source + i, 2, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                    TK_POWER, source + i, 2, start_line, start_col, source_map, start_offset)) {
                         result.error_code = -1;
                         result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                         goto fail;
@@ -1274,7 +1239,7 @@ LexerResult lexer_tokenize(const char* source,
                     i += 2; col += 2;
                 } else {
                     if (!emit_token(&tokens, &result.count, &cap,
-                                    TK_STAR, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                    TK_STAR, source + i, 1, start_line, start_col, source_map, start_offset)) {
                         result.error_code = -1;
                         result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                         goto fail;
@@ -1284,7 +1249,7 @@ LexerResult lexer_tokenize(const char* source,
                 continue;
             case '/':
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_SLASH, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_SLASH, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1293,7 +1258,7 @@ LexerResult lexer_tokenize(const char* source,
                 continue;
             case '%':
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_PERCENT, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_PERCENT, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1303,7 +1268,7 @@ LexerResult lexer_tokenize(const char* source,
             case '^':
                 /* 位异或 */
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_BIT_XOR, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_BIT_XOR, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1314,7 +1279,7 @@ LexerResult lexer_tokenize(const char* source,
                 /* ?. 可选链访问 */
                 if (i + 1 < len && source[i + 1] == '.') {
                     if (!emit_token(&tokens, &result.count, &cap,
-                                    TK_QUESTION_DOT, source + i, 2, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                    TK_QUESTION_DOT, source + i, 2, start_line, start_col, source_map, start_offset)) {
                         result.error_code = -1;
                         result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                         goto fail;
@@ -1325,7 +1290,7 @@ LexerResult lexer_tokenize(const char* source,
                 /* ?[ 可选链索引访问 */
                 if (i + 1 < len && source[i + 1] == '[') {
                     if (!emit_token(&tokens, &result.count, &cap,
-                                    TK_QUESTION_BRACKET, source + i, 2, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                    TK_QUESTION_BRACKET, source + i, 2, start_line, start_col, source_map, start_offset)) {
                         result.error_code = -1;
                         result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                         goto fail;
@@ -1336,7 +1301,7 @@ LexerResult lexer_tokenize(const char* source,
                 /* ?? 空值合并运算符 */
                 if (i + 1 < len && source[i + 1] == '?') {
                     if (!emit_token(&tokens, &result.count, &cap,
-                                    TK_NULLISH_COALESCE, source + i, 2, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                    TK_NULLISH_COALESCE, source + i, 2, start_line, start_col, source_map, start_offset)) {
                         result.error_code = -1;
                         result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                         goto fail;
@@ -1346,7 +1311,7 @@ LexerResult lexer_tokenize(const char* source,
                 }
                 /* 三元运算符问号 */
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_QUESTION, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_QUESTION, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1355,7 +1320,7 @@ LexerResult lexer_tokenize(const char* source,
                 continue;
             case ';':
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_SEMI, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_SEMI, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1364,7 +1329,7 @@ LexerResult lexer_tokenize(const char* source,
                 continue;
             case ',':
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_COMMA, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_COMMA, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1373,7 +1338,7 @@ LexerResult lexer_tokenize(const char* source,
                 continue;
             case '(':
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_L_PAREN, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_L_PAREN, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1382,7 +1347,7 @@ LexerResult lexer_tokenize(const char* source,
                 continue;
             case ')':
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_R_PAREN, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_R_PAREN, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1391,7 +1356,7 @@ LexerResult lexer_tokenize(const char* source,
                 continue;
             case '{':
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_L_BRACE, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_L_BRACE, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1400,7 +1365,7 @@ LexerResult lexer_tokenize(const char* source,
                 continue;
             case '}':
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_R_BRACE, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_R_BRACE, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1409,7 +1374,7 @@ LexerResult lexer_tokenize(const char* source,
                 continue;
             case '[':
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_L_BRACKET, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_L_BRACKET, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1418,7 +1383,7 @@ LexerResult lexer_tokenize(const char* source,
                 continue;
             case ']':
                 if (!emit_token(&tokens, &result.count, &cap,
-                                TK_R_BRACKET, source + i, 1, start_line, start_col, norm_source_map, norm_source_map_size, offset_map, offset_map_size, start_offset)) {
+                                TK_R_BRACKET, source + i, 1, start_line, start_col, source_map, start_offset)) {
                     result.error_code = -1;
                     result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
                     goto fail;
@@ -1431,8 +1396,7 @@ LexerResult lexer_tokenize(const char* source,
 
         /* 未知字符 - 使用原始源码位置 */
         int orig_line, orig_col;
-        get_original_position(i, norm_source_map, norm_source_map_size,
-                              offset_map, offset_map_size,
+        get_original_position(i, source_map,
                               line, col,
                               &orig_line, &orig_col);
         result.error_code = 1;
@@ -1441,18 +1405,21 @@ LexerResult lexer_tokenize(const char* source,
     }
 
     /* 注意：不再生成 EOF token，语法结束完全靠 ';' 和 token 数组长度 */
-    result.tokens = tokens;
+    result.tokens = (Token*)arena_alloc(lexer_strings->arena, (result.count ? result.count : 1) * sizeof(Token));
+    if (!result.tokens) {
+        result.error_code = -1;
+        result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
+        goto fail;
+    }
+    if (result.count) memcpy(result.tokens, tokens, result.count * sizeof(Token));
+    free(tokens);
     result.error_code = 0;
     result.error_msg = NULL;
     return result;
 
 fail:
-    if (tokens) {
-        for (size_t k = 0; k < result.count; k++) {
-            free(tokens[k].lexeme);
-        }
-        free(tokens);
-    }
+    /* lexeme 都在字符串池的 Arena 中，随它一起释放 */
+    free(tokens);
     result.tokens = NULL;
     result.count = 0;
     return result;
@@ -1462,13 +1429,7 @@ fail:
 
 void lexer_result_free(LexerResult* result) {
     if (!result) return;
-    if (result->tokens) {
-        for (size_t i = 0; i < result->count; i++) {
-            free(result->tokens[i].lexeme);
-        }
-        free(result->tokens);
-        result->tokens = NULL;
-    }
+    result->tokens = NULL;  /* 归 Arena 所有 */
     if (result->error_msg) {
         free(result->error_msg);
         result->error_msg = NULL;
@@ -971,11 +971,140 @@ static char* normalize_internal_newlines(const char* stmt) {
     return result;
 }
 
+/* ========== 紧凑源码位置映射 ========== */
+
+typedef struct {
+    SourceMap* map;
+    size_t next_norm;     /* 延续当前片段时下一个字符的规范化偏移 */
+    int next_line;        /* 延续当前片段时下一个字符的原始行号（合成片段为 0） */
+    int next_column;      /* 延续当前片段时下一个字符的原始列号 */
+    int failed;
+} SourceMapBuilder;
+
+static void source_map_builder_init(SourceMapBuilder* b, SourceMap* map,
+                                    const char* text, size_t text_len) {
+    map->segments = NULL;
+    map->count = 0;
+    map->capacity = 0;
+    map->text = text;
+    map->text_len = text_len;
+    b->map = map;
+    b->next_norm = 0;
+    b->next_line = -1;
+    b->next_column = 0;
+    b->failed = 0;
+}
+
+static void source_map_push(SourceMapBuilder* b, size_t norm_start, int line, int column) {
+    SourceMap* map = b->map;
+    if (map->count == map->capacity) {
+        size_t new_cap = map->capacity ? map->capacity * 2 : 64;
+        SourceSegment* p = (SourceSegment*)realloc(map->segments, new_cap * sizeof(SourceSegment));
+        if (!p) {
+            b->failed = 1;
+            return;
+        }
+        map->segments = p;
+        map->capacity = new_cap;
+    }
+    SourceSegment* seg = &map->segments[map->count++];
+    seg->norm_start = norm_start;
+    seg->orig_line = line;
+    seg->orig_column = column;
+}
+
+/* 记录 norm_idx 处来自原始源码 (line, column) 的一个字符（char_bytes 字节） */
+static void source_map_record(SourceMapBuilder* b, size_t norm_idx, int char_bytes,
+                              int line, int column) {
+    if (b->failed) return;
+    if (norm_idx != b->next_norm || line != b->next_line || column != b->next_column ||
+        char_bytes > 1) {
+        source_map_push(b, norm_idx, line, column);
+    }
+    b->next_norm = norm_idx + char_bytes;
+    // 多字节字符单独成段，保证其余片段内字节数与列数一一对应
+    b->next_line = char_bytes > 1 ? -1 : line;
+    b->next_column = column + 1;
+}
+
+/* 记录 norm_idx 处的一个合成字符 */
+static void source_map_record_synthetic(SourceMapBuilder* b, size_t norm_idx) {
+    if (b->failed) return;
+    if (norm_idx != b->next_norm || b->next_line != 0) {
+        source_map_push(b, norm_idx, 0, 0);
+    }
+    b->next_norm = norm_idx + 1;
+    b->next_line = 0;
+    b->next_column = 0;
+}
+
+/* 包含 offset 的片段下标，不存在返回 -1 */
+static long source_map_find_segment(const SourceMap* map, size_t offset) {
+    if (!map || !map->segments || offset >= map->text_len) return -1;
+    size_t lo = 0, hi = map->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (map->segments[mid].norm_start <= offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return (long)lo - 1;
+}
+
+static SourceLocation source_map_segment_location(const SourceMap* map, long index, size_t offset) {
+    SourceLocation loc = {0, 0, 0, 1};
+    if (index < 0) return loc;
+    const SourceSegment* seg = &map->segments[index];
+    if (seg->orig_line == 0) return loc;
+
+    // ASCII 片段内偏移即列差；多字节字符自成一段，后续字节与首字节同列，长度为 0
+    size_t delta = offset - seg->norm_start;
+    unsigned char lead = (unsigned char)map->text[seg->norm_start];
+    int column = seg->orig_column;
+    int length = 1;
+    if (lead < 0x80) {
+        column += (int)delta;
+    } else if (delta > 0) {
+        length = 0;
+    } else if (lead >= 0xF0) {
+        length = 4;
+    } else if (lead >= 0xE0) {
+        length = 3;
+    } else if (lead >= 0xC0) {
+        length = 2;
+    }
+
+    loc.orig_line = seg->orig_line;
+    loc.orig_column = column;
+    loc.orig_length = length;
+    loc.is_synthetic = 0;
+    return loc;
+}
+
+SourceLocation source_map_lookup(const SourceMap* map, size_t offset) {
+    return source_map_segment_location(map, source_map_find_segment(map, offset), offset);
+}
+
+SourceLocation source_map_lookup_nearest(const SourceMap* map, size_t offset) {
+    long index = source_map_find_segment(map, offset);
+    if (index >= 0 && map->segments[index].orig_line == 0) {
+        // 合成片段：取前面最近的非合成片段的最后一个字符
+        long prev = index - 1;
+        while (prev >= 0 && map->segments[prev].orig_line == 0) prev--;
+        if (prev >= 0) {
+            return source_map_segment_location(map, prev, map->segments[prev + 1].norm_start - 1);
+        }
+    }
+    return source_map_segment_location(map, index, offset);
+}
+
 /**
  * 主规范化函数
  */
 NormalizeResult flyux_normalize(const char* source_code) {
-    NormalizeResult result = {NULL, NULL, 0, NULL, 0};
+    NormalizeResult result = {NULL, {NULL, 0, 0, NULL, 0}, NULL, 0};
     
     if (!source_code) {
         result.error_msg = "Source code is null";
@@ -1090,15 +1219,10 @@ NormalizeResult flyux_normalize(const char* source_code) {
     free(normalized_stmts);
     free_statements(statements, stmt_count);
     
-    // 构建源码位置映射：记录每个规范化字符对应的原始位置
+    // 构建源码位置映射：记录每个规范化字符对应的原始位置（按片段压缩）
     size_t norm_len = strlen(normalized);
-    SourceLocation* source_map = malloc(norm_len * sizeof(SourceLocation));
-    if (!source_map) {
-        free(normalized);
-        result.error_msg = "Memory allocation failed for source_map";
-        result.error_code = -1;
-        return result;
-    }
+    SourceMapBuilder map_builder;
+    source_map_builder_init(&map_builder, &result.source_map, normalized, norm_len);
     
     // 构建字符级映射
     int orig_line = 1, orig_col = 1;
@@ -1222,14 +1346,12 @@ NormalizeResult flyux_normalize(const char* source_code) {
         if (src_idx >= src_len) {
             // 原始源码已结束，normalized还有字符 → 必定是synthetic
             if (normalized[norm_idx] == ';') {
-                source_map[norm_idx].orig_line = 0;
-                source_map[norm_idx].orig_column = 0;
-                source_map[norm_idx].orig_length = 0;
-                source_map[norm_idx].is_synthetic = 1;
+                source_map_record_synthetic(&map_builder, norm_idx);
                 norm_idx++;
                 continue;
             }
             // 其他情况（不应该发生）
+            source_map_record_synthetic(&map_builder, norm_idx);
             norm_idx++;
             continue;
         }
@@ -1239,10 +1361,7 @@ NormalizeResult flyux_normalize(const char* source_code) {
         // 尝试匹配
         if (src_ch == normalized[norm_idx]) {
             // 匹配成功！
-            source_map[norm_idx].orig_line = orig_line;
-            source_map[norm_idx].orig_column = orig_col;
-            source_map[norm_idx].is_synthetic = 0;
-            
+
             // 判断UTF-8字符长度
             int char_bytes = 1;
             if ((unsigned char)src_ch >= 0x80) {
@@ -1253,18 +1372,8 @@ NormalizeResult flyux_normalize(const char* source_code) {
             }
             
             if (char_bytes > 0) {
-                // 字符首字节
-                source_map[norm_idx].orig_length = char_bytes;
-                
-                // 处理多字节字符的后续字节
-                for (int b = 1; b < char_bytes && (norm_idx + b) < norm_len && (src_idx + b) < src_len; b++) {
-                    if (source_code[src_idx + b] == normalized[norm_idx + b]) {
-                        source_map[norm_idx + b].orig_line = orig_line;
-                        source_map[norm_idx + b].orig_column = orig_col;
-                        source_map[norm_idx + b].orig_length = 0;
-                        source_map[norm_idx + b].is_synthetic = 0;
-                    }
-                }
+                // 字符首字节（后续字节随首字节落在同一片段内）
+                source_map_record(&map_builder, norm_idx, char_bytes, orig_line, orig_col);
                 
                 // 前进
                 norm_idx += char_bytes;
@@ -1277,10 +1386,7 @@ NormalizeResult flyux_normalize(const char* source_code) {
         } else {
             // 不匹配：可能是synthetic分号
             if (normalized[norm_idx] == ';') {
-                source_map[norm_idx].orig_line = 0;
-                source_map[norm_idx].orig_column = 0;
-                source_map[norm_idx].orig_length = 0;
-                source_map[norm_idx].is_synthetic = 1;
+                source_map_record_synthetic(&map_builder, norm_idx);
                 norm_idx++;
                 // 不前进src_idx，继续用当前原始位置
             } else {
@@ -1293,16 +1399,20 @@ NormalizeResult flyux_normalize(const char* source_code) {
     
     // 标记合成字符（normalize添加的分号等）
     while (norm_idx < norm_len) {
-        source_map[norm_idx].orig_line = 0;  // 0表示合成
-        source_map[norm_idx].orig_column = 0;
-        source_map[norm_idx].orig_length = 0;
-        source_map[norm_idx].is_synthetic = 1;
+        source_map_record_synthetic(&map_builder, norm_idx);
         norm_idx++;
     }
     
+    if (map_builder.failed) {
+        free(normalized);
+        free(result.source_map.segments);
+        result.source_map.segments = NULL;
+        result.error_msg = "Memory allocation failed for source_map";
+        result.error_code = -1;
+        return result;
+    }
+    
     result.normalized = normalized;
-    result.source_map = source_map;
-    result.source_map_size = norm_len;
     result.error_code = 0;
     return result;
 }
@@ -1316,10 +1426,13 @@ void normalize_result_free(NormalizeResult* result) {
         free(result->normalized);
         result->normalized = NULL;
     }
-    if (result->source_map) {
-        free(result->source_map);
-        result->source_map = NULL;
+    if (result->source_map.segments) {
+        free(result->source_map.segments);
+        result->source_map.segments = NULL;
     }
+    result->source_map.count = 0;
+    result->source_map.capacity = 0;
+    result->source_map.text = NULL;
     if (result->error_msg) {
         free(result->error_msg);
         result->error_msg = NULL;
@@ -0,0 +1,57 @@
+#ifndef FLYUXC_NORMALIZE_SCANNER_H
+#define FLYUXC_NORMALIZE_SCANNER_H
+
+/**
+ * 规范化扫描器（内部）
+ * 从左到右逐字符推进，携带字符串 / 转义 / 括号深度状态，
+ * 取代每个位置都从 0 重新扫描的 is_in_string / get_bracket_depth，
+ * 使各规范化步骤保持 O(n)。
+ *
+ * 用法：在处理 text[i] 之前读取状态（即 text[0..i) 的扫描结果），
+ * 处理后调用 normalize_scan_char(&s, text[i]) 推进。
+ */
+
+typedef struct {
+    char quote;             /* 当前字符串的引号，0 表示不在字符串内 */
+    int escape;             /* 上一个字符是未被消耗的 '\\' */
+    int depth;              /* 字符串外 () [] {} 的嵌套深度 */
+    int escape_in_code;     /* 1: 字符串外的 '\\' 也转义下一个字符 */
+} NormalizeScanner;
+
+static inline void normalize_scanner_init(NormalizeScanner* s, int escape_in_code) {
+    s->quote = 0;
+    s->escape = 0;
+    s->depth = 0;
+    s->escape_in_code = escape_in_code;
+}
+
+static inline int normalize_scanner_in_string(const NormalizeScanner* s) {
+    return s->quote != 0;
+}
+
+static inline void normalize_scan_char(NormalizeScanner* s, char ch) {
+    if (s->escape) {
+        s->escape = 0;
+        return;
+    }
+
+    if (ch == '\\' && (s->quote || s->escape_in_code)) {
+        s->escape = 1;
+        return;
+    }
+
+    if (s->quote) {
+        if (ch == s->quote) s->quote = 0;
+        return;
+    }
+
+    if (ch == '"' || ch == '\'') {
+        s->quote = ch;
+    } else if (ch == '(' || ch == '[' || ch == '{') {
+        s->depth++;
+    } else if (ch == ')' || ch == ']' || ch == '}') {
+        s->depth--;
+    }
+}
+
+#endif // FLYUXC_NORMALIZE_SCANNER_H
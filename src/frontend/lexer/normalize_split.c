@@ -2,89 +2,15 @@
  * 语句分割模块
  * 根据分隔符（;、换行符）分割语句
  * 需要处理括号、大括号、字符串内的分隔符
+ * 字符串与括号深度由 NormalizeScanner 单遍推进，整体 O(n)
  */
 
 #include "flyuxc/frontend/normalize.h"
+#include "normalize_scanner.h"
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 
-/**
- * 检查当前位置是否在字符串内
- */
-static int is_in_string_split(const char* text, int pos) {
-    int in_str = 0;
-    char str_quote = 0;  /* 记录开启字符串的引号类型 */
-    int escape = 0;
-    
-    for (int i = 0; i < pos && text[i] != '\0'; i++) {
-        if (escape) {
-            escape = 0;
-            continue;
-        }
-        
-        if (text[i] == '\\') {
-            escape = 1;
-            continue;
-        }
-        
-        if (!in_str && (text[i] == '"' || text[i] == 39)) {  /* 39 is '\'' */
-            in_str = 1;
-            str_quote = text[i];
-        } else if (in_str && text[i] == str_quote) {
-            in_str = 0;
-            str_quote = 0;
-        }
-    }
-    
-    return in_str;
-}
-
-/**
- * 获取括号深度（用于判断是否在括号内）
- * 包括 () [] {}
- */
-static int get_bracket_depth(const char* text, int pos) {
-    int depth = 0;
-    int in_str = 0;
-    char str_quote = 0;  /* 记录开启字符串的引号类型 */
-    int escape = 0;
-    
-    for (int i = 0; i < pos && text[i] != '\0'; i++) {
-        if (escape) {
-            escape = 0;
-            continue;
-        }
-        
-        if (text[i] == '\\') {
-            escape = 1;
-            continue;
-        }
-        
-        if (!in_str && (text[i] == '"' || text[i] == 39)) {  /* 39 is '\'' */
-            in_str = 1;
-            str_quote = text[i];
-            continue;
-        }
-        
-        if (in_str && text[i] == str_quote) {
-            in_str = 0;
-            str_quote = 0;
-            continue;
-        }
-        
-        if (!in_str) {
-            if (text[i] == '(' || text[i] == '[' || text[i] == '{') {
-                depth++;
-            } else if (text[i] == ')' || text[i] == ']' || text[i] == '}') {
-                depth--;
-            }
-        }
-    }
-    
-    return depth;
-}
-
 /**
  * 检查是否是函数定义开始
  */
@@ -164,10 +90,12 @@ Statement* normalize_split_statements(const char* input, int* stmt_count) {
     // 注意：最后如果有非空内容且没有分隔符,也算一个语句
     int count = 0;
     int has_content_after_last_separator = 0;
+    NormalizeScanner scan;
+    normalize_scanner_init(&scan, 1);
     
-    for (int i = 0; i < len; i++) {
+    for (size_t i = 0; i < len; i++) {
         // 检查分隔符（;或换行）且不在括号/字符串内
-        if (!is_in_string_split(input, i) && get_bracket_depth(input, i) == 0) {
+        if (!normalize_scanner_in_string(&scan) && scan.depth == 0) {
             if (input[i] == ';' || input[i] == '\n') {
                 count++;
                 has_content_after_last_separator = 0;
@@ -177,6 +105,7 @@ Statement* normalize_split_statements(const char* input, int* stmt_count) {
         } else if (input[i] != ' ' && input[i] != '\t' && input[i] != '\n') {
             has_content_after_last_separator = 1;
         }
+        normalize_scan_char(&scan, input[i]);
     }
     
     // 如果最后有内容但没有分隔符,也算一个语句
@@ -197,10 +126,11 @@ Statement* normalize_split_statements(const char* input, int* stmt_count) {
     
     // 第二遍：提取语句
     int stmt_idx = 0;
-    int start = 0;
+    size_t start = 0;
     int stmt_line = 1;
+    normalize_scanner_init(&scan, 1);
     
-    for (int i = 0; i <= len; i++) {
+    for (size_t i = 0; i <= len; i++) {
         if (i < len) {
             if (input[i] == '\n') {
                 stmt_line++;
@@ -208,13 +138,16 @@ Statement* normalize_split_statements(const char* input, int* stmt_count) {
         }
         
         int is_separator = (i == len) || 
-                          (!is_in_string_split(input, i) && 
-                           get_bracket_depth(input, i) == 0 && 
+                          (!normalize_scanner_in_string(&scan) && 
+                           scan.depth == 0 && 
                            (input[i] == ';' || input[i] == '\n'));
+        if (i < len) {
+            normalize_scan_char(&scan, input[i]);
+        }
         
         if (is_separator && i > start) {
             // 提取语句内容
-            int len_stmt = i - start;
+            size_t len_stmt = i - start;
             char* content = malloc(len_stmt + 1);
             if (!content) {
                 // 错误处理：释放已分配的内存
@@ -230,7 +163,7 @@ Statement* normalize_split_statements(const char* input, int* stmt_count) {
             
             // 跳过空语句（只有空白的语句）
             int has_content = 0;
-            for (int j = 0; j < len_stmt; j++) {
+            for (size_t j = 0; j < len_stmt; j++) {
                 if (!isspace(content[j])) {
                     has_content = 1;
                     break;
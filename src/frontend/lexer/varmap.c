@@ -15,11 +15,6 @@ static int is_ident_char(int c) {
     return (c == '_' || isalnum((unsigned char)c) || (unsigned char)c >= 0x80);
 }
 
-static int is_ident_start(int c) {
-    /* Allow starting with letters, _, non-ASCII; digits not allowed at start */
-    return (c == '_' || isalpha((unsigned char)c) || (unsigned char)c >= 0x80);
-}
-
 /* Simple string copy, returns NULL on error */
 static char* str_dup_n(const char* s, size_t len) {
     char* out = (char*)malloc(len + 1);
@@ -375,30 +370,62 @@ static int ensure_entry_capacity(VarMapEntry** arr, size_t* cap, size_t needed)
     return 1;
 }
 
+/* 标识符字节的 FNV-1a 哈希 */
+static unsigned int varmap_hash(const char* name, size_t len) {
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/* 索引扩容：槽数翻倍后按已存的哈希重新放入所有条目 */
+static int varmap_grow_slots(VarMap* vm) {
+    size_t new_cap = vm->slot_cap ? vm->slot_cap * 2 : 64;
+    size_t* slots = (size_t*)calloc(new_cap, sizeof(size_t));
+    if (!slots) return 0;
+    for (size_t i = 0; i < vm->entry_count; i++) {
+        size_t pos = vm->entries[i].hash & (new_cap - 1);
+        while (slots[pos]) pos = (pos + 1) & (new_cap - 1);
+        slots[pos] = i + 1;
+    }
+    free(vm->slots);
+    vm->slots = slots;
+    vm->slot_cap = new_cap;
+    return 1;
+}
+
 /* 在映射表中查找名字，返回索引或 -1 */
-static int varmap_find(const VarMapEntry* entries, size_t count, const char* name, size_t len) {
-    for (size_t i = 0; i < count; i++) {
-        if (strlen(entries[i].original) == len &&
-            memcmp(entries[i].original, name, len) == 0) {
-            return (int)i;
+static int varmap_find(const VarMap* vm, const char* name, size_t len) {
+    if (vm->slot_cap == 0) return -1;
+    unsigned int hash = varmap_hash(name, len);
+    size_t pos = hash & (vm->slot_cap - 1);
+    while (vm->slots[pos]) {
+        const VarMapEntry* e = &vm->entries[vm->slots[pos] - 1];
+        if (e->hash == hash && e->original_len == len &&
+            memcmp(e->original, name, len) == 0) {
+            return (int)(vm->slots[pos] - 1);
         }
+        pos = (pos + 1) & (vm->slot_cap - 1);
     }
     return -1;
 }
 
 /* 向映射表添加新名字（调用前确保不存在同名） */
-static int varmap_add(VarMapEntry** entries,
-                      size_t* count,
-                      size_t* cap,
+static int varmap_add(VarMap* vm,
                       const char* name,
                       size_t len,
                       VarKind kind,
                       size_t index_for_name) {
-    if (!ensure_entry_capacity(entries, cap, *count + 1)) {
+    if (!ensure_entry_capacity(&vm->entries, &vm->entry_cap, vm->entry_count + 1)) {
+        return -1;
+    }
+    if ((vm->entry_count + 1) * 2 > vm->slot_cap && !varmap_grow_slots(vm)) {
         return -1;
     }
 
-    VarMapEntry* e = &((*entries)[*count]);
+    VarMapEntry* e = &vm->entries[vm->entry_count];
     e->original = str_dup_n(name, len);
     if (!e->original) return -1;
 
@@ -408,12 +435,19 @@ static int varmap_add(VarMapEntry** entries,
         return -1;
     }
 
+    e->original_len = len;
+    e->mapped_len = strlen(e->mapped);
+    e->hash = varmap_hash(name, len);
     e->kind = kind;
     e->first_line = 0;
     e->first_column = 0;
 
-    (*count)++;
-    return (int)(*count - 1);
+    size_t pos = e->hash & (vm->slot_cap - 1);
+    while (vm->slots[pos]) pos = (pos + 1) & (vm->slot_cap - 1);
+    vm->slots[pos] = vm->entry_count + 1;
+
+    vm->entry_count++;
+    return (int)(vm->entry_count - 1);
 }
 
 /* 判断当前 identifier 是否像是 “类型注解/变量定义的名字”，而不是对象 key */
@@ -465,503 +499,305 @@ static int looks_like_typed_definition(const char* src, size_t len, size_t ident
     return 0;
 }
 
-/* ========== 辅助宏：同时写入 out 和 offset_map ========== */
-
-/* 确保 out 和 offset_map 有足够容量 */
-#define ENSURE_CAPACITY(needed) do { \
-    while (out_idx + (needed) >= out_cap) { \
-        out_cap *= 2; \
-        char* new_out = (char*)realloc(out, out_cap); \
-        if (!new_out) { \
-            result.error_code = -1; \
-            result.error_msg = str_dup_n("Memory allocation failed", 25); \
-            free(out); free(offset_map); \
-            for (size_t k = 0; k < entry_count; k++) { \
-                free(entries[k].original); \
-                free(entries[k].mapped); \
-            } \
-            free(entries); \
-            return result; \
-        } \
-        out = new_out; \
-    } \
-    while (out_idx + (needed) >= offset_map_cap) { \
-        offset_map_cap *= 2; \
-        size_t* new_map = (size_t*)realloc(offset_map, offset_map_cap * sizeof(size_t)); \
-        if (!new_map) { \
-            result.error_code = -1; \
-            result.error_msg = str_dup_n("Memory allocation failed for offset_map", 41); \
-            free(out); free(offset_map); \
-            for (size_t k = 0; k < entry_count; k++) { \
-                free(entries[k].original); \
-                free(entries[k].mapped); \
-            } \
-            free(entries); \
-            return result; \
-        } \
-        offset_map = new_map; \
-    } \
-} while(0)
-
-/* 写入单个字符到 out，同时记录 offset_map */
-#define EMIT_CHAR(ch, src_offset) do { \
-    ENSURE_CAPACITY(1); \
-    out[out_idx] = (ch); \
-    offset_map[out_idx] = (src_offset); \
-    out_idx++; \
-} while(0)
-
-/* 写入多个字符（映射后的标识符），所有字符都映射到同一个源位置 */
-#define EMIT_STR_MAPPED(str, str_len, src_offset) do { \
-    ENSURE_CAPACITY(str_len); \
-    memcpy(out + out_idx, str, str_len); \
-    for (size_t _k = 0; _k < (str_len); _k++) { \
-        offset_map[out_idx + _k] = (src_offset); \
-    } \
-    out_idx += (str_len); \
-} while(0)
-
 /* ========== 主映射逻辑 ========== */
 
-VarMapResult flyux_varmap_process(const char* normalized_source,
-                                  const SourceLocation* source_map,
-                                  size_t source_map_size,
-                                  const char* original_source) {
-    VarMapResult result;
-    result.mapped_source = NULL;
-    result.entries = NULL;
-    result.entry_count = 0;
-    result.offset_map = NULL;
-    result.offset_map_size = 0;
-    result.error_msg = NULL;
-    result.error_code = 0;
-
-    if (!normalized_source) {
-        result.error_code = -1;
-        result.error_msg = str_dup_n("normalized_source is NULL", strlen("normalized_source is NULL"));
-        return result;
-    }
+void flyux_varmap_init(VarMap* vm,
+                       const char* normalized_source,
+                       const SourceMap* source_map,
+                       const char* original_source) {
+    memset(vm, 0, sizeof(*vm));
+    vm->source = normalized_source;
+    vm->source_len = normalized_source ? strlen(normalized_source) : 0;
+    vm->source_map = source_map;
+    vm->original_source = original_source;
+    vm->next_index = 1;
+}
 
-    size_t len = strlen(normalized_source);
-    /* 映射结果字符串：保守估计 4 倍长度 */
-    size_t out_cap = len * 4 + 16;
-    char* out = (char*)malloc(out_cap);
-    if (!out) {
-        result.error_code = -1;
-        result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
-        return result;
-    }
-    
-    /* 同时分配 offset_map，在主循环中填充 */
-    size_t offset_map_cap = out_cap;
-    size_t* offset_map = (size_t*)malloc(offset_map_cap * sizeof(size_t));
-    if (!offset_map) {
-        free(out);
-        result.error_code = -1;
-        result.error_msg = str_dup_n("Memory allocation failed for offset_map", 41);
-        return result;
+const char* flyux_varmap_identifier(VarMap* vm, size_t start, size_t j, size_t* out_len) {
+    const char* normalized_source = vm->source;
+    size_t len = vm->source_len;
+    const SourceMap* source_map = vm->source_map;
+    const char* original_source = vm->original_source;
+    size_t ident_len = j - start;
+    const char* ident_start = normalized_source + start;
+
+    *out_len = ident_len;
+
+    /* Check for invalid X> format (single uppercase letter followed by >, not valid L>/R>/T>/B>/N>) */
+    if (ident_len == 1 && isupper((unsigned char)ident_start[0]) 
+        && j < len && normalized_source[j] == '>'
+        && ident_start[0] != 'L' && ident_start[0] != 'R' && ident_start[0] != 'T' 
+        && ident_start[0] != 'B' && ident_start[0] != 'N') {
+        /* Find original position */
+        int orig_line = 1, orig_col = 1;
+        SourceLocation loc = source_map_lookup(source_map, start);
+        if (loc.orig_line > 0) {
+            orig_line = loc.orig_line;
+            orig_col = loc.orig_column;
+        }
+        
+        vm->error_code = 1;
+        vm->error_msg = create_varmap_stmt_type_error(original_source, orig_line, orig_col, ident_start[0]);
+        return NULL;
     }
 
-    VarMapEntry* entries = NULL;
-    size_t entry_count = 0;
-    size_t entry_cap = 0;
-    size_t next_index = 1;  /* 用于生成 _00001, _00002, ... */
-
-    int in_str = 0;
-    char str_quote = 0;  /* 记录开启字符串的引号类型 */
-    int escape = 0;
-    size_t i = 0;
-    size_t out_idx = 0;
-
-    while (i < len) {
-        char c = normalized_source[i];
-
-        /* 字符串内照抄 */
-        if (escape) {
-            EMIT_CHAR(c, i);
-            escape = 0;
-            i++;
-            continue;
-        }
+    /* 确认 token 边界：前一个/后一个字符不能是标识符字符，否则保持原名 */
+    if (!((start == 0 || !is_ident_char((unsigned char)normalized_source[start - 1])) &&
+          (j >= len || !is_ident_char((unsigned char)normalized_source[j])))) {
+        return ident_start;
+    }
 
-        if (c == '\\') {
-            EMIT_CHAR(c, i);
-            escape = 1;
-            i++;
-            continue;
+    /* 检测非 FLYUX 关键字用法（不是作为变量名使用时才报错） */
+    const InvalidKeywordInfo* inv_kw = check_invalid_keyword(ident_start, ident_len);
+    if (inv_kw != NULL) {
+        /* 先检查这个关键字是否已经在映射表中（之前被定义过） */
+        int already_defined = varmap_find(vm, ident_start, ident_len) >= 0;
+        
+        /* 检查是否是作为变量名使用 */
+        /* 在 varmap 阶段，空格已经被删除，所以直接检查后面的字符 */
+        char after_char = (j < len) ? normalized_source[j] : '\0';
+        int is_var_usage = 0;
+        
+        /* 特殊值关键字 - 永远不允许使用（即使作为表达式的一部分）*/
+        int is_special_value = (ident_len == 4 && memcmp(ident_start, "None", 4) == 0) ||
+                               (ident_len == 3 && memcmp(ident_start, "nil", 3) == 0) ||
+                               (ident_len == 9 && memcmp(ident_start, "undefined", 9) == 0) ||
+                               (ident_len == 4 && memcmp(ident_start, "True", 4) == 0) ||
+                               (ident_len == 5 && memcmp(ident_start, "False", 5) == 0);
+        
+        /* 如果是特殊值且没有被定义，直接报错 */
+        if (is_special_value && !already_defined) {
+            /* 只有当它被用作 := 左边时才允许（定义同名变量） */
+            if (!(after_char == ':' && j + 1 < len && normalized_source[j + 1] == '=')) {
+                /* Find original position */
+                int orig_line = 1, orig_col = 1;
+                SourceLocation loc = source_map_lookup(source_map, start);
+                if (loc.orig_line > 0) {
+                    orig_line = loc.orig_line;
+                    orig_col = loc.orig_column;
+                }
+                
+                vm->error_code = 1;
+                vm->error_msg = create_varmap_formatted_error(original_source, orig_line, orig_col,
+                                                              inv_kw->keyword,
+                                                              inv_kw->flyux_equiv,
+                                                              inv_kw->suggestion);
+                return NULL;
+            }
         }
-
-        if (!in_str && (c == '"' || c == 39)) {  /* 39 is '\'' */
-            /* 进入字符串 */
-            EMIT_CHAR(c, i);
-            in_str = 1;
-            str_quote = c;
-            i++;
-            continue;
+        
+        /* 如果已经被定义，则后续使用都是合法的 */
+        if (already_defined) {
+            is_var_usage = 1;
+        } else {
+            /* 对于 for/while/do，如果后面跟着 ( 是其他语言的循环语法，不算变量使用 */
+            int is_loop_keyword = (ident_len == 3 && memcmp(ident_start, "for", 3) == 0) ||
+                                  (ident_len == 5 && memcmp(ident_start, "while", 5) == 0) ||
+                                  (ident_len == 2 && memcmp(ident_start, "do", 2) == 0);
+            
+            if (after_char == ':' && j + 1 < len && normalized_source[j + 1] == '=') is_var_usage = 1;  // :=
+            else if (after_char == '=') is_var_usage = 1;   // = assignment
+            else if (after_char == '.') is_var_usage = 1;   // member access
+            else if (after_char == '[') is_var_usage = 1;   // index access
+            else if (after_char == '(' && !is_loop_keyword) is_var_usage = 1;   // function call (not for/while/do)
+            else if (after_char == '+' || after_char == '-' || after_char == '*' || after_char == '/') is_var_usage = 1;  // operators
+            else if (after_char == '<' || after_char == '>' || after_char == '!' || after_char == '&' || after_char == '|') is_var_usage = 1;  // comparison/logic
+            else if (after_char == ')' || after_char == ',' || after_char == ';' || after_char == '}') is_var_usage = 1;  // expression/statement end
+            else if (after_char == '?' || after_char == ':') is_var_usage = 1;  // ternary operator
+            else if (after_char == '\0') is_var_usage = 1;  // end of file
         }
-
-        if (in_str && c == str_quote) {
-            /* 退出字符串 */
-            EMIT_CHAR(c, i);
-            in_str = 0;
-            str_quote = 0;
-            i++;
-            continue;
+        
+        if (!is_var_usage) {
+            /* Find original position */
+            int orig_line = 1, orig_col = 1;
+            SourceLocation loc = source_map_lookup(source_map, start);
+            if (loc.orig_line > 0) {
+                orig_line = loc.orig_line;
+                orig_col = loc.orig_column;
+            }
+            
+            vm->error_code = 1;
+            vm->error_msg = create_varmap_formatted_error(original_source, orig_line, orig_col,
+                                                          inv_kw->keyword,
+                                                          inv_kw->flyux_equiv,
+                                                          inv_kw->suggestion);
+            return NULL;
         }
+    }
 
-        if (in_str) {
-            /* 字符串内容照抄 */
-            EMIT_CHAR(c, i);
-            i++;
-            continue;
+    /* Reserved/builtin identifiers: don't participate in mapping */
+    int reserved = is_reserved_identifier(ident_start, ident_len) ||
+                   is_builtin_identifier(ident_start, ident_len);
+
+    /* 上下文判断：成员访问 / 方法名 / 对象 key */
+    char before = (start > 0) ? normalized_source[start - 1] : '\0';
+    char after  = (j < len) ? normalized_source[j] : '\0';
+
+    int is_method_after_chain = 0;   /* .>methodName */
+    int is_property_access    = 0;   /* obj.property or obj.@property */
+    int is_spread_expr        = 0;   /* ...expr spread 操作符 */
+    
+    if (before == '>' && start >= 2 && normalized_source[start - 2] == '.') {
+        /* ".>method" 场景 */
+        is_method_after_chain = 1;
+    } else if (before == '@' && start >= 2 && normalized_source[start - 2] == '.') {
+        /* ".@property" 解绑属性访问 */
+        is_property_access = 1;
+    } else if (before == '.') {
+        /* 检查是否是 spread 语法 "..." */
+        /* ...obj 的情况: 前面是 . 且前两个字符也是 . */
+        if (start >= 3 && normalized_source[start - 2] == '.' && normalized_source[start - 3] == '.') {
+            /* 这是 spread 语法 ...identifier */
+            is_spread_expr = 1;
+        } else {
+            /* 普通属性访问 obj.prop */
+            is_property_access = 1;
         }
+    }
 
-        /* 识别标识符起点 */
-        if (is_ident_start((unsigned char)c)) {
-            size_t start = i;
-            size_t j = i + 1;
-            while (j < len && is_ident_char((unsigned char)normalized_source[j])) {
-                j++;
+    int is_object_key = 0;
+    if (after == ':') {
+        /* 区分类型注解/变量定义、对象 key、三元运算符、以及 foreach 循环中的迭代变量 */
+        // 检查是否是 foreach: L> (arr : item) 或 L>arr:item
+        // 向前搜索，看是否有 "L>" 后面跟 "(" 或直接跟标识符
+        int is_foreach = 0;
+        int is_ternary = 0;
+        
+        if (start >= 2) {
+            // 向前搜索 L> (，允许中间有空格
+            size_t k = start - 1;
+            while (k > 0 && (normalized_source[k] == ' ' || normalized_source[k] == '\t')) {
+                k--;
             }
-            size_t ident_len = j - start;
-            const char* ident_start = normalized_source + start;
             
-            /* Check for invalid X> format (single uppercase letter followed by >, not valid L>/R>/T>/B>/N>) */
-            if (ident_len == 1 && isupper((unsigned char)ident_start[0]) 
-                && j < len && normalized_source[j] == '>'
-                && ident_start[0] != 'L' && ident_start[0] != 'R' && ident_start[0] != 'T' 
-                && ident_start[0] != 'B' && ident_start[0] != 'N') {
-                /* Find original position */
-                int orig_line = 1, orig_col = 1;
-                if (source_map && start < source_map_size && source_map[start].orig_line > 0) {
-                    orig_line = source_map[start].orig_line;
-                    orig_col = source_map[start].orig_column;
+            // 情况1: L> (arr:item)
+            if (k > 0 && normalized_source[k] == '(') {
+                k--;
+                while (k > 0 && (normalized_source[k] == ' ' || normalized_source[k] == '\t')) {
+                    k--;
                 }
-                
-                result.error_code = 1;
-                result.error_msg = create_varmap_stmt_type_error(original_source, orig_line, orig_col, ident_start[0]);
-                free(out);
-                if (entries) {
-                    for (size_t k = 0; k < entry_count; k++) {
-                        free(entries[k].original);
-                        free(entries[k].mapped);
-                    }
-                    free(entries);
+                if (k >= 1 && normalized_source[k] == '>' && normalized_source[k-1] == 'L') {
+                    is_foreach = 1;
                 }
-                return result;
             }
-            /* 确认 token 边界：前一个/后一个字符不能是标识符字符 */
-            if ( (start == 0 || !is_ident_char((unsigned char)normalized_source[start - 1])) &&
-                 (j >= len || !is_ident_char((unsigned char)normalized_source[j])) ) {
-
-                /* 检测非 FLYUX 关键字用法（不是作为变量名使用时才报错） */
-                const InvalidKeywordInfo* inv_kw = check_invalid_keyword(ident_start, ident_len);
-                if (inv_kw != NULL) {
-                    /* 先检查这个关键字是否已经在映射表中（之前被定义过） */
-                    int already_defined = varmap_find(entries, entry_count, ident_start, ident_len) >= 0;
-                    
-                    /* 检查是否是作为变量名使用 */
-                    /* 在 varmap 阶段，空格已经被删除，所以直接检查后面的字符 */
-                    char after_char = (j < len) ? normalized_source[j] : '\0';
-                    int is_var_usage = 0;
-                    
-                    /* 特殊值关键字 - 永远不允许使用（即使作为表达式的一部分）*/
-                    int is_special_value = (ident_len == 4 && memcmp(ident_start, "None", 4) == 0) ||
-                                           (ident_len == 3 && memcmp(ident_start, "nil", 3) == 0) ||
-                                           (ident_len == 9 && memcmp(ident_start, "undefined", 9) == 0) ||
-                                           (ident_len == 4 && memcmp(ident_start, "True", 4) == 0) ||
-                                           (ident_len == 5 && memcmp(ident_start, "False", 5) == 0);
-                    
-                    /* 如果是特殊值且没有被定义，直接报错 */
-                    if (is_special_value && !already_defined) {
-                        /* 只有当它被用作 := 左边时才允许（定义同名变量） */
-                        if (!(after_char == ':' && j + 1 < len && normalized_source[j + 1] == '=')) {
-                            /* Find original position */
-                            int orig_line = 1, orig_col = 1;
-                            if (source_map && start < source_map_size && source_map[start].orig_line > 0) {
-                                orig_line = source_map[start].orig_line;
-                                orig_col = source_map[start].orig_column;
-                            }
-                            
-                            result.error_code = 1;
-                            result.error_msg = create_varmap_formatted_error(original_source, orig_line, orig_col,
-                                                                             inv_kw->keyword,
-                                                                             inv_kw->flyux_equiv,
-                                                                             inv_kw->suggestion);
-                            free(out);
-                            if (entries) {
-                                for (size_t k = 0; k < entry_count; k++) {
-                                    free(entries[k].original);
-                                    free(entries[k].mapped);
-                                }
-                                free(entries);
-                            }
-                            return result;
-                        }
-                    }
-                    
-                    /* 如果已经被定义，则后续使用都是合法的 */
-                    if (already_defined) {
-                        is_var_usage = 1;
-                    } else {
-                        /* 对于 for/while/do，如果后面跟着 ( 是其他语言的循环语法，不算变量使用 */
-                        int is_loop_keyword = (ident_len == 3 && memcmp(ident_start, "for", 3) == 0) ||
-                                              (ident_len == 5 && memcmp(ident_start, "while", 5) == 0) ||
-                                              (ident_len == 2 && memcmp(ident_start, "do", 2) == 0);
-                        
-                        if (after_char == ':' && j + 1 < len && normalized_source[j + 1] == '=') is_var_usage = 1;  // :=
-                        else if (after_char == '=') is_var_usage = 1;   // = assignment
-                        else if (after_char == '.') is_var_usage = 1;   // member access
-                        else if (after_char == '[') is_var_usage = 1;   // index access
-                        else if (after_char == '(' && !is_loop_keyword) is_var_usage = 1;   // function call (not for/while/do)
-                        else if (after_char == '+' || after_char == '-' || after_char == '*' || after_char == '/') is_var_usage = 1;  // operators
-                        else if (after_char == '<' || after_char == '>' || after_char == '!' || after_char == '&' || after_char == '|') is_var_usage = 1;  // comparison/logic
-                        else if (after_char == ')' || after_char == ',' || after_char == ';' || after_char == '}') is_var_usage = 1;  // expression/statement end
-                        else if (after_char == '?' || after_char == ':') is_var_usage = 1;  // ternary operator
-                        else if (after_char == '\0') is_var_usage = 1;  // end of file
-                    }
-                    
-                    if (!is_var_usage) {
-                        /* Find original position */
-                        int orig_line = 1, orig_col = 1;
-                        if (source_map && start < source_map_size && source_map[start].orig_line > 0) {
-                            orig_line = source_map[start].orig_line;
-                            orig_col = source_map[start].orig_column;
-                        }
-                        
-                        result.error_code = 1;
-                        result.error_msg = create_varmap_formatted_error(original_source, orig_line, orig_col,
-                                                                         inv_kw->keyword,
-                                                                         inv_kw->flyux_equiv,
-                                                                         inv_kw->suggestion);
-                        free(out);
-                        if (entries) {
-                            for (size_t k = 0; k < entry_count; k++) {
-                                free(entries[k].original);
-                                free(entries[k].mapped);
-                            }
-                            free(entries);
-                        }
-                        return result;
-                    }
+            // 情况2: L>arr:item (不带括号)
+            // k 此时指向 arr 的前一个字符（应该是 >）
+            else if (k >= 1 && normalized_source[k] == '>') {
+                if (k >= 1 && normalized_source[k-1] == 'L') {
+                    is_foreach = 1;
                 }
-
-                /* Reserved/builtin identifiers: don't participate in mapping */
-                int reserved = is_reserved_identifier(ident_start, ident_len) ||
-                               is_builtin_identifier(ident_start, ident_len);
-
-                /* 上下文判断：成员访问 / 方法名 / 对象 key */
-                char before = (start > 0) ? normalized_source[start - 1] : '\0';
-                char after  = (j < len) ? normalized_source[j] : '\0';
-
-                int is_method_after_chain = 0;   /* .>methodName */
-                int is_property_access    = 0;   /* obj.property or obj.@property */
-                int is_spread_expr        = 0;   /* ...expr spread 操作符 */
-                
-                if (before == '>' && start >= 2 && normalized_source[start - 2] == '.') {
-                    /* ".>method" 场景 */
-                    is_method_after_chain = 1;
-                } else if (before == '@' && start >= 2 && normalized_source[start - 2] == '.') {
-                    /* ".@property" 解绑属性访问 */
-                    is_property_access = 1;
-                } else if (before == '.') {
-                    /* 检查是否是 spread 语法 "..." */
-                    /* ...obj 的情况: 前面是 . 且前两个字符也是 . */
-                    if (start >= 3 && normalized_source[start - 2] == '.' && normalized_source[start - 3] == '.') {
-                        /* 这是 spread 语法 ...identifier */
-                        is_spread_expr = 1;
-                    } else {
-                        /* 普通属性访问 obj.prop */
-                        is_property_access = 1;
-                    }
+            }
+        }
+        
+        // 检查是否是三元运算符的一部分：向前搜索 ?
+        // 三元表达式: cond ? true_val : false_val
+        // 如果在 : 之前找到 ? (在同一表达式中)，说明这是三元运算符
+        if (!is_foreach && start > 0) {
+            int paren_depth = 0;
+            int brace_depth = 0;
+            int bracket_depth = 0;
+            for (size_t k = start - 1; k > 0; k--) {
+                char ch = normalized_source[k];
+                // 跳过括号内部
+                if (ch == ')') paren_depth++;
+                else if (ch == '(') {
+                    if (paren_depth > 0) paren_depth--;
+                    else break;  // 到达表达式开始
                 }
-
-                int is_object_key = 0;
-                if (after == ':') {
-                    /* 区分类型注解/变量定义、对象 key、三元运算符、以及 foreach 循环中的迭代变量 */
-                    // 检查是否是 foreach: L> (arr : item) 或 L>arr:item
-                    // 向前搜索，看是否有 "L>" 后面跟 "(" 或直接跟标识符
-                    int is_foreach = 0;
-                    int is_ternary = 0;
-                    
-                    if (start >= 2) {
-                        // 向前搜索 L> (，允许中间有空格
-                        size_t k = start - 1;
-                        while (k > 0 && (normalized_source[k] == ' ' || normalized_source[k] == '\t')) {
-                            k--;
-                        }
-                        
-                        // 情况1: L> (arr:item)
-                        if (k > 0 && normalized_source[k] == '(') {
-                            k--;
-                            while (k > 0 && (normalized_source[k] == ' ' || normalized_source[k] == '\t')) {
-                                k--;
-                            }
-                            if (k >= 1 && normalized_source[k] == '>' && normalized_source[k-1] == 'L') {
-                                is_foreach = 1;
-                            }
-                        }
-                        // 情况2: L>arr:item (不带括号)
-                        // k 此时指向 arr 的前一个字符（应该是 >）
-                        else if (k >= 1 && normalized_source[k] == '>') {
-                            if (k >= 1 && normalized_source[k-1] == 'L') {
-                                is_foreach = 1;
-                            }
-                        }
-                    }
-                    
-                    // 检查是否是三元运算符的一部分：向前搜索 ?
-                    // 三元表达式: cond ? true_val : false_val
-                    // 如果在 : 之前找到 ? (在同一表达式中)，说明这是三元运算符
-                    if (!is_foreach && start > 0) {
-                        int paren_depth = 0;
-                        int brace_depth = 0;
-                        int bracket_depth = 0;
-                        for (size_t k = start - 1; k > 0; k--) {
-                            char ch = normalized_source[k];
-                            // 跳过括号内部
-                            if (ch == ')') paren_depth++;
-                            else if (ch == '(') {
-                                if (paren_depth > 0) paren_depth--;
-                                else break;  // 到达表达式开始
-                            }
-                            else if (ch == '}') brace_depth++;
-                            else if (ch == '{') {
-                                if (brace_depth > 0) brace_depth--;
-                                else break;  // 对象字面量开始
-                            }
-                            else if (ch == ']') bracket_depth++;
-                            else if (ch == '[') {
-                                if (bracket_depth > 0) bracket_depth--;
-                                else break;
-                            }
-                            else if (paren_depth == 0 && brace_depth == 0 && bracket_depth == 0) {
-                                if (ch == '?') {
-                                    is_ternary = 1;
-                                    break;
-                                }
-                                // 到达语句边界就停止
-                                if (ch == ';' || ch == ':' && k > 0 && normalized_source[k-1] == '=') {
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                    
-                    if (!is_foreach && !is_ternary && !looks_like_typed_definition(normalized_source, len, j)) {
-                        is_object_key = 1;
-                    }
+                else if (ch == '}') brace_depth++;
+                else if (ch == '{') {
+                    if (brace_depth > 0) brace_depth--;
+                    else break;  // 对象字面量开始
                 }
-
-                const char* replacement = ident_start;
-                size_t replacement_len = ident_len;
-
-                if (!reserved && !is_object_key) {
-                    if (is_method_after_chain) {
-                        /* .>method：若 method 在映射表中，则替换；否则保持原名 */
-                        int idx = varmap_find(entries, entry_count, ident_start, ident_len);
-                        if (idx >= 0) {
-                            replacement = entries[idx].mapped;
-                            replacement_len = strlen(replacement);
-                        }
-                        /* 如果没找到，不新增映射，保持原名（length 这类） */
-                    } else if (!is_property_access) {
-                        /* 普通变量/函数名：正常参与映射 */
-                        int idx = varmap_find(entries, entry_count, ident_start, ident_len);
-                        if (idx < 0) {
-                            int add_idx = varmap_add(&entries,
-                                                     &entry_count,
-                                                     &entry_cap,
-                                                     ident_start,
-                                                     ident_len,
-                                                     VARKIND_UNKNOWN,
-                                                     next_index++);
-                            if (add_idx < 0) {
-                                result.error_code = -1;
-                                result.error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
-                                free(out);
-                                for (size_t k = 0; k < entry_count; k++) {
-                                    free(entries[k].original);
-                                    free(entries[k].mapped);
-                                }
-                                free(entries);
-                                return result;
-                            }
-                            idx = add_idx;
-                        }
-                        replacement = entries[idx].mapped;
-                        replacement_len = strlen(replacement);
+                else if (ch == ']') bracket_depth++;
+                else if (ch == '[') {
+                    if (bracket_depth > 0) bracket_depth--;
+                    else break;
+                }
+                else if (paren_depth == 0 && brace_depth == 0 && bracket_depth == 0) {
+                    if (ch == '?') {
+                        is_ternary = 1;
+                        break;
+                    }
+                    // 到达语句边界就停止
+                    if (ch == ';' || ch == ':' && k > 0 && normalized_source[k-1] == '=') {
+                        break;
                     }
-                    /* is_property_access：对象属性名一律不改名 */
                 }
-
-                /* 写出 token（要么映射名，要么原名）
-                 * 使用 EMIT_STR_MAPPED 将所有输出字符映射到原始标识符的起始位置
-                 */
-                EMIT_STR_MAPPED(replacement, replacement_len, start);
-
-                i = j;
-                continue;
             }
-
-            /* 不满足 token 边界，按普通字符抄 */
-            EMIT_CHAR(c, i);
-            i++;
-            continue;
         }
-
-        /* 其他字符照抄 */
-        EMIT_CHAR(c, i);
-        i++;
+        
+        if (!is_foreach && !is_ternary && !looks_like_typed_definition(normalized_source, len, j)) {
+            is_object_key = 1;
+        }
     }
 
-    out[out_idx] = '\0';
-
-    // offset_map 已在主循环中构建完成
+    const char* replacement = ident_start;
+    size_t replacement_len = ident_len;
 
-    result.mapped_source = out;
-    result.entries = entries;
-    result.entry_count = entry_count;
-    result.offset_map = offset_map;
-    result.offset_map_size = out_idx;
-    result.error_code = 0;
-    result.error_msg = NULL;
+    if (!reserved && !is_object_key) {
+        if (is_method_after_chain) {
+            /* .>method：若 method 在映射表中，则替换；否则保持原名 */
+            int idx = varmap_find(vm, ident_start, ident_len);
+            if (idx >= 0) {
+                replacement = vm->entries[idx].mapped;
+                replacement_len = vm->entries[idx].mapped_len;
+            }
+            /* 如果没找到，不新增映射，保持原名（length 这类） */
+        } else if (!is_property_access) {
+            /* 普通变量/函数名：正常参与映射 */
+            int idx = varmap_find(vm, ident_start, ident_len);
+            if (idx < 0) {
+                int add_idx = varmap_add(vm,
+                                         ident_start,
+                                         ident_len,
+                                         VARKIND_UNKNOWN,
+                                         vm->next_index++);
+                if (add_idx < 0) {
+                    vm->error_code = -1;
+                    vm->error_msg = str_dup_n("Memory allocation failed", strlen("Memory allocation failed"));
+                    return NULL;
+                }
+                idx = add_idx;
+            }
+            replacement = vm->entries[idx].mapped;
+            replacement_len = vm->entries[idx].mapped_len;
+        }
+        /* is_property_access：对象属性名一律不改名 */
+    }
 
-    return result;
+    *out_len = replacement_len;
+    return replacement;
 }
 
 /* ========== 释放与打印 ========== */
 
-void varmap_result_free(VarMapResult* result) {
-    if (!result) return;
-    if (result->mapped_source) {
-        free(result->mapped_source);
-        result->mapped_source = NULL;
-    }
-    if (result->offset_map) {
-        free(result->offset_map);
-        result->offset_map = NULL;
-    }
-    if (result->entries) {
-        for (size_t i = 0; i < result->entry_count; i++) {
-            free(result->entries[i].original);
-            free(result->entries[i].mapped);
+void varmap_free(VarMap* vm) {
+    if (!vm) return;
+    if (vm->entries) {
+        for (size_t i = 0; i < vm->entry_count; i++) {
+            free(vm->entries[i].original);
+            free(vm->entries[i].mapped);
         }
-        free(result->entries);
-        result->entries = NULL;
+        free(vm->entries);
+        vm->entries = NULL;
     }
-    if (result->error_msg) {
-        free(result->error_msg);
-        result->error_msg = NULL;
+    free(vm->slots);
+    vm->slots = NULL;
+    if (vm->error_msg) {
+        free(vm->error_msg);
+        vm->error_msg = NULL;
     }
-    result->entry_count = 0;
-    result->error_code = 0;
+    vm->entry_count = 0;
+    vm->entry_cap = 0;
+    vm->slot_cap = 0;
+    vm->error_code = 0;
 }
 
-void varmap_print_table(const VarMapResult* result, FILE* out) {
-    if (!result || !out) return;
-    for (size_t i = 0; i < result->entry_count; i++) {
-        const VarMapEntry* e = &result->entries[i];
+void varmap_print_table(const VarMap* vm, FILE* out) {
+    if (!vm || !out) return;
+    for (size_t i = 0; i < vm->entry_count; i++) {
+        const VarMapEntry* e = &vm->entries[i];
         const char* kind_str = "UNKNOWN";
         switch (e->kind) {
             case VARKIND_LOCAL:   kind_str = "LOCAL"; break;
@@ -7,9 +7,35 @@
  * AST节点创建和销毁
  * ============================================================================ */
 
+/* 累计创建的节点数（--time-report 统计用） */
+static size_t ast_nodes_created = 0;
+
+/* 本次编译的分配区（见 ast_set_arena） */
+static Arena *ast_arena = NULL;
+static StringPool *ast_strings = NULL;
+
+void ast_set_arena(Arena *arena, StringPool *strings) {
+    ast_arena = arena;
+    ast_strings = strings;
+}
+
+void *ast_alloc(size_t size) {
+    /* arena_alloc 对 0 字节返回 NULL，空数组也给一个有效指针 */
+    return arena_alloc(ast_arena, size ? size : 1);
+}
+
+void *ast_realloc(void *ptr, size_t old_size, size_t new_size) {
+    return arena_realloc(ast_arena, ptr, old_size, new_size);
+}
+
+char *ast_strdup(const char *str) {
+    return (char *)string_pool_insert_cstr(ast_strings, str);
+}
+
 ASTNode *ast_node_create(ASTNodeKind kind, SourceLocation loc) {
-    ASTNode *node = (ASTNode *)malloc(sizeof(ASTNode));
+    ASTNode *node = (ASTNode *)ast_alloc(sizeof(ASTNode));
     if (!node) return NULL;
+    ast_nodes_created++;
     
     node->kind = kind;
     node->loc = loc;
@@ -18,168 +44,8 @@ ASTNode *ast_node_create(ASTNodeKind kind, SourceLocation loc) {
     return node;
 }
 
-void ast_node_free(ASTNode *node) {
-    if (!node) return;
-    
-    // 递归释放具体节点数据
-    switch (node->kind) {
-        case AST_PROGRAM: {
-            ASTProgram *prog = (ASTProgram *)node->data;
-            for (size_t i = 0; i < prog->stmt_count; i++) {
-                ast_node_free(prog->statements[i]);
-            }
-            free(prog->statements);
-            free(prog);
-            break;
-        }
-        
-        case AST_VAR_DECL: {
-            ASTVarDecl *decl = (ASTVarDecl *)node->data;
-            free(decl->name);
-            ast_node_free(decl->type_annotation);
-            ast_node_free(decl->init_expr);
-            free(decl);
-            break;
-        }
-        
-        case AST_FUNC_DECL: {
-            ASTFuncDecl *func = (ASTFuncDecl *)node->data;
-            free(func->name);
-            for (size_t i = 0; i < func->param_count; i++) {
-                free(func->params[i]);
-            }
-            free(func->params);
-            ast_node_free(func->return_type);
-            ast_node_free(func->body);
-            free(func);
-            break;
-        }
-        
-        case AST_BLOCK: {
-            ASTBlock *block = (ASTBlock *)node->data;
-            for (size_t i = 0; i < block->stmt_count; i++) {
-                ast_node_free(block->statements[i]);
-            }
-            free(block->statements);
-            free(block);
-            break;
-        }
-        
-        case AST_BINARY_EXPR: {
-            ASTBinaryExpr *expr = (ASTBinaryExpr *)node->data;
-            ast_node_free(expr->left);
-            ast_node_free(expr->right);
-            free(expr);
-            break;
-        }
-        
-        case AST_TERNARY_EXPR: {
-            ASTTernaryExpr *expr = (ASTTernaryExpr *)node->data;
-            ast_node_free(expr->condition);
-            ast_node_free(expr->true_value);
-            ast_node_free(expr->false_value);
-            free(expr);
-            break;
-        }
-        
-        case AST_CALL_EXPR: {
-            ASTCallExpr *call = (ASTCallExpr *)node->data;
-            ast_node_free(call->callee);
-            for (size_t i = 0; i < call->arg_count; i++) {
-                ast_node_free(call->args[i]);
-            }
-            free(call->args);
-            free(call);
-            break;
-        }
-        
-        case AST_IDENTIFIER: {
-            ASTIdentifier *id = (ASTIdentifier *)node->data;
-            free(id->name);
-            free(id);
-            break;
-        }
-        
-        case AST_NUM_LITERAL: {
-            ASTNumLiteral *num = (ASTNumLiteral *)node->data;
-            free(num->raw);
-            free(num);
-            break;
-        }
-        
-        case AST_STRING_LITERAL: {
-            ASTStringLiteral *str = (ASTStringLiteral *)node->data;
-            free(str->value);
-            free(str);
-            break;
-        }
-        
-        case AST_RETURN_STMT: {
-            ASTReturnStmt *ret = (ASTReturnStmt *)node->data;
-            ast_node_free(ret->value);
-            free(ret);
-            break;
-        }
-        
-        case AST_TRY_STMT: {
-            ASTTryStmt *try_stmt = (ASTTryStmt *)node->data;
-            ast_node_free(try_stmt->try_block);
-            if (try_stmt->catch_param) free(try_stmt->catch_param);
-            ast_node_free(try_stmt->catch_block);
-            ast_node_free(try_stmt->finally_block);
-            free(try_stmt);
-            break;
-        }
-        
-        case AST_IF_STMT: {
-            ASTIfStmt *ifstmt = (ASTIfStmt *)node->data;
-            for (size_t i = 0; i < ifstmt->cond_count; i++) {
-                ast_node_free(ifstmt->conditions[i]);
-                ast_node_free(ifstmt->then_blocks[i]);
-            }
-            free(ifstmt->conditions);
-            free(ifstmt->then_blocks);
-            ast_node_free(ifstmt->else_block);
-            free(ifstmt);
-            break;
-        }
-        
-        case AST_ASSIGN_STMT: {
-            ASTAssignStmt *assign = (ASTAssignStmt *)node->data;
-            ast_node_free(assign->target);
-            ast_node_free(assign->value);
-            free(assign);
-            break;
-        }
-        
-        case AST_ARRAY_LITERAL: {
-            ASTArrayLiteral *arr = (ASTArrayLiteral *)node->data;
-            for (size_t i = 0; i < arr->elem_count; i++) {
-                ast_node_free(arr->elements[i]);
-            }
-            if (arr->elements) free(arr->elements);
-            if (arr->is_spread) free(arr->is_spread);
-            free(arr);
-            break;
-        }
-        
-        case AST_OBJECT_LITERAL: {
-            ASTObjectLiteral *obj = (ASTObjectLiteral *)node->data;
-            for (size_t i = 0; i < obj->prop_count; i++) {
-                if (obj->properties[i].key) free(obj->properties[i].key);
-                ast_node_free(obj->properties[i].value);
-            }
-            if (obj->properties) free(obj->properties);
-            free(obj);
-            break;
-        }
-        
-        default:
-            if (node->data) free(node->data);
-            break;
-    }
-    
-    free(node);
+size_t ast_node_count(void) {
+    return ast_nodes_created;
 }
 
 /* ============================================================================
@@ -190,7 +56,7 @@ ASTNode *ast_program_create(ASTNode **statements, size_t count, SourceLocation l
     ASTNode *node = ast_node_create(AST_PROGRAM, loc);
     if (!node) return NULL;
     
-    ASTProgram *prog = (ASTProgram *)malloc(sizeof(ASTProgram));
+    ASTProgram *prog = (ASTProgram *)ast_alloc(sizeof(ASTProgram));
     prog->statements = statements;
     prog->stmt_count = count;
     node->data = prog;
@@ -203,7 +69,7 @@ ASTNode *ast_var_decl_create(char *name, ASTNode *type_ann, bool is_const,
     ASTNode *node = ast_node_create(AST_VAR_DECL, loc);
     if (!node) return NULL;
     
-    ASTVarDecl *decl = (ASTVarDecl *)malloc(sizeof(ASTVarDecl));
+    ASTVarDecl *decl = (ASTVarDecl *)ast_alloc(sizeof(ASTVarDecl));
     decl->name = name;
     decl->type_annotation = type_ann;
     decl->is_const = is_const;
@@ -218,7 +84,7 @@ ASTNode *ast_func_decl_create(char *name, char **params, size_t param_count,
     ASTNode *node = ast_node_create(AST_FUNC_DECL, loc);
     if (!node) return NULL;
     
-    ASTFuncDecl *func = (ASTFuncDecl *)malloc(sizeof(ASTFuncDecl));
+    ASTFuncDecl *func = (ASTFuncDecl *)ast_alloc(sizeof(ASTFuncDecl));
     func->name = name;
     func->params = params;
     func->param_count = param_count;
@@ -234,7 +100,7 @@ ASTNode *ast_block_create(ASTNode **statements, size_t count, SourceLocation loc
     ASTNode *node = ast_node_create(AST_BLOCK, loc);
     if (!node) return NULL;
     
-    ASTBlock *block = (ASTBlock *)malloc(sizeof(ASTBlock));
+    ASTBlock *block = (ASTBlock *)ast_alloc(sizeof(ASTBlock));
     block->statements = statements;
     block->stmt_count = count;
     node->data = block;
@@ -247,7 +113,7 @@ ASTNode *ast_binary_expr_create(TokenKind op, ASTNode *left, ASTNode *right,
     ASTNode *node = ast_node_create(AST_BINARY_EXPR, loc);
     if (!node) return NULL;
     
-    ASTBinaryExpr *expr = (ASTBinaryExpr *)malloc(sizeof(ASTBinaryExpr));
+    ASTBinaryExpr *expr = (ASTBinaryExpr *)ast_alloc(sizeof(ASTBinaryExpr));
     expr->op = op;
     expr->left = left;
     expr->right = right;
@@ -261,7 +127,7 @@ ASTNode *ast_call_expr_create(ASTNode *callee, ASTNode **args, size_t arg_count,
     ASTNode *node = ast_node_create(AST_CALL_EXPR, loc);
     if (!node) return NULL;
     
-    ASTCallExpr *call = (ASTCallExpr *)malloc(sizeof(ASTCallExpr));
+    ASTCallExpr *call = (ASTCallExpr *)ast_alloc(sizeof(ASTCallExpr));
     call->callee = callee;
     call->args = args;
     call->arg_count = arg_count;
@@ -275,8 +141,8 @@ ASTNode *ast_identifier_create(char *name, SourceLocation loc) {
     ASTNode *node = ast_node_create(AST_IDENTIFIER, loc);
     if (!node) return NULL;
     
-    ASTIdentifier *id = (ASTIdentifier *)malloc(sizeof(ASTIdentifier));
-    id->name = strdup(name);
+    ASTIdentifier *id = (ASTIdentifier *)ast_alloc(sizeof(ASTIdentifier));
+    id->name = name;
     node->data = id;
     
     return node;
@@ -286,9 +152,9 @@ ASTNode *ast_num_literal_create(double value, char *raw, SourceLocation loc) {
     ASTNode *node = ast_node_create(AST_NUM_LITERAL, loc);
     if (!node) return NULL;
     
-    ASTNumLiteral *num = (ASTNumLiteral *)malloc(sizeof(ASTNumLiteral));
+    ASTNumLiteral *num = (ASTNumLiteral *)ast_alloc(sizeof(ASTNumLiteral));
     num->value = value;
-    num->raw = raw ? strdup(raw) : NULL;
+    num->raw = raw;
     node->data = num;
     
     return node;
@@ -298,13 +164,9 @@ ASTNode *ast_string_literal_create(char *value, size_t length, SourceLocation lo
     ASTNode *node = ast_node_create(AST_STRING_LITERAL, loc);
     if (!node) return NULL;
     
-    ASTStringLiteral *str = (ASTStringLiteral *)malloc(sizeof(ASTStringLiteral));
-    /* 使用memcpy而不是strdup，支持包含\0的字符串 */
-    str->value = (char*)malloc(length + 1);
-    if (str->value) {
-        memcpy(str->value, value, length);
-        str->value[length] = '\0';  /* 添加终止符以便其他地方使用 */
-    }
+    ASTStringLiteral *str = (ASTStringLiteral *)ast_alloc(sizeof(ASTStringLiteral));
+    /* value 已在分配区中并以 \0 结尾；length 是实际长度，支持包含 \0 的字符串 */
+    str->value = value;
     str->length = length;  /* 保存实际长度，支持\0字符串 */
     node->data = str;
     
@@ -315,7 +177,7 @@ ASTNode *ast_bool_literal_create(bool value, SourceLocation loc) {
     ASTNode *node = ast_node_create(AST_BOOL_LITERAL, loc);
     if (!node) return NULL;
     
-    ASTBoolLiteral *bl = (ASTBoolLiteral *)malloc(sizeof(ASTBoolLiteral));
+    ASTBoolLiteral *bl = (ASTBoolLiteral *)ast_alloc(sizeof(ASTBoolLiteral));
     bl->value = value;
     node->data = bl;
     
@@ -326,7 +188,7 @@ ASTNode *ast_return_stmt_create(ASTNode *value, SourceLocation loc) {
     ASTNode *node = ast_node_create(AST_RETURN_STMT, loc);
     if (!node) return NULL;
     
-    ASTReturnStmt *ret = (ASTReturnStmt *)malloc(sizeof(ASTReturnStmt));
+    ASTReturnStmt *ret = (ASTReturnStmt *)ast_alloc(sizeof(ASTReturnStmt));
     ret->value = value;
     node->data = ret;
     
@@ -338,7 +200,7 @@ ASTNode *ast_try_stmt_create(ASTNode *try_block, char *catch_param,
     ASTNode *node = ast_node_create(AST_TRY_STMT, loc);
     if (!node) return NULL;
     
-    ASTTryStmt *try_stmt = (ASTTryStmt *)malloc(sizeof(ASTTryStmt));
+    ASTTryStmt *try_stmt = (ASTTryStmt *)ast_alloc(sizeof(ASTTryStmt));
     try_stmt->try_block = try_block;
     try_stmt->catch_param = catch_param;
     try_stmt->catch_block = catch_block;
@@ -353,7 +215,7 @@ ASTNode *ast_if_stmt_create(ASTNode **conditions, ASTNode **then_blocks,
     ASTNode *node = ast_node_create(AST_IF_STMT, loc);
     if (!node) return NULL;
     
-    ASTIfStmt *ifstmt = (ASTIfStmt *)malloc(sizeof(ASTIfStmt));
+    ASTIfStmt *ifstmt = (ASTIfStmt *)ast_alloc(sizeof(ASTIfStmt));
     ifstmt->conditions = conditions;
     ifstmt->then_blocks = then_blocks;
     ifstmt->cond_count = cond_count;
@@ -367,7 +229,7 @@ ASTNode *ast_assign_stmt_create(ASTNode *target, ASTNode *value, SourceLocation
     ASTNode *node = ast_node_create(AST_ASSIGN_STMT, loc);
     if (!node) return NULL;
     
-    ASTAssignStmt *assign = (ASTAssignStmt *)malloc(sizeof(ASTAssignStmt));
+    ASTAssignStmt *assign = (ASTAssignStmt *)ast_alloc(sizeof(ASTAssignStmt));
     assign->target = target;
     assign->value = value;
     node->data = assign;
@@ -442,7 +304,7 @@ void ast_print(ASTNode *node, int indent) {
 // 一元表达式
 ASTNode *ast_unary_expr_create(TokenKind op, ASTNode *operand, SourceLocation loc) {
     ASTNode *node = ast_node_create(AST_UNARY_EXPR, loc);
-    ASTUnaryExpr *expr = (ASTUnaryExpr *)malloc(sizeof(ASTUnaryExpr));
+    ASTUnaryExpr *expr = (ASTUnaryExpr *)ast_alloc(sizeof(ASTUnaryExpr));
     expr->op = op;
     expr->operand = operand;
     expr->is_postfix = false;  // 默认为前缀
@@ -454,7 +316,7 @@ ASTNode *ast_unary_expr_create(TokenKind op, ASTNode *operand, SourceLocation lo
 ASTNode *ast_ternary_expr_create(ASTNode *condition, ASTNode *true_value, 
                                   ASTNode *false_value, SourceLocation loc) {
     ASTNode *node = ast_node_create(AST_TERNARY_EXPR, loc);
-    ASTTernaryExpr *expr = (ASTTernaryExpr *)malloc(sizeof(ASTTernaryExpr));
+    ASTTernaryExpr *expr = (ASTTernaryExpr *)ast_alloc(sizeof(ASTTernaryExpr));
     expr->condition = condition;
     expr->true_value = true_value;
     expr->false_value = false_value;
@@ -465,7 +327,7 @@ ASTNode *ast_ternary_expr_create(ASTNode *condition, ASTNode *true_value,
 // 成员访问表达式
 ASTNode *ast_member_expr_create(ASTNode *object, char *property, bool is_computed, SourceLocation loc) {
     ASTNode *node = ast_node_create(AST_MEMBER_EXPR, loc);
-    ASTMemberExpr *expr = (ASTMemberExpr *)malloc(sizeof(ASTMemberExpr));
+    ASTMemberExpr *expr = (ASTMemberExpr *)ast_alloc(sizeof(ASTMemberExpr));
     expr->object = object;
     expr->property = property;
     expr->is_computed = is_computed;
@@ -478,7 +340,7 @@ ASTNode *ast_member_expr_create(ASTNode *object, char *property, bool is_compute
 // 索引访问表达式
 ASTNode *ast_index_expr_create(ASTNode *object, ASTNode *index, SourceLocation loc) {
     ASTNode *node = ast_node_create(AST_INDEX_EXPR, loc);
-    ASTIndexExpr *expr = (ASTIndexExpr *)malloc(sizeof(ASTIndexExpr));
+    ASTIndexExpr *expr = (ASTIndexExpr *)ast_alloc(sizeof(ASTIndexExpr));
     expr->object = object;
     expr->index = index;
     expr->is_unbound = false;  // 默认为普通绑定访问
@@ -490,12 +352,12 @@ ASTNode *ast_index_expr_create(ASTNode *object, ASTNode *index, SourceLocation l
 // 数组字面量（无展开）
 ASTNode *ast_array_literal_create(ASTNode **elements, size_t count, SourceLocation loc) {
     ASTNode *node = ast_node_create(AST_ARRAY_LITERAL, loc);
-    ASTArrayLiteral *arr = (ASTArrayLiteral *)malloc(sizeof(ASTArrayLiteral));
+    ASTArrayLiteral *arr = (ASTArrayLiteral *)ast_alloc(sizeof(ASTArrayLiteral));
     arr->elements = elements;
     arr->elem_count = count;
     // 初始化 is_spread 为全 false
     if (count > 0) {
-        arr->is_spread = (bool *)calloc(count, sizeof(bool));
+        arr->is_spread = (bool *)arena_alloc_zero(ast_arena, count * sizeof(bool));
     } else {
         arr->is_spread = NULL;
     }
@@ -506,7 +368,7 @@ ASTNode *ast_array_literal_create(ASTNode **elements, size_t count, SourceLocati
 // 数组字面量（支持展开）
 ASTNode *ast_array_literal_create_with_spread(ASTNode **elements, bool *is_spread, size_t count, SourceLocation loc) {
     ASTNode *node = ast_node_create(AST_ARRAY_LITERAL, loc);
-    ASTArrayLiteral *arr = (ASTArrayLiteral *)malloc(sizeof(ASTArrayLiteral));
+    ASTArrayLiteral *arr = (ASTArrayLiteral *)ast_alloc(sizeof(ASTArrayLiteral));
     arr->elements = elements;
     arr->is_spread = is_spread;
     arr->elem_count = count;
@@ -517,7 +379,7 @@ ASTNode *ast_array_literal_create_with_spread(ASTNode **elements, bool *is_sprea
 // 对象字面量
 ASTNode *ast_object_literal_create(ASTObjectProperty *properties, size_t count, SourceLocation loc) {
     ASTNode *node = ast_node_create(AST_OBJECT_LITERAL, loc);
-    ASTObjectLiteral *obj = (ASTObjectLiteral *)malloc(sizeof(ASTObjectLiteral));
+    ASTObjectLiteral *obj = (ASTObjectLiteral *)ast_alloc(sizeof(ASTObjectLiteral));
     obj->properties = properties;
     obj->prop_count = count;
     node->data = obj;
@@ -527,7 +389,7 @@ ASTNode *ast_object_literal_create(ASTObjectProperty *properties, size_t count,
 // 循环语句
 ASTNode *ast_loop_stmt_create(LoopType type, ASTNode *body, SourceLocation loc) {
     ASTNode *node = ast_node_create(AST_LOOP_STMT, loc);
-    ASTLoopStmt *loop = (ASTLoopStmt *)malloc(sizeof(ASTLoopStmt));
+    ASTLoopStmt *loop = (ASTLoopStmt *)ast_alloc(sizeof(ASTLoopStmt));
     loop->loop_type = type;
     loop->label = NULL;  /* 默认无标签 */
     loop->body = body;
@@ -283,7 +283,7 @@ static ASTNode *parse_primary(Parser *p) {
                 do {
                     if (arg_count >= arg_capacity) {
                         arg_capacity = arg_capacity == 0 ? 4 : arg_capacity * 2;
-                        args = (ASTNode **)realloc(args, arg_capacity * sizeof(ASTNode *));
+                        args = (ASTNode **)ast_realloc(args, arg_count * sizeof(ASTNode *), arg_capacity * sizeof(ASTNode *));
                     }
                     args[arg_count++] = parse_expression(p);
                 } while (match(p, TK_COMMA) && !check(p, TK_R_PAREN));
@@ -349,10 +349,10 @@ static ASTNode *parse_primary(Parser *p) {
                 
                 if (param_count >= param_capacity) {
                     param_capacity = param_capacity == 0 ? 4 : param_capacity * 2;
-                    params = (char **)realloc(params, param_capacity * sizeof(char *));
+                    params = (char **)ast_realloc(params, param_count * sizeof(char *), param_capacity * sizeof(char *));
                 }
                 
-                params[param_count++] = strdup(current_token(p)->lexeme);
+                params[param_count++] = current_token(p)->lexeme;
                 advance(p);
                 
                 if (!match(p, TK_COMMA)) {
@@ -362,8 +362,6 @@ static ASTNode *parse_primary(Parser *p) {
             
             if (!match(p, TK_R_PAREN)) {
                 error_at(p, current_token(p), "Expected ')' after parameters");
-                for (size_t i = 0; i < param_count; i++) free(params[i]);
-                free(params);
                 return NULL;
             }
             
@@ -376,8 +374,8 @@ static ASTNode *parse_primary(Parser *p) {
             snprintf(anon_name, sizeof(anon_name), "_anon_%d", anon_func_counter++);
             
             ASTNode *func_node = ast_node_create(AST_FUNC_DECL, token_to_loc(lparen));
-            ASTFuncDecl *func = (ASTFuncDecl *)malloc(sizeof(ASTFuncDecl));
-            func->name = strdup(anon_name);
+            ASTFuncDecl *func = (ASTFuncDecl *)ast_alloc(sizeof(ASTFuncDecl));
+            func->name = ast_strdup(anon_name);
             func->params = params;
             func->param_count = param_count;
             func->return_type = NULL;
@@ -407,8 +405,8 @@ static ASTNode *parse_primary(Parser *p) {
             do {
                 if (elem_count >= elem_capacity) {
                     elem_capacity = elem_capacity == 0 ? 4 : elem_capacity * 2;
-                    elements = (ASTNode **)realloc(elements, elem_capacity * sizeof(ASTNode *));
-                    is_spread = (bool *)realloc(is_spread, elem_capacity * sizeof(bool));
+                    elements = (ASTNode **)ast_realloc(elements, elem_count * sizeof(ASTNode *), elem_capacity * sizeof(ASTNode *));
+                    is_spread = (bool *)ast_realloc(is_spread, elem_count * sizeof(bool), elem_capacity * sizeof(bool));
                 }
                 
                 // 检查是否是展开语法 ...expr
@@ -457,7 +455,8 @@ static ASTNode *parse_primary(Parser *p) {
                     
                     if (prop_count >= prop_capacity) {
                         prop_capacity = prop_capacity == 0 ? 4 : prop_capacity * 2;
-                        properties = (ASTObjectProperty *)realloc(properties, 
+                        properties = (ASTObjectProperty *)ast_realloc(properties, 
+                                    prop_count * sizeof(ASTObjectProperty), 
                                     prop_capacity * sizeof(ASTObjectProperty));
                     }
                     properties[prop_count].key = NULL;  // 展开没有 key
@@ -477,10 +476,10 @@ static ASTNode *parse_primary(Parser *p) {
                         match(p, TK_FALSE) || match(p, TK_NULL) ||
                         match(p, TK_UNDEF) || match(p, TK_KW_IF) ||
                         match(p, TK_SELF)) {
-                        key = strdup(key_token->lexeme);
+                        key = key_token->lexeme;
                     } else if (match(p, TK_STRING)) {
                         // lexer已经去除引号并处理转义
-                        key = strdup(key_token->lexeme);
+                        key = key_token->lexeme;
                     } else {
                         error_at(p, key_token, "Expected property key or spread operator");
                         had_error_in_object = true;
@@ -493,7 +492,6 @@ static ASTNode *parse_primary(Parser *p) {
                     
                     if (!match(p, TK_COLON)) {
                         error_at(p, current_token(p), "Expected ':' after property key");
-                        free(key);
                         had_error_in_object = true;
                         // 错误恢复：跳到右花括号结束对象解析
                         while (!check(p, TK_R_BRACE) && !check(p, TK_EOF)) {
@@ -506,7 +504,6 @@ static ASTNode *parse_primary(Parser *p) {
                     
                     // 如果解析值失败，跳到右花括号结束对象解析
                     if (value == NULL) {
-                        free(key);
                         had_error_in_object = true;
                         while (!check(p, TK_R_BRACE) && !check(p, TK_EOF)) {
                             advance(p);
@@ -516,7 +513,8 @@ static ASTNode *parse_primary(Parser *p) {
                     
                     if (prop_count >= prop_capacity) {
                         prop_capacity = prop_capacity == 0 ? 4 : prop_capacity * 2;
-                        properties = (ASTObjectProperty *)realloc(properties, 
+                        properties = (ASTObjectProperty *)ast_realloc(properties, 
+                                    prop_count * sizeof(ASTObjectProperty), 
                                     prop_capacity * sizeof(ASTObjectProperty));
                     }
                     properties[prop_count].key = key;
@@ -542,11 +540,6 @@ static ASTNode *parse_primary(Parser *p) {
         
         // 如果对象解析过程中有错误，返回 NULL 而不是部分对象
         if (had_error_in_object) {
-            // 释放已分配的属性
-            for (size_t i = 0; i < prop_count; i++) {
-                if (properties[i].key) free(properties[i].key);
-            }
-            if (properties) free(properties);
             return NULL;
         }
         
@@ -579,7 +572,7 @@ static ASTNode *parse_postfix(Parser *p) {
             }
             // 创建解绑索引表达式
             ASTNode *node = ast_node_create(AST_INDEX_EXPR, expr->loc);
-            ASTIndexExpr *idx = (ASTIndexExpr *)malloc(sizeof(ASTIndexExpr));
+            ASTIndexExpr *idx = (ASTIndexExpr *)ast_alloc(sizeof(ASTIndexExpr));
             idx->object = expr;
             idx->index = index;
             idx->is_unbound = true;  // 标记为解绑访问
@@ -611,9 +604,9 @@ static ASTNode *parse_postfix(Parser *p) {
             }
             // 创建未绑定成员表达式
             ASTNode *node = ast_node_create(AST_MEMBER_EXPR, expr->loc);
-            ASTMemberExpr *member = (ASTMemberExpr *)malloc(sizeof(ASTMemberExpr));
+            ASTMemberExpr *member = (ASTMemberExpr *)ast_alloc(sizeof(ASTMemberExpr));
             member->object = expr;
-            member->property = strdup(prop_token->lexeme);
+            member->property = prop_token->lexeme;
             member->is_computed = false;
             member->is_unbound = true;  // 标记为未绑定访问
             member->is_optional = false; // 非可选访问
@@ -634,7 +627,7 @@ static ASTNode *parse_postfix(Parser *p) {
                 error_at(p, prop_token, "Expected property name after '.'");
                 break;
             }
-            expr = ast_member_expr_create(expr, strdup(prop_token->lexeme), false, expr->loc);
+            expr = ast_member_expr_create(expr, prop_token->lexeme, false, expr->loc);
         }
         // 可选链成员访问: obj?.prop（属性不存在返回undef）
         else if (match(p, TK_QUESTION_DOT)) {
@@ -652,9 +645,9 @@ static ASTNode *parse_postfix(Parser *p) {
             }
             // 创建可选链成员表达式
             ASTNode *node = ast_node_create(AST_MEMBER_EXPR, expr->loc);
-            ASTMemberExpr *member = (ASTMemberExpr *)malloc(sizeof(ASTMemberExpr));
+            ASTMemberExpr *member = (ASTMemberExpr *)ast_alloc(sizeof(ASTMemberExpr));
             member->object = expr;
-            member->property = strdup(prop_token->lexeme);
+            member->property = prop_token->lexeme;
             member->is_computed = false;
             member->is_unbound = false;  // 非解绑访问
             member->is_optional = true;  // 标记为可选链访问
@@ -683,7 +676,7 @@ static ASTNode *parse_postfix(Parser *p) {
                 error_at(p, method_token, "Expected method name after '.>'");
                 break;
             }
-            char *method_name = strdup(method_token->lexeme);
+            char *method_name = method_token->lexeme;
             
             // 检查是否有参数（有括号）
             if (match(p, TK_L_PAREN)) {
@@ -696,7 +689,7 @@ static ASTNode *parse_postfix(Parser *p) {
                     do {
                         if (arg_count >= arg_capacity) {
                             arg_capacity = arg_capacity == 0 ? 4 : arg_capacity * 2;
-                            args = (ASTNode **)realloc(args, arg_capacity * sizeof(ASTNode *));
+                            args = (ASTNode **)ast_realloc(args, arg_count * sizeof(ASTNode *), arg_capacity * sizeof(ASTNode *));
                         }
                         args[arg_count++] = parse_expression(p);
                     } while (match(p, TK_COMMA) && !check(p, TK_R_PAREN));
@@ -719,12 +712,11 @@ static ASTNode *parse_postfix(Parser *p) {
                 
                 // 创建方法调用: method(obj, args...)
                 size_t total_args = arg_count + 1;
-                ASTNode **all_args = (ASTNode **)malloc(total_args * sizeof(ASTNode *));
+                ASTNode **all_args = (ASTNode **)ast_alloc(total_args * sizeof(ASTNode *));
                 all_args[0] = expr;  // 第一个参数是对象本身
                 for (size_t i = 0; i < arg_count; i++) {
                     all_args[i + 1] = args[i];
                 }
-                if (args) free(args);
                 
                 ASTNode *callee = ast_identifier_create(method_name, expr->loc);
                 expr = ast_call_expr_create(callee, all_args, total_args, throw_on_error, expr->loc);
@@ -738,7 +730,7 @@ static ASTNode *parse_postfix(Parser *p) {
                     throw_on_error = 1;
                 }
                 
-                ASTNode **all_args = (ASTNode **)malloc(1 * sizeof(ASTNode *));
+                ASTNode **all_args = (ASTNode **)ast_alloc(1 * sizeof(ASTNode *));
                 all_args[0] = expr;  // 左边的值作为唯一参数
                 
                 ASTNode *callee = ast_identifier_create(method_name, expr->loc);
@@ -750,7 +742,7 @@ static ASTNode *parse_postfix(Parser *p) {
             Token *op_token = &p->tokens[p->current - 1];
             // 创建后缀一元运算符节点
             ASTNode *node = ast_node_create(AST_UNARY_EXPR, expr->loc);
-            ASTUnaryExpr *unary = (ASTUnaryExpr *)malloc(sizeof(ASTUnaryExpr));
+            ASTUnaryExpr *unary = (ASTUnaryExpr *)ast_alloc(sizeof(ASTUnaryExpr));
             unary->op = op_token->kind;
             unary->operand = expr;
             unary->is_postfix = true;  // 标记为后缀
@@ -767,7 +759,7 @@ static ASTNode *parse_postfix(Parser *p) {
                 do {
                     if (arg_count >= arg_capacity) {
                         arg_capacity = arg_capacity == 0 ? 4 : arg_capacity * 2;
-                        args = (ASTNode **)realloc(args, arg_capacity * sizeof(ASTNode *));
+                        args = (ASTNode **)ast_realloc(args, arg_count * sizeof(ASTNode *), arg_capacity * sizeof(ASTNode *));
                     }
                     args[arg_count++] = parse_expression(p);
                 } while (match(p, TK_COMMA) && !check(p, TK_R_PAREN));
@@ -815,7 +807,7 @@ static ASTNode *parse_unary(Parser *p) {
         }
         
         ASTNode *node = ast_node_create(AST_UNARY_EXPR, token_to_loc(op_token));
-        ASTUnaryExpr *unary = (ASTUnaryExpr *)malloc(sizeof(ASTUnaryExpr));
+        ASTUnaryExpr *unary = (ASTUnaryExpr *)ast_alloc(sizeof(ASTUnaryExpr));
         unary->op = op_token->kind;
         unary->operand = operand;
         unary->is_postfix = false;  // 前缀运算符
@@ -959,7 +951,7 @@ static ASTNode *parse_optional_chain_index(Parser *p, ASTNode *object) {
     }
     // 创建可选链索引表达式
     ASTNode *node = ast_node_create(AST_INDEX_EXPR, object->loc);
-    ASTIndexExpr *idx = (ASTIndexExpr *)malloc(sizeof(ASTIndexExpr));
+    ASTIndexExpr *idx = (ASTIndexExpr *)ast_alloc(sizeof(ASTIndexExpr));
     idx->object = object;
     idx->index = index;
     idx->is_unbound = false;
@@ -995,8 +987,8 @@ static ASTNode *parse_ternary(Parser *p) {
                 do {
                     if (elem_count >= elem_capacity) {
                         elem_capacity = elem_capacity == 0 ? 4 : elem_capacity * 2;
-                        elements = (ASTNode **)realloc(elements, elem_capacity * sizeof(ASTNode *));
-                        is_spread = (bool *)realloc(is_spread, elem_capacity * sizeof(bool));
+                        elements = (ASTNode **)ast_realloc(elements, elem_count * sizeof(ASTNode *), elem_capacity * sizeof(ASTNode *));
+                        is_spread = (bool *)ast_realloc(is_spread, elem_count * sizeof(bool), elem_capacity * sizeof(bool));
                     }
                     
                     if (match(p, TK_SPREAD)) {
@@ -1012,8 +1004,6 @@ static ASTNode *parse_ternary(Parser *p) {
             
             if (!match(p, TK_R_BRACKET)) {
                 error_at(p, current_token(p), "Expected ']'");
-                if (elements) free(elements);
-                if (is_spread) free(is_spread);
                 return left;
             }
             
@@ -1029,24 +1019,18 @@ static ASTNode *parse_ternary(Parser *p) {
                 // 这是可选链索引访问：obj?[index]
                 if (elem_count != 1) {
                     error_at(p, qb_token, "Optional chain index must be a single expression, not array elements");
-                    if (elements) free(elements);
-                    if (is_spread) free(is_spread);
                     return left;
                 }
                 if (is_spread && is_spread[0]) {
                     error_at(p, qb_token, "Spread operator not allowed in optional chain index");
-                    if (elements) free(elements);
-                    if (is_spread) free(is_spread);
                     return left;
                 }
                 
                 ASTNode *index = elements[0];
-                if (elements) free(elements);
-                if (is_spread) free(is_spread);
                 
                 // 创建可选链索引表达式
                 ASTNode *node = ast_node_create(AST_INDEX_EXPR, left->loc);
-                ASTIndexExpr *idx = (ASTIndexExpr *)malloc(sizeof(ASTIndexExpr));
+                ASTIndexExpr *idx = (ASTIndexExpr *)ast_alloc(sizeof(ASTIndexExpr));
                 idx->object = left;
                 idx->index = index;
                 idx->is_unbound = false;
@@ -1070,9 +1054,9 @@ static ASTNode *parse_ternary(Parser *p) {
                 break;
             }
             ASTNode *node = ast_node_create(AST_MEMBER_EXPR, left->loc);
-            ASTMemberExpr *member = (ASTMemberExpr *)malloc(sizeof(ASTMemberExpr));
+            ASTMemberExpr *member = (ASTMemberExpr *)ast_alloc(sizeof(ASTMemberExpr));
             member->object = left;
-            member->property = strdup(prop_token->lexeme);
+            member->property = prop_token->lexeme;
             member->is_computed = false;
             member->is_unbound = false;
             member->is_optional = true;
@@ -1092,7 +1076,7 @@ static ASTNode *parse_ternary(Parser *p) {
                 error_at(p, prop_token, "Expected property name after '.'");
                 break;
             }
-            left = ast_member_expr_create(left, strdup(prop_token->lexeme), false, left->loc);
+            left = ast_member_expr_create(left, prop_token->lexeme, false, left->loc);
         }
         // 普通索引访问: obj[index]
         else if (match(p, TK_L_BRACKET)) {
@@ -1115,7 +1099,7 @@ static ASTNode *parse_ternary(Parser *p) {
                 error_at(p, method_token, "Expected method name after '.>'");
                 break;
             }
-            char *method_name = strdup(method_token->lexeme);
+            char *method_name = method_token->lexeme;
             
             if (match(p, TK_L_PAREN)) {
                 ASTNode **args = NULL;
@@ -1126,7 +1110,7 @@ static ASTNode *parse_ternary(Parser *p) {
                     do {
                         if (arg_count >= arg_capacity) {
                             arg_capacity = arg_capacity == 0 ? 4 : arg_capacity * 2;
-                            args = (ASTNode **)realloc(args, arg_capacity * sizeof(ASTNode *));
+                            args = (ASTNode **)ast_realloc(args, arg_count * sizeof(ASTNode *), arg_capacity * sizeof(ASTNode *));
                         }
                         args[arg_count++] = parse_expression(p);
                     } while (match(p, TK_COMMA) && !check(p, TK_R_PAREN));
@@ -1139,18 +1123,17 @@ static ASTNode *parse_ternary(Parser *p) {
                 int throw_on_error = match(p, TK_BANG) ? 1 : 0;
                 
                 size_t total_args = arg_count + 1;
-                ASTNode **all_args = (ASTNode **)malloc(total_args * sizeof(ASTNode *));
+                ASTNode **all_args = (ASTNode **)ast_alloc(total_args * sizeof(ASTNode *));
                 all_args[0] = left;
                 for (size_t i = 0; i < arg_count; i++) {
                     all_args[i + 1] = args[i];
                 }
-                if (args) free(args);
                 
                 ASTNode *callee = ast_identifier_create(method_name, left->loc);
                 left = ast_call_expr_create(callee, all_args, total_args, throw_on_error, left->loc);
             } else {
                 int throw_on_error = match(p, TK_BANG) ? 1 : 0;
-                ASTNode **all_args = (ASTNode **)malloc(1 * sizeof(ASTNode *));
+                ASTNode **all_args = (ASTNode **)ast_alloc(1 * sizeof(ASTNode *));
                 all_args[0] = left;
                 ASTNode *callee = ast_identifier_create(method_name, left->loc);
                 left = ast_call_expr_create(callee, all_args, 1, throw_on_error, left->loc);
@@ -1170,9 +1153,9 @@ static ASTNode *parse_ternary(Parser *p) {
                 break;
             }
             ASTNode *node = ast_node_create(AST_MEMBER_EXPR, left->loc);
-            ASTMemberExpr *member = (ASTMemberExpr *)malloc(sizeof(ASTMemberExpr));
+            ASTMemberExpr *member = (ASTMemberExpr *)ast_alloc(sizeof(ASTMemberExpr));
             member->object = left;
-            member->property = strdup(prop_token->lexeme);
+            member->property = prop_token->lexeme;
             member->is_computed = false;
             member->is_unbound = true;
             member->is_optional = false;
@@ -1190,7 +1173,7 @@ static ASTNode *parse_ternary(Parser *p) {
                 error_at(p, current_token(p), "Expected ']' after index");
             }
             ASTNode *node = ast_node_create(AST_INDEX_EXPR, left->loc);
-            ASTIndexExpr *idx = (ASTIndexExpr *)malloc(sizeof(ASTIndexExpr));
+            ASTIndexExpr *idx = (ASTIndexExpr *)ast_alloc(sizeof(ASTIndexExpr));
             idx->object = left;
             idx->index = index;
             idx->is_unbound = true;
@@ -1243,7 +1226,7 @@ static ASTNode *parse_block(Parser *p) {
     while (!check(p, TK_R_BRACE) && !check(p, TK_EOF)) {
         if (stmt_count >= stmt_capacity) {
             stmt_capacity = stmt_capacity == 0 ? 8 : stmt_capacity * 2;
-            statements = (ASTNode **)realloc(statements, stmt_capacity * sizeof(ASTNode *));
+            statements = (ASTNode **)ast_realloc(statements, stmt_count * sizeof(ASTNode *), stmt_capacity * sizeof(ASTNode *));
         }
         
         size_t old_pos = p->current;
@@ -1297,8 +1280,8 @@ static ASTNode *parse_if_statement(Parser *p) {
     ASTNode *then_block = parse_block(p);
     
     // 收集所有条件和对应的块
-    ASTNode **conditions = (ASTNode **)malloc(sizeof(ASTNode *));
-    ASTNode **then_blocks = (ASTNode **)malloc(sizeof(ASTNode *));
+    ASTNode **conditions = (ASTNode **)ast_alloc(sizeof(ASTNode *));
+    ASTNode **then_blocks = (ASTNode **)ast_alloc(sizeof(ASTNode *));
     size_t cond_count = 1;
     size_t cond_capacity = 1;
     
@@ -1325,8 +1308,8 @@ static ASTNode *parse_if_statement(Parser *p) {
         // 扩展数组
         if (cond_count >= cond_capacity) {
             cond_capacity *= 2;
-            conditions = (ASTNode **)realloc(conditions, cond_capacity * sizeof(ASTNode *));
-            then_blocks = (ASTNode **)realloc(then_blocks, cond_capacity * sizeof(ASTNode *));
+            conditions = (ASTNode **)ast_realloc(conditions, cond_count * sizeof(ASTNode *), cond_capacity * sizeof(ASTNode *));
+            then_blocks = (ASTNode **)ast_realloc(then_blocks, cond_count * sizeof(ASTNode *), cond_capacity * sizeof(ASTNode *));
         }
         
         conditions[cond_count] = next_cond;
@@ -1371,15 +1354,15 @@ static ASTNode *parse_break_statement(Parser *p) {
     if (check(p, TK_IDENT)) {
         Token *label_token = current_token(p);
         advance(p);
-        target_label = strdup(label_token->lexeme);
+        target_label = label_token->lexeme;
     }
     
     // 创建带标签的 break 节点
-    ASTNode *node = (ASTNode*)malloc(sizeof(ASTNode));
+    ASTNode *node = (ASTNode*)ast_alloc(sizeof(ASTNode));
     node->kind = AST_BREAK_STMT;
     node->loc = token_to_loc(start);
     
-    ASTBreakStmt *break_stmt = (ASTBreakStmt *)malloc(sizeof(ASTBreakStmt));
+    ASTBreakStmt *break_stmt = (ASTBreakStmt *)ast_alloc(sizeof(ASTBreakStmt));
     break_stmt->target_label = target_label;
     node->data = break_stmt;
     
@@ -1398,15 +1381,15 @@ static ASTNode *parse_next_statement(Parser *p) {
     if (check(p, TK_IDENT)) {
         Token *label_token = current_token(p);
         advance(p);
-        target_label = strdup(label_token->lexeme);
+        target_label = label_token->lexeme;
     }
     
     // 创建带标签的 next 节点
-    ASTNode *node = (ASTNode*)malloc(sizeof(ASTNode));
+    ASTNode *node = (ASTNode*)ast_alloc(sizeof(ASTNode));
     node->kind = AST_NEXT_STMT;
     node->loc = token_to_loc(start);
     
-    ASTNextStmt *next_stmt = (ASTNextStmt *)malloc(sizeof(ASTNextStmt));
+    ASTNextStmt *next_stmt = (ASTNextStmt *)ast_alloc(sizeof(ASTNextStmt));
     next_stmt->target_label = target_label;
     node->data = next_stmt;
     
@@ -1440,32 +1423,25 @@ static ASTNode *parse_try_statement(Parser *p) {
         
         if (current_token(p)->kind != TK_IDENT) {
             error_at(p, current_token(p), "Expected parameter name in catch clause");
-            ast_node_free(try_block);
             return NULL;
         }
         
         Token *param_tok = current_token(p);
-        catch_param = strdup(param_tok->lexeme);
+        catch_param = param_tok->lexeme;
         advance(p);
         
         if (!match(p, TK_R_PAREN)) {
             error_at(p, current_token(p), "Expected ')' after catch parameter");
-            free(catch_param);
-            ast_node_free(try_block);
             return NULL;
         }
         
         if (!check(p, TK_L_BRACE)) {
             error_at(p, current_token(p), "Expected '{' for catch block");
-            free(catch_param);
-            ast_node_free(try_block);
             return NULL;
         }
         
         catch_block = parse_block(p);
         if (!catch_block) {
-            free(catch_param);
-            ast_node_free(try_block);
             return NULL;
         }
     }
@@ -1475,9 +1451,6 @@ static ASTNode *parse_try_statement(Parser *p) {
     if (check(p, TK_L_BRACE)) {
         finally_block = parse_block(p);
         if (!finally_block) {
-            if (catch_param) free(catch_param);
-            ast_node_free(catch_block);
-            ast_node_free(try_block);
             return NULL;
         }
     }
@@ -1497,7 +1470,7 @@ static char *parse_optional_loop_label(Parser *p) {
                 advance(p);  // 跳过 :
                 Token *label_token = current_token(p);
                 advance(p);  // 跳过标识符
-                return strdup(label_token->lexeme);
+                return label_token->lexeme;
             }
         }
     }
@@ -1634,7 +1607,7 @@ static ASTNode *parse_loop_statement(Parser *p) {
             error_at(p, item_token, "Expected variable name after ':'");
             return NULL;
         }
-        char *item_var = strdup(item_token->lexeme);
+        char *item_var = item_token->lexeme;
         if (!match(p, TK_R_PAREN)) {
             error_at(p, current_token(p), "Expected ')' after foreach header");
             return NULL;
@@ -1702,7 +1675,7 @@ static ASTNode *parse_var_declaration(Parser *p) {
         return NULL;
     }
     
-    char *name = strdup(name_token->lexeme);
+    char *name = name_token->lexeme;
     
     // 跳过可选的类型注解: :[type]= 或 :<type>= 或 :(type)=
     // :[type]= - 变量声明（方括号）
@@ -1733,7 +1706,7 @@ static ASTNode *parse_var_declaration(Parser *p) {
             
             // 创建类型注解AST节点
             type_annotation = ast_node_create(AST_TYPE_ANNOTATION, token_to_loc(type_tok));
-            ASTTypeAnnotation *type_ann = (ASTTypeAnnotation *)malloc(sizeof(ASTTypeAnnotation));
+            ASTTypeAnnotation *type_ann = (ASTTypeAnnotation *)ast_alloc(sizeof(ASTTypeAnnotation));
             type_ann->type_token = type_kind;
             type_annotation->data = type_ann;
             is_const = false;  // 方括号表示变量
@@ -1756,7 +1729,7 @@ static ASTNode *parse_var_declaration(Parser *p) {
             
             // 创建类型注解AST节点
             type_annotation = ast_node_create(AST_TYPE_ANNOTATION, token_to_loc(type_tok));
-            ASTTypeAnnotation *type_ann = (ASTTypeAnnotation *)malloc(sizeof(ASTTypeAnnotation));
+            ASTTypeAnnotation *type_ann = (ASTTypeAnnotation *)ast_alloc(sizeof(ASTTypeAnnotation));
             type_ann->type_token = type_kind;
             type_annotation->data = type_ann;
             is_const = true;  // 圆括号表示常量
@@ -1778,7 +1751,7 @@ static ASTNode *parse_var_declaration(Parser *p) {
             
             // 创建类型注解AST节点
             type_annotation = ast_node_create(AST_TYPE_ANNOTATION, token_to_loc(type_tok));
-            ASTTypeAnnotation *type_ann = (ASTTypeAnnotation *)malloc(sizeof(ASTTypeAnnotation));
+            ASTTypeAnnotation *type_ann = (ASTTypeAnnotation *)ast_alloc(sizeof(ASTTypeAnnotation));
             type_ann->type_token = type_kind;
             type_annotation->data = type_ann;
             is_const = false;
@@ -1797,7 +1770,6 @@ static ASTNode *parse_var_declaration(Parser *p) {
         // 期望参数列表
         if (!match(p, TK_L_PAREN)) {
             error_at(p, current_token(p), "Expected '(' after function type");
-            free(name);
             return NULL;
         }
         
@@ -1814,10 +1786,10 @@ static ASTNode *parse_var_declaration(Parser *p) {
             
             if (param_count >= param_capacity) {
                 param_capacity = param_capacity == 0 ? 4 : param_capacity * 2;
-                params = (char **)realloc(params, param_capacity * sizeof(char *));
+                params = (char **)ast_realloc(params, param_count * sizeof(char *), param_capacity * sizeof(char *));
             }
             
-            params[param_count++] = strdup(current_token(p)->lexeme);
+            params[param_count++] = current_token(p)->lexeme;
             advance(p);
             
             if (!match(p, TK_COMMA)) {
@@ -1827,9 +1799,6 @@ static ASTNode *parse_var_declaration(Parser *p) {
         
         if (!match(p, TK_R_PAREN)) {
             error_at(p, current_token(p), "Expected ')' after parameters");
-            free(name);
-            for (size_t i = 0; i < param_count; i++) free(params[i]);
-            free(params);
             return NULL;
         }
         
@@ -1838,7 +1807,7 @@ static ASTNode *parse_var_declaration(Parser *p) {
         
         // 创建函数声明节点
         ASTNode *func_node = ast_node_create(AST_FUNC_DECL, token_to_loc(name_token));
-        ASTFuncDecl *func = (ASTFuncDecl *)malloc(sizeof(ASTFuncDecl));
+        ASTFuncDecl *func = (ASTFuncDecl *)ast_alloc(sizeof(ASTFuncDecl));
         func->name = name;
         func->params = params;
         func->param_count = param_count;
@@ -1859,7 +1828,6 @@ static ASTNode *parse_var_declaration(Parser *p) {
         } else {
             error_at(p, current_token(p), "Expected ':=' in variable declaration");
         }
-        free(name);
         return NULL;
     }
     
@@ -1869,7 +1837,6 @@ static ASTNode *parse_var_declaration(Parser *p) {
         // 解析为函数定义
         if (!match(p, TK_L_PAREN)) {
             error_at(p, current_token(p), "Expected '('");
-            free(name);
             return NULL;
         }
         
@@ -1886,10 +1853,10 @@ static ASTNode *parse_var_declaration(Parser *p) {
             
             if (param_count >= param_capacity) {
                 param_capacity = param_capacity == 0 ? 4 : param_capacity * 2;
-                params = (char **)realloc(params, param_capacity * sizeof(char *));
+                params = (char **)ast_realloc(params, param_count * sizeof(char *), param_capacity * sizeof(char *));
             }
             
-            params[param_count++] = strdup(current_token(p)->lexeme);
+            params[param_count++] = current_token(p)->lexeme;
             advance(p);
             
             if (!match(p, TK_COMMA)) {
@@ -1899,9 +1866,6 @@ static ASTNode *parse_var_declaration(Parser *p) {
         
         if (!match(p, TK_R_PAREN)) {
             error_at(p, current_token(p), "Expected ')' after parameters");
-            free(name);
-            for (size_t i = 0; i < param_count; i++) free(params[i]);
-            free(params);
             return NULL;
         }
         
@@ -1910,7 +1874,7 @@ static ASTNode *parse_var_declaration(Parser *p) {
         
         // 创建函数声明节点
         ASTNode *func_node = ast_node_create(AST_FUNC_DECL, token_to_loc(name_token));
-        ASTFuncDecl *func = (ASTFuncDecl *)malloc(sizeof(ASTFuncDecl));
+        ASTFuncDecl *func = (ASTFuncDecl *)ast_alloc(sizeof(ASTFuncDecl));
         func->name = name;
         func->params = params;
         func->param_count = param_count;
@@ -1927,21 +1891,18 @@ static ASTNode *parse_var_declaration(Parser *p) {
     
     // 如果表达式解析失败，返回 NULL
     if (init == NULL) {
-        free(name);
         return NULL;
     }
     
     // 检查常量必须初始化
     if (is_const && init == NULL) {
         error_at(p, name_token, "Constant must be initialized");
-        free(name);
         return NULL;
     }
     
     // 检查：如果是 := null 则报错（null需要显式类型注解）
     if (!type_annotation && init->kind == AST_NULL_LITERAL) {
         error_at(p, name_token, "Cannot infer type from null value. Use explicit type annotation like 'name:[type]=null'");
-        free(name);
         return NULL;
     }
     
@@ -2001,7 +1962,7 @@ static ASTNode *parse_statement(Parser *p) {
             ASTNode *expr = parse_expression(p);
             if (expr) {
                 ASTNode *node = ast_node_create(AST_EXPR_STMT, expr->loc);
-                ASTExprStmt *stmt = (ASTExprStmt *)malloc(sizeof(ASTExprStmt));
+                ASTExprStmt *stmt = (ASTExprStmt *)ast_alloc(sizeof(ASTExprStmt));
                 stmt->expr = expr;
                 node->data = stmt;
                 return node;
@@ -2016,7 +1977,7 @@ static ASTNode *parse_statement(Parser *p) {
                 ASTNode *expr = parse_expression(p);
                 if (expr) {
                     ASTNode *node = ast_node_create(AST_EXPR_STMT, expr->loc);
-                    ASTExprStmt *stmt = (ASTExprStmt *)malloc(sizeof(ASTExprStmt));
+                    ASTExprStmt *stmt = (ASTExprStmt *)ast_alloc(sizeof(ASTExprStmt));
                     stmt->expr = expr;
                     node->data = stmt;
                     return node;
@@ -2066,7 +2027,7 @@ static ASTNode *parse_statement(Parser *p) {
         
         // 如果不是赋值，则作为表达式语句
         ASTNode *node = ast_node_create(AST_EXPR_STMT, target->loc);
-        ASTExprStmt *stmt = (ASTExprStmt *)malloc(sizeof(ASTExprStmt));
+        ASTExprStmt *stmt = (ASTExprStmt *)ast_alloc(sizeof(ASTExprStmt));
         stmt->expr = target;
         node->data = stmt;
         return node;
@@ -2146,7 +2107,7 @@ static ASTNode *parse_statement(Parser *p) {
             
             // 如果不是赋值，则作为表达式语句
             ASTNode *node = ast_node_create(AST_EXPR_STMT, target->loc);
-            ASTExprStmt *stmt = (ASTExprStmt *)malloc(sizeof(ASTExprStmt));
+            ASTExprStmt *stmt = (ASTExprStmt *)ast_alloc(sizeof(ASTExprStmt));
             stmt->expr = target;
             node->data = stmt;
             return node;
@@ -2163,7 +2124,7 @@ static ASTNode *parse_statement(Parser *p) {
             }
             
             ASTNode *node = ast_node_create(AST_EXPR_STMT, expr->loc);
-            ASTExprStmt *stmt = (ASTExprStmt *)malloc(sizeof(ASTExprStmt));
+            ASTExprStmt *stmt = (ASTExprStmt *)ast_alloc(sizeof(ASTExprStmt));
             stmt->expr = expr;
             node->data = stmt;
             return node;
@@ -2175,7 +2136,7 @@ static ASTNode *parse_statement(Parser *p) {
     ASTNode *expr = parse_expression(p);
     if (expr) {
         ASTNode *node = ast_node_create(AST_EXPR_STMT, expr->loc);
-        ASTExprStmt *stmt = (ASTExprStmt *)malloc(sizeof(ASTExprStmt));
+        ASTExprStmt *stmt = (ASTExprStmt *)ast_alloc(sizeof(ASTExprStmt));
         stmt->expr = expr;
         node->data = stmt;
         return node;
@@ -2197,7 +2158,7 @@ ASTNode *parser_parse(Parser *p) {
     while (!check(p, TK_EOF)) {
         if (stmt_count >= stmt_capacity) {
             stmt_capacity = stmt_capacity == 0 ? 16 : stmt_capacity * 2;
-            statements = (ASTNode **)realloc(statements, stmt_capacity * sizeof(ASTNode *));
+            statements = (ASTNode **)ast_realloc(statements, stmt_count * sizeof(ASTNode *), stmt_capacity * sizeof(ASTNode *));
         }
         
         size_t old_pos = p->current;
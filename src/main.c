@@ -1,5 +1,8 @@
 #include "flyuxc/utils/cli.h"
 #include "flyuxc/utils/io.h"
+#include "flyuxc/utils/time_report.h"
+#include "flyuxc/utils/compile_cache.h"
+#include "flyuxc/utils/compile_server.h"
 #include "flyuxc/frontend/normalize.h"
 #include "flyuxc/frontend/varmap.h"
 #include "flyuxc/frontend/lexer.h"
@@ -7,10 +10,16 @@
 #include "flyuxc/backend/codegen.h"
 #include "flyuxc/llvm_compiler.h"
 #include "flyuxc/version.h"
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/time.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <mach-o/dyld.h>
+#endif
 
 /* ANSI 颜色代码 */
 #define COLOR_BLUE    "\033[38;5;27m"
@@ -27,307 +36,720 @@ static double get_time_ms(void) {
     return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
 }
 
-int main(int argc, char *argv[])
-{
-    // 尽早输出,用于测量启动时间
-    double t_init_start = get_time_ms();
+/* run 模式下 stdout 只留给被运行的程序，编译进度不输出 */
+static bool g_quiet = false;
+
+static void progress_printf(const char *fmt, ...) {
+    if (g_quiet) return;
+    va_list args;
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+}
+
+/* 结束编译：输出 --time-report 报告并返回退出码 */
+static int finish_compile(int status) {
+    time_report_write(status);
+    return status;
+}
+
+/* 打开编译缓存：--cache-dir 优先于 FLYUXC_CACHE_DIR，都未设置时不使用缓存 */
+static bool open_compile_cache(const CliOptions *options, CompileCache *cache) {
+    if (options->no_cache) return false;
+
+    const char *dir = options->cache_dir ? options->cache_dir : getenv("FLYUXC_CACHE_DIR");
+    if (!dir || !*dir) return false;
+
+    unsigned long long size_mb = options->cache_size_mb;
+    const char *env_size = getenv("FLYUXC_CACHE_SIZE");
+    if (size_mb == 0 && env_size) size_mb = strtoull(env_size, NULL, 10);
+    if (size_mb == 0) size_mb = COMPILE_CACHE_DEFAULT_MAX_MB;
+
+    if (!compile_cache_open(cache, dir, size_mb * 1024 * 1024)) {
+        fprintf(stderr, "%sWarning:%s Cannot use compile cache directory %s\n",
+                COLOR_YELLOW, COLOR_RESET, dir);
+        return false;
+    }
+    return true;
+}
+
+/* 编译器自身的标识（版本 + 可执行文件大小与修改时间），重新构建编译器后旧条目自然失效 */
+static void cache_key_add_compiler(CacheKeyBuilder *key, const char *argv0) {
+    cache_key_add_string(key, FLYUXC_VERSION);
+
+    char self_path[4096];
+    const char *path = argv0;
+#if defined(__APPLE__)
+    uint32_t self_size = sizeof(self_path);
+    if (_NSGetExecutablePath(self_path, &self_size) == 0) path = self_path;
+#else
+    ssize_t n = readlink("/proc/self/exe", self_path, sizeof(self_path) - 1);
+    if (n > 0) {
+        self_path[n] = '\0';
+        path = self_path;
+    }
+#endif
+    struct stat st;
+    if (stat(path, &st) == 0) {
+        cache_key_add_int(key, (long long)st.st_size);
+        cache_key_add_int(key, (long long)st.st_mtime);
+    }
+    cache_key_add_string(key, llvm_target_description());
+}
+
+/* PGO 选项：插桩的输出路径会写进程序，profile 内容决定优化结果
+ * （--profile-use 的文件已由 llvm_set_profile 读取过，这里不会读不到） */
+static void cache_key_add_profile(CacheKeyBuilder *key, const CliOptions *options) {
+    cache_key_add_string(key, options->profile_generate ? options->profile_generate : "");
+    cache_key_add_string(key, options->profile_use ? "profile-use" : "");
+    if (options->profile_use) cache_key_add_file(key, options->profile_use);
+}
+
+/* 经由缓存生成可执行文件：命中优化后的对象文件时只做链接 */
+static int compile_with_cache(const CompileCache *cache, const CliOptions *options, const char *argv0,
+                              const char *ir_code, size_t ir_size,
+                              const char *executable_name, int opt_level) {
+    size_t runtime_len;
+    int runtime_in_object;
+    const unsigned char *runtime = llvm_embedded_runtime(&runtime_len, &runtime_in_object);
+
+    CacheKeyBuilder builder;
+    char obj_key[COMPILE_CACHE_KEY_HEX_LEN + 1];
+    cache_key_begin(&builder, "flyuxc-object");
+    cache_key_add_compiler(&builder, argv0);
+    cache_key_add_int(&builder, opt_level);
+    cache_key_add_profile(&builder, options);
+    // bitcode 构建下运行时被编进对象文件，属于对象的输入
+    if (runtime_in_object) cache_key_add(&builder, runtime, runtime_len);
+    cache_key_add(&builder, ir_code, ir_size);
+    cache_key_finish(&builder, obj_key);
+
+    char obj_path[1200];
+    if (compile_cache_lookup(cache, CACHE_ENTRY_OBJECT, obj_key, obj_path, sizeof(obj_path))) {
+        time_report_count("cache_object_hit", 1);
+        return llvm_link_executable(obj_path, NULL, executable_name, opt_level);
+    }
+    time_report_count("cache_object_hit", 0);
+
+    char *temp_obj = create_temp_file("main_", ".o");
+    if (!temp_obj) {
+        fprintf(stderr, "%sError:%s Failed to create temporary object file\n", COLOR_RED, COLOR_RESET);
+        return 3;
+    }
+    int result = llvm_compile_string_to_object(ir_code, NULL, temp_obj, opt_level);
+    if (result == 0) {
+        compile_cache_store(cache, CACHE_ENTRY_OBJECT, obj_key, temp_obj);
+        result = llvm_link_executable(temp_obj, NULL, executable_name, opt_level);
+    }
+    unlink(temp_obj);
+    free(temp_obj);
+    return result;
+}
+
+/* 编译前的准备：LLVM 初始化、代码生成线程数和 PGO 配置 */
+static int setup_compiler(CliOptions *options) {
+    if (options->time_report) {
+        time_report_enable(options->time_report_file);
+    }
     
-    CliOptions options = parse_arguments(argc, argv);
+    // 提前初始化 LLVM 以减少首次编译时的延迟
+    int tr_init = time_report_begin("llvm_init");
+    llvm_initialize();
+    time_report_end(tr_init);
 
-    /* 打印编译器信息 */
-    if (argc == 1 || options.help)
-    {
-        printf("%s%s %s%s%s\n", COLOR_BLUE, FLYUXC_COMPILER_NAME, COLOR_CYAN, FLYUXC_VERSION, COLOR_RESET);
-        printf("%sTarget: %s%s\n", COLOR_CYAN, COLOR_RESET, FLYUXC_TARGET);
-        printf("%sThread model: %s%s\n", COLOR_CYAN, COLOR_RESET, FLYUXC_THREAD_MODEL);
-        printf("-----------------------------------\n");
-        print_help();
-        return options.help ? 0 : 1;
+    llvm_set_codegen_threads(options->jobs);
+
+    if (options->profile_generate && options->profile_use) {
+        fprintf(stderr, "%sError:%s --profile-generate and --profile-use cannot be used together\n",
+                COLOR_RED, COLOR_RESET);
+        return finish_compile(1);
+    }
+    if (options->profile_generate && options->run) {
+        fprintf(stderr, "%sWarning:%s --profile-generate is ignored by run\n", COLOR_YELLOW, COLOR_RESET);
+        options->profile_generate = NULL;
+    }
+    if ((options->profile_generate || options->profile_use) &&
+        llvm_set_profile(options->profile_generate, options->profile_use) != 0) {
+        fprintf(stderr, "%sError:%s %s\n", COLOR_RED, COLOR_RESET, llvm_get_last_error());
+        return finish_compile(1);
     }
 
-    if (options.version)
-    {
-        print_version();
-        return 0;
+    return 0;
+}
+
+/* 编译一个源文件并生成可执行文件（run 模式下直接运行），返回退出码 */
+/* 输入文件对应的可执行文件名：去掉目录和扩展名，输出在当前目录下 */
+static void executable_name_for(const char *input, char *out, size_t size) {
+    const char *slash = strrchr(input, '/');
+    const char *base_name = slash ? slash + 1 : input;
+    const char *dot = strrchr(base_name, '.');
+    
+    size_t name_len = (dot && dot > base_name) ? (size_t)(dot - base_name) : strlen(base_name);
+    if (name_len >= size) name_len = size - 1;
+    memcpy(out, base_name, name_len);
+    out[name_len] = '\0';
+}
+
+static int compile_file(const CliOptions *options, const char *input, const char *argv0) {
+    if (options->run) g_quiet = true;
+    int run_exit_code = 0;
+    
+    double t_start = get_time_ms();
+    
+    // 确定可执行文件名
+    char executable_name[256];
+    executable_name_for(input, executable_name, sizeof(executable_name));
+    
+    int opt_level = options->opt_level | (options->lto ? FLYUXC_OPT_LTO : 0);
+    CompileCache cache;
+    bool use_cache = open_compile_cache(options, &cache);
+    
+    progress_printf("%s%s %s%s%s\n", COLOR_BLUE, FLYUXC_COMPILER_NAME, COLOR_CYAN, FLYUXC_VERSION, COLOR_RESET);
+    progress_printf("%sTarget: %s%s\n", COLOR_CYAN, COLOR_RESET, FLYUXC_TARGET);
+    progress_printf("%sThread model: %s%s\n", COLOR_CYAN, COLOR_RESET, FLYUXC_THREAD_MODEL);
+    progress_printf("-----------------------------------\n");
+    progress_printf("%s⚡ Compiling %s%s\n\n", COLOR_GREEN, input, COLOR_RESET);
+    
+    /* 读取源文件 */
+    double t1 = get_time_ms();
+    int tr_read = time_report_begin("read");
+    char* source_code = read_file_to_string(input);
+    if (!source_code) {
+        fprintf(stderr, "%sError:%s Failed to read file: %s\n", COLOR_RED, COLOR_RESET, input);
+        return finish_compile(1);
     }
+    time_report_end(tr_read);
+    time_report_count("source_bytes", strlen(source_code));
     
+    /* 保存原始源代码副本用于错误报告 */
+    char* original_source = strdup(source_code);
+    
+    double t2 = get_time_ms();
+    progress_printf("%sSource loaded: %.2fms%s\n", COLOR_YELLOW, t2 - t1, COLOR_RESET);
 
-    if (options.input) {
-        // 提前初始化 LLVM 以减少首次编译时的延迟
-        llvm_initialize();
-        
-        double t_start = get_time_ms();
-        
-        printf("%s%s %s%s%s\n", COLOR_BLUE, FLYUXC_COMPILER_NAME, COLOR_CYAN, FLYUXC_VERSION, COLOR_RESET);
-        printf("%sTarget: %s%s\n", COLOR_CYAN, COLOR_RESET, FLYUXC_TARGET);
-        printf("%sThread model: %s%s\n", COLOR_CYAN, COLOR_RESET, FLYUXC_THREAD_MODEL);
-        printf("-----------------------------------\n");
-        printf("%s⚡ Compiling %s%s\n\n", COLOR_GREEN, options.input, COLOR_RESET);
+    /* 缓存：源码、编译器、优化级别和运行时都相同时直接取出上次的可执行文件 */
+    char exe_key[COMPILE_CACHE_KEY_HEX_LEN + 1] = "";
+    if (use_cache) {
+        int tr_cache = time_report_begin("cache_lookup");
+        size_t runtime_len;
+        int runtime_in_object;
+        const unsigned char *runtime = llvm_embedded_runtime(&runtime_len, &runtime_in_object);
+        CacheKeyBuilder builder;
+        cache_key_begin(&builder, "flyuxc-executable");
+        cache_key_add_compiler(&builder, argv0);
+        cache_key_add_int(&builder, opt_level);
+        cache_key_add_profile(&builder, options);
+        cache_key_add(&builder, runtime, runtime_len);
+        cache_key_add(&builder, source_code, strlen(source_code));
+        cache_key_finish(&builder, exe_key);
         
-        /* 读取源文件 */
-        double t1 = get_time_ms();
-        char* source_code = read_file_to_string(options.input);
-        if (!source_code) {
-            fprintf(stderr, "%sError:%s Failed to read file: %s\n", COLOR_RED, COLOR_RESET, options.input);
-            return 1;
+        // -IR 需要生成 .ll，run 模式不产生可执行文件，都不能跳过前端
+        bool hit = !options->emit_ir && !options->run &&
+                   compile_cache_fetch(&cache, CACHE_ENTRY_EXECUTABLE, exe_key, executable_name);
+        time_report_end(tr_cache);
+        time_report_count("cache_executable_hit", hit ? 1 : 0);
+        if (hit) {
+            progress_printf("%sCache hit: %s%s\n", COLOR_YELLOW, executable_name, COLOR_RESET);
+            progress_printf("\n%s✨ Compilation successful! (%.2fms)%s\n",
+                            COLOR_GREEN, get_time_ms() - t_start, COLOR_RESET);
+            free(source_code);
+            free(original_source);
+            return finish_compile(0);
         }
-        
-        /* 保存原始源代码副本用于错误报告 */
-        char* original_source = strdup(source_code);
-        
-        double t2 = get_time_ms();
-        printf("%sSource loaded: %.2fms%s\n", COLOR_YELLOW, t2 - t1, COLOR_RESET);
+    }
 
-        /* Step 1: 规范化代码 */
-        double t3 = get_time_ms();
-        
-        // DEBUG: 输出原始代码
-        if (getenv("DEBUG_NORM")) {
-            fprintf(stderr, "=== SOURCE CODE ===\n%s\n=== END SOURCE ===\n", source_code);
-        }
-        
-        NormalizeResult norm_result = flyux_normalize(source_code);
-        free(source_code);
-
-        if (norm_result.error_code != 0) {
-            // 如果 error_msg 非空才打印（空字符串表示错误已通过全局接口输出）
-            if (norm_result.error_msg && norm_result.error_msg[0] != '\0') {
-                fprintf(stderr, "%sNormalization error:%s %s\n", COLOR_RED, COLOR_RESET, 
-                        norm_result.error_msg);
-            }
-            normalize_result_free(&norm_result);
-            return 1;
-        }
+    /* Step 1: 规范化代码 */
+    double t3 = get_time_ms();
+    
+    // DEBUG: 输出原始代码
+    if (getenv("DEBUG_NORM")) {
+        fprintf(stderr, "=== SOURCE CODE ===\n%s\n=== END SOURCE ===\n", source_code);
+    }
+    
+    int tr_normalize = time_report_begin("normalize");
+    NormalizeResult norm_result = flyux_normalize(source_code);
+    free(source_code);
+    time_report_end(tr_normalize);
 
-        // DEBUG: 输出normalize结果
-        if (getenv("DEBUG_NORM")) {
-            fprintf(stderr, "=== NORMALIZED CODE ===\n%s\n=== END ===\n", norm_result.normalized);
+    if (norm_result.error_code != 0) {
+        // 如果 error_msg 非空才打印（空字符串表示错误已通过全局接口输出）
+        if (norm_result.error_msg && norm_result.error_msg[0] != '\0') {
+            fprintf(stderr, "%sNormalization error:%s %s\n", COLOR_RED, COLOR_RESET, 
+                    norm_result.error_msg);
         }
+        normalize_result_free(&norm_result);
+        return finish_compile(1);
+    }
+    time_report_count("normalized_bytes", strlen(norm_result.normalized));
+    time_report_count("source_map_segments", norm_result.source_map.count);
 
-        /* Step 2: 变量名映射 */
-        VarMapResult vm_result = flyux_varmap_process(norm_result.normalized,
-                                                      norm_result.source_map,
-                                                      norm_result.source_map_size,
-                                                      original_source);
-        if (vm_result.error_code != 0) {
-            fprintf(stderr, "%sVarmap error:%s %s\n", COLOR_RED, COLOR_RESET,
-                    vm_result.error_msg ? vm_result.error_msg : "Unknown error");
-            normalize_result_free(&norm_result);
-            varmap_result_free(&vm_result);
-            return 1;
-        }
-        
-        if (getenv("DEBUG_VARMAP")) {
-            fprintf(stderr, "=== VARMAP RESULT ===\n%s\n=== END ===\n", vm_result.mapped_source);
-            fprintf(stderr, "=== VARMAP ENTRIES ===\n");
-            for (size_t i = 0; i < vm_result.entry_count; i++) {
-                fprintf(stderr, "  %s -> %s\n", vm_result.entries[i].original, vm_result.entries[i].mapped);
-            }
-            fprintf(stderr, "=== END ===\n");
-        }
+    // DEBUG: 输出normalize结果
+    if (getenv("DEBUG_NORM")) {
+        fprintf(stderr, "=== NORMALIZED CODE ===\n%s\n=== END ===\n", norm_result.normalized);
+    }
 
-        /* Step 3: 词法分析 */
-        LexerResult lex_result = lexer_tokenize(vm_result.mapped_source,
-                                                norm_result.source_map,
-                                                norm_result.source_map_size,
-                                                vm_result.offset_map,
-                                                vm_result.offset_map_size);
-        if (lex_result.error_code != 0) {
+    /* 本次编译的分配区：token、AST 节点和名字都从这里分配，最后一次性释放 */
+    Arena *arena = arena_create();
+    StringPool *strings = arena ? string_pool_create(arena) : NULL;
+    if (!strings) {
+        fprintf(stderr, "%sError:%s Failed to create compilation arena\n", COLOR_RED, COLOR_RESET);
+        arena_destroy(arena);
+        normalize_result_free(&norm_result);
+        return finish_compile(1);
+    }
+    ast_set_arena(arena, strings);
+
+    /* Step 2: 词法分析（同时完成变量名映射，不生成改名后的源码） */
+    int tr_lexer = time_report_begin("lexer");
+    VarMap varmap;
+    flyux_varmap_init(&varmap, norm_result.normalized,
+                      &norm_result.source_map,
+                      original_source);
+    LexerResult lex_result = lexer_tokenize(norm_result.normalized,
+                                            &norm_result.source_map,
+                                            &varmap, strings);
+    if (lex_result.error_code != 0) {
+        if (varmap.error_code != 0) {
+            fprintf(stderr, "%sVarmap error:%s %s\n", COLOR_RED, COLOR_RESET,
+                    varmap.error_msg ? varmap.error_msg : "Unknown error");
+        } else {
             fprintf(stderr, "%sLexer error:%s %s\n", COLOR_RED, COLOR_RESET,
                     lex_result.error_msg ? lex_result.error_msg : "Unknown error");
-            lexer_result_free(&lex_result);
-            normalize_result_free(&norm_result);
-            varmap_result_free(&vm_result);
-            return 1;
         }
-        double t4 = get_time_ms();
-        printf("%sLexical analysis: %.2fms%s\n", COLOR_YELLOW, t4 - t3, COLOR_RESET);
-
-        /* Step 4: 语法分析 */
-        double t5 = get_time_ms();
-        Parser *parser = parser_create(lex_result.tokens, lex_result.count, vm_result.mapped_source);
-        if (!parser) {
-            fprintf(stderr, "%sParser error:%s Failed to create parser\n", COLOR_RED, COLOR_RESET);
-            free(original_source);
-            lexer_result_free(&lex_result);
-            normalize_result_free(&norm_result);
-            varmap_result_free(&vm_result);
-            return 1;
+        lexer_result_free(&lex_result);
+        normalize_result_free(&norm_result);
+        varmap_free(&varmap);
+        arena_destroy(arena);
+        return finish_compile(1);
+    }
+    time_report_end(tr_lexer);
+    time_report_count("tokens", lex_result.count);
+    time_report_count("varmap_entries", varmap.entry_count);
+    
+    if (getenv("DEBUG_VARMAP")) {
+        fprintf(stderr, "=== VARMAP ENTRIES ===\n");
+        for (size_t i = 0; i < varmap.entry_count; i++) {
+            fprintf(stderr, "  %s -> %s\n", varmap.entries[i].original, varmap.entries[i].mapped);
         }
-        
-        /* 设置原始源代码用于错误报告 */
-        parser_set_original_source(parser, original_source);
+        fprintf(stderr, "=== END ===\n");
+    }
+    double t4 = get_time_ms();
+    progress_printf("%sLexical analysis: %.2fms%s\n", COLOR_YELLOW, t4 - t3, COLOR_RESET);
+
+    /* Step 3: 语法分析 */
+    double t5 = get_time_ms();
+    int tr_parser = time_report_begin("parser");
+    Parser *parser = parser_create(lex_result.tokens, lex_result.count, norm_result.normalized);
+    if (!parser) {
+        fprintf(stderr, "%sParser error:%s Failed to create parser\n", COLOR_RED, COLOR_RESET);
+        free(original_source);
+        lexer_result_free(&lex_result);
+        normalize_result_free(&norm_result);
+        varmap_free(&varmap);
+        arena_destroy(arena);
+        return finish_compile(1);
+    }
+    
+    /* 设置原始源代码用于错误报告 */
+    parser_set_original_source(parser, original_source);
+
+    ASTNode *ast = parser_parse(parser);
+    bool has_errors = (parser->error_count > 0);
+    bool has_warnings = (parser->warning_count > 0);
+    
+    if (has_warnings) {
+        fprintf(stderr, "\n%s⚠️  %d warning(s)%s\n", COLOR_YELLOW, parser->warning_count, COLOR_RESET);
+    }
+    
+    if (has_errors) {
+        fprintf(stderr, "\n%sParsing failed with %d error(s)%s\n", COLOR_RED, parser->error_count, COLOR_RESET);
+        parser_free(parser);
+        free(original_source);
+        lexer_result_free(&lex_result);
+        normalize_result_free(&norm_result);
+        varmap_free(&varmap);
+        arena_destroy(arena);
+        return finish_compile(1);
+    }
+    time_report_end(tr_parser);
+    time_report_count("ast_nodes", ast_node_count());
+    time_report_count("arena_allocations", arena_alloc_count(arena));
+    time_report_count("arena_bytes_used", arena_total_used(arena));
+    time_report_count("arena_bytes_reserved", arena_total_allocated(arena));
+    time_report_count("interned_strings", string_pool_count(strings));
+    time_report_count("interned_bytes", string_pool_total_length(strings));
+    double t6 = get_time_ms();
+    progress_printf("%sParsing: %.2fms%s\n", COLOR_YELLOW, t6 - t5, COLOR_RESET);
 
-        ASTNode *ast = parser_parse(parser);
-        bool has_errors = (parser->error_count > 0);
-        bool has_warnings = (parser->warning_count > 0);
+    /* Step 4: 代码生成 */
+    if (!has_errors && ast) {
+        double t7 = get_time_ms();
+        int tr_codegen = time_report_begin("codegen");
         
-        if (has_warnings) {
-            fprintf(stderr, "\n%s⚠️  %d warning(s)%s\n", COLOR_YELLOW, parser->warning_count, COLOR_RESET);
-        }
+        CodeGen *codegen = NULL;
+        char *ir_buffer = NULL;
+        size_t ir_size = 0;
         
-        if (has_errors) {
-            fprintf(stderr, "\n%sParsing failed with %d error(s)%s\n", COLOR_RED, parser->error_count, COLOR_RESET);
-            if (ast) ast_node_free(ast);
-            parser_free(parser);
-            free(original_source);
-            lexer_result_free(&lex_result);
-            normalize_result_free(&norm_result);
-            varmap_result_free(&vm_result);
-            return 1;
+        // IR 始终生成到内存流中，只有 -IR 时才写出 .ll 文件
+        FILE *output = open_memstream(&ir_buffer, &ir_size);
+        if (!output) {
+            fprintf(stderr, "%sError:%s Failed to create memory stream for IR generation\n",
+                    COLOR_RED, COLOR_RESET);
+            has_errors = true;
         }
-        double t6 = get_time_ms();
-        printf("%sParsing: %.2fms%s\n", COLOR_YELLOW, t6 - t5, COLOR_RESET);
-
-        /* Step 5: 代码生成 */
-        if (!has_errors && ast) {
-            double t7 = get_time_ms();
-            
-            // 确定基础文件名和可执行文件名
-            const char *input_name = options.input;
-            const char *dot = strrchr(input_name, '.');
-            const char *slash = strrchr(input_name, '/');
-            const char *base_name = slash ? slash + 1 : input_name;
+        
+        if (!has_errors && output) {
+            codegen = codegen_create(output);
+            if (!codegen) {
+                fprintf(stderr, "%sError:%s Failed to create code generator\n", COLOR_RED, COLOR_RESET);
+                has_errors = true;
+            } else {
+                // 设置变量映射表用于错误消息
+                codegen_set_varmap(codegen, varmap.entries, varmap.entry_count);
+                // 设置原始源代码用于错误消息
+                codegen_set_original_source(codegen, original_source);
+                // -IR 写出的 .ll 需要自包含：统一调用入口输出完整文本定义
+                codegen_set_text_entries(codegen, options->emit_ir);
+                
+                codegen_generate(codegen, ast);
+                
+                // 检查 codegen 是否有错误（错误已经在 codegen 内部输出）
+                if (codegen_has_error(codegen)) {
+                    has_errors = true;
+                }
+                
+                codegen_free(codegen);
+            }
             
-            char executable_name[256];
-            if (dot && dot > base_name) {
-                size_t name_len = dot - base_name;
-                strncpy(executable_name, base_name, name_len);
-                executable_name[name_len] = '\0';
+            fclose(output);
+        }
+        time_report_end(tr_codegen);
+        time_report_count("ir_bytes", ir_size);
+        
+        char ir_file[sizeof(executable_name) + 3];
+        snprintf(ir_file, sizeof(ir_file), "%s.ll", executable_name);
+        
+        // -IR: 写出文本 IR 供查看
+        if (!has_errors && options->emit_ir && ir_buffer) {
+            FILE *ir_out = fopen(ir_file, "w");
+            if (!ir_out) {
+                fprintf(stderr, "%sError:%s Failed to open output file: %s\n", 
+                        COLOR_RED, COLOR_RESET, ir_file);
+                has_errors = true;
             } else {
-                strcpy(executable_name, base_name);
+                fwrite(ir_buffer, 1, ir_size, ir_out);
+                fclose(ir_out);
             }
+        }
+        double t8 = get_time_ms();
+        progress_printf("%sIR generation: %.2fms%s\n", COLOR_YELLOW, t8 - t7, COLOR_RESET);
+        
+        /* Step 5: LLVM 编译 */
+        if (!has_errors && ir_buffer) {
+            double t9 = get_time_ms();
             
-            CodeGen *codegen = NULL;
-            FILE *output = NULL;
-            char *ir_buffer = NULL;
-            size_t ir_size = 0;
+            // 如果有DEBUG_NORM，输出IR以便调试
+            if (getenv("DEBUG_NORM")) {
+                fprintf(stderr, "\n=== GENERATED IR (first 5000 chars) ===\n");
+                fprintf(stderr, "%.5000s\n", ir_buffer);
+                fprintf(stderr, "=== END IR ===\n\n");
+            }
             
-            // 根据是否需要输出 IR 文件选择不同的生成方式
-            if (options.emit_ir) {
-                // 生成 .ll 文件
-                char output_file[256];
-                snprintf(output_file, sizeof(output_file), "%s.ll", executable_name);
-                
-                output = fopen(output_file, "w");
-                if (!output) {
-                    fprintf(stderr, "%sError:%s Failed to open output file: %s\n", 
-                            COLOR_RED, COLOR_RESET, output_file);
-                    has_errors = true;
+            int compile_result;
+            int tr_llvm = time_report_begin("llvm");
+            if (options->run) {
+                // run：JIT 编译后直接在本进程中执行 main
+                compile_result = llvm_run_string_jit(ir_buffer, opt_level, options->lazy, &run_exit_code);
+            } else if (options->emit_ir && getenv("DEBUG_IR_FILE")) {
+                // 调试回退：走旧的 .ll 文件 → parseIRFile 路径
+                compile_result = llvm_compile_to_executable(ir_file, NULL, executable_name, opt_level);
+            } else if (use_cache) {
+                // 经由缓存编译，成功后存入可执行文件条目
+                compile_result = compile_with_cache(&cache, options, argv0, ir_buffer, ir_size,
+                                                    executable_name, opt_level);
+                if (compile_result == 0) {
+                    compile_cache_store(&cache, CACHE_ENTRY_EXECUTABLE, exe_key, executable_name);
                 }
             } else {
-                // 使用内存流
-                output = open_memstream(&ir_buffer, &ir_size);
-                if (!output) {
-                    fprintf(stderr, "%sError:%s Failed to create memory stream for IR generation\n",
-                            COLOR_RED, COLOR_RESET);
-                    has_errors = true;
-                }
+                // 默认：直接在内存中解析 IR 并编译
+                compile_result = llvm_compile_string_to_executable(ir_buffer, NULL, executable_name, opt_level);
             }
+            time_report_end(tr_llvm);
             
-            if (!has_errors && output) {
-                codegen = codegen_create(output);
-                if (!codegen) {
-                    fprintf(stderr, "%sError:%s Failed to create code generator\n", COLOR_RED, COLOR_RESET);
-                    has_errors = true;
-                } else {
-                    // 设置变量映射表用于错误消息
-                    codegen_set_varmap(codegen, vm_result.entries, vm_result.entry_count);
-                    // 设置原始源代码用于错误消息
-                    codegen_set_original_source(codegen, original_source);
-                    
-                    codegen_generate(codegen, ast);
-                    
-                    // 检查 codegen 是否有错误（错误已经在 codegen 内部输出）
-                    if (codegen_has_error(codegen)) {
-                        has_errors = true;
-                    }
-                    
-                    codegen_free(codegen);
+            if (compile_result != 0) {
+                fprintf(stderr, "%sLLVM compilation failed:%s %s\n", 
+                        COLOR_RED, COLOR_RESET, llvm_get_last_error());
+                
+                // 验证失败时输出更多IR以便调试
+                if (getenv("DEBUG_NORM")) {
+                    fprintf(stderr, "\n=== FULL IR ===\n");
+                    fprintf(stderr, "%s\n", ir_buffer);
+                    fprintf(stderr, "=== END FULL IR ===\n");
                 }
                 
-                fclose(output);
+                has_errors = true;
             }
-            double t8 = get_time_ms();
-            printf("%sIR generation: %.2fms%s\n", COLOR_YELLOW, t8 - t7, COLOR_RESET);
             
-            /* Step 6: LLVM 编译 */
+            double t10 = get_time_ms();
+            progress_printf("%sBinary emission: %.2fms%s\n", COLOR_YELLOW, t10 - t9, COLOR_RESET);
+            
             if (!has_errors) {
-                double t9 = get_time_ms();
-                
-                int opt_level = 1;
-                
-                if (options.emit_ir) {
-                    // 从 .ll 文件编译
-                    char output_file[256];
-                    snprintf(output_file, sizeof(output_file), "%s.ll", executable_name);
-                    
-                    if (llvm_compile_to_executable(output_file, NULL, executable_name, opt_level) != 0) {
-                        fprintf(stderr, "%sLLVM compilation failed:%s %s\n", 
-                                COLOR_RED, COLOR_RESET, llvm_get_last_error());
-                        has_errors = true;
-                    }
-                } else {
-                    // 从内存中的 IR 字符串编译
-                    if (ir_buffer) {
-                        // 如果有DEBUG_NORM，输出IR以便调试
-                        if (getenv("DEBUG_NORM")) {
-                            fprintf(stderr, "\n=== GENERATED IR (first 5000 chars) ===\n");
-                            fprintf(stderr, "%.5000s\n", ir_buffer);
-                            fprintf(stderr, "=== END IR ===\n\n");
-                        }
-                        
-                        if (llvm_compile_string_to_executable(ir_buffer, NULL, executable_name, opt_level) != 0) {
-                            fprintf(stderr, "%sLLVM compilation failed:%s %s\n", 
-                                    COLOR_RED, COLOR_RESET, llvm_get_last_error());
-                            
-                            // 验证失败时输出更多IR以便调试
-                            if (getenv("DEBUG_NORM")) {
-                                fprintf(stderr, "\n=== FULL IR ===\n");
-                                fprintf(stderr, "%s\n", ir_buffer);
-                                fprintf(stderr, "=== END FULL IR ===\n");
-                            }
-                            
-                            has_errors = true;
-                        }
-                        free(ir_buffer);
-                    }
-                }
-                
-                double t10 = get_time_ms();
-                printf("%sBinary emission: %.2fms%s\n", COLOR_YELLOW, t10 - t9, COLOR_RESET);
-                
-                if (!has_errors) {
-                    double t_end = get_time_ms();
-                    printf("\n%s✨ Compilation successful! (%.2fms)%s\n", 
-                           COLOR_GREEN, t_end - t_start, COLOR_RESET);
-                    if (options.emit_ir) {
-                        printf("%sLLIR: %s%s.ll\n", COLOR_CYAN, COLOR_RESET, executable_name);
-                    }
+                double t_end = get_time_ms();
+                progress_printf("\n%s✨ Compilation successful! (%.2fms)%s\n", 
+                                COLOR_GREEN, t_end - t_start, COLOR_RESET);
+                if (options->emit_ir) {
+                    progress_printf("%sLLIR: %s%s.ll\n", COLOR_CYAN, COLOR_RESET, executable_name);
                 }
             }
         }
-        
-        if (has_errors) {
-            fprintf(stderr, "\n%s✗ Compilation failed%s\n", COLOR_RED, COLOR_RESET);
+        free(ir_buffer);
+    }
+    
+    if (has_errors) {
+        fprintf(stderr, "\n%s✗ Compilation failed%s\n", COLOR_RED, COLOR_RESET);
+    }
+
+    /* 清理：token、AST 和名字都随分配区一起释放 */
+    parser_free(parser);
+    arena_destroy(arena);
+
+    /* 释放资源 */
+    free(original_source);
+    lexer_result_free(&lex_result);
+    normalize_result_free(&norm_result);
+    varmap_free(&varmap);
+
+    if (has_errors) {
+        return finish_compile(1);
+    }
+    finish_compile(0);
+    return options->run ? run_exit_code : 0;
+}
+
+/* 把工作进程的输出转给 out */
+static void copy_log(const char *path, FILE *out) {
+    FILE *log = fopen(path, "rb");
+    if (!log) return;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), log)) > 0) {
+        fwrite(buf, 1, n, out);
+    }
+    fclose(log);
+}
+
+static int cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+typedef struct {
+    const CliOptions *options;
+    const char *argv0;
+} BatchContext;
+
+/* 批量编译的工作进程：只输出警告和错误，进度由父进程汇总 */
+static int batch_job(const char *input, void *ctx) {
+    const BatchContext *batch = ctx;
+    g_quiet = true;
+    return compile_file(batch->options, input, batch->argv0);
+}
+
+static void batch_done(const BatchResult *result, void *ctx) {
+    (void)ctx;
+    if (result->status == 0) {
+        printf("%s✓%s %s %s(%.2fms)%s\n", COLOR_GREEN, COLOR_RESET, result->input,
+               COLOR_YELLOW, result->ms, COLOR_RESET);
+        if (result->log_path) copy_log(result->log_path, stdout);
+        fflush(stdout);
+    } else {
+        fflush(stdout);
+        if (result->log_path) {
+            fprintf(stderr, "%s✗%s %s (exit %d)\n", COLOR_RED, COLOR_RESET, result->input, result->status);
+            copy_log(result->log_path, stderr);
+        } else {
+            fprintf(stderr, "%s✗%s %s: cannot start a worker process\n", COLOR_RED, COLOR_RESET, result->input);
         }
+    }
+}
+
+typedef struct {
+    char name[256];
+    const char *input;
+} BatchOutput;
 
-        /* 清理AST */
-        if (ast) {
-            ast_node_free(ast);
+static int compare_batch_output(const void *a, const void *b) {
+    return strcmp(((const BatchOutput *)a)->name, ((const BatchOutput *)b)->name);
+}
+
+/* 可执行文件都写在当前目录下：不同目录中的同名输入（a/x.fx b/x.fx）会让并行的工作进程
+ * 写同一个输出文件，在派生工作进程之前拒绝 */
+static bool check_batch_outputs(const CliOptions *options) {
+    BatchOutput *outputs = malloc(sizeof(BatchOutput) * options->input_count);
+    if (!outputs) {
+        fprintf(stderr, "%sError:%s Out of memory\n", COLOR_RED, COLOR_RESET);
+        return false;
+    }
+    
+    for (int i = 0; i < options->input_count; i++) {
+        executable_name_for(options->inputs[i], outputs[i].name, sizeof(outputs[i].name));
+        outputs[i].input = options->inputs[i];
+    }
+    qsort(outputs, options->input_count, sizeof(BatchOutput), compare_batch_output);
+    
+    bool ok = true;
+    for (int i = 1; i < options->input_count; i++) {
+        if (strcmp(outputs[i - 1].name, outputs[i].name) == 0) {
+            fprintf(stderr, "%sError:%s %s and %s would both be written to ./%s\n",
+                    COLOR_RED, COLOR_RESET, outputs[i - 1].input, outputs[i].input, outputs[i].name);
+            ok = false;
         }
-        parser_free(parser);
+    }
+    free(outputs);
+    return ok;
+}
 
-        /* 释放资源 */
-        free(original_source);
-        lexer_result_free(&lex_result);
-        normalize_result_free(&norm_result);
-        varmap_result_free(&vm_result);
+/* 批量编译：预热后每个文件在独立的工作进程中编译，-j 为同时运行的工作进程数 */
+static int compile_batch(const CliOptions *options, const char *argv0) {
+    if (options->run || options->time_report_file) {
+        fprintf(stderr, "%sError:%s run and --time-report=json:<file> take a single input file\n",
+                COLOR_RED, COLOR_RESET);
+        return 1;
+    }
+    if (!check_batch_outputs(options)) {
+        return 1;
+    }
+    
+    int workers = options->jobs > 0 ? options->jobs : cpu_count();
+    if (workers > options->input_count) workers = options->input_count;
+    // 并行来自工作进程，单个文件的代码生成不再分区
+    llvm_set_codegen_threads(1);
+    llvm_warm_up();
+    
+    printf("%s%s %s%s%s\n", COLOR_BLUE, FLYUXC_COMPILER_NAME, COLOR_CYAN, FLYUXC_VERSION, COLOR_RESET);
+    printf("%sTarget: %s%s\n", COLOR_CYAN, COLOR_RESET, FLYUXC_TARGET);
+    printf("%sThread model: %s%s\n", COLOR_CYAN, COLOR_RESET, FLYUXC_THREAD_MODEL);
+    printf("-----------------------------------\n");
+    printf("%s⚡ Compiling %d files (%d workers)%s\n\n", COLOR_GREEN, options->input_count, workers, COLOR_RESET);
+    
+    double t_start = get_time_ms();
+    BatchContext batch = {options, argv0};
+    int failed = batch_run(options->inputs, options->input_count, workers, batch_job, batch_done, &batch);
+    
+    if (failed > 0) {
+        fprintf(stderr, "\n%s✗ %d of %d files failed%s\n", COLOR_RED, failed, options->input_count, COLOR_RESET);
+        return 1;
+    }
+    printf("\n%s✨ %d files compiled (%.2fms)%s\n", COLOR_GREEN, options->input_count,
+           get_time_ms() - t_start, COLOR_RESET);
+    return 0;
+}
 
-        return has_errors ? 1 : 0;
+/* 编译命令行中的输入文件：一个文件直接编译，多个文件批量编译 */
+static int compile_inputs(CliOptions *options, const char *argv0) {
+    int status = setup_compiler(options);
+    if (status != 0) return status;
+    
+    if (options->input_count > 1) {
+        return compile_batch(options, argv0);
+    }
+    return compile_file(options, options->input, argv0);
+}
+
+/* 编译服务器的工作进程：按客户端发来的命令行编译 */
+static int serve_job(int argc, char **argv, void *ctx) {
+    (void)ctx;
+    CliOptions options = parse_arguments(argc, argv);
+    if (options.input_count == 0) {
+        fprintf(stderr, "No input file specified. Use -h for help.\n");
+        return 1;
+    }
+    return compile_inputs(&options, argv[0]);
+}
+
+/* serve：预热后在 Unix 套接字上接受编译请求，-j 为同时处理的请求数 */
+static int serve(const CliOptions *options) {
+    if (!options->input) {
+        fprintf(stderr, "%sError:%s Usage: flyuxc serve [-j <N>] <socket>\n", COLOR_RED, COLOR_RESET);
+        return 1;
+    }
+    
+    int workers = options->jobs > 0 ? options->jobs : cpu_count();
+    llvm_initialize();
+    llvm_warm_up();
+    
+    return compile_server_run(options->input, workers, serve_job, NULL);
+}
+
+int main(int argc, char *argv[])
+{
+    // 尽早输出,用于测量启动时间
+    double t_init_start = get_time_ms();
+    
+    CliOptions options = parse_arguments(argc, argv);
+
+    /* 打印编译器信息 */
+    if (argc == 1 || options.help)
+    {
+        printf("%s%s %s%s%s\n", COLOR_BLUE, FLYUXC_COMPILER_NAME, COLOR_CYAN, FLYUXC_VERSION, COLOR_RESET);
+        printf("%sTarget: %s%s\n", COLOR_CYAN, COLOR_RESET, FLYUXC_TARGET);
+        printf("%sThread model: %s%s\n", COLOR_CYAN, COLOR_RESET, FLYUXC_THREAD_MODEL);
+        printf("-----------------------------------\n");
+        print_help();
+        return options.help ? 0 : 1;
+    }
+
+    if (options.version)
+    {
+        print_version();
+        return 0;
+    }
+
+    /* profile-merge：合并 --profile-generate 程序写出的原始 profile */
+    if (options.profile_merge)
+    {
+        int result = 1;
+        if (!options.output || options.input_count == 0) {
+            fprintf(stderr, "%sError:%s Usage: flyuxc profile-merge -o <out.profdata> <file...>\n",
+                    COLOR_RED, COLOR_RESET);
+        } else if (llvm_profile_merge(options.inputs, options.input_count, options.output) != 0) {
+            fprintf(stderr, "%sError:%s %s\n", COLOR_RED, COLOR_RESET, llvm_get_last_error());
+        } else {
+            result = 0;
+        }
+        return result;
+    }
+
+    /* serve：编译服务器 */
+    if (options.serve)
+    {
+        return serve(&options);
+    }
+
+    if (options.input_count == 0) {
+        /* 如果没有输入文件，则提示并退出 */
+        fprintf(stderr, "No input file specified. Use -h for help.\n");
+        return 1;
+    }
+
+    /* 配置了编译服务器时交给服务器编译，请求没有送达时在本地编译；
+     * 送达后中断的请求可能已经输出诊断或运行过程序，不再重复执行 */
+    const char *server = options.server ? options.server : getenv("FLYUXC_SERVER");
+    if (server && *server) {
+        int exit_code = 1;
+        switch (compile_server_request(server, argc, argv, &exit_code)) {
+            case SERVER_REQUEST_DONE:
+                return exit_code;
+            case SERVER_REQUEST_LOST:
+                fprintf(stderr, "%sError:%s Compile server %s closed the connection before replying\n",
+                        COLOR_RED, COLOR_RESET, server);
+                return 1;
+            case SERVER_REQUEST_UNAVAILABLE:
+                break;
+        }
+        fprintf(stderr, "%sWarning:%s Compile server %s is not available, compiling locally\n",
+                COLOR_YELLOW, COLOR_RESET, server);
     }
 
-    /* 如果没有输入文件，则提示并退出 */
-    fprintf(stderr, "No input file specified. Use -h for help.\n");
-    return 1;
+    return compile_inputs(&options, argv[0]);
 }
@@ -0,0 +1,342 @@
+#include "flyuxc/utils/compile_cache.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+/* ============================================================================
+ * 缓存键：SHA-256
+ * ============================================================================ */
+
+static const uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_compress(uint32_t state[8], const unsigned char block[64]) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) |
+               ((uint32_t)block[i * 4 + 2] << 8) | (uint32_t)block[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ROTR32(w[i - 15], 7) ^ ROTR32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROTR32(w[i - 2], 17) ^ ROTR32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t s1 = ROTR32(e, 6) ^ ROTR32(e, 11) ^ ROTR32(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t t1 = h + s1 + ch + SHA256_K[i] + w[i];
+        uint32_t s0 = ROTR32(a, 2) ^ ROTR32(a, 13) ^ ROTR32(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = s0 + maj;
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+void cache_key_begin(CacheKeyBuilder *builder, const char *domain) {
+    static const uint32_t init[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    memcpy(builder->state, init, sizeof(init));
+    builder->length = 0;
+    builder->block_used = 0;
+    // 不同用途的键带上各自的域名，互不冲突
+    cache_key_add_string(builder, domain);
+}
+
+void cache_key_add(CacheKeyBuilder *builder, const void *data, size_t len) {
+    const unsigned char *p = (const unsigned char *)data;
+    builder->length += len;
+    while (len > 0) {
+        size_t take = 64 - builder->block_used;
+        if (take > len) take = len;
+        memcpy(builder->block + builder->block_used, p, take);
+        builder->block_used += take;
+        p += take;
+        len -= take;
+        if (builder->block_used == 64) {
+            sha256_compress(builder->state, builder->block);
+            builder->block_used = 0;
+        }
+    }
+}
+
+void cache_key_add_string(CacheKeyBuilder *builder, const char *str) {
+    size_t len = str ? strlen(str) : 0;
+    cache_key_add_int(builder, (long long)len);
+    if (len) cache_key_add(builder, str, len);
+}
+
+void cache_key_add_int(CacheKeyBuilder *builder, long long value) {
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = (unsigned char)((unsigned long long)value >> (i * 8));
+    }
+    cache_key_add(builder, bytes, sizeof(bytes));
+}
+
+bool cache_key_add_file(CacheKeyBuilder *builder, const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+
+    unsigned char buf[65536];
+    size_t n;
+    long long total = 0;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        cache_key_add(builder, buf, n);
+        total += (long long)n;
+    }
+    bool ok = !ferror(f);
+    fclose(f);
+    // 以长度收尾，与 cache_key_add_string 一样避免和后续字段拼接产生歧义
+    cache_key_add_int(builder, total);
+    return ok;
+}
+
+void cache_key_finish(CacheKeyBuilder *builder, char out[COMPILE_CACHE_KEY_HEX_LEN + 1]) {
+    uint64_t bit_length = builder->length * 8;
+    unsigned char pad = 0x80;
+    cache_key_add(builder, &pad, 1);
+    pad = 0;
+    while (builder->block_used != 56) {
+        cache_key_add(builder, &pad, 1);
+    }
+    unsigned char len_bytes[8];
+    for (int i = 0; i < 8; i++) {
+        len_bytes[i] = (unsigned char)(bit_length >> (56 - i * 8));
+    }
+    cache_key_add(builder, len_bytes, sizeof(len_bytes));
+
+    static const char hex[] = "0123456789abcdef";
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 4; j++) {
+            unsigned char byte = (unsigned char)(builder->state[i] >> (24 - j * 8));
+            out[i * 8 + j * 2] = hex[byte >> 4];
+            out[i * 8 + j * 2 + 1] = hex[byte & 0x0f];
+        }
+    }
+    out[COMPILE_CACHE_KEY_HEX_LEN] = '\0';
+}
+
+/* ============================================================================
+ * 缓存目录
+ * ============================================================================ */
+
+static const char *entry_subdir(CacheEntryKind kind) {
+    return kind == CACHE_ENTRY_EXECUTABLE ? "exe" : "obj";
+}
+
+// 逐级创建目录（mkdir -p）
+static bool make_dirs(const char *path) {
+    char buf[1024];
+    size_t len = strlen(path);
+    if (len == 0 || len >= sizeof(buf)) return false;
+    memcpy(buf, path, len + 1);
+
+    for (char *p = buf + 1; *p; p++) {
+        if (*p != '/') continue;
+        *p = '\0';
+        if (mkdir(buf, 0755) != 0 && errno != EEXIST) return false;
+        *p = '/';
+    }
+    return mkdir(buf, 0755) == 0 || errno == EEXIST;
+}
+
+bool compile_cache_open(CompileCache *cache, const char *dir, unsigned long long max_bytes) {
+    if (!dir || !*dir) return false;
+    int written = snprintf(cache->dir, sizeof(cache->dir), "%s", dir);
+    if (written < 0 || (size_t)written >= sizeof(cache->dir) - 16) return false;
+    cache->max_bytes = max_bytes;
+
+    char sub[1100];
+    snprintf(sub, sizeof(sub), "%s/exe", cache->dir);
+    if (!make_dirs(sub)) return false;
+    snprintf(sub, sizeof(sub), "%s/obj", cache->dir);
+    return make_dirs(sub);
+}
+
+void compile_cache_entry_path(const CompileCache *cache, CacheEntryKind kind,
+                              const char *key, char *path, size_t path_size) {
+    snprintf(path, path_size, "%s/%s/%s%s", cache->dir, entry_subdir(kind), key,
+             kind == CACHE_ENTRY_OBJECT ? ".o" : "");
+}
+
+bool compile_cache_lookup(const CompileCache *cache, CacheEntryKind kind, const char *key,
+                          char *path, size_t path_size) {
+    compile_cache_entry_path(cache, kind, key, path, path_size);
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) return false;
+
+    // 修改时间即 LRU 时间（atime 常被 noatime 挂载选项关闭）
+    utimes(path, NULL);
+    return true;
+}
+
+// 复制文件内容并保留可执行权限
+static bool copy_file(const char *src, const char *dest, mode_t mode) {
+    int in = open(src, O_RDONLY);
+    if (in < 0) return false;
+    int out = open(dest, O_WRONLY | O_CREAT | O_TRUNC, mode);
+    if (out < 0) {
+        close(in);
+        return false;
+    }
+
+    char buf[65536];
+    bool ok = true;
+    ssize_t n;
+    while ((n = read(in, buf, sizeof(buf))) > 0) {
+        if (write(out, buf, (size_t)n) != n) {
+            ok = false;
+            break;
+        }
+    }
+    if (n < 0) ok = false;
+    close(in);
+    if (close(out) != 0) ok = false;
+    if (!ok) unlink(dest);
+    return ok;
+}
+
+bool compile_cache_fetch(const CompileCache *cache, CacheEntryKind kind, const char *key,
+                         const char *dest) {
+    char path[1200];
+    if (!compile_cache_lookup(cache, kind, key, path, sizeof(path))) return false;
+
+    // 先删除旧输出：硬链接要求目标不存在，也避免改写到别处链接着的旧文件
+    unlink(dest);
+    if (link(path, dest) == 0) return true;
+    return copy_file(path, dest, kind == CACHE_ENTRY_EXECUTABLE ? 0755 : 0644);
+}
+
+/* ============================================================================
+ * LRU 淘汰
+ * ============================================================================ */
+
+typedef struct {
+    char *path;
+    off_t size;
+    time_t mtime;
+} CacheFileInfo;
+
+typedef struct {
+    CacheFileInfo *items;
+    size_t count;
+    size_t capacity;
+    unsigned long long total;
+} CacheFileList;
+
+static void collect_entries(const char *dir, CacheFileList *list) {
+    DIR *d = opendir(dir);
+    if (!d) return;
+
+    time_t now = time(NULL);
+    struct dirent *ent;
+    while ((ent = readdir(d)) != NULL) {
+        if (ent->d_name[0] == '.') continue;
+
+        char path[1400];
+        snprintf(path, sizeof(path), "%s/%s", dir, ent->d_name);
+        struct stat st;
+        if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) continue;
+
+        // 写入中途崩溃留下的临时文件：超过一天就清掉，否则跳过
+        if (strstr(ent->d_name, ".tmp.")) {
+            if (now - st.st_mtime > 24 * 60 * 60) unlink(path);
+            continue;
+        }
+
+        if (list->count == list->capacity) {
+            size_t new_capacity = list->capacity ? list->capacity * 2 : 64;
+            CacheFileInfo *items = realloc(list->items, new_capacity * sizeof(CacheFileInfo));
+            if (!items) break;
+            list->items = items;
+            list->capacity = new_capacity;
+        }
+        CacheFileInfo *info = &list->items[list->count];
+        info->path = strdup(path);
+        if (!info->path) break;
+        info->size = st.st_size;
+        info->mtime = st.st_mtime;
+        list->count++;
+        list->total += (unsigned long long)st.st_size;
+    }
+    closedir(d);
+}
+
+static int compare_mtime(const void *a, const void *b) {
+    const CacheFileInfo *x = (const CacheFileInfo *)a;
+    const CacheFileInfo *y = (const CacheFileInfo *)b;
+    return (x->mtime > y->mtime) - (x->mtime < y->mtime);
+}
+
+static void compile_cache_evict(const CompileCache *cache) {
+    if (cache->max_bytes == 0) return;
+
+    CacheFileList list = {0};
+    char sub[1100];
+    snprintf(sub, sizeof(sub), "%s/exe", cache->dir);
+    collect_entries(sub, &list);
+    snprintf(sub, sizeof(sub), "%s/obj", cache->dir);
+    collect_entries(sub, &list);
+
+    if (list.total > cache->max_bytes) {
+        // 最久未使用的先删
+        qsort(list.items, list.count, sizeof(CacheFileInfo), compare_mtime);
+        for (size_t i = 0; i < list.count && list.total > cache->max_bytes; i++) {
+            if (unlink(list.items[i].path) == 0) {
+                list.total -= (unsigned long long)list.items[i].size;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < list.count; i++) free(list.items[i].path);
+    free(list.items);
+}
+
+bool compile_cache_store(const CompileCache *cache, CacheEntryKind kind, const char *key,
+                         const char *src) {
+    char path[1200];
+    char tmp[1300];
+    compile_cache_entry_path(cache, kind, key, path, sizeof(path));
+    static unsigned int store_count = 0;
+    snprintf(tmp, sizeof(tmp), "%s.tmp.%d.%u", path, (int)getpid(), store_count++);
+
+    unlink(tmp);
+    if (link(src, tmp) != 0 &&
+        !copy_file(src, tmp, kind == CACHE_ENTRY_EXECUTABLE ? 0755 : 0644)) {
+        return false;
+    }
+    // 刚写入的条目是最新使用的（硬链接共享 inode，也会刷新输出文件的时间）
+    utimes(tmp, NULL);
+    if (rename(tmp, path) != 0) {
+        unlink(tmp);
+        return false;
+    }
+
+    compile_cache_evict(cache);
+    return true;
+}
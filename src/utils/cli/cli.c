@@ -3,14 +3,43 @@
 #include <string.h>
 #include <stdlib.h>
 #include "flyuxc/version.h"
+#include "flyuxc/llvm_compiler.h"
 
 void print_help(void) {
-    printf("Usage: flyuxc [options] <input file>\n\n");
+    printf("Usage: flyuxc [options] <input file>\n");
+    printf("       flyuxc [options] <input file> <input file>...\n");
+    printf("                                            Batch mode: compile files concurrently (-j workers)\n");
+    printf("       flyuxc run [options] <input file>   Compile in memory (JIT) and run immediately\n");
+    printf("       flyuxc profile-merge -o <out.profdata> <file...>\n");
+    printf("                                            Merge .profraw/.profdata files for --profile-use\n");
+    printf("       flyuxc serve [-j <N>] <socket>      Run a compile server on a Unix socket\n\n");
     printf("Options:\n");
     printf("  -h, --help            Display this help message\n");
     printf("  -v, --version         Display compiler version\n");
     printf("  -o, --output <file>   Specify output file\n");
     printf("  -IR                   Emit LLVM IR (.ll) file\n");
+    printf("  -O0, -O1, -O2, -O3, -Os\n");
+    printf("                        Optimization level (default: -O1)\n");
+    printf("  --lto                 Whole-program optimization: merge the runtime bitcode,\n");
+    printf("                        internalize everything but main and run the LTO pipeline\n");
+    printf("  -j<N>                 Split the module and generate code on N threads; in batch mode\n");
+    printf("                        and for serve, the number of worker processes\n");
+    printf("                        (-j alone: one per CPU core; default: 1)\n");
+    printf("  --server=<socket>     Compile through the server on <socket>, locally if it is down\n");
+    printf("                        (default: $FLYUXC_SERVER)\n");
+    printf("  --profile-generate[=<file>]\n");
+    printf("                        Instrument the program; it writes a raw profile on exit\n");
+    printf("                        (default: default_%%m.profraw, overridden by $LLVM_PROFILE_FILE)\n");
+    printf("  --profile-use=<file>  Optimize using a merged profile (.profdata or a single .profraw)\n");
+    printf("  --time-report=json[:<file>]\n");
+    printf("                        Write per-phase timing, memory and IR statistics as JSON\n");
+    printf("                        (to stderr, or to <file>)\n");
+    printf("  --cache-dir=<dir>     Reuse executables and objects from a compile cache in <dir>\n");
+    printf("                        (default: $FLYUXC_CACHE_DIR, cache disabled if unset)\n");
+    printf("  --cache-size=<MiB>    Cache size limit, least recently used entries are evicted\n");
+    printf("                        (default: $FLYUXC_CACHE_SIZE or 256)\n");
+    printf("  --no-cache            Do not read or write the compile cache\n");
+    printf("  --lazy                With run: compile each function on its first call\n");
 }
 
 void print_version(void) {
@@ -23,10 +52,40 @@ CliOptions parse_arguments(int argc, char *argv[]) {
         .version = false,
         .emit_ir = false,
         .output = NULL,
-        .input = NULL
+        .input = NULL,
+        .inputs = NULL,
+        .input_count = 0,
+        .time_report = false,
+        .time_report_file = NULL,
+        .cache_dir = NULL,
+        .no_cache = false,
+        .cache_size_mb = 0,
+        .run = false,
+        .lazy = false,
+        .opt_level = 1,
+        .lto = false,
+        .jobs = 1,
+        .profile_generate = NULL,
+        .profile_use = NULL,
+        .profile_merge = false,
+        .serve = false,
+        .server = NULL
     };
 
-    for (int i = 1; i < argc; i++) {
+    int first = 1;
+    if (argc > 1 && strcmp(argv[1], "run") == 0) {
+        options.run = true;
+        first = 2;
+    } else if (argc > 1 && strcmp(argv[1], "profile-merge") == 0) {
+        options.profile_merge = true;
+        first = 2;
+    } else if (argc > 1 && strcmp(argv[1], "serve") == 0) {
+        options.serve = true;
+        first = 2;
+    }
+    options.inputs = malloc(sizeof(const char*) * argc);
+
+    for (int i = first; i < argc; i++) {
         if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             options.help = true;
         }
@@ -41,8 +100,79 @@ CliOptions parse_arguments(int argc, char *argv[]) {
                 options.output = argv[++i];
             }
         }
-        else if (argv[i][0] != '-' && options.input == NULL) {
-            options.input = argv[i];
+        else if (strncmp(argv[i], "--time-report=", 14) == 0) {
+            const char *format = argv[i] + 14;
+            if (strncmp(format, "json", 4) == 0 && (format[4] == '\0' || format[4] == ':')) {
+                options.time_report = true;
+                options.time_report_file = (format[4] == ':' && format[5]) ? format + 5 : NULL;
+            } else {
+                fprintf(stderr, "Unsupported time report format: %s (expected json)\n", format);
+            }
+        }
+        else if (strncmp(argv[i], "--cache-dir=", 12) == 0) {
+            options.cache_dir = argv[i] + 12;
+        }
+        else if (strncmp(argv[i], "--cache-size=", 13) == 0) {
+            char *end = NULL;
+            unsigned long long mb = strtoull(argv[i] + 13, &end, 10);
+            if (end && *end == '\0' && mb > 0) {
+                options.cache_size_mb = mb;
+            } else {
+                fprintf(stderr, "Invalid cache size: %s (expected MiB > 0)\n", argv[i] + 13);
+            }
+        }
+        else if (strcmp(argv[i], "--no-cache") == 0) {
+            options.no_cache = true;
+        }
+        else if (strcmp(argv[i], "--lazy") == 0) {
+            options.lazy = true;
+        }
+        else if (strncmp(argv[i], "-O", 2) == 0) {
+            const char *level = argv[i] + 2;
+            if (level[0] >= '0' && level[0] <= '3' && level[1] == '\0') {
+                options.opt_level = level[0] - '0';
+            } else if (strcmp(level, "s") == 0) {
+                options.opt_level = FLYUXC_OPT_SIZE;
+            } else {
+                fprintf(stderr, "Unsupported optimization level: %s (expected -O0..-O3 or -Os)\n", argv[i]);
+            }
+        }
+        else if (strcmp(argv[i], "--lto") == 0) {
+            options.lto = true;
+        }
+        else if (strncmp(argv[i], "-j", 2) == 0) {
+            // -j<N>、-j <N>；只有 -j 时按 CPU 核数
+            const char *count = argv[i][2] ? argv[i] + 2 : NULL;
+            if (!count && i + 1 < argc && argv[i + 1][0] >= '0' && argv[i + 1][0] <= '9') {
+                count = argv[++i];
+            }
+            char *end = NULL;
+            long jobs = count ? strtol(count, &end, 10) : 0;
+            if (count && (*end != '\0' || jobs < 0)) {
+                fprintf(stderr, "Invalid job count: %s\n", count);
+            } else {
+                options.jobs = (int)jobs;
+            }
+        }
+        else if (strcmp(argv[i], "--profile-generate") == 0) {
+            options.profile_generate = "default_%m.profraw";
+        }
+        else if (strncmp(argv[i], "--profile-generate=", 19) == 0) {
+            options.profile_generate = argv[i] + 19;
+        }
+        else if (strncmp(argv[i], "--profile-use=", 14) == 0) {
+            options.profile_use = argv[i] + 14;
+        }
+        else if (strncmp(argv[i], "--server=", 9) == 0) {
+            options.server = argv[i] + 9;
+        }
+        else if (argv[i][0] != '-') {
+            if (options.input == NULL) {
+                options.input = argv[i];
+            }
+            if (options.inputs) {
+                options.inputs[options.input_count++] = argv[i];
+            }
         }
     }
 
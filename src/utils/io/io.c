@@ -1,6 +1,10 @@
 #include "flyuxc/utils/io.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
 int print_file_to_stdout(const char *path) {
     if (!path) {
@@ -79,3 +83,48 @@ char* read_file_to_string(const char *path) {
     fclose(f);
     return content;
 }
+
+static const char* system_temp_dir(void) {
+    const char *tmpdir = getenv("TMPDIR");
+    return (tmpdir && *tmpdir) ? tmpdir : "/tmp";
+}
+
+const char* flyuxc_temp_dir(void) {
+    static char dir[1024];
+    static int state = 0;  // 0: 未检查, 1: 可用, -1: 不可用
+    if (state != 0) return state > 0 ? dir : NULL;
+
+    state = -1;
+    int n = snprintf(dir, sizeof(dir), "%s/flyuxc-%u", system_temp_dir(), (unsigned)getuid());
+    if (n < 0 || (size_t)n >= sizeof(dir) - 64) return NULL;
+
+    if (mkdir(dir, 0700) != 0 && errno != EEXIST) return NULL;
+
+    // 共享的 /tmp 下可能被别人抢先创建：必须是当前用户拥有、他人不可写的真实目录
+    struct stat st;
+    if (lstat(dir, &st) != 0 || !S_ISDIR(st.st_mode) ||
+        st.st_uid != getuid() || (st.st_mode & 022) != 0) {
+        return NULL;
+    }
+
+    state = 1;
+    return dir;
+}
+
+char* create_temp_file(const char *prefix, const char *suffix) {
+    const char *dir = flyuxc_temp_dir();
+    if (!dir) dir = system_temp_dir();
+
+    size_t len = strlen(dir) + strlen(prefix) + strlen(suffix) + 16;
+    char *path = malloc(len);
+    if (!path) return NULL;
+    snprintf(path, len, "%s/%sXXXXXX%s", dir, prefix, suffix);
+
+    int fd = mkstemps(path, (int)strlen(suffix));
+    if (fd < 0) {
+        free(path);
+        return NULL;
+    }
+    close(fd);
+    return path;
+}
@@ -50,6 +50,7 @@ Arena* arena_create(void) {
     arena->current = arena->first;
     arena->total_allocated = ARENA_INITIAL_BLOCK_SIZE;
     arena->block_size = ARENA_INITIAL_BLOCK_SIZE;
+    arena->alloc_count = 0;
     
     return arena;
 }
@@ -83,6 +84,7 @@ void* arena_alloc(Arena* arena, size_t size) {
     /* 分配内存 */
     void* ptr = arena->current->memory + arena->current->used;
     arena->current->used += size;
+    arena->alloc_count++;
     
     return ptr;
 }
@@ -96,6 +98,29 @@ void* arena_alloc_zero(Arena* arena, size_t size) {
     return ptr;
 }
 
+/* 扩展分配 */
+void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size) {
+    if (!arena) return NULL;
+    if (!ptr) return arena_alloc(arena, new_size);
+    if (new_size <= old_size) return ptr;
+    
+    /* ptr 是当前块的最后一次分配且剩余空间足够：原地扩展 */
+    ArenaBlock* block = arena->current;
+    size_t old_aligned = ALIGN_UP(old_size, ARENA_ALIGN);
+    size_t new_aligned = ALIGN_UP(new_size, ARENA_ALIGN);
+    if ((uint8_t*)ptr + old_aligned == block->memory + block->used &&
+        block->used - old_aligned + new_aligned <= block->capacity) {
+        block->used += new_aligned - old_aligned;
+        return ptr;
+    }
+    
+    void* new_ptr = arena_alloc(arena, new_size);
+    if (new_ptr) {
+        memcpy(new_ptr, ptr, old_size);
+    }
+    return new_ptr;
+}
+
 /* 重置 Arena */
 void arena_reset(Arena* arena) {
     if (!arena) return;
@@ -109,6 +134,7 @@ void arena_reset(Arena* arena) {
     
     /* 重置当前块指针 */
     arena->current = arena->first;
+    arena->alloc_count = 0;
 }
 
 /* 销毁 Arena */
@@ -131,6 +157,11 @@ size_t arena_total_allocated(const Arena* arena) {
     return arena ? arena->total_allocated : 0;
 }
 
+/* 获取分配次数 */
+size_t arena_alloc_count(const Arena* arena) {
+    return arena ? arena->alloc_count : 0;
+}
+
 /* 获取总使用量 */
 size_t arena_total_used(const Arena* arena) {
     if (!arena) return 0;
@@ -0,0 +1,520 @@
+#include "flyuxc/utils/compile_server.h"
+#include "flyuxc/utils/io.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+/* 请求头之后是工作目录和各参数，均以 '\0' 结尾；
+ * 回复是 int32 退出码，由服务器在工作进程结束后发送 */
+#define REQUEST_MAGIC 0x46585331u   /* "FXS1" */
+#define REQUEST_MAX_BYTES (1u << 20)
+#define REQUEST_FDS 3
+
+typedef struct {
+    uint32_t magic;
+    uint32_t length;
+} RequestHeader;
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/* 工作进程退出码：被信号终止时按 shell 的习惯记为 128 + 信号值 */
+static int exit_status(int status) {
+    if (WIFEXITED(status)) return WEXITSTATUS(status);
+    if (WIFSIGNALED(status)) return 128 + WTERMSIG(status);
+    return 1;
+}
+
+/* ============================================================================
+ * 批量编译
+ * ============================================================================ */
+
+typedef struct {
+    pid_t pid;
+    int index;
+    double start_ms;
+    char *log_path;
+} BatchSlot;
+
+int batch_run(const char *const *inputs, int count, int workers,
+              BatchJobFn job, BatchDoneFn done, void *ctx) {
+    if (workers < 1) workers = 1;
+    if (workers > count) workers = count;
+
+    BatchSlot *slots = calloc(workers > 0 ? workers : 1, sizeof(BatchSlot));
+    if (!slots) return count;
+
+    // 父进程缓冲区中未输出的内容不能被工作进程重复输出
+    fflush(stdout);
+    fflush(stderr);
+
+    int next = 0, running = 0, failed = 0;
+    while (next < count || running > 0) {
+        // 有空闲名额就启动下一个文件
+        while (next < count && running < workers) {
+            int slot = 0;
+            while (slots[slot].pid != 0) slot++;
+
+            char *log_path = create_temp_file("batch_", ".log");
+            pid_t pid = log_path ? fork() : -1;
+            if (pid == 0) {
+                int fd = open(log_path, O_WRONLY | O_TRUNC);
+                if (fd >= 0) {
+                    dup2(fd, STDOUT_FILENO);
+                    dup2(fd, STDERR_FILENO);
+                    close(fd);
+                }
+                int status = job(inputs[next], ctx);
+                fflush(stdout);
+                fflush(stderr);
+                _exit(status & 0xff);
+            }
+            if (pid < 0) {
+                BatchResult result = {inputs[next], -1, 0.0, NULL};
+                done(&result, ctx);
+                if (log_path) {
+                    unlink(log_path);
+                    free(log_path);
+                }
+                failed++;
+                next++;
+                continue;
+            }
+
+            slots[slot].pid = pid;
+            slots[slot].index = next;
+            slots[slot].start_ms = now_ms();
+            slots[slot].log_path = log_path;
+            running++;
+            next++;
+        }
+        if (running == 0) break;
+
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int i = 0; i < workers; i++) {
+            if (slots[i].pid != pid) continue;
+            BatchResult result = {
+                inputs[slots[i].index], exit_status(status),
+                now_ms() - slots[i].start_ms, slots[i].log_path
+            };
+            done(&result, ctx);
+            if (result.status != 0) failed++;
+            unlink(slots[i].log_path);
+            free(slots[i].log_path);
+            memset(&slots[i], 0, sizeof(slots[i]));
+            running--;
+            break;
+        }
+    }
+
+    free(slots);
+    return failed;
+}
+
+/* ============================================================================
+ * 编译服务器
+ * ============================================================================ */
+
+static bool read_full(int fd, void *buf, size_t len) {
+    char *p = buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static bool write_full(int fd, const void *buf, size_t len) {
+    const char *p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static bool socket_address(const char *path, struct sockaddr_un *addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr->sun_path)) return false;
+    strcpy(addr->sun_path, path);
+    return true;
+}
+
+static int connect_socket(const char *path) {
+    struct sockaddr_un addr;
+    if (!socket_address(path, &addr)) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* 请求头与客户端的 stdin / stdout / stderr 一起发送 */
+static bool send_header(int sock, const RequestHeader *header, const int fds[REQUEST_FDS]) {
+    union {
+        char buf[CMSG_SPACE(REQUEST_FDS * sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct iovec iov = {(void *)header, sizeof(*header)};
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(REQUEST_FDS * sizeof(int));
+    memcpy(CMSG_DATA(cmsg), fds, REQUEST_FDS * sizeof(int));
+
+    ssize_t n;
+    do {
+        n = sendmsg(sock, &msg, 0);
+    } while (n < 0 && errno == EINTR);
+    return n == (ssize_t)sizeof(*header);
+}
+
+static bool recv_header(int sock, RequestHeader *header, int fds[REQUEST_FDS]) {
+    union {
+        char buf[CMSG_SPACE(REQUEST_FDS * sizeof(int))];
+        struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct iovec iov = {header, sizeof(*header)};
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+
+    ssize_t n;
+    do {
+        n = recvmsg(sock, &msg, 0);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) return false;
+    // 描述符随第一段数据到达，头部其余部分可能分段
+    if ((size_t)n < sizeof(*header) &&
+        !read_full(sock, (char *)header + n, sizeof(*header) - (size_t)n)) {
+        return false;
+    }
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS ||
+        cmsg->cmsg_len != CMSG_LEN(REQUEST_FDS * sizeof(int))) {
+        return false;
+    }
+    memcpy(fds, CMSG_DATA(cmsg), REQUEST_FDS * sizeof(int));
+    return true;
+}
+
+/* 在工作进程中处理一个请求：换上客户端的 stdio 和工作目录后执行命令行，返回退出码 */
+static int serve_request(int client, ServerJobFn job, void *ctx) {
+    RequestHeader header;
+    int fds[REQUEST_FDS];
+    if (!recv_header(client, &header, fds)) return 1;
+    if (header.magic != REQUEST_MAGIC || header.length == 0 || header.length > REQUEST_MAX_BYTES) {
+        for (int i = 0; i < REQUEST_FDS; i++) close(fds[i]);
+        return 1;
+    }
+
+    char *payload = malloc(header.length + 1);
+    char **argv = malloc(sizeof(char *) * (header.length + 1));
+    if (!payload || !argv || !read_full(client, payload, header.length)) {
+        for (int i = 0; i < REQUEST_FDS; i++) close(fds[i]);
+        free(payload);
+        free(argv);
+        return 1;
+    }
+    payload[header.length] = '\0';
+
+    const char *cwd = payload;
+    int argc = 0;
+    for (char *p = payload + strlen(payload) + 1; p < payload + header.length; p += strlen(p) + 1) {
+        argv[argc++] = p;
+    }
+    argv[argc] = NULL;
+
+    for (int i = 0; i < REQUEST_FDS; i++) {
+        dup2(fds[i], i);
+        close(fds[i]);
+    }
+
+    int status = 1;
+    if (argc == 0) {
+        fprintf(stderr, "Error: Empty compile server request\n");
+    } else if (chdir(cwd) != 0) {
+        fprintf(stderr, "Error: Compile server cannot enter %s: %s\n", cwd, strerror(errno));
+    } else {
+        status = job(argc, argv, ctx);
+    }
+    fflush(stdout);
+    fflush(stderr);
+    free(payload);
+    free(argv);
+    return status;
+}
+
+typedef struct {
+    pid_t pid;
+    int client;
+} ServerSlot;
+
+static volatile sig_atomic_t server_stopping = 0;
+static int server_wake_pipe[2] = {-1, -1};
+
+/* SIGINT / SIGTERM 请求退出，SIGCHLD 表示有工作进程结束；都通过管道唤醒主循环的 poll */
+static void server_signal(int sig) {
+    int saved_errno = errno;
+    if (sig != SIGCHLD) server_stopping = 1;
+    char byte = 0;
+    ssize_t n = write(server_wake_pipe[1], &byte, 1);
+    (void)n;
+    errno = saved_errno;
+}
+
+/* 回收已结束的工作进程，把退出码回复给对应的客户端，返回回收的数量；
+ * block 为 true 时至少等待一个工作进程结束 */
+static int server_reap(ServerSlot *slots, int workers, bool block) {
+    int reaped = 0;
+    for (;;) {
+        int status;
+        pid_t pid = waitpid(-1, &status, block && reaped == 0 ? 0 : WNOHANG);
+        if (pid < 0 && errno == EINTR) continue;
+        if (pid <= 0) break;
+        for (int i = 0; i < workers; i++) {
+            if (slots[i].pid != pid) continue;
+            // 工作进程崩溃时也要回复，客户端据此报告失败而不是重新编译
+            int32_t reply = exit_status(status);
+            write_full(slots[i].client, &reply, sizeof(reply));
+            close(slots[i].client);
+            slots[i].pid = 0;
+            slots[i].client = -1;
+            reaped++;
+            break;
+        }
+    }
+    return reaped;
+}
+
+int compile_server_run(const char *socket_path, int workers, ServerJobFn job, void *ctx) {
+    if (workers < 1) workers = 1;
+
+    struct sockaddr_un addr;
+    if (!socket_address(socket_path, &addr)) {
+        fprintf(stderr, "Error: Socket path too long: %s\n", socket_path);
+        return 1;
+    }
+
+    // 已有服务器在监听时不抢占；连接不上的是上次残留的套接字文件
+    int probe = connect_socket(socket_path);
+    if (probe >= 0) {
+        close(probe);
+        fprintf(stderr, "Error: A compile server is already listening on %s\n", socket_path);
+        return 1;
+    }
+    unlink(socket_path);
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0 || bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(listen_fd, 64) != 0) {
+        fprintf(stderr, "Error: Cannot listen on %s: %s\n", socket_path, strerror(errno));
+        if (listen_fd >= 0) close(listen_fd);
+        return 1;
+    }
+
+    // 服务器自身不使用 stdout：工作进程换上客户端的 stdout 后，按其类型决定缓冲方式
+    fprintf(stderr, "Compile server listening on %s (%d workers)\n", socket_path, workers);
+
+    ServerSlot *slots = calloc(workers, sizeof(ServerSlot));
+    if (!slots || pipe(server_wake_pipe) != 0) {
+        fprintf(stderr, "Error: Cannot start compile server: %s\n", strerror(errno));
+        free(slots);
+        close(listen_fd);
+        unlink(socket_path);
+        return 1;
+    }
+    for (int i = 0; i < workers; i++) slots[i].client = -1;
+    fcntl(server_wake_pipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(server_wake_pipe[1], F_SETFL, O_NONBLOCK);
+    fcntl(server_wake_pipe[0], F_SETFD, FD_CLOEXEC);
+    fcntl(server_wake_pipe[1], F_SETFD, FD_CLOEXEC);
+    fcntl(listen_fd, F_SETFD, FD_CLOEXEC);
+
+    struct sigaction action, old_int, old_term, old_chld;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = server_signal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigaction(SIGINT, &action, &old_int);
+    sigaction(SIGTERM, &action, &old_term);
+    sigaction(SIGCHLD, &action, &old_chld);
+    // 客户端提前断开时回复失败即可，不应终止服务器
+    signal(SIGPIPE, SIG_IGN);
+
+    int running = 0;
+    while (!server_stopping) {
+        running -= server_reap(slots, workers, false);
+
+        // 满员时只等待工作进程结束，不接受新连接
+        struct pollfd fds[2] = {
+            {server_wake_pipe[0], POLLIN, 0},
+            {listen_fd, running < workers ? POLLIN : 0, 0}
+        };
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "Error: poll failed: %s\n", strerror(errno));
+            break;
+        }
+        if (fds[0].revents & POLLIN) {
+            char drain[64];
+            while (read(server_wake_pipe[0], drain, sizeof(drain)) > 0) {}
+        }
+        if (server_stopping || !(fds[1].revents & POLLIN)) continue;
+
+        int client = accept(listen_fd, NULL, NULL);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED || errno == EAGAIN) continue;
+            fprintf(stderr, "Error: accept failed: %s\n", strerror(errno));
+            break;
+        }
+        fcntl(client, F_SETFD, FD_CLOEXEC);
+
+        int slot = 0;
+        while (slots[slot].pid != 0) slot++;
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(listen_fd);
+            close(server_wake_pipe[0]);
+            close(server_wake_pipe[1]);
+            for (int i = 0; i < workers; i++) {
+                if (slots[i].pid != 0) close(slots[i].client);
+            }
+            sigaction(SIGINT, &old_int, NULL);
+            sigaction(SIGTERM, &old_term, NULL);
+            sigaction(SIGCHLD, &old_chld, NULL);
+            signal(SIGPIPE, SIG_DFL);
+            _exit(serve_request(client, job, ctx) & 0xff);
+        }
+        if (pid > 0) {
+            slots[slot].pid = pid;
+            slots[slot].client = client;
+            running++;
+        } else {
+            fprintf(stderr, "Warning: Cannot start compile worker: %s\n", strerror(errno));
+            close(client);
+        }
+    }
+
+    close(listen_fd);
+    unlink(socket_path);
+    // 进行中的请求照常完成
+    while (running > 0) {
+        int reaped = server_reap(slots, workers, true);
+        if (reaped == 0) break;
+        running -= reaped;
+    }
+
+    sigaction(SIGINT, &old_int, NULL);
+    sigaction(SIGTERM, &old_term, NULL);
+    sigaction(SIGCHLD, &old_chld, NULL);
+    close(server_wake_pipe[0]);
+    close(server_wake_pipe[1]);
+    server_wake_pipe[0] = server_wake_pipe[1] = -1;
+    free(slots);
+    return 0;
+}
+
+ServerRequestStatus compile_server_request(const char *socket_path, int argc, char *const argv[],
+                                           int *exit_code) {
+    char cwd[4096];
+    if (!getcwd(cwd, sizeof(cwd))) return SERVER_REQUEST_UNAVAILABLE;
+
+    size_t length = strlen(cwd) + 1;
+    for (int i = 0; i < argc; i++) length += strlen(argv[i]) + 1;
+    if (length > REQUEST_MAX_BYTES) return SERVER_REQUEST_UNAVAILABLE;
+
+    char *payload = malloc(length);
+    if (!payload) return SERVER_REQUEST_UNAVAILABLE;
+    size_t offset = 0;
+    memcpy(payload, cwd, strlen(cwd) + 1);
+    offset += strlen(cwd) + 1;
+    for (int i = 0; i < argc; i++) {
+        size_t len = strlen(argv[i]) + 1;
+        memcpy(payload + offset, argv[i], len);
+        offset += len;
+    }
+
+    int sock = connect_socket(socket_path);
+    if (sock < 0) {
+        free(payload);
+        return SERVER_REQUEST_UNAVAILABLE;
+    }
+
+    // 已关闭的标准描述符以 /dev/null 代替
+    int fds[REQUEST_FDS];
+    int null_fd = -1;
+    for (int i = 0; i < REQUEST_FDS; i++) {
+        if (fcntl(i, F_GETFD) != -1) {
+            fds[i] = i;
+        } else {
+            if (null_fd < 0) null_fd = open("/dev/null", O_RDWR);
+            fds[i] = null_fd;
+        }
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+    RequestHeader header = {REQUEST_MAGIC, (uint32_t)length};
+    ServerRequestStatus result = SERVER_REQUEST_UNAVAILABLE;
+    if (fds[0] >= 0 && fds[1] >= 0 && fds[2] >= 0 && send_header(sock, &header, fds)) {
+        // 请求头送达后服务器可能已经开始执行，之后的失败都不能再回退到本地编译
+        int32_t reply;
+        if (write_full(sock, payload, length) && read_full(sock, &reply, sizeof(reply))) {
+            *exit_code = reply;
+            result = SERVER_REQUEST_DONE;
+        } else {
+            result = SERVER_REQUEST_LOST;
+        }
+    }
+
+    if (null_fd >= 0) close(null_fd);
+    close(sock);
+    free(payload);
+    return result;
+}
@@ -20,20 +20,44 @@ StringPool* string_pool_create(Arena* arena) {
     StringPool* pool = (StringPool*)arena_alloc_zero(arena, sizeof(StringPool));
     if (!pool) return NULL;
     
+    pool->table = (StringPoolEntry**)arena_alloc_zero(arena, STRING_POOL_HASH_SIZE * sizeof(StringPoolEntry*));
+    if (!pool->table) return NULL;
+    
     pool->arena = arena;
+    pool->table_size = STRING_POOL_HASH_SIZE;
     pool->count = 0;
     pool->total_length = 0;
     
     return pool;
 }
 
+/* 哈希表扩容：表大小翻倍并重新挂链（旧表留在Arena中，随Arena释放） */
+static void string_pool_grow(StringPool* pool) {
+    size_t new_size = pool->table_size * 2;
+    StringPoolEntry** table = (StringPoolEntry**)arena_alloc_zero(pool->arena, new_size * sizeof(StringPoolEntry*));
+    if (!table) return;  // 扩容失败时继续使用旧表
+    
+    for (size_t i = 0; i < pool->table_size; i++) {
+        StringPoolEntry* entry = pool->table[i];
+        while (entry) {
+            StringPoolEntry* next = entry->next;
+            size_t index = entry->hash & (new_size - 1);
+            entry->next = table[index];
+            table[index] = entry;
+            entry = next;
+        }
+    }
+    pool->table = table;
+    pool->table_size = new_size;
+}
+
 /* 插入字符串 */
 const char* string_pool_insert(StringPool* pool, const char* str, size_t length) {
     if (!pool || !str) return NULL;
     
     /* 计算哈希值 */
     uint32_t hash = fnv1a_hash(str, length);
-    uint32_t index = hash & (STRING_POOL_HASH_SIZE - 1);
+    size_t index = hash & (pool->table_size - 1);
     
     /* 查找是否已存在 */
     StringPoolEntry* entry = pool->table[index];
@@ -46,7 +70,12 @@ const char* string_pool_insert(StringPool* pool, const char* str, size_t length)
         entry = entry->next;
     }
     
-    /* 不存在，创建新条目 */
+    /* 不存在，创建新条目（装载率超过1时先扩容） */
+    if (pool->count >= pool->table_size) {
+        string_pool_grow(pool);
+        index = hash & (pool->table_size - 1);
+    }
+    
     entry = (StringPoolEntry*)arena_alloc(pool->arena, sizeof(StringPoolEntry));
     if (!entry) return NULL;
     
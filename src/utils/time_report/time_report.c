@@ -0,0 +1,234 @@
+#include "flyuxc/utils/time_report.h"
+#include "flyuxc/version.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#define TIME_REPORT_MAX_PHASES 64
+#define TIME_REPORT_MAX_PASSES 256
+#define TIME_REPORT_MAX_COUNTS 64
+#define TIME_REPORT_MAX_DEPTH  8
+#define TIME_REPORT_NAME_LEN   96
+
+typedef struct {
+    char name[TIME_REPORT_NAME_LEN];  // 嵌套阶段为 "parent/child"
+    double start_ms;
+    double ms;
+    size_t heap_start;
+    size_t heap_end;                  // 阶段结束时的堆占用（字节）
+    size_t peak_rss;                  // 阶段结束时的峰值 RSS（字节）
+    int open;
+} PhaseRecord;
+
+typedef struct {
+    char name[TIME_REPORT_NAME_LEN];
+    unsigned long runs;
+    double ms;
+} PassRecord;
+
+typedef struct {
+    char name[TIME_REPORT_NAME_LEN];
+    unsigned long long value;
+} CountRecord;
+
+static struct {
+    bool enabled;
+    const char *path;
+    double start_ms;
+    PhaseRecord phases[TIME_REPORT_MAX_PHASES];
+    int phase_count;
+    int stack[TIME_REPORT_MAX_DEPTH];
+    int depth;
+    PassRecord passes[TIME_REPORT_MAX_PASSES];
+    int pass_count;
+    CountRecord counts[TIME_REPORT_MAX_COUNTS];
+    int count_count;
+} report;
+
+double time_report_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// 峰值 RSS（字节）：macOS 的 ru_maxrss 单位是字节，Linux 是 KB
+static size_t peak_rss_bytes(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return (size_t)usage.ru_maxrss;
+#else
+    return (size_t)usage.ru_maxrss * 1024;
+#endif
+}
+
+// 当前 malloc 堆占用（字节），平台不支持时为 0
+static size_t heap_in_use_bytes(void) {
+#if defined(__APPLE__)
+    malloc_statistics_t stats;
+    malloc_zone_statistics(NULL, &stats);
+    return stats.size_in_use;
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+void time_report_enable(const char *path) {
+    report.enabled = true;
+    report.path = path;
+    report.start_ms = time_report_now_ms();
+}
+
+bool time_report_enabled(void) {
+    return report.enabled;
+}
+
+int time_report_begin(const char *phase) {
+    if (!report.enabled || report.phase_count >= TIME_REPORT_MAX_PHASES) return -1;
+
+    int handle = report.phase_count++;
+    PhaseRecord *rec = &report.phases[handle];
+    if (report.depth > 0) {
+        // 按长度拼接 "parent/phase"，超长时截断
+        const char *parent = report.phases[report.stack[report.depth - 1]].name;
+        size_t cap = sizeof(rec->name) - 1;
+        size_t parent_len = strlen(parent);
+        size_t phase_len = strlen(phase);
+        if (parent_len > cap) parent_len = cap;
+        memcpy(rec->name, parent, parent_len);
+        size_t len = parent_len;
+        if (len < cap) rec->name[len++] = '/';
+        if (phase_len > cap - len) phase_len = cap - len;
+        memcpy(rec->name + len, phase, phase_len);
+        rec->name[len + phase_len] = '\0';
+    } else {
+        snprintf(rec->name, sizeof(rec->name), "%s", phase);
+    }
+    if (report.depth < TIME_REPORT_MAX_DEPTH) {
+        report.stack[report.depth++] = handle;
+    }
+    rec->open = 1;
+    rec->heap_start = heap_in_use_bytes();
+    rec->start_ms = time_report_now_ms();
+    return handle;
+}
+
+void time_report_end(int handle) {
+    if (!report.enabled || handle < 0 || handle >= report.phase_count) return;
+
+    PhaseRecord *rec = &report.phases[handle];
+    if (!rec->open) return;
+    rec->ms = time_report_now_ms() - rec->start_ms;
+    rec->heap_end = heap_in_use_bytes();
+    rec->peak_rss = peak_rss_bytes();
+    rec->open = 0;
+
+    // 关闭该阶段及其内部未关闭的阶段（错误提前返回时）
+    while (report.depth > 0) {
+        int top = report.stack[--report.depth];
+        if (top == handle) break;
+    }
+}
+
+void time_report_add_pass(const char *pass, double ms) {
+    if (!report.enabled) return;
+
+    for (int i = 0; i < report.pass_count; i++) {
+        if (strcmp(report.passes[i].name, pass) == 0) {
+            report.passes[i].runs++;
+            report.passes[i].ms += ms;
+            return;
+        }
+    }
+    if (report.pass_count >= TIME_REPORT_MAX_PASSES) return;
+    PassRecord *rec = &report.passes[report.pass_count++];
+    snprintf(rec->name, sizeof(rec->name), "%s", pass);
+    rec->runs = 1;
+    rec->ms = ms;
+}
+
+void time_report_count(const char *name, unsigned long long value) {
+    if (!report.enabled) return;
+
+    for (int i = 0; i < report.count_count; i++) {
+        if (strcmp(report.counts[i].name, name) == 0) {
+            report.counts[i].value = value;
+            return;
+        }
+    }
+    if (report.count_count >= TIME_REPORT_MAX_COUNTS) return;
+    CountRecord *rec = &report.counts[report.count_count++];
+    snprintf(rec->name, sizeof(rec->name), "%s", name);
+    rec->value = value;
+}
+
+// 名字都来自编译器内部（阶段名 / LLVM pass 类名），只需转义引号和反斜杠
+static void write_json_string(FILE *out, const char *s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', out);
+        if ((unsigned char)*s < 0x20) continue;
+        fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+void time_report_write(int status) {
+    if (!report.enabled) return;
+
+    FILE *out = stderr;
+    if (report.path) {
+        out = fopen(report.path, "w");
+        if (!out) {
+            perror(report.path);
+            return;
+        }
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"compiler\": \"%s %s\",\n", FLYUXC_COMPILER_NAME, FLYUXC_VERSION);
+    fprintf(out, "  \"status\": %d,\n", status);
+    fprintf(out, "  \"total_ms\": %.3f,\n", time_report_now_ms() - report.start_ms);
+    fprintf(out, "  \"peak_rss_bytes\": %zu,\n", peak_rss_bytes());
+
+    fprintf(out, "  \"phases\": [");
+    for (int i = 0; i < report.phase_count; i++) {
+        PhaseRecord *rec = &report.phases[i];
+        fprintf(out, "%s\n    {\"name\": ", i ? "," : "");
+        write_json_string(out, rec->name);
+        fprintf(out, ", \"ms\": %.3f, \"heap_bytes\": %zu, \"heap_delta_bytes\": %lld, \"peak_rss_bytes\": %zu}",
+                rec->ms, rec->heap_end,
+                (long long)rec->heap_end - (long long)rec->heap_start, rec->peak_rss);
+    }
+    fprintf(out, "%s],\n", report.phase_count ? "\n  " : "");
+
+    fprintf(out, "  \"llvm_passes\": [");
+    for (int i = 0; i < report.pass_count; i++) {
+        PassRecord *rec = &report.passes[i];
+        fprintf(out, "%s\n    {\"name\": ", i ? "," : "");
+        write_json_string(out, rec->name);
+        fprintf(out, ", \"runs\": %lu, \"ms\": %.3f}", rec->runs, rec->ms);
+    }
+    fprintf(out, "%s],\n", report.pass_count ? "\n  " : "");
+
+    fprintf(out, "  \"counts\": {");
+    for (int i = 0; i < report.count_count; i++) {
+        fprintf(out, "%s\n    ", i ? "," : "");
+        write_json_string(out, report.counts[i].name);
+        fprintf(out, ": %llu", report.counts[i].value);
+    }
+    fprintf(out, "%s}\n", report.count_count ? "\n  " : "");
+    fprintf(out, "}\n");
+
+    if (out != stderr) fclose(out);
+}
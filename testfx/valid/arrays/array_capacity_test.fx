@@ -0,0 +1,139 @@
+// 数组容量与头部偏移回归测试
+// 覆盖 push / pop / shift / unshift 在扩容、收缩和头部整理前后的行为
+
+// 打印数组内容和长度，便于逐步对照
+show := (label, arr) {
+    println(label, len(arr), " ", arr)
+}
+
+// 1. 字面量数组（容量等于长度）直接 push 触发扩容
+println("=== 1. push 扩容 ===")
+a := [1, 2, 3]
+push(a, 4)
+show("push 4:", a)                      // 4 [1, 2, 3, 4]
+L> (i := 5; i <= 20; i++) {
+    a.>push(i)
+}
+show("push 到 20:", a)                  // 20 [1..20]
+println("a[0] = ", a[0], ", a[19] = ", a[19])  // 1 20
+
+// 2. 大量 pop 之后收缩，再继续 push
+println("\n=== 2. pop 收缩后再 push ===")
+L> (16) {
+    pop(a)
+}
+show("pop 16 次:", a)                   // 4 [1, 2, 3, 4]
+push(a, 100)
+push(a, 101)
+show("再 push:", a)                     // 6 [1, 2, 3, 4, 100, 101]
+L> (6) {
+    pop(a)
+}
+show("全部 pop:", a)                    // 0 []
+println("空数组 pop:", pop(a))          // null
+push(a, "again")
+show("空后 push:", a)                   // 1 ["again"]
+
+// 3. shift 只移动头部，之后 push / 下标读写都要正确
+println("\n=== 3. shift 后 push ===")
+b := [10, 20, 30, 40, 50, 60, 70, 80]
+println("shift:", shift(b), " ", shift(b), " ", shift(b))  // 10 20 30
+show("shift 3 次:", b)                  // 5 [40, 50, 60, 70, 80]
+push(b, 90)
+b[0] = 41
+b[5] = 91
+show("push + 下标赋值:", b)             // 6 [41, 50, 60, 70, 80, 91]
+println("b[1] + b[4] = ", b[1] + b[4])   // 130
+
+// 4. 头部有空闲槽时 unshift 直接复用
+println("\n=== 4. shift 后 unshift ===")
+unshift(b, 33)
+unshift(b, 22)
+show("unshift 2 次:", b)                // 8 [22, 33, 41, 50, 60, 70, 80, 91]
+unshift(b, 11)
+unshift(b, 0)
+show("unshift 超过空闲槽:", b)          // 10 [0, 11, 22, 33, 41, ...]
+
+// 5. 连续 shift 直到头部整理，再 shift 到空
+println("\n=== 5. 连续 shift ===")
+q := []
+L> (i := 0; i < 40; i++) {
+    push(q, i)
+}
+total := 0
+L> (i := 0; i < 30; i++) {
+    total = total + shift(q)
+}
+println("前 30 个之和:", total)         // 435
+show("剩余:", q)                        // 10 [30..39]
+push(q, 40)
+unshift(q, 29)
+show("整理后 push/unshift:", q)         // 12 [29..40]
+L> (k := len(q); k > 0; k--) {
+    shift(q)
+}
+show("shift 到空:", q)                  // 0 []
+println("空数组 shift:", shift(q))      // null
+unshift(q, "first")
+push(q, "last")
+show("空后 unshift/push:", q)           // 2 ["first", "last"]
+
+// 6. 队列：交替 push / shift，长度保持不变
+println("\n=== 6. 队列轮转 ===")
+ring := [1, 2, 3, 4, 5]
+L> (i := 0; i < 1000; i++) {
+    push(ring, shift(ring) + 5)
+}
+show("轮转 1000 次:", ring)             // 5 [1001, 1002, 1003, 1004, 1005]
+
+// 7. 栈：从头部反复 unshift / shift
+println("\n=== 7. 头部栈 ===")
+st := []
+L> (i := 1; i <= 50; i++) {
+    unshift(st, i)
+}
+println("len:", len(st), " st[0]:", st[0], " st[49]:", st[49])  // 50 50 1
+sum := 0
+L> (25) {
+    sum = sum + shift(st)
+}
+println("shift 25 个之和:", sum)        // 950
+println("剩余 len:", len(st), " 首:", st[0], " 尾:", st[len(st) - 1])  // 25 25 1
+
+// 8. shift 过的数组传给其他内置函数
+println("\n=== 8. 偏移数组上的内置函数 ===")
+c := [5, 3, 9, 1, 7, 2]
+shift(c)
+show("shift 后:", c)                    // 5 [3, 9, 1, 7, 2]
+println("slice(1, 3):", slice(c, 1, 3)) // [9, 1]
+println("concat:", concat(c, [100]))    // [3, 9, 1, 7, 2, 100]
+println("indexOf 7:", indexOf(c, 7))    // 3
+println("join:", join(c, "-"))          // 3-9-1-7-2
+d := c
+shift(d)
+show("别名 shift 后原数组:", c)         // 4 [9, 1, 7, 2]
+each := 0
+L> (c : item) {
+    each = each + item
+}
+println("foreach 求和:", each)          // 19
+
+// 9. 嵌套数组在 shift 后被释放
+println("\n=== 9. 嵌套数组 ===")
+outer := [[0, 0]]
+L> (i := 1; i < 10; i++) {
+    push(outer, [i, i * 2])
+}
+L> (8) {
+    shift(outer)
+}
+show("outer:", outer)                   // 2 [[8, 16], [9, 18]]
+pair := [0]
+pair = shift(outer)
+push(pair, 99)
+show("取出的内层:", pair)              // 3 [8, 16, 99]
+show("outer:", outer)                   // 1 [[9, 18]]
+outer = [["x"]]
+show("重新赋值后:", outer)              // 1 [["x"]]
+
+println("\n=== 测试完成 ===")
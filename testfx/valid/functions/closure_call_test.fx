@@ -0,0 +1,110 @@
+// 闭包调用约定回归测试
+// 覆盖经函数值调用时实参个数与形参不一致、带捕获的绑定方法、直接调用点之后被重新赋值的闭包变量
+
+// 1. 经函数值调用：实参少于形参时补 undef，多于形参时忽略多余部分
+println("=== 1. 实参个数不一致 ===")
+three := (a, b, c) {
+    R> typeOf(a) + "," + typeOf(b) + "," + typeOf(c)
+}
+f := three
+println("0 个:", f())                   // undef,undef,undef
+println("1 个:", f(1))                  // num,undef,undef
+println("3 个:", f(1, "s", 3))          // num,str,num
+println("5 个:", f(1, 2, 3, 4, 5))      // num,num,num
+add2 := (a, b) {
+    R> a + b
+}
+g := add2
+println("多传参数:", g(10, 20, 30, 40)) // 30
+println("直接调用多传:", add2(1, 2, 3)) // 3
+
+// 参数多于旧上限（10 个）
+many := (a, b, c, d, e, f1, g1, h, i, j, k, l) {
+    R> a + b + c + d + e + f1 + g1 + h + i + j + k + l
+}
+m := many
+println("12 个参数:", m(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12))  // 78
+println("12 个形参只传 2 个:", typeOf(m(1, 2)))                  // num 之外的结果也不能崩溃
+
+// 2. 高阶函数：同一调用点依次遇到不同元数的函数值
+println("\n=== 2. 高阶函数 ===")
+apply3 := (fn) {
+    R> fn(1, 2, 3)
+}
+println("一元:", apply3((x) { R> x * 100 }))         // 100
+println("二元:", apply3((x, y) { R> x + y }))        // 3
+println("三元:", apply3((x, y, z) { R> x + y + z })) // 6
+println("零元:", apply3(() { R> "none" }))           // none
+
+// 3. 带捕获的闭包与绑定方法
+println("\n=== 3. 捕获与绑定方法 ===")
+makeCounter := (start, step) {
+    count := start
+    R> {
+        n: 0,
+        next: () {
+            count = count + step
+            self.n = self.n + 1
+            R> count
+        }
+    }
+}
+c1 := makeCounter(0, 1)
+c2 := makeCounter(100, 10)
+nextC1 := c1.next
+println("c1:", nextC1(), " ", nextC1(), " ", c1.next())  // 1 2 3
+println("c2:", c2.next(), " ", c2.next())                 // 110 120
+println("调用次数:", c1.n, " ", c2.n)                      // 3 2
+println("多传参数的绑定方法:", nextC1("extra", 1, 2))      // 4
+holder := {run: nextC1}
+println("转存后仍绑定 c1:", holder.run(), " ", c1.n)       // 5 5
+
+// 4. 直接调用点之后闭包变量被重新赋值
+// （顶层 name := (..) {..} 是具名函数定义，这里用函数内局部变量和工厂返回的闭包）
+println("\n=== 4. 闭包变量重新赋值 ===")
+localOps := () {
+    op := (x) {
+        R> x + 1
+    }
+    println("op(10):", op(10))                  // 11
+    op = (x) {
+        R> x * 3
+    }
+    println("重新赋值后 op(10):", op(10))       // 30
+    op = (x, y) {
+        R> x - y
+    }
+    println("换成二元 op(10, 4):", op(10, 4))   // 6
+}
+localOps()
+makeAdder := (k) {
+    R> (x) {
+        R> x + k
+    }
+}
+adder := makeAdder(1)
+println("adder(10):", adder(10))                // 11
+callAdder := (x) {
+    R> adder(x)
+}
+println("callAdder(10):", callAdder(10))        // 11
+adder = makeAdder(5)
+println("换捕获后 adder(10):", adder(10))       // 15
+println("换捕获后 callAdder(10):", callAdder(10))  // 15
+adder = (x) {
+    R> x * 2
+}
+println("换成新闭包:", adder(10), " ", callAdder(10))  // 20 20
+
+// 5. 递归闭包经函数值调用
+println("\n=== 5. 递归 ===")
+fib := (n) {
+    if (n < 2) {
+        R> n
+    }
+    R> fib(n - 1) + fib(n - 2)
+}
+viaValue := fib
+println("fib(15):", viaValue(15))       // 610
+
+println("\n=== 测试完成 ===")
@@ -0,0 +1,106 @@
+// 对象形状与字段内联缓存回归测试
+// 同一个 obj.field 访问点依次遇到不同形状、删除后重新添加字段、切换到哈希模式的对象
+
+// 这两个函数里的 o.x / o.y / o.x = ... 各是一个固定的访问点
+sumXY := (o) {
+    R> o.x + o.y
+}
+setX := (o, v) {
+    o.x = v
+}
+
+// 1. 相同键、不同插入顺序：形状不同，槽位不同
+println("=== 1. 键顺序不同 ===")
+p1 := {x: 1, y: 2}
+p2 := {y: 20, x: 10}
+p3 := {z: 0, x: 100, y: 200}
+println("p1:", sumXY(p1))               // 3
+println("p2:", sumXY(p2))               // 30
+println("p3:", sumXY(p3))               // 300
+println("p1 again:", sumXY(p1))         // 3
+
+// 2. 通过不同路径得到同一形状：字面量 vs 逐个添加
+println("\n=== 2. 不同路径到达同一形状 ===")
+q1 := {x: 5, y: 6}
+q2 := {x: 7}
+q2.y = 8
+q3 := {}
+setField(q3, "x", 9)
+setField(q3, "y", 10)
+println("q1:", sumXY(q1))               // 11
+println("q2:", sumXY(q2))               // 15
+println("q3:", sumXY(q3))               // 19
+println("keys q2:", keys(q2))          // ["x", "y"]
+println("keys q3:", keys(q3))          // ["x", "y"]
+
+// 3. 缓存命中后写入，再从另一个形状读取
+println("\n=== 3. 写入访问点 ===")
+setX(p1, 1000)
+setX(p2, 2000)
+setX(p3, 3000)
+println("p1:", p1.x, " ", sumXY(p1))   // 1000 1002
+println("p2:", p2.x, " ", sumXY(p2))   // 2000 2020
+println("p3:", p3.x, " ", sumXY(p3))   // 3000 3200
+
+// 4. 删除字段后重新添加：键顺序和槽位都变了
+println("\n=== 4. 删除后重新添加 ===")
+r := {x: 1, y: 2, z: 3}
+println("before:", sumXY(r), " ", keys(r))      // 3 ["x", "y", "z"]
+deleteField(r, "x")
+println("hasField x:", hasField(r, "x"))  // false
+println("after delete:", r?.x)          // undef
+r.x = 50
+println("re-added:", sumXY(r), " ", keys(r))    // 52 ["y", "z", "x"]
+setX(r, 60)
+println("written:", r.x, " ", r.y, " ", r.z)    // 60 2 3
+r.y = undef
+println("y = undef:", keys(r), " ", r?.y)      // ["z", "x"] undef
+r.y = 7
+println("y again:", sumXY(r), " ", keys(r))     // 67 ["z", "x", "y"]
+
+// 5. 单态访问点上的对象切换到哈希模式
+println("\n=== 5. 切换到哈希模式 ===")
+h := {x: 1, y: 2}
+L> (i := 0; i < 5; i++) {
+    println("linear ", i, ": ", sumXY(h))  // 3
+}
+names := ["a", "b", "c", "d", "e", "f", "g", "h", "i", "j"]
+L> (names : name) {
+    setField(h, name, name)
+}
+println("field count:", len(keys(h)))   // 12
+println("hash mode:", sumXY(h))         // 3
+setX(h, 40)
+h.y = 2
+println("hash write:", h.x, " ", h.y, " ", sumXY(h))  // 40 2 42
+deleteField(h, "x")
+h.x = 1
+println("hash delete + re-add:", sumXY(h), " ", h.j)  // 3 j
+// 同一访问点再回到线性模式的对象
+println("linear again:", sumXY(p2))     // 2020
+
+// 6. 方法字段：命中缓存后仍需绑定 self
+println("\n=== 6. 方法字段 ===")
+counter := {n: 0, inc: () { self.n = self.n + 1; R> self.n }}
+other := {inc: () { R> "other" }, n: 100}
+callInc := (o) {
+    R> o.inc()
+}
+println(callInc(counter))               // 1
+println(callInc(counter))               // 2
+println(callInc(other))                 // other
+println(callInc(counter))               // 3
+counter.inc = 5
+println("inc 变为数字:", counter.inc)   // 5
+
+// 7. 同一形状，字段值类型不同
+println("\n=== 7. 字段值类型变化 ===")
+m1 := {x: "a", y: "b"}
+m2 := {x: [1], y: [2]}
+println(sumXY(m1))                      // ab
+println(sumXY(m2))                      // 0（数组相加按数值）
+m1.x = 1
+m1.y = 2
+println(sumXY(m1))                      // 3
+
+println("\n=== 测试完成 ===")
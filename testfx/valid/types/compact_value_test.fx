@@ -0,0 +1,110 @@
+// 紧凑值（NaN-boxing）回归测试
+// 函数内可证明为 num 的局部变量与任意值做 + / == / != 时走 box_number_fx / box_value_fx / fx_add /
+// fx_equals / unbox_value_fx；结果必须与两边都是普通 Value 时的 value_add / value_equals 一致
+
+// 普通 Value 路径：从数组取出的值不是可证明的 num
+dyn := (x) {
+    box := [x]
+    R> box[0]
+}
+
+// 比较类型和值；NaN 与 NaN 视为一致
+check := (label, fx, ref) {
+    same := fx == ref
+    if (fx != fx) { same = ref != ref }
+    if (typeOf(fx) != typeOf(ref)) { same = false }
+    println(label, " ", fx, " ", typeOf(fx), " 一致:", same)
+}
+
+// 比较运算的结果与普通 Value 路径的结果是否相同
+agree := (a, b) {
+    R> a == b
+}
+
+// 1. 各种类型经过 box_value_fx / unbox_value_fx 往返：n + v
+println("=== 1. num + 任意值 ===")
+mixedAdd := (v) {
+    n := 1.5
+    n = n * 2
+    dn := dyn(n)
+    check("n + v:", n + v, dn + v)
+    check("v + n:", v + n, v + dn)
+}
+tn:[str] = null
+samples := [2, -0.25, true, false, null, tn, undef, "s", [1, 2], {k: 1}]
+L> (samples : v) {
+    print(typeOf(v), ": ")
+    mixedAdd(v)
+}
+fnv := (a) { R> a }
+mixedAdd(fnv)
+
+// 2. NaN 规范化：NaN 仍按数字处理，不会被当成 null/bool/undef 等标签
+println("\n=== 2. NaN ===")
+nanTest := () {
+    z := 0
+    nan := z / z
+    neg := -nan
+    big := 1e308 * 10
+    check("nan + 1:", nan + dyn(1), dyn(nan) + 1)
+    check("-nan + true:", neg + dyn(true), dyn(neg) + true)
+    // NaN 转成字符串时的符号与平台有关，只比较两条路径是否一致
+    s := nan + dyn("x")
+    println("nan + str:", typeOf(s), " 一致:", s == dyn(nan) + "x")
+    println("nan == nan 值:", nan == dyn(nan), " != :", nan != dyn(nan))
+    println("nan == null:", nan == dyn(null), " nan == undef:", nan == dyn(undef))
+    check("inf + 1:", big + dyn(1), dyn(big) + 1)
+    println("typeOf(nan + 0):", typeOf(nan + dyn(0)))
+}
+nanTest()
+
+// 3. fx_equals 与 value_equals：混合类型比较
+println("\n=== 3. num == / != 任意值 ===")
+mixedEq := (v) {
+    zero := 0
+    one := zero + 1
+    two := one * 2
+    d0 := dyn(zero)
+    d1 := dyn(one)
+    d2 := dyn(two)
+    r0 := zero == v
+    r1 := one == v
+    r2 := two != v
+    ok := agree(r0, d0 == v) && agree(r1, d1 == v) && agree(r2, d2 != v)
+    println("  0==:", r0, " 1==:", r1, " 2!=:", r2, " 一致:", ok)
+    // 条件表达式中的比较直接使用 fx_equals 的结果
+    hits := 0
+    if (v == one) { hits = hits + 1 }
+    if (zero != v) { hits = hits + 10 }
+    println("  条件:", hits)
+}
+L> (samples : v) {
+    print(typeOf(v), ":")
+    mixedEq(v)
+}
+mixedEq(fnv)
+
+// 4. 堆对象引用计数：循环中反复转换，字符串拼接结果可以继续使用
+println("\n=== 4. 循环与引用计数 ===")
+loopTest := () {
+    acc := ""
+    arr := [10, 20]
+    L> (i := 0; i < 5; i++) {
+        k := i * 1
+        acc = k + acc
+        arr[0] = k + arr[0]
+    }
+    println("acc:", acc, " arr:", arr)
+    total := 0
+    L> (arr : item) {
+        total = total * 1
+        if (total == item) { println("不应相等") }
+    }
+    s := "tail"
+    j := 3
+    t := j + s
+    println(t, " ", s, " ", len(t))
+}
+loopTest()
+
+println("\n=== 测试完成 ===")
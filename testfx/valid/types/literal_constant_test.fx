@@ -0,0 +1,93 @@
+// 字面量常量回归测试
+// 字符串 / 数字字面量是只读的静态 Value：含 \0 的字面量要保持完整长度，
+// 传给会修改参数的内置函数或在循环里反复求值后，字面量本身不能被改动
+
+// 1. 含 \0 的字符串字面量：静态 Value 记录完整字节长度，
+// 按长度读取的 substr 能取到 \0 之后的内容；按 C 字符串处理的 len / == 在 \0 处截止
+println("=== 1. 内嵌 \\0 ===")
+z := "ab\0cd"
+println("substr(z, 3, 2):", substr(z, 3, 2))            // cd
+println("substr 字面量:", substr("ab\0cd", 3, 2))       // cd
+println("\\0 之后的长度:", len(substr(z, 3)))           // 2
+println("len:", len(z))                                  // 2
+println("等于自身字面量:", z == "ab\0cd")                // true
+println("拼接后 len:", len(z + "!"))                     // 3
+println("typeOf:", typeOf("\0"))                         // str
+println("空串 len:", len(""), " ", "" == "")             // 0 true
+
+// 2. 循环里反复求值的字面量
+println("\n=== 2. 循环中的字面量 ===")
+acc := ""
+L> (i := 0; i < 3; i++) {
+    s := "lit"
+    s = s + i
+    acc = acc + s + ","
+}
+println("拼接结果:", acc)                   // lit0,lit1,lit2,
+println("字面量未变:", "lit")               // lit
+n := 0
+L> (i := 0; i < 4; i++) {
+    x := 2.5
+    x++
+    x = x * 2
+    n = n + x
+}
+println("数字累加:", n)                     // 28
+println("2.5 仍是:", 2.5)                   // 2.5
+big := 0
+L> (3) {
+    big = big + 1000000007
+}
+println("大整数字面量:", big)               // 3000000021
+
+// 3. 字面量放进数组后被修改
+println("\n=== 3. 修改数组中的字面量 ===")
+L> (i := 0; i < 3; i++) {
+    arr := ["a", "b"]
+    push(arr, "c")
+    arr[0] = arr[0] + i
+    println("第", i, "次:", arr)           // ["a0", "b", "c"] ...
+}
+words := []
+L> (3) {
+    push(words, "w")
+    unshift(words, 1.5)
+}
+println("push/unshift 字面量:", words)     // [1.5, 1.5, 1.5, "w", "w", "w"]
+popped := ""
+popped = pop(words)
+popped = popped + "!"
+println("pop 出的字面量再拼接:", popped, " ", words[len(words) - 1])  // w! w
+sorted := sort(["c", "a", "b"])
+println("sort 字面量数组:", sorted)         // ["a", "b", "c"]
+rev := reverse("abc")
+println("reverse 字符串:", rev, " 原字面量:", "abc")  // cba abc
+L> (2) {
+    r := reverse([1, 2, 3])
+    println("reverse 数组字面量:", r)       // [3, 2, 1]
+}
+
+// 4. 字面量作为对象字段后被修改
+println("\n=== 4. 修改对象中的字面量 ===")
+L> (i := 0; i < 2; i++) {
+    o := {name: "base", score: 0.5}
+    o.name = o.name + "-" + i
+    o.score = o.score + 1
+    setField(o, "tag", "t")
+    o.tag = o.tag + o.tag
+    println(o.name, " ", o.score, " ", o.tag)  // base-0 1.5 tt
+}
+shared := "shared"
+p := {a: shared, b: shared}
+p.a = p.a + "!"
+println("共享字面量:", p.a, " ", p.b, " ", shared)  // shared! shared shared
+
+// 5. 字符串内置函数不修改字面量
+println("\n=== 5. 字符串内置函数 ===")
+println(upper("mixed Case"), " ", lower("MIXED"))  // MIXED CASE mixed
+println(trim("  pad  "), "|")                      // pad|
+println(replace("a-b-a", "a", "x"))                // x-b-a
+println(split("x,y,z", ","))                       // ["x", "y", "z"]
+println("原字面量:", "mixed Case", " ", "  pad  ", "|")
+
+println("\n=== 测试完成 ===")